@@ -0,0 +1,177 @@
+﻿using DumpFormatter.Diff;
+using DumpFormatter.Model;
+
+using System.Diagnostics;
+using System.Text;
+using System.Text.Json;
+
+using static DumpFormatter.Program;
+
+namespace DumpFormatter;
+
+/// <summary>
+/// Formats every build listed in registry.json in a single process, which is what Pages needs. The dictionary is loaded once,
+/// each dump is deserialized once for all the output formats and the builds are formatted in parallel. Optionally, the diffs
+/// between adjacent builds of each game are precomputed too (see <see cref="DiffArtifact"/>).
+/// </summary>
+internal static class BatchCompiler
+{
+    public static readonly Format[] DefaultFormats = { Format.Html, Format.PlainText, Format.JsonTree };
+
+    private record Build(string Game, string Name);
+
+    private sealed class BuildTimings
+    {
+        public TimeSpan Load { get; set; }
+        public Dictionary<Format, TimeSpan> Formats { get; } = new();
+        public bool Missing { get; set; }
+    }
+
+    public static void Run(FileInfo? dictionary, Format[] formats, bool diffs, int threads, bool strict, FileInfo registry, DirectoryInfo dumps, DirectoryInfo output)
+    {
+        var total = Stopwatch.StartNew();
+        formats = formats.Distinct().ToArray();
+
+        var stage = Stopwatch.StartNew();
+        if (dictionary != null)
+        {
+            Joaat.LoadDictionary(dictionary.FullName);
+        }
+        var dictionaryTime = stage.Elapsed;
+
+        var builds = ReadRegistry(registry);
+        output.Create();
+        registry.CopyTo(Path.Combine(output.FullName, "registry.json"), overwrite: true);
+
+        // the formatters only read the dictionary and the dump, so builds can be formatted concurrently
+        var timings = builds.Select(_ => new BuildTimings()).ToArray();
+        var options = new ParallelOptions { MaxDegreeOfParallelism = threads > 0 ? threads : Environment.ProcessorCount };
+        stage.Restart();
+        Parallel.For(0, builds.Length, options, i =>
+        {
+            var build = builds[i];
+            var input = new FileInfo(Path.Combine(dumps.FullName, build.Game, $"b{build.Name}.json"));
+            if (!input.Exists)
+            {
+                timings[i].Missing = true;
+                return;
+            }
+
+            var gameOutput = Directory.CreateDirectory(Path.Combine(output.FullName, build.Game));
+            var watch = Stopwatch.StartNew();
+            input.CopyTo(Path.Combine(gameOutput.FullName, input.Name), overwrite: true);
+            var dump = LoadDump(input);
+            timings[i].Load = watch.Elapsed;
+
+            foreach (var format in formats)
+            {
+                watch.Restart();
+                WriteDump(CreateFormatter(format), dump, new FileInfo(Path.Combine(gameOutput.FullName, $"b{build.Name}{GetExtension(format)}")));
+                timings[i].Formats[format] = watch.Elapsed;
+            }
+        });
+        var formatTime = stage.Elapsed;
+
+        // the registry lists the builds of a game from newest to oldest, each build is compared with the previous one of the
+        // same edition
+        var pairs = diffs ?
+                        builds.GroupBy(b => (b.Game, GetEdition(b)))
+                              .SelectMany(g => g.Zip(g.Skip(1), (newer, older) => (A: older, B: newer)))
+                              .ToArray() :
+                        Array.Empty<(Build A, Build B)>();
+        stage.Restart();
+        Parallel.ForEach(pairs, options, pair =>
+        {
+            var inputA = new FileInfo(Path.Combine(dumps.FullName, pair.A.Game, $"b{pair.A.Name}.json"));
+            var inputB = new FileInfo(Path.Combine(dumps.FullName, pair.B.Game, $"b{pair.B.Name}.json"));
+            if (!inputA.Exists || !inputB.Exists)
+            {
+                return; // already reported as missing
+            }
+
+            var diffOutput = new FileInfo(Path.Combine(output.FullName, pair.B.Game, DiffArtifact.GetFileName(pair.A.Name, pair.B.Name)));
+            using var outputWriter = new StreamWriter(diffOutput.Open(FileMode.Create, FileAccess.Write), Encoding.UTF8);
+            DiffArtifact.Write(outputWriter, LoadDump(inputA), LoadDump(inputB));
+        });
+        var diffTime = stage.Elapsed;
+
+        PrintTimings(builds, timings, formats);
+        Console.WriteLine($"Dictionary: {dictionaryTime.TotalMilliseconds,10:F0} ms");
+        Console.WriteLine($"Builds:     {formatTime.TotalMilliseconds,10:F0} ms ({builds.Length} builds, {options.MaxDegreeOfParallelism} threads)");
+        if (diffs)
+        {
+            Console.WriteLine($"Diffs:      {diffTime.TotalMilliseconds,10:F0} ms ({pairs.Length} pairs)");
+        }
+        Console.WriteLine($"Total:      {total.Elapsed.TotalMilliseconds,10:F0} ms");
+
+        var missing = builds.Where((_, i) => timings[i].Missing).Select(b => $"{b.Game}/b{b.Name}.json").ToArray();
+        if (missing.Length > 0)
+        {
+            // reported and skipped unless strict, so one missing dump does not stop the other builds from being published
+            var message = $"Dumps listed in the registry are missing: {string.Join(", ", missing)}";
+            if (strict)
+            {
+                throw new FileNotFoundException(message);
+            }
+
+            Console.WriteLine($"{message}, skipped");
+        }
+    }
+
+    private static Build[] ReadRegistry(FileInfo registry)
+    {
+        using var stream = registry.OpenRead();
+        using var doc = JsonDocument.Parse(stream);
+        return doc.RootElement.EnumerateObject()
+                  .SelectMany(game => game.Value.EnumerateArray().Select(entry => new Build(game.Name, entry.GetProperty("build").GetString()!)))
+                  .ToArray();
+    }
+
+    // the GTA5 Enhanced builds ("3323g9") are numbered apart from the legacy ones, so they are only compared with each other
+    private static string GetEdition(Build build) => build.Name.EndsWith("g9") ? "g9" : "";
+
+    // same names as compile_dumps.ps1 used, Pages expects them
+    private static string GetExtension(Format format) => format switch
+    {
+        Format.PlainText => ".txt",
+        Format.Html => ".html",
+        Format.Xsd => ".xsd",
+        Format.JsonTree => ".tree.json",
+        _ => throw new ArgumentException($"Unknown format '{format}'"),
+    };
+
+    private static void PrintTimings(Build[] builds, BuildTimings[] timings, Format[] formats)
+    {
+        Console.Write($"{"Build",-24} {"Load",10}");
+        foreach (var format in formats)
+        {
+            Console.Write($" {format,10}");
+        }
+        Console.WriteLine();
+
+        for (int i = 0; i < builds.Length; i++)
+        {
+            Console.Write($"{$"{builds[i].Game}/b{builds[i].Name}",-24}");
+            if (timings[i].Missing)
+            {
+                Console.WriteLine($" {"missing",10}");
+                continue;
+            }
+
+            Console.Write($" {timings[i].Load.TotalMilliseconds,7:F0} ms");
+            foreach (var format in formats)
+            {
+                Console.Write($" {timings[i].Formats[format].TotalMilliseconds,7:F0} ms");
+            }
+            Console.WriteLine();
+        }
+
+        // summed over the builds, so with several threads it is more than the elapsed time
+        Console.Write($"{"Sum",-24} {timings.Sum(t => t.Load.TotalMilliseconds),7:F0} ms");
+        foreach (var format in formats)
+        {
+            Console.Write($" {timings.Where(t => !t.Missing).Sum(t => t.Formats[format].TotalMilliseconds),7:F0} ms");
+        }
+        Console.WriteLine();
+    }
+}
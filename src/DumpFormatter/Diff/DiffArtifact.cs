@@ -0,0 +1,98 @@
+﻿using DumpFormatter.Formatters;
+using DumpFormatter.Model;
+
+using System.Text.Json;
+using System.Text.Json.Serialization;
+
+namespace DumpFormatter.Diff;
+
+/// <summary>
+/// Writes the *.diff.json loaded by the diff page of Pages, so it doesn't need to fetch and compare the two *.tree.json. It has
+/// the nodes that the page shows: added and removed structs/enums, and those whose markup or structure changed. Each node has
+/// the markup of both builds, the page highlights the changes, along with the changes found by <see cref="DumpDiff"/>.
+/// </summary>
+internal static class DiffArtifact
+{
+    private record Artifact(string BuildA, string BuildB, List<Node> Structs, List<Node> Enums);
+    private class Node
+    {
+        public string Name { get; init; } = "";
+        public string Hash { get; init; } = "";
+        public string DiffType { get; init; } = "";
+        public ulong? Size { get; init; }
+        public ulong? Align { get; init; }
+        public string Markup { get; init; } = ""; // of build A, or build B if added
+        public string? MarkupB { get; init; }     // only if modified
+        public string[]? Changed { get; init; }
+        public List<MemberDiff>? Members { get; init; }
+        public List<EnumValueDiff>? Values { get; init; }
+    }
+
+    public static void Write(TextWriter writer, ParDump a, ParDump b)
+    {
+        var diff = DumpDiff.Compare(a, b);
+        var formatter = new JsonTreeFormatter();
+        var structsA = a.Structs.ToDictionary(s => s.Name.Hash);
+        var structsB = b.Structs.ToDictionary(s => s.Name.Hash);
+        var enumsA = a.Enums.ToDictionary(e => e.Name.Hash);
+        var enumsB = b.Enums.ToDictionary(e => e.Name.Hash);
+
+        var structs = new List<Node>();
+        var structDiffs = diff.Structs.ToDictionary(d => d.Name.Hash);
+        foreach (var d in diff.Structs.Where(d => d.DiffType != DiffType.Modified))
+        {
+            var s = d.DiffType == DiffType.Added ? structsB[d.Name.Hash] : structsA[d.Name.Hash];
+            structs.Add(new() { Name = s.Name.ToFormattedString(), Hash = s.Name.ToFormattedHash(), DiffType = d.DiffType, Size = s.Size, Align = s.Align, Markup = formatter.GetStructMarkup(d.DiffType == DiffType.Added ? b : a, s) });
+        }
+        foreach (var sa in a.Structs)
+        {
+            if (!structsB.TryGetValue(sa.Name.Hash, out var sb))
+            {
+                continue;
+            }
+
+            // the markup also changes if a struct or enum it references was renamed, which DumpDiff doesn't see
+            var markupA = formatter.GetStructMarkup(a, sa);
+            var markupB = formatter.GetStructMarkup(b, sb);
+            structDiffs.TryGetValue(sa.Name.Hash, out var d);
+            if (d != null || markupA != markupB)
+            {
+                structs.Add(new() { Name = sa.Name.ToFormattedString(), Hash = sa.Name.ToFormattedHash(), DiffType = DiffType.Modified, Size = sb.Size, Align = sb.Align, Markup = markupA, MarkupB = markupB, Changed = d?.Changed, Members = d?.Members });
+            }
+        }
+
+        var enums = new List<Node>();
+        var enumDiffs = diff.Enums.ToDictionary(d => d.Name.Hash);
+        foreach (var d in diff.Enums.Where(d => d.DiffType != DiffType.Modified))
+        {
+            var e = d.DiffType == DiffType.Added ? enumsB[d.Name.Hash] : enumsA[d.Name.Hash];
+            enums.Add(new() { Name = e.Name.ToFormattedString(), Hash = e.Name.ToFormattedHash(), DiffType = d.DiffType, Markup = formatter.GetEnumMarkup(d.DiffType == DiffType.Added ? b : a, e) });
+        }
+        foreach (var ea in a.Enums)
+        {
+            if (!enumsB.TryGetValue(ea.Name.Hash, out var eb))
+            {
+                continue;
+            }
+
+            var markupA = formatter.GetEnumMarkup(a, ea);
+            var markupB = formatter.GetEnumMarkup(b, eb);
+            enumDiffs.TryGetValue(ea.Name.Hash, out var d);
+            if (d != null || markupA != markupB)
+            {
+                enums.Add(new() { Name = ea.Name.ToFormattedString(), Hash = ea.Name.ToFormattedHash(), DiffType = DiffType.Modified, Markup = markupA, MarkupB = markupB, Values = d?.Values });
+            }
+        }
+
+        // same order as the page used: removed, added and then modified
+        static int order(Node n) => n.DiffType switch { DiffType.Removed => 0, DiffType.Added => 1, _ => 2 };
+        var artifact = new Artifact(a.Build, b.Build,
+                                    structs.OrderBy(order).ThenBy(n => n.Name, StringComparer.Ordinal).ToList(),
+                                    enums.OrderBy(order).ThenBy(n => n.Name, StringComparer.Ordinal).ToList());
+        var opt = new JsonSerializerOptions(JsonSerializerDefaults.Web) { DefaultIgnoreCondition = JsonIgnoreCondition.WhenWritingNull };
+        writer.Write(JsonSerializer.Serialize(artifact, opt));
+    }
+
+    // loaded by Pages as dumps/<game>/b<buildA>_b<buildB>.diff.json, see getDumpURL
+    public static string GetFileName(string buildA, string buildB) => $"b{buildA}_b{buildB}.diff.json";
+}
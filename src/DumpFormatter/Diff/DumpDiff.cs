@@ -0,0 +1,162 @@
+﻿using DumpFormatter.Model;
+
+namespace DumpFormatter.Diff;
+
+/// <summary>
+/// Kind of change of a struct, enum, member or enum value between two builds. Same letters as the diff view of Pages.
+/// </summary>
+internal static class DiffType
+{
+    public const string Added = "a";
+    public const string Removed = "r";
+    public const string Modified = "m";
+}
+
+internal record MemberDiff(string Name, string DiffType, string[]? Changed = null);
+
+internal record EnumValueDiff(string Name, string DiffType, long? ValueA = null, long? ValueB = null);
+
+internal record StructDiff(Name Name, string DiffType, string[]? Changed = null, List<MemberDiff>? Members = null);
+
+internal record EnumDiff(Name Name, string DiffType, List<EnumValueDiff>? Values = null);
+
+/// <summary>
+/// Structural differences between two dumps. Structs and enums are matched by name hash, members and enum values by name
+/// hash too (in order, if a name appears more than once). Function addresses are ignored, they change in every build.
+/// </summary>
+internal record DumpDiff(List<StructDiff> Structs, List<EnumDiff> Enums)
+{
+    public static DumpDiff Compare(ParDump a, ParDump b)
+    {
+        var structs = new List<StructDiff>();
+        var structsB = b.Structs.ToDictionary(s => s.Name.Hash);
+        var structsA = a.Structs.ToDictionary(s => s.Name.Hash);
+        foreach (var sa in a.Structs)
+        {
+            if (!structsB.TryGetValue(sa.Name.Hash, out var sb))
+            {
+                structs.Add(new(sa.Name, DiffType.Removed));
+            }
+            else if (CompareStruct(sa, sb) is StructDiff diff)
+            {
+                structs.Add(diff);
+            }
+        }
+        structs.AddRange(b.Structs.Where(s => !structsA.ContainsKey(s.Name.Hash)).Select(s => new StructDiff(s.Name, DiffType.Added)));
+
+        var enums = new List<EnumDiff>();
+        var enumsB = b.Enums.ToDictionary(e => e.Name.Hash);
+        var enumsA = a.Enums.ToDictionary(e => e.Name.Hash);
+        foreach (var ea in a.Enums)
+        {
+            if (!enumsB.TryGetValue(ea.Name.Hash, out var eb))
+            {
+                enums.Add(new(ea.Name, DiffType.Removed));
+            }
+            else if (CompareEnum(ea, eb) is EnumDiff diff)
+            {
+                enums.Add(diff);
+            }
+        }
+        enums.AddRange(b.Enums.Where(e => !enumsA.ContainsKey(e.Name.Hash)).Select(e => new EnumDiff(e.Name, DiffType.Added)));
+
+        return new(structs, enums);
+    }
+
+    private static StructDiff? CompareStruct(ParStructure a, ParStructure b)
+    {
+        var changed = new List<string>();
+        if (a.Size != b.Size) { changed.Add("size"); }
+        if (a.Align != b.Align) { changed.Add("align"); }
+        if (a.Version != b.Version) { changed.Add("version"); }
+        if (a.Flags != b.Flags) { changed.Add("flags"); }
+        if (a.Base?.Name != b.Base?.Name || a.Base?.Offset != b.Base?.Offset) { changed.Add("base"); }
+
+        var members = new List<MemberDiff>();
+        MatchByName(a.Members, b.Members, m => m.Name,
+            removed: m => members.Add(new(m.Name.ToFormattedString(), DiffType.Removed)),
+            added: m => members.Add(new(m.Name.ToFormattedString(), DiffType.Added)),
+            both: (ma, mb) =>
+            {
+                var memberChanged = new List<string>();
+                if (ma.Offset != mb.Offset) { memberChanged.Add("offset"); }
+                if (ma.Size != mb.Size) { memberChanged.Add("size"); }
+                if (ma.Align != mb.Align) { memberChanged.Add("align"); }
+                if (TypeSignature(ma) != TypeSignature(mb)) { memberChanged.Add("type"); }
+                if (memberChanged.Count > 0)
+                {
+                    members.Add(new(ma.Name.ToFormattedString(), DiffType.Modified, memberChanged.ToArray()));
+                }
+            });
+
+        return changed.Count > 0 || members.Count > 0 ?
+                new(a.Name, DiffType.Modified, changed.Count > 0 ? changed.ToArray() : null, members.Count > 0 ? members : null) :
+                null;
+    }
+
+    private static EnumDiff? CompareEnum(ParEnum a, ParEnum b)
+    {
+        var values = new List<EnumValueDiff>();
+        MatchByName(a.Values, b.Values, v => v.Name,
+            removed: v => values.Add(new(v.Name.ToFormattedString(), DiffType.Removed, ValueA: v.Value)),
+            added: v => values.Add(new(v.Name.ToFormattedString(), DiffType.Added, ValueB: v.Value)),
+            both: (va, vb) =>
+            {
+                if (va.Value != vb.Value)
+                {
+                    values.Add(new(va.Name.ToFormattedString(), DiffType.Modified, va.Value, vb.Value));
+                }
+            });
+
+        return values.Count > 0 ? new(a.Name, DiffType.Modified, values) : null;
+    }
+
+    private static void MatchByName<T>(IEnumerable<T> a, IEnumerable<T> b, Func<T, Name> getName, Action<T> removed, Action<T> added, Action<T, T> both)
+    {
+        var byNameB = b.ToLookup(getName);
+        var matchedB = new Dictionary<Name, int>();
+        foreach (var itemA in a)
+        {
+            var name = getName(itemA);
+            matchedB.TryGetValue(name, out var index);
+            var candidates = byNameB[name];
+            if (index < candidates.Count())
+            {
+                both(itemA, candidates.ElementAt(index));
+            }
+            else
+            {
+                removed(itemA);
+            }
+            matchedB[name] = index + 1;
+        }
+
+        foreach (var itemB in b)
+        {
+            var name = getName(itemB);
+            matchedB.TryGetValue(name, out var count);
+            if (count > 0)
+            {
+                matchedB[name] = count - 1;
+            }
+            else
+            {
+                added(itemB);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Describes the type of a member, including the struct/enum it refers to and the types of array items and map
+    /// keys/values, so two members with the same signature have the same type.
+    /// </summary>
+    private static string TypeSignature(ParMember m) => m switch
+    {
+        ParMemberStruct s => $"{m.Type}.{m.Subtype}({s.StructName?.Hash:X08})",
+        ParMemberEnum e => $"{m.Type}.{m.Subtype}({e.EnumName.Hash:X08})",
+        ParMemberArray arr => $"{m.Type}.{m.Subtype}<{TypeSignature(arr.Item)}, {arr.ArraySize}>",
+        ParMemberMap map => $"{m.Type}.{m.Subtype}<{TypeSignature(map.Key)}, {TypeSignature(map.Value)}>",
+        ParMemberString str => $"{m.Type}.{m.Subtype}({str.MemberSize})",
+        _ => $"{m.Type}.{m.Subtype}",
+    };
+}
@@ -1,4 +1,5 @@
-﻿using DumpFormatter.Formatters;
+﻿using DumpFormatter.Diff;
+using DumpFormatter.Formatters;
 using DumpFormatter.Model;
 
 using System.CommandLine;
@@ -10,7 +11,7 @@ namespace DumpFormatter;
 
 internal static class Program
 {
-    enum Format
+    internal enum Format
     {
         PlainText,
         Html,
@@ -28,10 +29,37 @@ internal static class Program
         var input = new Argument<FileInfo>("input", "The input JSON dump file.");
         var output = new Argument<FileInfo>("output", "The output formatted dump file.");
 
+        var batchFormats = new Option<Format[]>(new[] { "--formats", "-f" }, () => BatchCompiler.DefaultFormats, "The output formats, can be repeated.");
+        var batchDiffs = new Option<bool>("--diffs", "Also write the diffs between adjacent builds of each game.");
+        var batchThreads = new Option<int>(new[] { "--threads", "-t" }, () => 0, "Number of builds formatted in parallel (0 = one per core).");
+        var batchStrict = new Option<bool>("--strict", "Fail if a dump listed in the registry is missing, instead of skipping it.");
+        var batchRegistry = new Argument<FileInfo>("registry", "The registry.json listing the builds of each game.");
+        var batchDumps = new Argument<DirectoryInfo>("dumps", "The directory with a subdirectory of JSON dumps per game.");
+        var batchOutput = new Argument<DirectoryInfo>("output", "The output directory.");
+        var batch = new Command("batch", "Format every build of the registry, loading the dictionary and each dump only once.")
+        {
+            dictionary,
+            batchFormats, batchDiffs, batchThreads, batchStrict,
+            batchRegistry, batchDumps, batchOutput,
+        };
+        batch.SetHandler(BatchCompiler.Run, dictionary, batchFormats, batchDiffs, batchThreads, batchStrict, batchRegistry, batchDumps, batchOutput);
+
+        var diffA = new Argument<FileInfo>("a", "The JSON dump of the older build.");
+        var diffB = new Argument<FileInfo>("b", "The JSON dump of the newer build.");
+        var diffOutput = new Argument<FileInfo>("output", "The output diff file.");
+        var diff = new Command("diff", "Compare the structs and enums of two builds.")
+        {
+            dictionary,
+            diffA, diffB, diffOutput,
+        };
+        diff.SetHandler(DiffEntryPoint, dictionary, diffA, diffB, diffOutput);
+
         var root = new RootCommand("Format a RAGE parser dump generated by DumpStructs.asi.")
         {
             dictionary,
             format, input, output,
+            batch,
+            diff,
         };
         root.SetHandler(EntryPoint, dictionary, format, input, output);
         return root.Invoke(args);
@@ -49,26 +77,48 @@ internal static class Program
             Joaat.LoadDictionary(dictionary.FullName);
         }
 
-        IDumpFormatter formatter = format switch
-        {
-            Format.PlainText => new PlainTextFormatter(),
-            Format.Html => new HtmlFormatter(),
-            Format.Xsd => new XsdFormatter(),
-            Format.JsonTree => new JsonTreeFormatter(),
-            _ => throw new ArgumentException($"Unknown format '{format}'"),
-        };
+        var formatter = CreateFormatter(format);
+        var dump = LoadDump(input);
+        WriteDump(formatter, dump, output);
+    }
 
-        ParDump dump;
-        var opt = new JsonSerializerOptions(JsonSerializerDefaults.Web);
-        using (var inputStream = input.OpenRead())
-        {
-            dump = JsonSerializer.Deserialize<ParDump>(inputStream, opt) ?? throw new ArgumentException($"JSON deserialization of '{input.FullName}' returned null");
-        }
+    static void DiffEntryPoint(FileInfo? dictionary, FileInfo a, FileInfo b, FileInfo output)
+    {
+        Console.WriteLine($"Dictionary: {dictionary?.ToString() ?? "none"}");
+        Console.WriteLine($"A:      {a}");
+        Console.WriteLine($"B:      {b}");
+        Console.WriteLine($"Output: {output}");
 
-        using (var outputStream = output.Open(FileMode.Create, FileAccess.Write))
+        if (dictionary != null)
         {
-            using var outputWriter = new StreamWriter(outputStream, Encoding.UTF8);
-            formatter.Format(outputWriter, dump);
+            Joaat.LoadDictionary(dictionary.FullName);
         }
+
+        using var outputStream = output.Open(FileMode.Create, FileAccess.Write);
+        using var outputWriter = new StreamWriter(outputStream, Encoding.UTF8);
+        DiffArtifact.Write(outputWriter, LoadDump(a), LoadDump(b));
+    }
+
+    internal static IDumpFormatter CreateFormatter(Format format) => format switch
+    {
+        Format.PlainText => new PlainTextFormatter(),
+        Format.Html => new HtmlFormatter(),
+        Format.Xsd => new XsdFormatter(),
+        Format.JsonTree => new JsonTreeFormatter(),
+        _ => throw new ArgumentException($"Unknown format '{format}'"),
+    };
+
+    internal static ParDump LoadDump(FileInfo input)
+    {
+        var opt = new JsonSerializerOptions(JsonSerializerDefaults.Web);
+        using var inputStream = input.OpenRead();
+        return JsonSerializer.Deserialize<ParDump>(inputStream, opt) ?? throw new ArgumentException($"JSON deserialization of '{input.FullName}' returned null");
+    }
+
+    internal static void WriteDump(IDumpFormatter formatter, ParDump dump, FileInfo output)
+    {
+        using var outputStream = output.Open(FileMode.Create, FileAccess.Write);
+        using var outputWriter = new StreamWriter(outputStream, Encoding.UTF8);
+        formatter.Format(outputWriter, dump);
     }
 }
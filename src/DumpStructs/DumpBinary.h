@@ -0,0 +1,308 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <span>
+
+// Binary dump format (.pardump), an alternative to the JSON dump meant to be memory-mapped and read without any parsing.
+//
+// Layout:
+//   DumpBinaryHeader
+//   sections, each aligned to 8 bytes, located by the DumpBinarySection entries of the header
+//
+// Strings are stored in the string table prefixed by their uint32_t length and followed by a null terminator. Records reference
+// them by the offset of their first character within the string table. All records are fixed-size and reference each other by
+// index into the corresponding section. Every key that may be missing from the JSON dump has a presence bit in its record, so
+// the JSON dump can be reconstructed byte-for-byte from the binary dump.
+
+constexpr uint32_t DumpBinaryMagic = 0x42445052; // 'RPDB'
+constexpr uint16_t DumpBinaryVersion = 1;
+
+constexpr uint32_t DumpNoString = 0xFFFFFFFF;
+constexpr uint32_t DumpNoIndex = 0xFFFFFFFF;
+constexpr uint64_t DumpNullPointer = 0xFFFFFFFF'FFFFFFFF;
+
+struct DumpBinarySection
+{
+	uint32_t offset; // from the start of the file
+	uint32_t count;  // number of records, or number of bytes for the string table
+};
+
+struct DumpBinaryHeader
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t headerSize;
+	uint32_t game;
+	uint32_t build;
+	DumpBinarySection strings;
+	DumpBinarySection structs;
+	DumpBinarySection members;
+	DumpBinarySection subMembers; // array items and map keys/values
+	DumpBinarySection enums;
+	DumpBinarySection enumValues;
+	DumpBinarySection attributeLists;
+	DumpBinarySection attributes;
+	DumpBinarySection callbacks;
+	DumpBinarySection initValues;
+};
+
+// A name is either a hash (GTA5/RDR3 without name strings) or a string, in which case the hash is its JOAAT.
+struct DumpName
+{
+	uint32_t hash;
+	uint32_t string;
+
+	bool IsHashOnly() const { return string == DumpNoString; }
+};
+
+enum DumpStructKey : uint32_t
+{
+	DumpStructKey_Base = 1 << 0,
+	DumpStructKey_Align = 1 << 1,
+	DumpStructKey_ExtraAttributes = 1 << 2,
+	DumpStructKey_FactoryNew = 1 << 3,
+	DumpStructKey_FactoryPlacementNew = 1 << 4,
+	DumpStructKey_FactoryDelete = 1 << 5,
+	DumpStructKey_GetStructureCB = 1 << 6,
+	DumpStructKey_Callbacks = 1 << 7,
+};
+
+struct DumpStructRecord
+{
+	DumpName name;
+	DumpName baseName;
+	uint64_t baseOffset;
+	uint64_t size;
+	uint32_t align;
+	uint32_t flags; // string
+	uint16_t versionMajor;
+	uint16_t versionMinor;
+	uint32_t presence; // DumpStructKey
+	uint32_t firstMember;
+	uint32_t memberCount;
+	uint32_t extraAttributes; // index into attributeLists
+	uint32_t firstCallback;
+	uint32_t callbackCount;
+	uint32_t padding;
+	uint64_t factoryNew; // DumpNullPointer if null
+	uint64_t factoryPlacementNew;
+	uint64_t factoryDelete;
+	uint64_t getStructureCB;
+};
+
+enum DumpMemberKey : uint32_t
+{
+	DumpMemberKey_Align = 1 << 0,
+	DumpMemberKey_ExtraData = 1 << 1,
+	DumpMemberKey_Attributes = 1 << 2,
+	DumpMemberKey_StructName = 1 << 3,
+	DumpMemberKey_StructNameNull = 1 << 4,
+	DumpMemberKey_ExternalNamedResolveFunc = 1 << 5,
+	DumpMemberKey_ExternalNamedGetNameFunc = 1 << 6,
+	DumpMemberKey_AllocateStructFunc = 1 << 7,
+	DumpMemberKey_Item = 1 << 8,
+	DumpMemberKey_AllocFlags = 1 << 9,
+	DumpMemberKey_ArraySize = 1 << 10,
+	DumpMemberKey_CountOffset = 1 << 11,
+	DumpMemberKey_EnumName = 1 << 12,
+	DumpMemberKey_InitValue = 1 << 13,
+	DumpMemberKey_InitValueIsInt = 1 << 14,
+	DumpMemberKey_Key = 1 << 15,
+	DumpMemberKey_Value = 1 << 16,
+	DumpMemberKey_CreateIteratorFunc = 1 << 17,
+	DumpMemberKey_CreateInterfaceFunc = 1 << 18,
+	DumpMemberKey_MemberSize = 1 << 19,
+	DumpMemberKey_NamespaceIndex = 1 << 20,
+	DumpMemberKey_InitValues = 1 << 21,
+};
+
+struct DumpMemberRecord
+{
+	// indices into DumpMemberRecord::funcs
+	static constexpr size_t ExternalNamedResolveFunc = 0;
+	static constexpr size_t ExternalNamedGetNameFunc = 1;
+	static constexpr size_t AllocateStructFunc = 2;
+	static constexpr size_t CreateIteratorFunc = 0;
+	static constexpr size_t CreateInterfaceFunc = 1;
+
+	// indices into DumpMemberRecord::children
+	static constexpr size_t Item = 0;
+	static constexpr size_t Key = 0;
+	static constexpr size_t Value = 1;
+
+	DumpName name;
+	uint64_t offset;
+	uint32_t size;
+	uint32_t align;
+	uint16_t flags1;
+	uint16_t flags2;
+	uint16_t extraData;
+	uint16_t padding;
+	uint32_t type;    // string
+	uint32_t subtype; // string
+	uint32_t attributes; // index into attributeLists
+	uint32_t presence; // DumpMemberKey
+	DumpName refName; // structName or enumName
+	uint32_t children[2]; // indices into subMembers, DumpNoIndex if null
+	uint32_t allocFlags; // string
+	uint32_t count; // arraySize, countOffset, memberSize or namespaceIndex
+	union
+	{
+		double initValue;
+		int64_t initValueInt; // if DumpMemberKey_InitValueIsInt
+	};
+	uint32_t firstInitValue; // index into initValues
+	uint32_t initValueCount;
+	uint64_t funcs[3];
+};
+
+struct DumpEnumRecord
+{
+	DumpName name;
+	uint32_t flags; // string
+	uint32_t firstValue;
+	uint32_t valueCount;
+	uint32_t padding;
+};
+
+struct DumpEnumValueRecord
+{
+	DumpName name;
+	int64_t value;
+};
+
+enum DumpAttributeListKey : uint32_t
+{
+	DumpAttributeListKey_UserData1 = 1 << 0,
+	DumpAttributeListKey_UserData2 = 1 << 1,
+};
+
+struct DumpAttributeListRecord
+{
+	uint32_t firstAttribute;
+	uint32_t attributeCount;
+	uint8_t userData1;
+	uint8_t userData2;
+	uint16_t presence; // DumpAttributeListKey
+};
+
+enum class DumpAttributeValueKind : uint32_t
+{
+	None = 0,
+	String,
+	Int,
+	Double,
+	Bool,
+};
+
+struct DumpAttributeRecord
+{
+	uint32_t name; // string
+	uint32_t type; // string
+	DumpAttributeValueKind valueKind;
+	uint32_t padding;
+	union
+	{
+		uint32_t asString;
+		int64_t asInt;
+		double asDouble;
+		bool asBool;
+	};
+};
+
+struct DumpCallbackRecord
+{
+	uint32_t name; // string
+	uint32_t padding;
+	uint64_t func;
+};
+
+static_assert(sizeof(DumpBinaryHeader) == 96);
+static_assert(sizeof(DumpStructRecord) == 104);
+static_assert(sizeof(DumpMemberRecord) == 112);
+static_assert(sizeof(DumpEnumRecord) == 24);
+static_assert(sizeof(DumpEnumValueRecord) == 16);
+static_assert(sizeof(DumpAttributeListRecord) == 12);
+static_assert(sizeof(DumpAttributeRecord) == 24);
+static_assert(sizeof(DumpCallbackRecord) == 16);
+
+// Read-only view over a binary dump loaded in memory. Does not copy nor parse anything, all accessors point into the given buffer.
+class DumpBinaryView
+{
+public:
+	DumpBinaryView() = default;
+	DumpBinaryView(const void* data, size_t size) : _data{ static_cast<const uint8_t*>(data) }, _size{ size } {}
+
+	// Checks the header and that all sections are within the buffer. Must be called before accessing the dump.
+	bool Validate() const
+	{
+		if (_data == nullptr || _size < sizeof(DumpBinaryHeader) || reinterpret_cast<uintptr_t>(_data) % alignof(uint64_t) != 0)
+		{
+			return false;
+		}
+
+		const auto& h = Header();
+		return h.magic == DumpBinaryMagic && h.version == DumpBinaryVersion && h.headerSize == sizeof(DumpBinaryHeader) &&
+			IsValidSection(h.strings, 1) &&
+			IsValidSection(h.structs, sizeof(DumpStructRecord)) &&
+			IsValidSection(h.members, sizeof(DumpMemberRecord)) &&
+			IsValidSection(h.subMembers, sizeof(DumpMemberRecord)) &&
+			IsValidSection(h.enums, sizeof(DumpEnumRecord)) &&
+			IsValidSection(h.enumValues, sizeof(DumpEnumValueRecord)) &&
+			IsValidSection(h.attributeLists, sizeof(DumpAttributeListRecord)) &&
+			IsValidSection(h.attributes, sizeof(DumpAttributeRecord)) &&
+			IsValidSection(h.callbacks, sizeof(DumpCallbackRecord)) &&
+			IsValidSection(h.initValues, sizeof(double));
+	}
+
+	const DumpBinaryHeader& Header() const { return *reinterpret_cast<const DumpBinaryHeader*>(_data); }
+
+	std::string_view Game() const { return String(Header().game); }
+	std::string_view Build() const { return String(Header().build); }
+
+	std::span<const DumpStructRecord> Structs() const { return Section<DumpStructRecord>(Header().structs); }
+	std::span<const DumpMemberRecord> Members() const { return Section<DumpMemberRecord>(Header().members); }
+	std::span<const DumpMemberRecord> SubMembers() const { return Section<DumpMemberRecord>(Header().subMembers); }
+	std::span<const DumpEnumRecord> Enums() const { return Section<DumpEnumRecord>(Header().enums); }
+	std::span<const DumpEnumValueRecord> EnumValues() const { return Section<DumpEnumValueRecord>(Header().enumValues); }
+	std::span<const DumpAttributeListRecord> AttributeLists() const { return Section<DumpAttributeListRecord>(Header().attributeLists); }
+	std::span<const DumpAttributeRecord> Attributes() const { return Section<DumpAttributeRecord>(Header().attributes); }
+	std::span<const DumpCallbackRecord> Callbacks() const { return Section<DumpCallbackRecord>(Header().callbacks); }
+	std::span<const double> InitValues() const { return Section<double>(Header().initValues); }
+
+	std::span<const DumpMemberRecord> Members(const DumpStructRecord& s) const { return Members().subspan(s.firstMember, s.memberCount); }
+	std::span<const DumpEnumValueRecord> Values(const DumpEnumRecord& e) const { return EnumValues().subspan(e.firstValue, e.valueCount); }
+	std::span<const DumpCallbackRecord> Callbacks(const DumpStructRecord& s) const { return Callbacks().subspan(s.firstCallback, s.callbackCount); }
+	std::span<const DumpAttributeRecord> Attributes(const DumpAttributeListRecord& l) const { return Attributes().subspan(l.firstAttribute, l.attributeCount); }
+	std::span<const double> InitValues(const DumpMemberRecord& m) const { return InitValues().subspan(m.firstInitValue, m.initValueCount); }
+
+	std::string_view String(uint32_t offset) const
+	{
+		if (offset == DumpNoString)
+		{
+			return {};
+		}
+
+		const char* str = reinterpret_cast<const char*>(_data + Header().strings.offset + offset);
+		uint32_t length;
+		std::memcpy(&length, str - sizeof(uint32_t), sizeof(uint32_t));
+		return { str, length };
+	}
+
+private:
+	bool IsValidSection(const DumpBinarySection& section, size_t recordSize) const
+	{
+		return section.offset % alignof(uint64_t) == 0 && section.offset <= _size && (_size - section.offset) / recordSize >= section.count;
+	}
+
+	template<class T>
+	std::span<const T> Section(const DumpBinarySection& section) const
+	{
+		return { reinterpret_cast<const T*>(_data + section.offset), section.count };
+	}
+
+	const uint8_t* _data = nullptr;
+	size_t _size = 0;
+};
@@ -0,0 +1,688 @@
+#include "DumpBinaryWriter.h"
+#include "Joaat.h"
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+
+static DumpName MakeNullName()
+{
+	return { 0, DumpNoString };
+}
+
+// Parses hex numbers as written by JsonWriter ("0x" followed by uppercase digits), anything else is kept as a string.
+static std::optional<uint64_t> ParseHex(std::string_view str)
+{
+	if (!str.starts_with("0x") || str.size() == 2 || str.size() > 18 ||
+		!std::all_of(str.begin() + 2, str.end(), [](char c) { return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F'); }))
+	{
+		return std::nullopt;
+	}
+
+	uint64_t value = 0;
+	auto [ptr, ec] = std::from_chars(str.data() + 2, str.data() + str.size(), value, 16);
+	if (ec != std::errc{} || ptr != str.data() + str.size())
+	{
+		return std::nullopt;
+	}
+	return value;
+}
+
+DumpBinaryWriter::DumpBinaryWriter()
+	: _flushed{ true }, _game{ DumpNoString }, _build{ DumpNoString }
+{
+}
+
+DumpBinaryWriter::DumpBinaryWriter(std::string_view filePath)
+	: _filePath{ filePath }, _flushed{ false }, _game{ DumpNoString }, _build{ DumpNoString }
+{
+}
+
+DumpBinaryWriter::~DumpBinaryWriter()
+{
+	if (!_flushed)
+	{
+		Flush();
+	}
+}
+
+void DumpBinaryWriter::Null(std::optional<std::string_view> key)
+{
+	if (_scopes.empty() || !key.has_value())
+	{
+		Unexpected(key);
+	}
+
+	const auto k = key.value();
+	switch (_scopes.back())
+	{
+	case Scope::Struct:
+	case Scope::StructFactories:
+		Pointer(k, std::nullopt);
+		break;
+	case Scope::Member:
+	{
+		auto& m = CurrentMember();
+		if (k == "structName")
+		{
+			m.presence |= DumpMemberKey_StructName | DumpMemberKey_StructNameNull;
+			m.refName = MakeNullName();
+		}
+		else if (k == "item" || k == "key")
+		{
+			m.presence |= (k == "item" ? DumpMemberKey_Item : DumpMemberKey_Key);
+			m.children[DumpMemberRecord::Item] = DumpNoIndex;
+		}
+		else if (k == "value")
+		{
+			m.presence |= DumpMemberKey_Value;
+			m.children[DumpMemberRecord::Value] = DumpNoIndex;
+		}
+		else
+		{
+			Unexpected(key);
+		}
+	}
+	break;
+	default:
+		Unexpected(key);
+	}
+}
+
+void DumpBinaryWriter::String(std::optional<std::string_view> key, std::string_view value)
+{
+	if (_scopes.empty() || !key.has_value())
+	{
+		Unexpected(key);
+	}
+
+	const auto k = key.value();
+	switch (_scopes.back())
+	{
+	case Scope::Root:
+		if (k == "game") { _game = AddString(value); return; }
+		if (k == "build") { _build = AddString(value); return; }
+		break;
+	case Scope::Struct:
+	{
+		auto& s = _structs.back();
+		if (k == "name") { SetName(s.name, value); return; }
+		if (k == "flags") { s.flags = AddString(value); return; }
+		if (k == "version")
+		{
+			const auto dot = value.find('.');
+			if (dot == std::string_view::npos ||
+				std::from_chars(value.data(), value.data() + dot, s.versionMajor).ec != std::errc{} ||
+				std::from_chars(value.data() + dot + 1, value.data() + value.size(), s.versionMinor).ec != std::errc{})
+			{
+				Unexpected(key);
+			}
+			return;
+		}
+	}
+	break;
+	case Scope::StructBase:
+		if (k == "name") { SetName(_structs.back().baseName, value); return; }
+		break;
+	case Scope::Member:
+	{
+		auto& m = CurrentMember();
+		if (k == "name") { SetName(m.name, value); return; }
+		if (k == "type") { m.type = AddString(value); return; }
+		if (k == "subtype") { m.subtype = AddString(value); return; }
+		if (k == "allocFlags") { m.presence |= DumpMemberKey_AllocFlags; m.allocFlags = AddString(value); return; }
+		if (k == "structName") { m.presence |= DumpMemberKey_StructName; SetName(m.refName, value); return; }
+		if (k == "enumName") { m.presence |= DumpMemberKey_EnumName; SetName(m.refName, value); return; }
+	}
+	break;
+	case Scope::Attribute:
+	{
+		auto& a = _attributes.back();
+		if (k == "name") { a.name = AddString(value); return; }
+		if (k == "type") { a.type = AddString(value); return; }
+		if (k == "value") { a.valueKind = DumpAttributeValueKind::String; a.asString = AddString(value); return; }
+	}
+	break;
+	case Scope::Enum:
+	{
+		auto& e = _enums.back();
+		if (k == "name") { SetName(e.name, value); return; }
+		if (k == "flags") { e.flags = AddString(value); return; }
+	}
+	break;
+	case Scope::EnumValue:
+		if (k == "name") { SetName(_enumValues.back().name, value); return; }
+		break;
+	default:
+		// no string values in the other scopes
+		break;
+	}
+
+	// hex numbers are written as strings (see json_uint_hex), accept them for any integer key
+	if (auto hex = ParseHex(value); hex.has_value())
+	{
+		Number(key, hex.value(), false);
+		return;
+	}
+
+	Unexpected(key);
+}
+
+void DumpBinaryWriter::Bool(std::optional<std::string_view> key, bool value)
+{
+	if (!_scopes.empty() && _scopes.back() == Scope::Attribute && key == "value")
+	{
+		auto& a = _attributes.back();
+		a.valueKind = DumpAttributeValueKind::Bool;
+		a.asInt = 0;
+		a.asBool = value;
+		return;
+	}
+
+	Unexpected(key);
+}
+
+void DumpBinaryWriter::Double(std::optional<std::string_view> key, double value)
+{
+	if (!_scopes.empty())
+	{
+		switch (_scopes.back())
+		{
+		case Scope::Member:
+			if (key == "initValue")
+			{
+				auto& m = CurrentMember();
+				m.presence |= DumpMemberKey_InitValue;
+				m.initValue = value;
+				return;
+			}
+			break;
+		case Scope::InitValuesArray:
+			if (!key.has_value())
+			{
+				_initValues.push_back(value);
+				return;
+			}
+			break;
+		case Scope::Attribute:
+			if (key == "value")
+			{
+				auto& a = _attributes.back();
+				a.valueKind = DumpAttributeValueKind::Double;
+				a.asDouble = value;
+				return;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	Unexpected(key);
+}
+
+void DumpBinaryWriter::Number(std::optional<std::string_view> key, uint64_t value, bool isSigned)
+{
+	if (_scopes.empty())
+	{
+		Unexpected(key);
+	}
+
+	if (_scopes.back() == Scope::InitValuesArray && !key.has_value())
+	{
+		_initValues.push_back(isSigned ? static_cast<double>(static_cast<int64_t>(value)) : static_cast<double>(value));
+		return;
+	}
+
+	if (!key.has_value())
+	{
+		Unexpected(key);
+	}
+
+	const auto k = key.value();
+	switch (_scopes.back())
+	{
+	case Scope::Struct:
+	{
+		auto& s = _structs.back();
+		if (k == "name") { s.name = { static_cast<uint32_t>(value), DumpNoString }; return; }
+		if (k == "size") { s.size = value; return; }
+		if (k == "align") { s.presence |= DumpStructKey_Align; s.align = static_cast<uint32_t>(value); return; }
+		if (k == "getStructureCB") { Pointer(k, value); return; }
+	}
+	break;
+	case Scope::StructBase:
+	{
+		auto& s = _structs.back();
+		if (k == "name") { s.baseName = { static_cast<uint32_t>(value), DumpNoString }; return; }
+		if (k == "offset") { s.baseOffset = value; return; }
+	}
+	break;
+	case Scope::StructFactories:
+		Pointer(k, value);
+		return;
+	case Scope::StructCallbacks:
+		_callbacks.push_back({ AddString(k), 0, value });
+		return;
+	case Scope::Member:
+	{
+		auto& m = CurrentMember();
+		if (k == "name") { m.name = { static_cast<uint32_t>(value), DumpNoString }; return; }
+		if (k == "offset") { m.offset = value; return; }
+		if (k == "size") { m.size = static_cast<uint32_t>(value); return; }
+		if (k == "align") { m.presence |= DumpMemberKey_Align; m.align = static_cast<uint32_t>(value); return; }
+		if (k == "flags1") { m.flags1 = static_cast<uint16_t>(value); return; }
+		if (k == "flags2") { m.flags2 = static_cast<uint16_t>(value); return; }
+		if (k == "extraData") { m.presence |= DumpMemberKey_ExtraData; m.extraData = static_cast<uint16_t>(value); return; }
+		if (k == "structName") { m.presence |= DumpMemberKey_StructName; m.refName = { static_cast<uint32_t>(value), DumpNoString }; return; }
+		if (k == "enumName") { m.presence |= DumpMemberKey_EnumName; m.refName = { static_cast<uint32_t>(value), DumpNoString }; return; }
+		if (k == "arraySize") { m.presence |= DumpMemberKey_ArraySize; m.count = static_cast<uint32_t>(value); return; }
+		if (k == "countOffset") { m.presence |= DumpMemberKey_CountOffset; m.count = static_cast<uint32_t>(value); return; }
+		if (k == "memberSize") { m.presence |= DumpMemberKey_MemberSize; m.count = static_cast<uint32_t>(value); return; }
+		if (k == "namespaceIndex") { m.presence |= DumpMemberKey_NamespaceIndex; m.count = static_cast<uint32_t>(value); return; }
+		if (k == "initValue")
+		{
+			m.presence |= DumpMemberKey_InitValue;
+			const auto type = GetString(m.type);
+			if (type == "ENUM" || type == "BITSET")
+			{
+				m.presence |= DumpMemberKey_InitValueIsInt;
+				m.initValueInt = static_cast<int64_t>(value);
+			}
+			else
+			{
+				m.initValue = isSigned ? static_cast<double>(static_cast<int64_t>(value)) : static_cast<double>(value);
+			}
+			return;
+		}
+		Pointer(k, value);
+		return;
+	}
+	case Scope::AttributeList:
+	{
+		auto& l = _attributeLists.back();
+		if (k == "userData1") { l.presence |= DumpAttributeListKey_UserData1; l.userData1 = static_cast<uint8_t>(value); return; }
+		if (k == "userData2") { l.presence |= DumpAttributeListKey_UserData2; l.userData2 = static_cast<uint8_t>(value); return; }
+	}
+	break;
+	case Scope::Attribute:
+		if (k == "value")
+		{
+			auto& a = _attributes.back();
+			if (GetString(a.type) == "Double")
+			{
+				// whole doubles are written without fractional part, keep the attribute type when reading a JSON dump
+				a.valueKind = DumpAttributeValueKind::Double;
+				a.asDouble = isSigned ? static_cast<double>(static_cast<int64_t>(value)) : static_cast<double>(value);
+			}
+			else
+			{
+				a.valueKind = DumpAttributeValueKind::Int;
+				a.asInt = static_cast<int64_t>(value);
+			}
+			return;
+		}
+		break;
+	case Scope::Enum:
+		if (k == "name") { _enums.back().name = { static_cast<uint32_t>(value), DumpNoString }; return; }
+		break;
+	case Scope::EnumValue:
+	{
+		auto& v = _enumValues.back();
+		if (k == "name") { v.name = { static_cast<uint32_t>(value), DumpNoString }; return; }
+		if (k == "value") { v.value = static_cast<int64_t>(value); return; }
+	}
+	break;
+	default:
+		break;
+	}
+
+	Unexpected(key);
+}
+
+void DumpBinaryWriter::Pointer(std::string_view key, std::optional<uint64_t> value)
+{
+	const uint64_t ptr = value.value_or(DumpNullPointer);
+	switch (_scopes.back())
+	{
+	case Scope::Struct:
+		if (key == "getStructureCB") { _structs.back().presence |= DumpStructKey_GetStructureCB; _structs.back().getStructureCB = ptr; return; }
+		break;
+	case Scope::StructFactories:
+	{
+		auto& s = _structs.back();
+		if (key == "new") { s.presence |= DumpStructKey_FactoryNew; s.factoryNew = ptr; return; }
+		if (key == "placementNew") { s.presence |= DumpStructKey_FactoryPlacementNew; s.factoryPlacementNew = ptr; return; }
+		if (key == "delete") { s.presence |= DumpStructKey_FactoryDelete; s.factoryDelete = ptr; return; }
+	}
+	break;
+	case Scope::Member:
+	{
+		if (!value.has_value())
+		{
+			break;
+		}
+
+		auto& m = CurrentMember();
+		if (key == "externalNamedResolveFunc") { m.presence |= DumpMemberKey_ExternalNamedResolveFunc; m.funcs[DumpMemberRecord::ExternalNamedResolveFunc] = ptr; return; }
+		if (key == "externalNamedGetNameFunc") { m.presence |= DumpMemberKey_ExternalNamedGetNameFunc; m.funcs[DumpMemberRecord::ExternalNamedGetNameFunc] = ptr; return; }
+		if (key == "allocateStructFunc") { m.presence |= DumpMemberKey_AllocateStructFunc; m.funcs[DumpMemberRecord::AllocateStructFunc] = ptr; return; }
+		if (key == "createIteratorFunc") { m.presence |= DumpMemberKey_CreateIteratorFunc; m.funcs[DumpMemberRecord::CreateIteratorFunc] = ptr; return; }
+		if (key == "createInterfaceFunc") { m.presence |= DumpMemberKey_CreateInterfaceFunc; m.funcs[DumpMemberRecord::CreateInterfaceFunc] = ptr; return; }
+	}
+	break;
+	default:
+		break;
+	}
+
+	Unexpected(key);
+}
+
+void DumpBinaryWriter::BeginObject(std::optional<std::string_view> key)
+{
+	if (_scopes.empty())
+	{
+		_scopes.push_back(Scope::Root);
+		return;
+	}
+
+	switch (_scopes.back())
+	{
+	case Scope::StructsArray:
+	{
+		DumpStructRecord s{};
+		s.name = MakeNullName();
+		s.baseName = MakeNullName();
+		s.flags = DumpNoString;
+		s.firstMember = static_cast<uint32_t>(_members.size());
+		s.extraAttributes = DumpNoIndex;
+		s.firstCallback = static_cast<uint32_t>(_callbacks.size());
+		s.factoryNew = s.factoryPlacementNew = s.factoryDelete = s.getStructureCB = DumpNullPointer;
+		_structs.push_back(s);
+		_scopes.push_back(Scope::Struct);
+		return;
+	}
+	case Scope::Struct:
+		if (key == "base")
+		{
+			_structs.back().presence |= DumpStructKey_Base;
+			_scopes.push_back(Scope::StructBase);
+			return;
+		}
+		if (key == "factories")
+		{
+			_scopes.push_back(Scope::StructFactories);
+			return;
+		}
+		if (key == "callbacks")
+		{
+			_structs.back().presence |= DumpStructKey_Callbacks;
+			_scopes.push_back(Scope::StructCallbacks);
+			return;
+		}
+		if (key == "extraAttributes")
+		{
+			_structs.back().presence |= DumpStructKey_ExtraAttributes;
+			_structs.back().extraAttributes = BeginAttributeList();
+			return;
+		}
+		break;
+	case Scope::MembersArray:
+	case Scope::Member:
+	{
+		size_t slot = DumpMemberRecord::Item;
+		if (_scopes.back() == Scope::Member)
+		{
+			auto& parent = CurrentMember();
+			if (key == "attributes")
+			{
+				parent.presence |= DumpMemberKey_Attributes;
+				parent.attributes = BeginAttributeList();
+				return;
+			}
+			else if (key == "item") { parent.presence |= DumpMemberKey_Item; slot = DumpMemberRecord::Item; }
+			else if (key == "key") { parent.presence |= DumpMemberKey_Key; slot = DumpMemberRecord::Key; }
+			else if (key == "value") { parent.presence |= DumpMemberKey_Value; slot = DumpMemberRecord::Value; }
+			else { break; }
+		}
+
+		DumpMemberRecord m{};
+		m.name = MakeNullName();
+		m.type = m.subtype = m.allocFlags = DumpNoString;
+		m.attributes = DumpNoIndex;
+		m.refName = MakeNullName();
+		m.children[0] = m.children[1] = DumpNoIndex;
+		_memberStack.push_back(m);
+		_memberChildSlots.push_back(slot);
+		_scopes.push_back(Scope::Member);
+		return;
+	}
+	case Scope::AttributesArray:
+		_attributes.push_back({ DumpNoString, DumpNoString, DumpAttributeValueKind::None, 0, { 0 } });
+		_scopes.push_back(Scope::Attribute);
+		return;
+	case Scope::EnumsArray:
+	{
+		DumpEnumRecord e{};
+		e.name = MakeNullName();
+		e.flags = DumpNoString;
+		e.firstValue = static_cast<uint32_t>(_enumValues.size());
+		_enums.push_back(e);
+		_scopes.push_back(Scope::Enum);
+		return;
+	}
+	case Scope::EnumValuesArray:
+		_enumValues.push_back({ MakeNullName(), 0 });
+		_scopes.push_back(Scope::EnumValue);
+		return;
+	default:
+		break;
+	}
+
+	Unexpected(key);
+}
+
+void DumpBinaryWriter::EndObject()
+{
+	assert(!_scopes.empty());
+	const auto scope = _scopes.back();
+	_scopes.pop_back();
+	switch (scope)
+	{
+	case Scope::Struct:
+	{
+		auto& s = _structs.back();
+		s.memberCount = static_cast<uint32_t>(_members.size()) - s.firstMember;
+		s.callbackCount = static_cast<uint32_t>(_callbacks.size()) - s.firstCallback;
+	}
+	break;
+	case Scope::Member:
+	{
+		const auto m = _memberStack.back();
+		const auto slot = _memberChildSlots.back();
+		_memberStack.pop_back();
+		_memberChildSlots.pop_back();
+		if (_memberStack.empty())
+		{
+			_members.push_back(m);
+		}
+		else
+		{
+			_memberStack.back().children[slot] = static_cast<uint32_t>(_subMembers.size());
+			_subMembers.push_back(m);
+		}
+	}
+	break;
+	case Scope::AttributeList:
+	{
+		auto& l = _attributeLists.back();
+		l.attributeCount = static_cast<uint32_t>(_attributes.size()) - l.firstAttribute;
+	}
+	break;
+	case Scope::Enum:
+	{
+		auto& e = _enums.back();
+		e.valueCount = static_cast<uint32_t>(_enumValues.size()) - e.firstValue;
+	}
+	break;
+	default:
+		// nothing to complete for the other objects
+		break;
+	}
+}
+
+void DumpBinaryWriter::BeginArray(std::optional<std::string_view> key)
+{
+	if (!_scopes.empty())
+	{
+		switch (_scopes.back())
+		{
+		case Scope::Root:
+			if (key == "structs") { _scopes.push_back(Scope::StructsArray); return; }
+			if (key == "enums") { _scopes.push_back(Scope::EnumsArray); return; }
+			break;
+		case Scope::Struct:
+			if (key == "members") { _scopes.push_back(Scope::MembersArray); return; }
+			break;
+		case Scope::Member:
+			if (key == "initValues")
+			{
+				auto& m = CurrentMember();
+				m.presence |= DumpMemberKey_InitValues;
+				m.firstInitValue = static_cast<uint32_t>(_initValues.size());
+				_scopes.push_back(Scope::InitValuesArray);
+				return;
+			}
+			break;
+		case Scope::AttributeList:
+			if (key == "list") { _scopes.push_back(Scope::AttributesArray); return; }
+			break;
+		case Scope::Enum:
+			if (key == "values") { _scopes.push_back(Scope::EnumValuesArray); return; }
+			break;
+		default:
+			break;
+		}
+	}
+
+	Unexpected(key);
+}
+
+void DumpBinaryWriter::EndArray()
+{
+	assert(!_scopes.empty());
+	const auto scope = _scopes.back();
+	_scopes.pop_back();
+	if (scope == Scope::InitValuesArray)
+	{
+		auto& m = CurrentMember();
+		m.initValueCount = static_cast<uint32_t>(_initValues.size()) - m.firstInitValue;
+	}
+}
+
+void DumpBinaryWriter::Flush()
+{
+	const auto data = Serialize();
+	std::ofstream out{ _filePath, std::ios::out | std::ios::binary };
+	out.write(reinterpret_cast<const char*>(data.data()), data.size());
+	_flushed = true;
+}
+
+std::vector<uint8_t> DumpBinaryWriter::Serialize() const
+{
+	std::vector<uint8_t> data(sizeof(DumpBinaryHeader));
+	const auto appendSection = [&data](const void* items, size_t count, size_t itemSize) -> DumpBinarySection
+	{
+		data.resize((data.size() + alignof(uint64_t) - 1) & ~(alignof(uint64_t) - 1));
+		const DumpBinarySection section{ static_cast<uint32_t>(data.size()), static_cast<uint32_t>(count) };
+		const auto* bytes = static_cast<const uint8_t*>(items);
+		data.insert(data.end(), bytes, bytes + count * itemSize);
+		return section;
+	};
+	const auto append = [&appendSection](const auto& items)
+	{
+		return appendSection(items.data(), items.size(), sizeof(items[0]));
+	};
+
+	DumpBinaryHeader header{};
+	header.magic = DumpBinaryMagic;
+	header.version = DumpBinaryVersion;
+	header.headerSize = sizeof(DumpBinaryHeader);
+	header.game = _game;
+	header.build = _build;
+	header.strings = append(_strings);
+	header.structs = append(_structs);
+	header.members = append(_members);
+	header.subMembers = append(_subMembers);
+	header.enums = append(_enums);
+	header.enumValues = append(_enumValues);
+	header.attributeLists = append(_attributeLists);
+	header.attributes = append(_attributes);
+	header.callbacks = append(_callbacks);
+	header.initValues = append(_initValues);
+	std::memcpy(data.data(), &header, sizeof(header));
+	return data;
+}
+
+void DumpBinaryWriter::SetName(DumpName& name, std::string_view value)
+{
+	// names without a known string are written as the hash in hex, see json_uint_hex
+	if (value.size() == 10)
+	{
+		if (auto hash = ParseHex(value); hash.has_value())
+		{
+			name = { static_cast<uint32_t>(hash.value()), DumpNoString };
+			return;
+		}
+	}
+
+	name = { joaat(value), AddString(value) };
+}
+
+uint32_t DumpBinaryWriter::AddString(std::string_view str)
+{
+	if (auto it = _stringOffsets.find(str); it != _stringOffsets.end())
+	{
+		return it->second;
+	}
+
+	const uint32_t length = static_cast<uint32_t>(str.size());
+	const auto* lengthBytes = reinterpret_cast<const char*>(&length);
+	_strings.insert(_strings.end(), lengthBytes, lengthBytes + sizeof(length));
+	const uint32_t offset = static_cast<uint32_t>(_strings.size());
+	_strings.insert(_strings.end(), str.begin(), str.end());
+	_strings.push_back('\0');
+	_stringOffsets.emplace(str, offset);
+	return offset;
+}
+
+std::string_view DumpBinaryWriter::GetString(uint32_t offset) const
+{
+	if (offset == DumpNoString)
+	{
+		return {};
+	}
+
+	uint32_t length;
+	std::memcpy(&length, _strings.data() + offset - sizeof(uint32_t), sizeof(uint32_t));
+	return { _strings.data() + offset, length };
+}
+
+uint32_t DumpBinaryWriter::BeginAttributeList()
+{
+	_attributeLists.push_back({ static_cast<uint32_t>(_attributes.size()), 0, 0, 0, 0 });
+	_scopes.push_back(Scope::AttributeList);
+	return static_cast<uint32_t>(_attributeLists.size() - 1);
+}
+
+DumpMemberRecord& DumpBinaryWriter::CurrentMember()
+{
+	assert(!_memberStack.empty());
+	return _memberStack.back();
+}
+
+void DumpBinaryWriter::Unexpected(std::optional<std::string_view> key) const
+{
+	throw std::runtime_error(std::string{ "Unexpected key in binary dump: " } + std::string{ key.value_or("<none>") });
+}
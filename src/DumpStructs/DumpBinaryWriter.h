@@ -0,0 +1,100 @@
+#pragma once
+#include "DumpBinary.h"
+#include "JsonWriter.h"
+#include <string_view>
+#include <string>
+#include <optional>
+#include <vector>
+#include <unordered_map>
+#include <concepts>
+
+// Writes a binary dump (see DumpBinary.h). Exposes the same interface as JsonWriter so the same code can generate either
+// format, the JSON events are mapped to the dump records based on the keys and nesting of the JSON dump schema.
+// Throws std::runtime_error if the events do not follow the schema.
+class DumpBinaryWriter
+{
+public:
+	// Writes the dump to memory only, use Serialize() to get it.
+	DumpBinaryWriter();
+	DumpBinaryWriter(std::string_view filePath);
+	~DumpBinaryWriter();
+
+	DumpBinaryWriter(const DumpBinaryWriter&) = delete;
+	DumpBinaryWriter& operator=(const DumpBinaryWriter&) = delete;
+
+	void Null(std::optional<std::string_view> key);
+	void String(std::optional<std::string_view> key, std::string_view value);
+	void Bool(std::optional<std::string_view> key, bool value);
+	void Int(std::optional<std::string_view> key, std::signed_integral auto value) { Number(key, static_cast<uint64_t>(static_cast<int64_t>(value)), true); }
+	// the formatting options only apply to the JSON, the binary dump stores the number
+	void UInt(std::optional<std::string_view> key, std::unsigned_integral auto value, JsonUIntOptions) { Number(key, static_cast<uint64_t>(value), false); }
+	void Float(std::optional<std::string_view> key, float value) { Double(key, value); }
+	void Double(std::optional<std::string_view> key, double value);
+	void BeginObject(std::optional<std::string_view> key = std::nullopt);
+	void EndObject();
+	void BeginArray(std::optional<std::string_view> key = std::nullopt);
+	void EndArray();
+
+	// Writes the dump to the file. Called automatically on destruction.
+	void Flush();
+
+	// Serializes the dump to memory instead of a file.
+	std::vector<uint8_t> Serialize() const;
+
+private:
+	enum class Scope
+	{
+		Root,
+		StructsArray,
+		Struct,
+		StructBase,
+		StructFactories,
+		StructCallbacks,
+		MembersArray,
+		Member,
+		InitValuesArray,
+		AttributeList,
+		AttributesArray,
+		Attribute,
+		EnumsArray,
+		Enum,
+		EnumValuesArray,
+		EnumValue,
+	};
+
+	void Number(std::optional<std::string_view> key, uint64_t value, bool isSigned);
+	void Pointer(std::string_view key, std::optional<uint64_t> value);
+	void SetName(DumpName& name, std::string_view value);
+	uint32_t AddString(std::string_view str);
+	std::string_view GetString(uint32_t offset) const;
+	uint32_t BeginAttributeList();
+	DumpMemberRecord& CurrentMember();
+	[[noreturn]] void Unexpected(std::optional<std::string_view> key) const;
+
+	std::string _filePath;
+	bool _flushed;
+	std::vector<Scope> _scopes;
+
+	std::vector<char> _strings;
+	struct StringHash
+	{
+		using is_transparent = void;
+		size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+	};
+	std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> _stringOffsets;
+	uint32_t _game;
+	uint32_t _build;
+	std::vector<DumpStructRecord> _structs;
+	std::vector<DumpMemberRecord> _members;
+	std::vector<DumpMemberRecord> _subMembers;
+	std::vector<DumpEnumRecord> _enums;
+	std::vector<DumpEnumValueRecord> _enumValues;
+	std::vector<DumpAttributeListRecord> _attributeLists;
+	std::vector<DumpAttributeRecord> _attributes;
+	std::vector<DumpCallbackRecord> _callbacks;
+	std::vector<double> _initValues;
+
+	// members currently being written, nested array items and map keys/values are pushed on top of their parent
+	std::vector<DumpMemberRecord> _memberStack;
+	std::vector<size_t> _memberChildSlots;
+};
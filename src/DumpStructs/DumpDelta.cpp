@@ -0,0 +1,283 @@
+#include "DumpDelta.h"
+#include "DumpRecords.h"
+#include "JsonReader.h"
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Hashes a record replayed by JsonReader with FNV-1a. A function address only adds a marker to the hash and is kept aside, so
+// a record that only moved in the executable hashes the same.
+class RecordHasher
+{
+public:
+	void Null(std::optional<std::string_view> key) { Add('n', key); }
+	void String(std::optional<std::string_view> key, std::string_view value)
+	{
+		if (_tracker.IsAddress(key))
+		{
+			addresses.emplace_back(value);
+			Add('p', key);
+			return;
+		}
+
+		if (_tracker.Depth() == 1 && key == "name")
+		{
+			name = value;
+		}
+		Add('s', key, value);
+	}
+	void Bool(std::optional<std::string_view> key, bool value) { Add(value ? 't' : 'f', key); }
+	void Int(std::optional<std::string_view> key, std::signed_integral auto value) { Add('i', key, Bytes(static_cast<int64_t>(value))); }
+	void UInt(std::optional<std::string_view> key, std::unsigned_integral auto value, JsonUIntOptions) { Add('u', key, Bytes(static_cast<uint64_t>(value))); }
+	void Double(std::optional<std::string_view> key, double value) { Add('d', key, Bytes(value)); }
+	void BeginObject(std::optional<std::string_view> key = std::nullopt) { Add('{', key); _tracker.Begin(key, true); }
+	void EndObject() { Add('}', std::nullopt); _tracker.End(); }
+	void BeginArray(std::optional<std::string_view> key = std::nullopt) { Add('[', key); _tracker.Begin(key, false); }
+	void EndArray() { Add(']', std::nullopt); _tracker.End(); }
+
+	uint64_t hash = 0xCBF29CE484222325;
+	std::string name;
+	std::vector<std::string> addresses;
+
+private:
+	template<class T>
+	static std::string_view Bytes(const T& value) { return { reinterpret_cast<const char*>(&value), sizeof(value) }; }
+
+	void Add(char kind, std::optional<std::string_view> key, std::string_view value = {})
+	{
+		Mix(Bytes(kind));
+		// with the sizes, different splits between key and value can't hash the same
+		const uint32_t keySize = key.has_value() ? static_cast<uint32_t>(key->size()) : UINT32_MAX;
+		Mix(Bytes(keySize));
+		Mix(key.value_or(std::string_view{}));
+		Mix(Bytes(static_cast<uint32_t>(value.size())));
+		Mix(value);
+	}
+
+	void Mix(std::string_view bytes)
+	{
+		for (const char c : bytes)
+		{
+			hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3;
+		}
+	}
+
+	AddressTracker _tracker;
+};
+
+// Reads an item of the structs/enums arrays of a delta, to tell whether it refers to an unchanged record of the baseline.
+class DeltaItemReader
+{
+public:
+	void Null(std::optional<std::string_view>) {}
+	void String(std::optional<std::string_view> key, std::string_view value)
+	{
+		if (_depth == 1 && key == "unchanged")
+		{
+			unchanged = value;
+		}
+		else if (_depth == 2 && _inAddresses)
+		{
+			addresses.emplace_back(value);
+		}
+	}
+	void Bool(std::optional<std::string_view>, bool) {}
+	void Int(std::optional<std::string_view>, std::signed_integral auto) {}
+	void UInt(std::optional<std::string_view>, std::unsigned_integral auto, JsonUIntOptions) {}
+	void Double(std::optional<std::string_view>, double) {}
+	void BeginObject(std::optional<std::string_view> = std::nullopt) { _depth++; }
+	void EndObject() { _depth--; }
+	void BeginArray(std::optional<std::string_view> key = std::nullopt) { _depth++; _inAddresses = _depth == 2 && key == "addresses"; }
+	void EndArray() { _depth--; _inAddresses = false; }
+
+	std::optional<std::string> unchanged;
+	std::vector<std::string> addresses;
+
+private:
+	size_t _depth = 0;
+	bool _inAddresses = false;
+};
+
+struct DumpRecord
+{
+	std::string_view text; // of the JSON object in the document
+	std::string name;
+	uint64_t hash;
+	std::vector<std::string> addresses;
+};
+
+struct DumpRecords
+{
+	std::string game;
+	std::string build;
+	std::vector<DumpRecord> structs;
+	std::vector<DumpRecord> enums;
+};
+
+static DumpRecords ReadDumpRecords(std::string_view text)
+{
+	DumpRecords dump;
+	JsonScanner{ text }.Members([&](std::string_view key, std::string_view value)
+	{
+		if (key == "game")
+		{
+			dump.game = JsonScanner::StringValue(value);
+		}
+		else if (key == "build")
+		{
+			dump.build = JsonScanner::StringValue(value);
+		}
+		else if (key == "structs" || key == "enums")
+		{
+			auto& records = key == "structs" ? dump.structs : dump.enums;
+			JsonScanner{ value }.Items([&](std::string_view item)
+			{
+				RecordHasher hasher;
+				JsonReader{ item }.Replay(hasher);
+				records.push_back({ item, std::move(hasher.name), hasher.hash, std::move(hasher.addresses) });
+			});
+		}
+	});
+	return dump;
+}
+
+// If several records have the same name, the first one.
+static std::unordered_map<std::string_view, size_t> IndexByName(const std::vector<DumpRecord>& records)
+{
+	std::unordered_map<std::string_view, size_t> index;
+	index.reserve(records.size());
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		index.emplace(records[i].name, i);
+	}
+	return index;
+}
+
+static void WriteRecordsDelta(JsonWriter& w, std::string_view key, std::string_view removedKey,
+	const std::vector<DumpRecord>& baseline, const std::vector<DumpRecord>& records, DumpDeltaStats& stats)
+{
+	const auto baselineIndex = IndexByName(baseline);
+	w.BeginArray(key);
+	for (auto& record : records)
+	{
+		const auto it = baselineIndex.find(record.name);
+		if (it == baselineIndex.end() || baseline[it->second].hash != record.hash)
+		{
+			(it == baselineIndex.end() ? stats.added : stats.changed)++;
+			JsonReader{ record.text }.Replay(w);
+			continue;
+		}
+
+		stats.unchanged++;
+		w.BeginObject();
+		w.String("unchanged", record.name);
+		w.BeginArray("addresses");
+		for (auto& address : record.addresses)
+		{
+			w.String(std::nullopt, address);
+		}
+		w.EndArray();
+		w.EndObject();
+	}
+	w.EndArray();
+
+	std::unordered_set<std::string_view> names;
+	names.reserve(records.size());
+	for (auto& record : records)
+	{
+		names.insert(record.name);
+	}
+	w.BeginArray(removedKey);
+	for (size_t i = 0; i < baseline.size(); i++)
+	{
+		// each name once, like the index
+		if (!names.contains(baseline[i].name) && baselineIndex.at(baseline[i].name) == i)
+		{
+			stats.removed++;
+			w.String(std::nullopt, baseline[i].name);
+		}
+	}
+	w.EndArray();
+}
+
+DumpDeltaStats WriteDumpDelta(JsonWriter& w, std::string_view baselineText, std::string_view dumpText)
+{
+	const auto baseline = ReadDumpRecords(baselineText);
+	const auto dump = ReadDumpRecords(dumpText);
+	if (baseline.game != dump.game)
+	{
+		throw std::runtime_error("the baseline is a dump of " + baseline.game + ", not of " + dump.game);
+	}
+
+	DumpDeltaStats stats;
+	stats.baselineBuild = baseline.build;
+	w.BeginObject();
+	w.String("game", dump.game);
+	w.String("build", dump.build);
+	w.String("baseline", baseline.build);
+	WriteRecordsDelta(w, "structs", "removedStructs", baseline.structs, dump.structs, stats);
+	WriteRecordsDelta(w, "enums", "removedEnums", baseline.enums, dump.enums, stats);
+	w.EndObject();
+	return stats;
+}
+
+static void ReconstructRecords(JsonWriter& w, std::string_view key, const std::vector<DumpRecord>& baseline, std::string_view items)
+{
+	const auto baselineIndex = IndexByName(baseline);
+	w.BeginArray(key);
+	JsonScanner{ items }.Items([&](std::string_view item)
+	{
+		DeltaItemReader reader;
+		JsonReader{ item }.Replay(reader);
+		if (!reader.unchanged.has_value())
+		{
+			JsonReader{ item }.Replay(w);
+			return;
+		}
+
+		const auto it = baselineIndex.find(*reader.unchanged);
+		if (it == baselineIndex.end())
+		{
+			throw std::runtime_error("unchanged record '" + *reader.unchanged + "' is not in the baseline");
+		}
+
+		AddressPatcher patcher{ w, std::span<const std::string>{ reader.addresses } };
+		JsonReader{ baseline[it->second].text }.Replay(patcher);
+		if (!patcher.UsedAllAddresses())
+		{
+			throw std::runtime_error("unchanged record '" + *reader.unchanged + "' has more addresses than the baseline record");
+		}
+	});
+	w.EndArray();
+}
+
+void ReconstructDump(JsonWriter& w, std::string_view baselineText, std::string_view deltaText)
+{
+	const auto baseline = ReadDumpRecords(baselineText);
+
+	std::string game, build, baselineBuild;
+	std::string_view structs = "[]", enums = "[]";
+	JsonScanner{ deltaText }.Members([&](std::string_view key, std::string_view value)
+	{
+		if (key == "game") { game = JsonScanner::StringValue(value); }
+		else if (key == "build") { build = JsonScanner::StringValue(value); }
+		else if (key == "baseline") { baselineBuild = JsonScanner::StringValue(value); }
+		else if (key == "structs") { structs = value; }
+		else if (key == "enums") { enums = value; }
+	});
+	if (game != baseline.game || baselineBuild != baseline.build)
+	{
+		throw std::runtime_error("the delta is against build " + baselineBuild + " of " + game + ", the baseline is build " + baseline.build + " of " + baseline.game);
+	}
+
+	w.BeginObject();
+	w.String("game", game);
+	w.String("build", build);
+	ReconstructRecords(w, "structs", baseline.structs, structs);
+	ReconstructRecords(w, "enums", baseline.enums, enums);
+	w.EndObject();
+}
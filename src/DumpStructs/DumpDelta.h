@@ -0,0 +1,42 @@
+#pragma once
+#include "JsonWriter.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// A dump stored as the changes since a baseline dump, usually the dump of the previous build. Consecutive builds only change a
+// few structs, so a delta is a small fraction of the full dump.
+//
+// The records (structs and enums) of both dumps are matched by name and compared by a hash of their contents without the
+// function addresses, which move in every build even if the struct did not change. The delta has the records in the same
+// order as the dump: new and changed records are written in full, unchanged records only as their name and their function
+// addresses, which are put back into the baseline record when reconstructing. Reconstructing gives back the dump exactly
+// as JsonWriter wrote it.
+//
+//   {
+//     "game": "gta5",
+//     "build": "3323",
+//     "baseline": "2944",
+//     "structs": [
+//       { "unchanged": "CFoo", "addresses": [ "0x81AD04", "0x12B7884", ... ] },
+//       { "name": "CBar", ... },
+//       ...
+//     ],
+//     "enums": [ ... ],
+//     "removedStructs": [ "CBaz" ],
+//     "removedEnums": [ ... ]
+//   }
+//
+// Both functions throw std::runtime_error if a document is malformed or the delta does not match the baseline.
+
+struct DumpDeltaStats
+{
+	std::string baselineBuild;
+	size_t added = 0;
+	size_t changed = 0;
+	size_t unchanged = 0;
+	size_t removed = 0;
+};
+
+DumpDeltaStats WriteDumpDelta(JsonWriter& w, std::string_view baselineText, std::string_view dumpText);
+void ReconstructDump(JsonWriter& w, std::string_view baselineText, std::string_view deltaText);
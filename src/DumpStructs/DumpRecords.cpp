@@ -0,0 +1,87 @@
+#include "DumpRecords.h"
+
+std::string_view JsonScanner::StringValue(std::string_view value)
+{
+	if (value.size() < 2 || value.front() != '"' || value.back() != '"' || value.find('\\') != std::string_view::npos)
+	{
+		throw std::runtime_error("expected a string without escape sequences");
+	}
+	return value.substr(1, value.size() - 2);
+}
+
+void JsonScanner::SkipWhitespace()
+{
+	while (_pos < _text.size() && (_text[_pos] == ' ' || _text[_pos] == '\t' || _text[_pos] == '\n' || _text[_pos] == '\r'))
+	{
+		_pos++;
+	}
+}
+
+bool JsonScanner::TryConsume(char c)
+{
+	SkipWhitespace();
+	if (_pos < _text.size() && _text[_pos] == c)
+	{
+		_pos++;
+		return true;
+	}
+	return false;
+}
+
+void JsonScanner::Expect(char c)
+{
+	if (!TryConsume(c))
+	{
+		throw std::runtime_error(std::string{ "expected '" } + c + "' at offset " + std::to_string(_pos));
+	}
+}
+
+char JsonScanner::Next()
+{
+	if (_pos >= _text.size())
+	{
+		throw std::runtime_error("unexpected end of input");
+	}
+	return _text[_pos++];
+}
+
+std::string_view JsonScanner::Value()
+{
+	const size_t start = _pos;
+	size_t depth = 0;
+	do
+	{
+		const char c = Next();
+		if (c == '"')
+		{
+			for (char s = Next(); s != '"'; s = Next())
+			{
+				if (s == '\\')
+				{
+					Next();
+				}
+			}
+		}
+		else if (c == '{' || c == '[')
+		{
+			depth++;
+		}
+		else if (c == '}' || c == ']')
+		{
+			if (depth == 0)
+			{
+				throw std::runtime_error(std::string{ "unexpected '" } + c + "' at offset " + std::to_string(_pos - 1));
+			}
+			depth--;
+		}
+		else if (depth == 0)
+		{
+			// number or literal, up to the next delimiter
+			while (_pos < _text.size() && std::string_view{ ",}] \t\r\n" }.find(_text[_pos]) == std::string_view::npos)
+			{
+				_pos++;
+			}
+		}
+	} while (depth > 0);
+	return _text.substr(start, _pos - start);
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include "JsonWriter.h"
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Helpers to work with the records (structs and enums) of a JSON dump one at a time, used by the delta dumps and the
+// definition store.
+
+// Tells which values of a record are function addresses: the members of the factories and callbacks objects and the values
+// with one of the address keys written by DumpJsonStructure/DumpJsonMember. Must see every Begin/End call of the record.
+class AddressTracker
+{
+public:
+	bool IsAddress(std::optional<std::string_view> key) const
+	{
+		return _inAddressObject ||
+			(key.has_value() && (*key == "getStructureCB" || *key == "externalNamedResolveFunc" || *key == "externalNamedGetNameFunc" ||
+				*key == "allocateStructFunc" || *key == "createIteratorFunc" || *key == "createInterfaceFunc"));
+	}
+
+	void Begin(std::optional<std::string_view> key, bool isObject)
+	{
+		_parents.push_back(_inAddressObject);
+		_inAddressObject = isObject && key.has_value() && (*key == "factories" || *key == "callbacks");
+	}
+
+	void End()
+	{
+		_inAddressObject = _parents.back();
+		_parents.pop_back();
+	}
+
+	// 1 inside the record object.
+	size_t Depth() const { return _parents.size(); }
+
+private:
+	std::vector<bool> _parents;
+	bool _inAddressObject = false;
+};
+
+// Replays a record to a writer, replacing its function addresses with the given ones, in order. Used to put back the addresses
+// of a build into a record stored without them.
+template<class TWriter>
+class AddressPatcher
+{
+public:
+	AddressPatcher(TWriter& w, std::span<const std::string> addresses) : _w{ w }, _addresses{ addresses } {}
+
+	void Null(std::optional<std::string_view> key) { _w.Null(key); }
+	void String(std::optional<std::string_view> key, std::string_view value)
+	{
+		if (!_tracker.IsAddress(key))
+		{
+			_w.String(key, value);
+			return;
+		}
+
+		if (_next >= _addresses.size())
+		{
+			throw std::runtime_error("the record has more addresses than were given");
+		}
+		_w.String(key, _addresses[_next++]);
+	}
+	void Bool(std::optional<std::string_view> key, bool value) { _w.Bool(key, value); }
+	void Int(std::optional<std::string_view> key, std::signed_integral auto value) { _w.Int(key, value); }
+	void UInt(std::optional<std::string_view> key, std::unsigned_integral auto value, JsonUIntOptions options) { _w.UInt(key, value, options); }
+	void Double(std::optional<std::string_view> key, double value) { _w.Double(key, value); }
+	void BeginObject(std::optional<std::string_view> key = std::nullopt) { _w.BeginObject(key); _tracker.Begin(key, true); }
+	void EndObject() { _w.EndObject(); _tracker.End(); }
+	void BeginArray(std::optional<std::string_view> key = std::nullopt) { _w.BeginArray(key); _tracker.Begin(key, false); }
+	void EndArray() { _w.EndArray(); _tracker.End(); }
+
+	bool UsedAllAddresses() const { return _next == _addresses.size(); }
+
+private:
+	TWriter& _w;
+	std::span<const std::string> _addresses;
+	size_t _next = 0;
+	AddressTracker _tracker;
+};
+
+// Splits the top levels of a document into the text of their values, without parsing the values.
+// Throws std::runtime_error on malformed input.
+class JsonScanner
+{
+public:
+	explicit JsonScanner(std::string_view text) : _text{ text }, _pos{ 0 } {}
+
+	// Calls f(key, value) for each member of the object.
+	template<class TFunc>
+	void Members(TFunc f)
+	{
+		Expect('{');
+		if (TryConsume('}'))
+		{
+			return;
+		}
+		do
+		{
+			SkipWhitespace();
+			const auto key = StringValue(Value());
+			Expect(':');
+			SkipWhitespace();
+			f(key, Value());
+		} while (TryConsume(','));
+		Expect('}');
+	}
+
+	// Calls f(item) for each item of the array.
+	template<class TFunc>
+	void Items(TFunc f)
+	{
+		Expect('[');
+		if (TryConsume(']'))
+		{
+			return;
+		}
+		do
+		{
+			SkipWhitespace();
+			f(Value());
+		} while (TryConsume(','));
+		Expect(']');
+	}
+
+	// The names in the dumps don't need escaping, so neither does reading them.
+	static std::string_view StringValue(std::string_view value);
+
+private:
+	void SkipWhitespace();
+	bool TryConsume(char c);
+	void Expect(char c);
+	char Next();
+	std::string_view Value();
+
+	std::string_view _text;
+	size_t _pos;
+};
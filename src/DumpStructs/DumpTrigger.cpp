@@ -0,0 +1,63 @@
+#include "DumpTrigger.h"
+
+DumpTrigger::DumpTrigger(const DumpTriggerOptions& options, uint64_t startTimeMs)
+	: _options(options), _startTimeMs(startTimeMs), _lastTimeMs(startTimeMs),
+	  _numEntriesChangedMs(startTimeMs), _numRegistrationsChangedMs(startTimeMs)
+{
+}
+
+DumpTriggerState DumpTrigger::Update(const DumpTriggerSample& sample)
+{
+	if (IsDone())
+	{
+		return _state;
+	}
+
+	_lastTimeMs = sample.timeMs;
+	const uint32_t numEntries = sample.hasManager ? sample.numEntries : 0;
+	if (numEntries != _numEntries)
+	{
+		_numEntries = numEntries;
+		_numEntriesChangedMs = sample.timeMs;
+	}
+	if (sample.numRegistrations != _numRegistrations)
+	{
+		_numRegistrations = sample.numRegistrations;
+		_numRegistrationsChangedMs = sample.timeMs;
+	}
+
+	// an empty map is not stable, the game may just not have started registering structures yet
+	const bool started = (sample.hasManager && _numEntries != 0) || (!_options.requireManager && _numRegistrations != 0);
+	if (!started)
+	{
+		_state = DumpTriggerState::WaitingForManager;
+	}
+	else if (sample.timeMs - _numEntriesChangedMs >= _options.stableMs &&
+			 sample.timeMs - _numRegistrationsChangedMs >= _options.quietMs)
+	{
+		_state = DumpTriggerState::Ready;
+		return _state;
+	}
+	else
+	{
+		_state = DumpTriggerState::WaitingForStable;
+	}
+
+	if (ElapsedMs() >= _options.timeoutMs)
+	{
+		_state = DumpTriggerState::TimedOut;
+	}
+	return _state;
+}
+
+const char* EnumToString(DumpTriggerState state)
+{
+	switch (state)
+	{
+	case DumpTriggerState::WaitingForManager: return "WaitingForManager";
+	case DumpTriggerState::WaitingForStable: return "WaitingForStable";
+	case DumpTriggerState::Ready: return "Ready";
+	case DumpTriggerState::TimedOut: return "TimedOut";
+	}
+	return "Unknown";
+}
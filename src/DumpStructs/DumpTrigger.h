@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+
+struct DumpTriggerOptions
+{
+	// give up waiting and dump anyway after this long (DUMPSTRUCTS_TIMEOUT, in seconds)
+	uint64_t timeoutMs = 120'000;
+	// parManager::structures.NumEntries must not change for this long (DUMPSTRUCTS_STABLE, in seconds). Conservative, a
+	// slow disk can stall the registrations for a few seconds while loading and dumping early misses structures.
+	uint64_t stableMs = 10'000;
+	// the registration hooks must not be called for this long (DUMPSTRUCTS_QUIET, in seconds)
+	uint64_t quietMs = 10'000;
+	// whether to wait for parManager::sm_Instance to be non-null and have some structures. Games that initialize it lazily
+	// (see InitParManager) instead wait for the registration hooks to be called at least once.
+	bool requireManager = true;
+};
+
+// State of the game polled by the DLL.
+struct DumpTriggerSample
+{
+	uint64_t timeMs;
+	bool hasManager;
+	uint32_t numEntries;
+	uint32_t numRegistrations; // total calls to the registration hooks so far
+};
+
+enum class DumpTriggerState
+{
+	WaitingForManager,
+	WaitingForStable,
+	Ready,
+	TimedOut,
+};
+
+// Decides when the game has finished registering its parStructures and can be dumped, instead of waiting a fixed time.
+// Doesn't read the game state or the clock itself, the caller polls and passes samples to Update, so it can be driven by
+// a simulated timeline.
+class DumpTrigger
+{
+public:
+	DumpTrigger(const DumpTriggerOptions& options, uint64_t startTimeMs);
+
+	// Updates the state with a new sample, times must be non-decreasing. Once Ready or TimedOut the state doesn't change.
+	DumpTriggerState Update(const DumpTriggerSample& sample);
+
+	DumpTriggerState State() const { return _state; }
+	bool IsDone() const { return _state == DumpTriggerState::Ready || _state == DumpTriggerState::TimedOut; }
+	// Time from the start to the last sample.
+	uint64_t ElapsedMs() const { return _lastTimeMs - _startTimeMs; }
+
+private:
+	DumpTriggerOptions _options;
+	DumpTriggerState _state = DumpTriggerState::WaitingForManager;
+	uint64_t _startTimeMs;
+	uint64_t _lastTimeMs;
+	uint32_t _numEntries = 0;
+	uint64_t _numEntriesChangedMs;
+	uint32_t _numRegistrations = 0;
+	uint64_t _numRegistrationsChangedMs;
+};
+
+const char* EnumToString(DumpTriggerState state);
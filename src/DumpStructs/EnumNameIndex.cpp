@@ -0,0 +1,28 @@
+#include "EnumNameIndex.h"
+
+size_t EnumNameIndex::IdentityHash::operator()(const EnumIdentity& id) const
+{
+	// values alone is almost always unique, mix in the rest for the cases where it is not
+	size_t hash = std::hash<const void*>{}(id.values);
+	hash ^= std::hash<const void*>{}(id.valueNames) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+	hash ^= std::hash<uint32_t>{}(id.valueCount) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+	return hash;
+}
+
+bool EnumNameIndex::Add(const void* member, const EnumIdentity& identity, const std::function<std::string_view(ScratchArena&)>& makeName)
+{
+	auto [it, inserted] = _identityNames.try_emplace(identity);
+	if (inserted)
+	{
+		it->second = makeName(_arena);
+	}
+
+	_memberNames[member] = it->second;
+	return inserted;
+}
+
+std::string_view EnumNameIndex::Find(const void* member) const
+{
+	auto it = _memberNames.find(member);
+	return it != _memberNames.end() ? it->second : std::string_view{};
+}
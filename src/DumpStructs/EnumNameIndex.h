@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include "ScratchArena.h"
+
+// In GTA4/MP3/RDR2 there is no parEnumData, each parMemberEnumData has its own pointers to the enum values, so two members
+// use the same enum if they point to the same values (see parMemberEnumData::hasSameEnum).
+struct EnumIdentity
+{
+	const void* values;
+	const void* valueNames;
+	uint32_t valueCount;
+
+	bool operator==(const EnumIdentity&) const = default;
+};
+
+// Gives a name to each distinct enum found in the members and remembers which name each member uses. The real enum names
+// don't appear in the executables of those games, so the names are generated from the first member found using the enum.
+// The names and the lookup maps live in an arena, registering thousands of members only takes a few heap allocations.
+class EnumNameIndex
+{
+public:
+	// Registers a member that uses the given enum. If the enum was not seen before, it is named with `makeName`, which
+	// must allocate the name in the given arena, and true is returned, otherwise the member shares the name of the first
+	// member with the same enum.
+	bool Add(const void* member, const EnumIdentity& identity, const std::function<std::string_view(ScratchArena&)>& makeName);
+
+	// Name of the enum used by the member, empty if the member was not added.
+	std::string_view Find(const void* member) const;
+
+	size_t EnumCount() const { return _identityNames.size(); }
+
+private:
+	struct IdentityHash
+	{
+		size_t operator()(const EnumIdentity& id) const;
+	};
+
+	ScratchArena _arena;
+	std::pmr::unordered_map<EnumIdentity, std::string_view, IdentityHash> _identityNames{ _arena.Resource() };
+	std::pmr::unordered_map<const void*, std::string_view> _memberNames{ _arena.Resource() };
+};
@@ -0,0 +1,179 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+
+// The enums of rage.h/rage_gta4.h that are written to the dumps are defined from a list macro, `LIST(X)` expanding
+// `X(name, value)` for each enumerator, so the enum and its string table can't get out of sync:
+//
+//   #define FOO_VALUES(X) X(A, 0) X(B, 1)
+//   enum class Foo { FOO_VALUES(ENUM_DEFINE_VALUE) };
+//   constexpr auto foo_names = ENUM_NAME_TABLE(Foo, FOO_VALUES);
+//
+// Lists that change between games are split in one macro per #if block, preprocessor directives can't be used inside them.
+#define ENUM_DEFINE_VALUE(name, value) name = value,
+#define ENUM_NAME_ENTRY(name, value) EnumNameEntry{ static_cast<uint64_t>(value), #name },
+
+#define ENUM_NAME_TABLE(type, list) \
+	EnumNameTable<type, EnumTableSize({ list(ENUM_NAME_ENTRY) })>{ { list(ENUM_NAME_ENTRY) } }
+#define FLAG_NAME_TABLE(type, list) \
+	FlagNameTable<type, std::initializer_list<EnumNameEntry>{ list(ENUM_NAME_ENTRY) }.size(), FlagTableChars({ list(ENUM_NAME_ENTRY) })>{ { list(ENUM_NAME_ENTRY) } }
+
+struct EnumNameEntry
+{
+	uint64_t value;
+	std::string_view name;
+};
+
+constexpr size_t EnumTableSize(std::initializer_list<EnumNameEntry> entries)
+{
+	uint64_t maxValue = 0;
+	for (auto& e : entries)
+	{
+		maxValue = e.value > maxValue ? e.value : maxValue;
+	}
+	return static_cast<size_t>(maxValue) + 1;
+}
+
+// Enumerator names indexed by value.
+template<class TEnum, size_t Size>
+class EnumNameTable
+{
+public:
+	constexpr EnumNameTable(std::initializer_list<EnumNameEntry> entries)
+	{
+		for (auto& e : entries)
+		{
+			_uniqueValues = _uniqueValues && _names[e.value].empty();
+			_names[e.value] = e.name;
+		}
+	}
+
+	// Name of the enumerator with the given value, `fallback` if there is none.
+	constexpr std::string_view operator()(TEnum value, std::string_view fallback = {}) const
+	{
+		const auto index = static_cast<size_t>(value);
+		return index < Size && !_names[index].empty() ? _names[index] : fallback;
+	}
+
+	// No two enumerators have the same value, otherwise one of them would be missing from the table.
+	constexpr bool HasUniqueValues() const { return _uniqueValues; }
+
+	// Every value from 0 to the largest enumerator has a name.
+	constexpr bool IsDense() const
+	{
+		for (auto name : _names)
+		{
+			if (name.empty())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	std::array<std::string_view, Size> _names{};
+	bool _uniqueValues = true;
+};
+
+// Characters needed for the strings of every combination of the flags: each name appears in half of them, and a combination
+// of `k` names has `k - 1` separators.
+constexpr size_t FlagTableChars(std::initializer_list<EnumNameEntry> entries)
+{
+	size_t chars = 0;
+	for (auto& e : entries)
+	{
+		chars += e.name.size() << (entries.size() - 1);
+	}
+	for (size_t mask = 0; mask < (size_t{ 1 } << entries.size()); mask++)
+	{
+		size_t count = 0;
+		for (size_t bits = mask; bits != 0; bits &= bits - 1)
+		{
+			count++;
+		}
+		chars += count > 1 ? (count - 1) * 2 : 0;
+	}
+	return chars;
+}
+
+// The string of every combination of a set of flags ("A, B, C"), in the order the flags are listed. Bits without a name
+// are ignored.
+template<class TEnum, size_t NumFlags, size_t NumChars>
+class FlagNameTable
+{
+	static_assert(NumFlags > 0 && NumFlags <= 8, "too many combinations");
+	static_assert(NumChars <= UINT16_MAX);
+
+public:
+	constexpr FlagNameTable(std::initializer_list<EnumNameEntry> entries)
+	{
+		size_t i = 0;
+		for (auto& e : entries)
+		{
+			_flags[i] = e.value;
+			_bitPerFlag = _bitPerFlag && e.value == (uint64_t{ 1 } << i);
+			i++;
+		}
+
+		size_t pos = 0;
+		for (size_t mask = 0; mask < NumCombinations; mask++)
+		{
+			_offsets[mask] = static_cast<uint16_t>(pos);
+			i = 0;
+			for (auto& e : entries)
+			{
+				if ((mask & (size_t{ 1 } << i++)) == 0)
+				{
+					continue;
+				}
+
+				if (pos != _offsets[mask])
+				{
+					_chars[pos++] = ',';
+					_chars[pos++] = ' ';
+				}
+				for (char c : e.name)
+				{
+					_chars[pos++] = c;
+				}
+			}
+		}
+		_offsets[NumCombinations] = static_cast<uint16_t>(pos);
+	}
+
+	constexpr std::string_view operator()(TEnum flags) const
+	{
+		const auto value = static_cast<uint64_t>(flags);
+		size_t mask = 0;
+		if (_bitPerFlag)
+		{
+			mask = static_cast<size_t>(value & (NumCombinations - 1));
+		}
+		else
+		{
+			for (size_t i = 0; i < NumFlags; i++)
+			{
+				if ((value & _flags[i]) == _flags[i])
+				{
+					mask |= size_t{ 1 } << i;
+				}
+			}
+		}
+		return { _chars.data() + _offsets[mask], static_cast<size_t>(_offsets[mask + 1] - _offsets[mask]) };
+	}
+
+	// The flags are the bits 0, 1, 2... in order, so the bits of a value are directly the index of its string.
+	constexpr bool IsBitPerFlag() const { return _bitPerFlag; }
+
+private:
+	static constexpr size_t NumCombinations = size_t{ 1 } << NumFlags;
+
+	std::array<uint64_t, NumFlags> _flags{};
+	std::array<uint16_t, NumCombinations + 1> _offsets{};
+	std::array<char, NumChars> _chars{};
+	bool _bitPerFlag = true;
+};
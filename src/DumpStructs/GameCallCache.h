@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+// Remembers the result of a call into game code for each object, so it is called at most once per object while dumping,
+// and counts the calls. The lock is held during the call, which also serializes the calls into game code when dumping
+// from multiple threads (see JsonParallel.h).
+template<class TObject, class TResult>
+class GameCallCache
+{
+public:
+	template<class TFunc>
+	TResult Get(TObject* object, TFunc call)
+	{
+		std::scoped_lock lock{ _mutex };
+		auto [it, inserted] = _results.try_emplace(object);
+		if (inserted)
+		{
+			it->second = call();
+			_calls++;
+		}
+		else
+		{
+			_hits++;
+		}
+		return it->second;
+	}
+
+	void Clear()
+	{
+		std::scoped_lock lock{ _mutex };
+		_results.clear();
+		_calls = 0;
+		_hits = 0;
+	}
+
+	// Calls into game code since the last Clear.
+	size_t Calls() const { return _calls; }
+	// Results returned from the cache since the last Clear.
+	size_t Hits() const { return _hits; }
+
+private:
+	std::mutex _mutex;
+	std::unordered_map<TObject*, TResult> _results;
+	size_t _calls = 0;
+	size_t _hits = 0;
+};
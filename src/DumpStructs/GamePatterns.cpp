@@ -0,0 +1,175 @@
+#include "GamePatterns.h"
+#include <Windows.h>
+#include <spdlog/spdlog.h>
+#include "Hooking.h"
+#include <array>
+#include <chrono>
+
+#include "PatternCache.h"
+#include "PatternScanner.h"
+
+static constexpr const char* pattern_cache_file = "DumpStructs.patterns";
+
+static constexpr size_t unresolved_pattern = SIZE_MAX;
+
+static uint8_t* imageBase = nullptr;
+// RVA of the first match of each entry of game_patterns
+static std::array<size_t, game_patterns.size()> resolvedPatterns;
+static size_t numResolvedPatterns = 0;
+
+static const char* LoadResultToStr(PatternCacheLoadResult result)
+{
+	switch (result)
+	{
+	case PatternCacheLoadResult::Loaded: return "loaded";
+	case PatternCacheLoadResult::Missing: return "missing";
+	case PatternCacheLoadResult::Stale: return "stale";
+	case PatternCacheLoadResult::Corrupt: return "corrupt";
+	}
+	return "unknown";
+}
+
+// Logs the patterns of the table without a match, returns whether there are none.
+static bool CheckAllResolved()
+{
+	for (size_t i = 0; i < game_patterns.size(); i++)
+	{
+		if (resolvedPatterns[i] == unresolved_pattern)
+		{
+			spdlog::error("Pattern for {} has no match", game_patterns[i].name);
+		}
+	}
+	return numResolvedPatterns == game_patterns.size();
+}
+
+bool InitPatterns(const std::tuple<uint16_t, uint16_t, uint16_t, uint16_t>& gameBuild)
+{
+	imageBase = reinterpret_cast<uint8_t*>(GetModuleHandle(NULL));
+	auto dosHeader = reinterpret_cast<IMAGE_DOS_HEADER*>(imageBase);
+	auto ntHeaders = reinterpret_cast<IMAGE_NT_HEADERS*>(imageBase + dosHeader->e_lfanew);
+	const size_t imageSize = ntHeaders->OptionalHeader.SizeOfImage;
+
+	auto [major, minor, build, revision] = gameBuild;
+	PatternCache cache{ { { major, minor, build, revision }, ntHeaders->FileHeader.TimeDateStamp, ntHeaders->OptionalHeader.CheckSum, ntHeaders->OptionalHeader.SizeOfImage } };
+	const auto loadResult = cache.Load(pattern_cache_file);
+	spdlog::info("Pattern cache {} ({} entries)", LoadResultToStr(loadResult), cache.Size());
+
+	resolvedPatterns.fill(unresolved_pattern);
+	PatternScanner scanner;
+	bool needsScan = false;
+	for (size_t i = 0; i < game_patterns.size(); i++)
+	{
+		auto& p = game_patterns[i];
+		const size_t index = scanner.Add(p.pattern);
+		if (index == PatternScanner::InvalidPattern)
+		{
+			spdlog::warn("Invalid pattern '{}' ({})", p.pattern, p.name);
+			continue;
+		}
+
+		// only trust the cached RVA if the pattern still matches there
+		const auto cachedRva = cache.Find(p.pattern);
+		if (cachedRva.has_value() && scanner.IsMatch(index, imageBase, imageSize, cachedRva.value()))
+		{
+			resolvedPatterns[i] = cachedRva.value();
+			numResolvedPatterns++;
+		}
+		else
+		{
+			if (cachedRva.has_value())
+			{
+				spdlog::warn("Cached RVA 0x{:X} of pattern for {} does not match, rescanning", cachedRva.value(), p.name);
+				cache.Remove(p.pattern);
+			}
+			needsScan = true;
+		}
+	}
+
+	if (!needsScan)
+	{
+		spdlog::info("All {} patterns resolved from the cache", numResolvedPatterns);
+		return CheckAllResolved();
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	scanner.Scan(imageBase, imageSize);
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+	spdlog::info("Scanned {} patterns in {} us ({} candidates, {})", scanner.PatternCount(), elapsed.count(),
+		scanner.CandidateCount(), PatternScanner::UsesAvx2() ? "AVX2" : "SSE2");
+	for (size_t i = 0; i < game_patterns.size(); i++)
+	{
+		auto& p = game_patterns[i];
+		if (resolvedPatterns[i] != unresolved_pattern)
+		{
+			continue;
+		}
+
+		const size_t index = scanner.Find(p.pattern);
+		const auto matches = index != PatternScanner::InvalidPattern ? scanner.Matches(index) : std::span<const size_t>{};
+		if (matches.size() != 1)
+		{
+			spdlog::warn("Pattern for {} has {} matches", p.name, matches.size());
+		}
+
+		if (!matches.empty())
+		{
+			resolvedPatterns[i] = matches[0];
+			numResolvedPatterns++;
+			cache.Set(p.pattern, matches[0]);
+		}
+	}
+
+	if (cache.IsDirty() && !cache.Save(pattern_cache_file))
+	{
+		spdlog::warn("Failed to write the pattern cache");
+	}
+
+	return CheckAllResolved();
+}
+
+// Returns the table entry of the pattern and the RVA of its match, or null if InitPatterns found no match.
+static const PatternInfo* FindResolved(GamePattern id, size_t& rva)
+{
+	for (size_t i = 0; i < game_patterns.size(); i++)
+	{
+		if (game_patterns[i].id == id)
+		{
+			if (resolvedPatterns[i] == unresolved_pattern)
+			{
+				spdlog::error("Pattern for {} was not resolved", game_patterns[i].name);
+				return nullptr;
+			}
+
+			rva = resolvedPatterns[i];
+			return &game_patterns[i];
+		}
+	}
+	return nullptr;
+}
+
+void* FindPatternMatch(GamePattern id)
+{
+	size_t rva;
+	return FindResolved(id, rva) != nullptr ? imageBase + rva : nullptr;
+}
+
+void* FindPatternAddress(GamePattern id)
+{
+	size_t rva;
+	const PatternInfo* p = FindResolved(id, rva);
+	if (p == nullptr)
+	{
+		return nullptr;
+	}
+
+	uint8_t* address = imageBase + rva + p->offset;
+	switch (p->resolve)
+	{
+	case PatternResolve::None: return address;
+	case PatternResolve::Address: return hook::get_address<void*>(address);
+	case PatternResolve::Call: return hook::get_call<void*>(address);
+	case PatternResolve::Pointer: return reinterpret_cast<void*>(static_cast<uintptr_t>(*reinterpret_cast<uint32_t*>(address)));
+	}
+	return nullptr;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "Patterns.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+
+// The pattern table of the current game.
+inline constexpr std::span<const PatternInfo> game_patterns =
+#if RDR3
+	rdr3_patterns;
+#elif RDR2
+	rdr2_patterns;
+#elif GTA5
+	gta5_patterns;
+#elif GTA5G9
+	gta5g9_patterns;
+#elif MP3
+	mp3_patterns;
+#elif GTA4
+	gta4_patterns;
+#endif
+
+constexpr bool HasGamePattern(GamePattern id)
+{
+	for (auto& p : game_patterns)
+	{
+		if (p.id == id)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Resolves all the patterns of the current game (see Patterns.h). They are read from the pattern cache file if it was
+// written by the same executable, otherwise the game executable is scanned in a single pass and the cache is updated.
+// Must be called before GetPattern. Returns false if any pattern of the table has no match, the missing ones are logged and
+// nothing else may run since the code using them does not check for null.
+bool InitPatterns(const std::tuple<uint16_t, uint16_t, uint16_t, uint16_t>& gameBuild);
+
+// Returns the first match of a pattern resolved by InitPatterns, or null if it has no match.
+void* FindPatternMatch(GamePattern id);
+// Returns the match plus the offset of the table entry, resolved as the entry says (see PatternResolve), or null if the
+// pattern has no match.
+void* FindPatternAddress(GamePattern id);
+
+// The address a pattern of the table resolves to, same as hook::get_pattern with the offset followed by the hook:: helper
+// of the entry. Using a pattern that is not in the table of the current game does not compile.
+template<GamePattern Id, class T = void>
+inline T* GetPattern()
+{
+	static_assert(HasGamePattern(Id), "the pattern is not in the table of the current game, see Patterns.h");
+	return reinterpret_cast<T*>(FindPatternAddress(Id));
+}
+
+// The first match of a pattern of the table, for the code that reads around it.
+template<GamePattern Id, class T = void>
+inline T* GetPatternMatch()
+{
+	static_assert(HasGamePattern(Id), "the pattern is not in the table of the current game, see Patterns.h");
+	return reinterpret_cast<T*>(FindPatternMatch(Id));
+}
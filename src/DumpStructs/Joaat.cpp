@@ -0,0 +1,269 @@
+#include "Joaat.h"
+#include "PatternScanner.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <vector>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define JOAAT_X86 1
+#if defined(_MSC_VER)
+#define JOAAT_AVX2_TARGET
+#else
+#define JOAAT_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+#if JOAAT_X86
+// The 4 bytes of the text starting at `pos` (little-endian, as x86 is), zero past the end. The lanes read their bytes
+// 4 at a time to make fewer loads per step.
+static int LoadWord(std::string_view text, size_t pos)
+{
+	uint32_t word = 0;
+	if (pos + 4 <= text.size())
+	{
+		std::memcpy(&word, text.data() + pos, 4);
+	}
+	else
+	{
+		for (size_t i = pos; i < text.size(); i++)
+		{
+			word |= static_cast<uint32_t>(static_cast<uint8_t>(text[i])) << ((i - pos) * 8);
+		}
+	}
+	return static_cast<int>(word);
+}
+
+// LoadWord when the text is known to have the 4 bytes.
+static int LoadFullWord(std::string_view text, size_t pos)
+{
+	int word;
+	std::memcpy(&word, text.data() + pos, 4);
+	return word;
+}
+
+static size_t MaxLength(const std::string_view* texts, size_t count)
+{
+	size_t maxLength = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		maxLength = std::max(maxLength, texts[i].size());
+	}
+	return maxLength;
+}
+
+static size_t MinLength(const std::string_view* texts, size_t count)
+{
+	size_t minLength = SIZE_MAX;
+	for (size_t i = 0; i < count; i++)
+	{
+		minLength = std::min(minLength, texts[i].size());
+	}
+	return minLength;
+}
+
+// Hashes 4 strings, one per 32-bit lane. Until the shortest string ends every lane is active; after that, lanes whose
+// string already ended keep their hash unchanged.
+static void JoaatLanesSse2(const std::string_view* texts, uint32_t* hashes)
+{
+	const size_t minLength = MinLength(texts, 4) & ~size_t{ 3 };
+	const size_t maxLength = MaxLength(texts, 4);
+	const __m128i lengths = _mm_setr_epi32(static_cast<int>(texts[0].size()), static_cast<int>(texts[1].size()),
+		static_cast<int>(texts[2].size()), static_cast<int>(texts[3].size()));
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	__m128i hash = _mm_setzero_si128();
+	size_t pos = 0;
+	for (; pos < minLength; pos += 4)
+	{
+		__m128i words = _mm_setr_epi32(LoadFullWord(texts[0], pos), LoadFullWord(texts[1], pos), LoadFullWord(texts[2], pos),
+			LoadFullWord(texts[3], pos));
+		for (size_t i = 0; i < 4; i++)
+		{
+			hash = _mm_add_epi32(hash, _mm_and_si128(words, byteMask));
+			hash = _mm_add_epi32(hash, _mm_slli_epi32(hash, 10));
+			hash = _mm_xor_si128(hash, _mm_srli_epi32(hash, 6));
+			words = _mm_srli_epi32(words, 8);
+		}
+	}
+	for (; pos < maxLength; pos += 4)
+	{
+		__m128i words = _mm_setr_epi32(LoadWord(texts[0], pos), LoadWord(texts[1], pos), LoadWord(texts[2], pos),
+			LoadWord(texts[3], pos));
+		for (size_t i = 0; i < 4; i++)
+		{
+			const __m128i active = _mm_cmpgt_epi32(lengths, _mm_set1_epi32(static_cast<int>(pos + i)));
+			__m128i next = _mm_add_epi32(hash, _mm_and_si128(words, byteMask));
+			next = _mm_add_epi32(next, _mm_slli_epi32(next, 10));
+			next = _mm_xor_si128(next, _mm_srli_epi32(next, 6));
+			hash = _mm_or_si128(_mm_and_si128(active, next), _mm_andnot_si128(active, hash));
+			words = _mm_srli_epi32(words, 8);
+		}
+	}
+	hash = _mm_add_epi32(hash, _mm_slli_epi32(hash, 3));
+	hash = _mm_xor_si128(hash, _mm_srli_epi32(hash, 11));
+	hash = _mm_add_epi32(hash, _mm_slli_epi32(hash, 15));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(hashes), hash);
+}
+
+// Same as JoaatLanesSse2 with 8 lanes. The 4 bytes of each lane are gathered directly from the strings, the gather indices
+// being their addresses.
+JOAAT_AVX2_TARGET static void JoaatLanesAvx2(const std::string_view* texts, uint32_t* hashes)
+{
+	const size_t shortest = MinLength(texts, 8);
+	if (shortest < 4)
+	{
+		// no 4 bytes to read at the end of the string, rare enough in a dictionary to not bother
+		for (size_t i = 0; i < 8; i++)
+		{
+			hashes[i] = joaat(texts[i]);
+		}
+		return;
+	}
+
+	const size_t minLength = shortest & ~size_t{ 3 };
+	const size_t maxLength = MaxLength(texts, 8);
+	const __m256i lengths = _mm256_setr_epi32(static_cast<int>(texts[0].size()), static_cast<int>(texts[1].size()),
+		static_cast<int>(texts[2].size()), static_cast<int>(texts[3].size()), static_cast<int>(texts[4].size()),
+		static_cast<int>(texts[5].size()), static_cast<int>(texts[6].size()), static_cast<int>(texts[7].size()));
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	__m256i hash = _mm256_setzero_si256();
+	__m256i addressesLow = _mm256_setr_epi64x(reinterpret_cast<int64_t>(texts[0].data()), reinterpret_cast<int64_t>(texts[1].data()),
+		reinterpret_cast<int64_t>(texts[2].data()), reinterpret_cast<int64_t>(texts[3].data()));
+	__m256i addressesHigh = _mm256_setr_epi64x(reinterpret_cast<int64_t>(texts[4].data()), reinterpret_cast<int64_t>(texts[5].data()),
+		reinterpret_cast<int64_t>(texts[6].data()), reinterpret_cast<int64_t>(texts[7].data()));
+	const __m256i step = _mm256_set1_epi64x(4);
+	size_t pos = 0;
+	for (; pos < minLength; pos += 4)
+	{
+		__m256i words = _mm256_set_m128i(_mm256_i64gather_epi32(nullptr, addressesHigh, 1),
+			_mm256_i64gather_epi32(nullptr, addressesLow, 1));
+		addressesLow = _mm256_add_epi64(addressesLow, step);
+		addressesHigh = _mm256_add_epi64(addressesHigh, step);
+		for (size_t i = 0; i < 4; i++)
+		{
+			hash = _mm256_add_epi32(hash, _mm256_and_si256(words, byteMask));
+			hash = _mm256_add_epi32(hash, _mm256_slli_epi32(hash, 10));
+			hash = _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 6));
+			words = _mm256_srli_epi32(words, 8);
+		}
+	}
+	// past the end of the shortest string, the lanes read the 4 bytes ending at the end of their string instead of reading past
+	// it, and shift out the bytes already hashed
+	const __m256i lastWords = _mm256_sub_epi32(lengths, _mm256_set1_epi32(4));
+	for (; pos < maxLength; pos += 4)
+	{
+		const __m256i position = _mm256_set1_epi32(static_cast<int>(pos));
+		const __m256i clamped = _mm256_min_epi32(position, lastWords);
+		const __m256i offsets = _mm256_sub_epi32(clamped, _mm256_set1_epi32(static_cast<int>(minLength)));
+		__m256i words = _mm256_set_m128i(
+			_mm256_i64gather_epi32(nullptr, _mm256_add_epi64(addressesHigh, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(offsets, 1))), 1),
+			_mm256_i64gather_epi32(nullptr, _mm256_add_epi64(addressesLow, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(offsets))), 1));
+		words = _mm256_srlv_epi32(words, _mm256_slli_epi32(_mm256_sub_epi32(position, clamped), 3));
+
+		for (size_t i = 0; i < 4; i++)
+		{
+			const __m256i active = _mm256_cmpgt_epi32(lengths, _mm256_set1_epi32(static_cast<int>(pos + i)));
+			__m256i next = _mm256_add_epi32(hash, _mm256_and_si256(words, byteMask));
+			next = _mm256_add_epi32(next, _mm256_slli_epi32(next, 10));
+			next = _mm256_xor_si256(next, _mm256_srli_epi32(next, 6));
+			hash = _mm256_blendv_epi8(hash, next, active);
+			words = _mm256_srli_epi32(words, 8);
+		}
+	}
+	hash = _mm256_add_epi32(hash, _mm256_slli_epi32(hash, 3));
+	hash = _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 11));
+	hash = _mm256_add_epi32(hash, _mm256_slli_epi32(hash, 15));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(hashes), hash);
+}
+#endif
+
+// JoaatBatch for texts in the order given.
+static void JoaatBatchInOrder(std::span<const std::string_view> texts, std::span<uint32_t> hashes)
+{
+	const size_t count = std::min(texts.size(), hashes.size());
+	size_t i = 0;
+#if JOAAT_X86
+	// the lane lengths are compared as signed 32-bit integers, longer strings are left to joaat()
+	const auto fitsLanes = [&](size_t first, size_t lanes) { return MaxLength(texts.data() + first, lanes) <= INT32_MAX; };
+	if (PatternScanner::UsesAvx2())
+	{
+		for (; count - i >= 8 && fitsLanes(i, 8); i += 8)
+		{
+			JoaatLanesAvx2(texts.data() + i, hashes.data() + i);
+		}
+	}
+	for (; count - i >= 4 && fitsLanes(i, 4); i += 4)
+	{
+		JoaatLanesSse2(texts.data() + i, hashes.data() + i);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		hashes[i] = joaat(texts[i]);
+	}
+}
+
+void JoaatBatch(std::span<const std::string_view> texts, std::span<uint32_t> hashes)
+{
+	// the lanes of a group keep stepping until its longest text is hashed, so with texts of mixed lengths most of the work
+	// is wasted. The texts are hashed in chunks, and a chunk where the groups would waste more than a third of the steps is
+	// sorted by length first (counting sort, longer texts share the last bucket) so the groups get texts of about the same
+	// length. Otherwise sorting costs more than it saves.
+	constexpr size_t chunk_size = 4096;
+	constexpr size_t num_buckets = 256;
+	constexpr size_t group_size = 8;
+	constexpr size_t sample_size = 512;
+
+	const size_t count = std::min(texts.size(), hashes.size());
+	std::vector<std::string_view> sorted;
+	std::vector<uint32_t> order, sortedHashes;
+	for (size_t first = 0; first < count; first += chunk_size)
+	{
+		const auto chunk = texts.subspan(first, std::min(chunk_size, count - first));
+		const auto chunkHashes = hashes.subspan(first, chunk.size());
+		// estimated from the start of the chunk, going through all of it costs as much as sorting saves on similar lengths
+		size_t chars = 0, steps = 0;
+		for (size_t i = 0; i + group_size <= std::min(chunk.size(), sample_size); i += group_size)
+		{
+			size_t groupMax = 0;
+			for (size_t j = i; j < i + group_size; j++)
+			{
+				chars += chunk[j].size();
+				groupMax = std::max(groupMax, chunk[j].size());
+			}
+			steps += groupMax * group_size;
+		}
+
+		if (2 * steps <= 3 * chars)
+		{
+			JoaatBatchInOrder(chunk, chunkHashes);
+			continue;
+		}
+
+		std::array<uint32_t, num_buckets + 1> starts{};
+		for (auto text : chunk)
+		{
+			starts[std::min(text.size(), num_buckets - 1) + 1]++;
+		}
+		for (size_t b = 1; b <= num_buckets; b++)
+		{
+			starts[b] += starts[b - 1];
+		}
+		sorted.resize(chunk.size());
+		order.resize(chunk.size());
+		sortedHashes.resize(chunk.size());
+		for (size_t i = 0; i < chunk.size(); i++)
+		{
+			const uint32_t pos = starts[std::min(chunk[i].size(), num_buckets - 1)]++;
+			sorted[pos] = chunk[i];
+			order[pos] = static_cast<uint32_t>(i);
+		}
+
+		JoaatBatchInOrder(sorted, sortedHashes);
+		for (size_t i = 0; i < chunk.size(); i++)
+		{
+			chunkHashes[order[i]] = sortedHashes[i];
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+constexpr uint32_t joaat_literal(const char* text)
+{
+	if (!text)
+	{
+		return 0;
+	}
+
+	unsigned int hash = 0;
+	while (*text)
+	{
+		hash += *text;
+		hash += hash << 10;
+		hash ^= hash >> 6;
+		text++;
+	}
+	hash += hash << 3;
+	hash ^= hash >> 11;
+	hash += hash << 15;
+	return hash;
+}
+
+constexpr uint32_t joaat(std::string_view text)
+{
+	uint32_t hash = 0;
+	for (char c : text)
+	{
+		hash += static_cast<uint8_t>(c);
+		hash += hash << 10;
+		hash ^= hash >> 6;
+	}
+	hash += hash << 3;
+	hash ^= hash >> 11;
+	hash += hash << 15;
+	return hash;
+}
+
+// Hashes each of `texts` into `hashes`, with the same results as joaat(). Several strings are hashed at once, one per SIMD
+// lane (8 with AVX2, 4 with SSE2), which is much faster than one at a time when hashing a whole dictionary. Strings of
+// mixed lengths are regrouped by length first, otherwise the short ones wait for the longest of their group.
+void JoaatBatch(std::span<const std::string_view> texts, std::span<uint32_t> hashes);
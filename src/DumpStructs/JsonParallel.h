@@ -0,0 +1,69 @@
+#pragma once
+#include "JsonWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes the items of the current JSON array/object, calling writeItem(w, item) for each. The items are split in chunks that
+// are serialized by `numThreads` threads into separate memory writers, then written to `w` in the original order, so the
+// output is byte-identical to writing them one by one in the calling thread. writeItem must be safe to call concurrently.
+// initThread() is called at the start of each thread started here, before any writeItem, to set up the per-thread state
+// writeItem needs (e.g. the game allocator in TLS).
+template<class T, class TFunc, class TInitFunc = void (*)()>
+void WriteJsonItemsParallel(JsonWriter& w, std::span<T> items, size_t numThreads, TFunc writeItem, TInitFunc initThread = [] {})
+{
+	if (numThreads <= 1 || items.size() <= 1)
+	{
+		for (auto& item : items)
+		{
+			writeItem(w, item);
+		}
+		return;
+	}
+
+	// more chunks than threads so a few slow chunks don't leave the other threads idle
+	const size_t numChunks = std::min(items.size(), numThreads * 8);
+	const size_t chunkSize = (items.size() + numChunks - 1) / numChunks;
+	std::vector<std::string> fragments(numChunks);
+	std::atomic<size_t> nextChunk = 0;
+
+	const size_t indent = w.Indentation();
+	const bool firstInContainer = w.IsFirstInContainer();
+	const auto worker = [&]
+	{
+		for (size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+		{
+			const size_t begin = chunk * chunkSize;
+			const size_t end = std::min(begin + chunkSize, items.size());
+			JsonWriter fragment{ indent, chunk == 0 && firstInContainer };
+			for (size_t i = begin; i < end; i++)
+			{
+				writeItem(fragment, items[i]);
+			}
+			fragments[chunk] = fragment.TakeFragment();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < std::min(numThreads, numChunks); i++)
+	{
+		threads.emplace_back([&]
+		{
+			initThread();
+			worker();
+		});
+	}
+	worker();
+	for (auto& t : threads)
+	{
+		t.join();
+	}
+
+	for (auto& fragment : fragments)
+	{
+		w.WriteFragment(fragment);
+	}
+}
@@ -0,0 +1,218 @@
+#include "JsonReader.h"
+#include <charconv>
+#include <stdexcept>
+
+char JsonReader::Peek()
+{
+	if (_pos >= _text.size())
+	{
+		Error("unexpected end of input");
+	}
+	return _text[_pos];
+}
+
+bool JsonReader::TryConsume(char c)
+{
+	SkipWhitespace();
+	if (_pos < _text.size() && _text[_pos] == c)
+	{
+		_pos++;
+		return true;
+	}
+	return false;
+}
+
+void JsonReader::Expect(char c)
+{
+	if (!TryConsume(c))
+	{
+		Error(std::string{ "expected '" } + c + "'");
+	}
+}
+
+void JsonReader::ExpectLiteral(std::string_view literal)
+{
+	if (_text.substr(_pos, literal.size()) != literal)
+	{
+		Error("invalid literal");
+	}
+	_pos += literal.size();
+}
+
+void JsonReader::SkipWhitespace()
+{
+	while (_pos < _text.size())
+	{
+		const char c = _text[_pos];
+		if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+		{
+			break;
+		}
+		_pos++;
+	}
+}
+
+static void AppendUtf8(std::string& out, uint32_t codePoint)
+{
+	if (codePoint < 0x80)
+	{
+		out += static_cast<char>(codePoint);
+	}
+	else if (codePoint < 0x800)
+	{
+		out += static_cast<char>(0xC0 | (codePoint >> 6));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else if (codePoint < 0x10000)
+	{
+		out += static_cast<char>(0xE0 | (codePoint >> 12));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else
+	{
+		out += static_cast<char>(0xF0 | (codePoint >> 18));
+		out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+}
+
+std::string_view JsonReader::ParseString()
+{
+	if (Peek() != '"')
+	{
+		Error("expected string");
+	}
+	_pos++;
+
+	// fast path, strings without escape sequences are returned directly from the input
+	const size_t start = _pos;
+	const size_t end = _text.find_first_of("\"\\", start);
+	if (end == std::string_view::npos)
+	{
+		Error("unterminated string");
+	}
+	if (_text[end] == '"')
+	{
+		_pos = end + 1;
+		return _text.substr(start, end - start);
+	}
+
+	_scratch.assign(_text.data() + start, end - start);
+	_pos = end;
+	const auto parseHex4 = [this]()
+	{
+		uint32_t value = 0;
+		if (_pos + 4 > _text.size() || std::from_chars(_text.data() + _pos, _text.data() + _pos + 4, value, 16).ptr != _text.data() + _pos + 4)
+		{
+			Error("invalid \\u escape");
+		}
+		_pos += 4;
+		return value;
+	};
+	while (true)
+	{
+		const char c = Peek();
+		_pos++;
+		if (c == '"')
+		{
+			break;
+		}
+		if (c != '\\')
+		{
+			_scratch += c;
+			continue;
+		}
+
+		const char e = Peek();
+		_pos++;
+		switch (e)
+		{
+		case '"':  _scratch += '"'; break;
+		case '\\': _scratch += '\\'; break;
+		case '/':  _scratch += '/'; break;
+		case 'b':  _scratch += '\b'; break;
+		case 'f':  _scratch += '\f'; break;
+		case 'n':  _scratch += '\n'; break;
+		case 'r':  _scratch += '\r'; break;
+		case 't':  _scratch += '\t'; break;
+		case 'u':
+		{
+			uint32_t codePoint = parseHex4();
+			if (codePoint >= 0xD800 && codePoint < 0xDC00 && _text.substr(_pos, 2) == "\\u")
+			{
+				_pos += 2;
+				const uint32_t low = parseHex4();
+				codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+			}
+			AppendUtf8(_scratch, codePoint);
+		}
+		break;
+		default:
+			Error("invalid escape sequence");
+		}
+	}
+	return _scratch;
+}
+
+JsonReader::Number JsonReader::ParseNumber()
+{
+	const size_t start = _pos;
+	bool isInteger = true;
+	while (_pos < _text.size())
+	{
+		const char c = _text[_pos];
+		if (c == '.' || c == 'e' || c == 'E' || c == '+')
+		{
+			isInteger = false;
+		}
+		else if (!(c == '-' || (c >= '0' && c <= '9')))
+		{
+			break;
+		}
+		_pos++;
+	}
+
+	const char* first = _text.data() + start;
+	const char* last = _text.data() + _pos;
+	if (first == last)
+	{
+		Error("unexpected character");
+	}
+
+	Number n;
+	// keep "-0" as a floating point number, it cannot be represented as an integer
+	if (isInteger && std::string_view{ first, last } != "-0")
+	{
+		if (*first == '-')
+		{
+			n.kind = Number::Signed;
+			if (auto [ptr, ec] = std::from_chars(first, last, n.asSigned); ec == std::errc{} && ptr == last)
+			{
+				return n;
+			}
+		}
+		else
+		{
+			n.kind = Number::Unsigned;
+			if (auto [ptr, ec] = std::from_chars(first, last, n.asUnsigned); ec == std::errc{} && ptr == last)
+			{
+				return n;
+			}
+		}
+	}
+
+	// fractional or out of range of the integer types
+	n.kind = Number::Floating;
+	if (auto [ptr, ec] = std::from_chars(first, last, n.asDouble); ec != std::errc{} || ptr != last)
+	{
+		Error("invalid number");
+	}
+	return n;
+}
+
+void JsonReader::Error(std::string_view message) const
+{
+	throw std::runtime_error(std::string{ "JSON parse error at offset " } + std::to_string(_pos) + ": " + std::string{ message });
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "JsonWriter.h"
+#include <string>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+
+// Minimal JSON parser that replays the document as calls to a writer with the JsonWriter interface (JsonWriter or
+// DumpBinaryWriter). Numbers without fraction or exponent are replayed as Int/UInt, everything else as Double.
+// Throws std::runtime_error on malformed input.
+class JsonReader
+{
+public:
+	JsonReader(std::string_view text) : _text{ text }, _pos{ 0 } {}
+
+	template<class TWriter>
+	void Replay(TWriter& w)
+	{
+		SkipWhitespace();
+		Value(w, std::nullopt);
+		SkipWhitespace();
+		if (_pos != _text.size())
+		{
+			Error("trailing characters");
+		}
+	}
+
+private:
+	struct Number
+	{
+		enum { Signed, Unsigned, Floating } kind;
+		union
+		{
+			int64_t asSigned;
+			uint64_t asUnsigned;
+			double asDouble;
+		};
+	};
+
+	template<class TWriter>
+	void Value(TWriter& w, std::optional<std::string_view> key)
+	{
+		switch (Peek())
+		{
+		case '{':
+			_pos++;
+			w.BeginObject(key);
+			if (!TryConsume('}'))
+			{
+				do
+				{
+					SkipWhitespace();
+					// the key must outlive the value, copy it out of the scratch buffer
+					std::string memberKey{ ParseString() };
+					Expect(':');
+					SkipWhitespace();
+					Value(w, memberKey);
+				} while (TryConsume(','));
+				Expect('}');
+			}
+			w.EndObject();
+			break;
+		case '[':
+			_pos++;
+			w.BeginArray(key);
+			if (!TryConsume(']'))
+			{
+				do
+				{
+					SkipWhitespace();
+					Value(w, std::nullopt);
+				} while (TryConsume(','));
+				Expect(']');
+			}
+			w.EndArray();
+			break;
+		case '"':
+			w.String(key, ParseString());
+			break;
+		case 't':
+			ExpectLiteral("true");
+			w.Bool(key, true);
+			break;
+		case 'f':
+			ExpectLiteral("false");
+			w.Bool(key, false);
+			break;
+		case 'n':
+			ExpectLiteral("null");
+			w.Null(key);
+			break;
+		default:
+		{
+			const auto n = ParseNumber();
+			switch (n.kind)
+			{
+			case Number::Signed: w.Int(key, n.asSigned); break;
+			case Number::Unsigned: w.UInt(key, n.asUnsigned, json_uint_dec); break;
+			case Number::Floating: w.Double(key, n.asDouble); break;
+			}
+		}
+		break;
+		}
+	}
+
+	char Peek();
+	bool TryConsume(char c);
+	void Expect(char c);
+	void ExpectLiteral(std::string_view literal);
+	void SkipWhitespace();
+	// Returns a view of the unescaped string, only valid until the next call.
+	std::string_view ParseString();
+	Number ParseNumber();
+	[[noreturn]] void Error(std::string_view message) const;
+
+	std::string_view _text;
+	size_t _pos;
+	std::string _scratch;
+};
@@ -2,59 +2,83 @@
 #include <cassert>
 #include <string>
 #include <array>
-#include <charconv>
+#include <algorithm>
+#include <cstring>
+#include <bit>
+#include <utility>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define JSON_WRITER_SSE2 1
+#endif
 
 JsonWriter::JsonWriter(std::string_view filePath)
-	: _indent{ 0 }, _out{ std::string{ filePath }, std::ios::out | std::ios::binary }, _skipComma{ true }, _first{ true }
+	: _indent{ 0 }, _out{ std::string{ filePath }, std::ios::out | std::ios::binary },
+	  _buffer{ std::make_unique<char[]>(BufferSize) }, _bufferSize{ BufferSize }, _bufferUsed{ 0 }, _skipComma{ true }, _first{ true },
+	  _escape{ true }
 {
 }
 
+JsonWriter::JsonWriter(size_t indent, bool firstInContainer)
+	: _indent{ indent }, _memory{ std::string{} },
+	  _buffer{ std::make_unique<char[]>(MemoryBufferSize) }, _bufferSize{ MemoryBufferSize }, _bufferUsed{ 0 },
+	  _skipComma{ firstInContainer }, _first{ false }, _escape{ true }
+{
+}
+
+JsonWriter::~JsonWriter()
+{
+	Flush();
+}
+
 void JsonWriter::Null(std::optional<std::string_view> key)
 {
 	NextLine();
 	WriteKey(key);
-	_out << "null";
+	Write("null");
 }
 
 void JsonWriter::String(std::optional<std::string_view> key, std::string_view value)
 {
 	NextLine();
 	WriteKey(key);
-	_out << std::format("\"{}\"", value);
+	Write('"');
+	WriteEscaped(value);
+	Write('"');
 }
 
 void JsonWriter::Bool(std::optional<std::string_view> key, bool value)
 {
 	NextLine();
 	WriteKey(key);
-	_out << (value ? "true" : "false");
+	Write(value ? "true" : "false");
 }
 
+// std::chars_format::fixed of DBL_MAX is 309 digits, plus sign and fractional part
+static constexpr size_t MaxFixedFloatSize = 512;
+
 void JsonWriter::Float(std::optional<std::string_view> key, float value)
 {
-	std::array<char, 256> buff;
-	auto [ptr, ec] = std::to_chars(buff.data(), buff.data() + buff.size(), value, std::chars_format::fixed);
-
 	NextLine();
 	WriteKey(key);
-	_out << std::string_view{ buff.data(), ptr };
+	char* buff = Reserve(MaxFixedFloatSize);
+	auto [ptr, ec] = std::to_chars(buff, buff + MaxFixedFloatSize, value, std::chars_format::fixed);
+	Commit(ptr);
 }
 
 void JsonWriter::Double(std::optional<std::string_view> key, double value)
 {
-	std::array<char, 256> buff;
-	auto [ptr, ec] = std::to_chars(buff.data(), buff.data() + buff.size(), value, std::chars_format::fixed);
-
 	NextLine();
 	WriteKey(key);
-	_out << std::string_view{ buff.data(), ptr };
+	char* buff = Reserve(MaxFixedFloatSize);
+	auto [ptr, ec] = std::to_chars(buff, buff + MaxFixedFloatSize, value, std::chars_format::fixed);
+	Commit(ptr);
 }
 
 void JsonWriter::BeginObject(std::optional<std::string_view> key)
 {
 	NextLine();
 	WriteKey(key);
-	_out << '{';
+	Write('{');
 	_skipComma = true;
 	Indent();
 }
@@ -63,14 +87,14 @@ void JsonWriter::EndObject()
 {
 	Unindent();
 	NextLine(false);
-	_out << '}';
+	Write('}');
 }
 
 void JsonWriter::BeginArray(std::optional<std::string_view> key)
 {
 	NextLine();
 	WriteKey(key);
-	_out << '[';
+	Write('[');
 	_skipComma = true;
 	Indent();
 }
@@ -79,14 +103,61 @@ void JsonWriter::EndArray()
 {
 	Unindent();
 	NextLine(false);
-	_out << ']';
+	Write(']');
+}
+
+void JsonWriter::Flush()
+{
+	if (_bufferUsed > 0)
+	{
+		WriteOut(_buffer.get(), _bufferUsed);
+		_bufferUsed = 0;
+	}
+	if (!_memory.has_value())
+	{
+		_out.flush();
+	}
+}
+
+std::string JsonWriter::TakeFragment()
+{
+	assert(_memory.has_value());
+	Flush();
+	return std::exchange(_memory.value(), std::string{});
+}
+
+void JsonWriter::WriteFragment(std::string_view fragment)
+{
+	if (fragment.empty())
+	{
+		return;
+	}
+
+	// the fragment starts with its own comma and new-line, and leaves the writer after a value at the same indentation
+	Write(fragment);
+	_first = false;
+	_skipComma = false;
+}
+
+void JsonWriter::WriteOut(const char* data, size_t size)
+{
+	if (_memory.has_value())
+	{
+		_memory->append(data, size);
+	}
+	else
+	{
+		_out.write(data, size);
+	}
 }
 
 void JsonWriter::WriteKey(std::optional<std::string_view> key)
 {
 	if (key.has_value())
 	{
-		_out << std::format("\"{}\": ", key.value());
+		Write('"');
+		WriteEscaped(key.value());
+		Write("\": ");
 	}
 }
 
@@ -101,18 +172,23 @@ void JsonWriter::NextLine(bool addComma)
 
 	if (!_skipComma && addComma)
 	{
-		_out << ',';
+		Write(',');
 	}
 	_skipComma = false;
-	_out << '\n';
+	Write('\n');
 	WriteIndent();
 }
 
 void JsonWriter::WriteIndent()
 {
-	for (size_t n = 0; n < _indent; ++n)
+	static constexpr auto tabs = [] { std::array<char, 64> a{}; a.fill('\t'); return a; }();
+
+	size_t remaining = _indent;
+	while (remaining > 0)
 	{
-		_out << '\t';
+		const size_t n = std::min(remaining, tabs.size());
+		Write(std::string_view{ tabs.data(), n });
+		remaining -= n;
 	}
 }
 
@@ -126,3 +202,188 @@ void JsonWriter::Unindent()
 	assert(_indent > 0);
 	_indent--;
 }
+
+char* JsonWriter::Reserve(size_t size)
+{
+	if (_bufferSize - _bufferUsed < size)
+	{
+		if (_memory.has_value())
+		{
+			// the fragment stays in the buffer until TakeFragment, instead of being copied out on every flush
+			GrowBuffer(_bufferUsed + size);
+		}
+		else
+		{
+			assert(size <= _bufferSize);
+			WriteOut(_buffer.get(), _bufferUsed);
+			_bufferUsed = 0;
+		}
+	}
+	return _buffer.get() + _bufferUsed;
+}
+
+void JsonWriter::Commit(char* end)
+{
+	_bufferUsed = end - _buffer.get();
+	assert(_bufferUsed <= _bufferSize);
+}
+
+void JsonWriter::GrowBuffer(size_t minSize)
+{
+	const size_t newSize = std::max(minSize, _bufferSize * 2);
+	auto buffer = std::make_unique_for_overwrite<char[]>(newSize);
+	std::memcpy(buffer.get(), _buffer.get(), _bufferUsed);
+	_buffer = std::move(buffer);
+	_bufferSize = newSize;
+}
+
+void JsonWriter::Write(char c)
+{
+	char* buff = Reserve(1);
+	*buff = c;
+	Commit(buff + 1);
+}
+
+void JsonWriter::Write(std::string_view str)
+{
+	if (str.size() > BufferSize && !_memory.has_value())
+	{
+		// too big to be buffered, write it directly
+		Flush();
+		WriteOut(str.data(), str.size());
+		return;
+	}
+
+	char* buff = Reserve(str.size());
+	std::memcpy(buff, str.data(), str.size());
+	Commit(buff + str.size());
+}
+
+void JsonWriter::WriteHex(uint64_t value, size_t minDigits)
+{
+	static constexpr char digits[] = "0123456789ABCDEF";
+
+	size_t numDigits = 1;
+	for (uint64_t v = value >> 4; v != 0; v >>= 4)
+	{
+		numDigits++;
+	}
+	numDigits = std::max(numDigits, minDigits);
+
+	char* buff = Reserve(numDigits);
+	for (size_t i = numDigits; i > 0; i--)
+	{
+		buff[i - 1] = digits[value & 0xF];
+		value >>= 4;
+	}
+	Commit(buff + numDigits);
+}
+
+static bool NeedsEscape(char c)
+{
+	return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+#if JSON_WRITER_SSE2
+// Bit i is set if p[i] needs to be escaped.
+static unsigned EscapeMask(const char* p)
+{
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i maxControl = _mm_set1_epi8(0x1F);
+	const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+	// unsigned c <= 0x1F  <=>  max(c, 0x1F) == 0x1F
+	const __m128i isControl = _mm_cmpeq_epi8(_mm_max_epu8(chunk, maxControl), maxControl);
+	const __m128i isSpecial = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+	return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(isControl, isSpecial)));
+}
+#endif
+
+// Returns a pointer to the first character in [begin, end) that needs to be escaped, or end if none. With `readPastEnd`, the
+// EscapeScanPadding bytes after `end` can be read, so the last partial block is checked with SSE2 too.
+static const char* FindEscapeChar(const char* begin, const char* end, bool readPastEnd)
+{
+	const char* p = begin;
+#if JSON_WRITER_SSE2
+	while (end - p >= 16 || (readPastEnd && p < end))
+	{
+		unsigned mask = EscapeMask(p);
+		if (end - p < 16)
+		{
+			mask &= (1u << (end - p)) - 1;
+		}
+		if (mask != 0)
+		{
+			return p + std::countr_zero(mask);
+		}
+		p += 16;
+	}
+	if (readPastEnd)
+	{
+		return end;
+	}
+#endif
+	while (p != end && !NeedsEscape(*p))
+	{
+		p++;
+	}
+	return p;
+}
+
+void JsonWriter::WriteEscaped(std::string_view str)
+{
+	if (!_escape)
+	{
+		Write(str);
+		return;
+	}
+
+	// the common case, nothing to escape: the string is copied to the buffer and the copy is checked, with room after it to
+	// read the last block whole
+	if (str.size() <= BufferSize - EscapeScanPadding)
+	{
+		char* buff = Reserve(str.size() + EscapeScanPadding);
+		std::memcpy(buff, str.data(), str.size());
+#if JSON_WRITER_SSE2
+		// most keys and names fit in a single block
+		if (str.size() <= 16 && (EscapeMask(buff) & ((1u << str.size()) - 1)) == 0)
+		{
+			Commit(buff + str.size());
+			return;
+		}
+#endif
+		const size_t numClean = FindEscapeChar(buff, buff + str.size(), true) - buff;
+		Commit(buff + numClean);
+		str.remove_prefix(numClean);
+	}
+
+	const char* p = str.data();
+	const char* const end = p + str.size();
+	while (p != end)
+	{
+		// copy the run of characters that don't need escaping as a single block
+		const char* next = FindEscapeChar(p, end, false);
+		Write(std::string_view{ p, static_cast<size_t>(next - p) });
+		if (next == end)
+		{
+			break;
+		}
+
+		const char c = *next;
+		switch (c)
+		{
+		case '"':  Write("\\\""); break;
+		case '\\': Write("\\\\"); break;
+		case '\b': Write("\\b"); break;
+		case '\f': Write("\\f"); break;
+		case '\n': Write("\\n"); break;
+		case '\r': Write("\\r"); break;
+		case '\t': Write("\\t"); break;
+		default:
+			Write("\\u00");
+			WriteHex(static_cast<unsigned char>(c), 2);
+			break;
+		}
+		p = next + 1;
+	}
+}
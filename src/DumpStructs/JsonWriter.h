@@ -2,7 +2,11 @@
 #include <string_view>
 #include <optional>
 #include <fstream>
-#include <format>
+#include <memory>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <string>
 
 struct JsonUIntOptions
 {
@@ -17,6 +21,14 @@ class JsonWriter
 {
 public:
 	JsonWriter(std::string_view filePath);
+	// Writes to memory instead of a file, to serialize parts of a document separately (e.g. in parallel) and then merge
+	// them with WriteFragment. The fragment continues the document at the given indentation level, either as the first
+	// value in its object/array or after other values. The buffer starts small and grows with the fragment.
+	JsonWriter(size_t indent, bool firstInContainer);
+	~JsonWriter();
+
+	JsonWriter(const JsonWriter&) = delete;
+	JsonWriter& operator=(const JsonWriter&) = delete;
 
 	void Null(std::optional<std::string_view> key);
 	void String(std::optional<std::string_view> key, std::string_view value);
@@ -30,6 +42,21 @@ public:
 	void BeginArray(std::optional<std::string_view> key = std::nullopt);
 	void EndArray();
 
+	void Flush();
+
+	size_t Indentation() const { return _indent; }
+	// Whether the next value is the first in its object/array.
+	bool IsFirstInContainer() const { return _first || _skipComma; }
+
+	// Writes strings and keys as they are, like the writer did before escaping them. The JSON is invalid if any of them needs
+	// escaping, this is only meant to measure the cost of escaping.
+	void SetEscaping(bool escape) { _escape = escape; }
+
+	// Returns everything written to a memory writer, leaving it empty.
+	std::string TakeFragment();
+	// Appends a fragment written by a memory writer created with the indentation and position of this writer.
+	void WriteFragment(std::string_view fragment);
+
 private:
 	void WriteKey(std::optional<std::string_view> key);
 	void NextLine(bool addComma = true);
@@ -37,23 +64,60 @@ private:
 	void Indent();
 	void Unindent();
 
+	// Returns a pointer to at least `size` free bytes in the output buffer, flushing it if needed.
+	// Must be followed by Commit() with the end of the written data.
+	char* Reserve(size_t size);
+	void Commit(char* end);
+	void GrowBuffer(size_t minSize);
+	void Write(char c);
+	void Write(std::string_view str);
+	void WriteEscaped(std::string_view str);
+	void WriteHex(uint64_t value, size_t minDigits);
+	void WriteOut(const char* data, size_t size);
+
+	// large enough that a full dump only needs a handful of writes to the file
+	static constexpr size_t BufferSize = 1024 * 1024;
+	// memory writers are created per chunk of a parallel dump, most fragments are a few KiB
+	static constexpr size_t MemoryBufferSize = 4 * 1024;
+	// free space WriteEscaped needs after a string to check it in whole 16-byte blocks
+	static constexpr size_t EscapeScanPadding = 16;
+
 	size_t _indent;
 	std::ofstream _out;
+	std::optional<std::string> _memory; // output of memory writers
+	std::unique_ptr<char[]> _buffer;
+	size_t _bufferSize;
+	size_t _bufferUsed;
 	bool _skipComma;
 	bool _first;
+	bool _escape;
 };
 
 void JsonWriter::Int(std::optional<std::string_view> key, std::signed_integral auto value)
 {
 	NextLine();
 	WriteKey(key);
-	_out << std::format("{}", value);
+	constexpr size_t maxSize = 24; // enough for INT64_MIN
+	char* buff = Reserve(maxSize);
+	auto [ptr, ec] = std::to_chars(buff, buff + maxSize, value);
+	Commit(ptr);
 }
 
 void JsonWriter::UInt(std::optional<std::string_view> key, std::unsigned_integral auto value, JsonUIntOptions options)
 {
 	NextLine();
 	WriteKey(key);
-	_out << (options.hex ? std::format("\"0x{:0{}X}\"", value, options.hexZeroPad ? (sizeof(value) * 2) : 1) :
-						   std::format("{}", value));
+	if (options.hex)
+	{
+		Write("\"0x");
+		WriteHex(value, options.hexZeroPad ? (sizeof(value) * 2) : 1);
+		Write('"');
+	}
+	else
+	{
+		constexpr size_t maxSize = 24; // enough for UINT64_MAX
+		char* buff = Reserve(maxSize);
+		auto [ptr, ec] = std::to_chars(buff, buff + maxSize, value);
+		Commit(ptr);
+	}
 }
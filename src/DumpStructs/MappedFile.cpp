@@ -0,0 +1,125 @@
+#include "MappedFile.h"
+#if _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#if _WIN32
+bool MappedFile::Open(const char* path)
+{
+	Close();
+
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		Close();
+		return false;
+	}
+	_size = static_cast<size_t>(size.QuadPart);
+	if (_size == 0)
+	{
+		// empty files cannot be mapped
+		return true;
+	}
+
+	_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (_mapping == NULL)
+	{
+		Close();
+		return false;
+	}
+
+	_data = static_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (_data == nullptr)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (_data != nullptr)
+	{
+		UnmapViewOfFile(_data);
+	}
+	if (_mapping != nullptr)
+	{
+		CloseHandle(_mapping);
+	}
+	if (_file != nullptr)
+	{
+		CloseHandle(_file);
+	}
+	_data = nullptr;
+	_size = 0;
+	_mapping = nullptr;
+	_file = nullptr;
+}
+#else
+bool MappedFile::Open(const char* path)
+{
+	Close();
+
+	_fd = open(path, O_RDONLY);
+	if (_fd == -1)
+	{
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(_fd, &st) != 0)
+	{
+		Close();
+		return false;
+	}
+	_size = static_cast<size_t>(st.st_size);
+	if (_size == 0)
+	{
+		// empty files cannot be mapped
+		return true;
+	}
+
+	void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+	if (data == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+	madvise(data, _size, MADV_SEQUENTIAL);
+	_data = static_cast<const uint8_t*>(data);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (_data != nullptr)
+	{
+		munmap(const_cast<uint8_t*>(_data), _size);
+	}
+	if (_fd != -1)
+	{
+		close(_fd);
+	}
+	_data = nullptr;
+	_size = 0;
+	_fd = -1;
+}
+#endif
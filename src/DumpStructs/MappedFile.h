@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Read-only memory-mapped file.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const char* path);
+	void Close();
+
+	const uint8_t* Data() const { return _data; }
+	size_t Size() const { return _size; }
+	std::string_view Text() const { return { reinterpret_cast<const char*>(_data), _size }; }
+
+private:
+	const uint8_t* _data = nullptr;
+	size_t _size = 0;
+#if _WIN32
+	void* _file = nullptr;
+	void* _mapping = nullptr;
+#else
+	int _fd = -1;
+#endif
+};
@@ -0,0 +1,235 @@
+#include "MemorySnapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+bool MemoryReader::Read(uint64_t address, void* dest, size_t size)
+{
+	auto* out = static_cast<uint8_t*>(dest);
+	while (size > 0)
+	{
+		const auto view = View(address);
+		if (view.empty())
+		{
+			return false;
+		}
+
+		const size_t n = std::min(size, view.size());
+		std::memcpy(out, view.data(), n);
+		out += n;
+		address += n;
+		size -= n;
+	}
+	return true;
+}
+
+std::string_view MemoryReader::ReadString(uint64_t address)
+{
+	if (address == 0)
+	{
+		return {};
+	}
+
+	const auto view = View(address);
+	const auto* str = reinterpret_cast<const char*>(view.data());
+	const auto* end = static_cast<const char*>(std::memchr(str, '\0', view.size()));
+	return end != nullptr ? std::string_view{ str, static_cast<size_t>(end - str) } : std::string_view{};
+}
+
+bool MemorySnapshot::Load(std::span<const uint8_t> file)
+{
+	if (file.size() < sizeof(MemorySnapshotHeader))
+	{
+		return false;
+	}
+
+	std::memcpy(&_header, file.data(), sizeof(_header));
+	if (_header.magic != MemorySnapshotMagic || _header.version != MemorySnapshotVersion)
+	{
+		return false;
+	}
+
+	const size_t rangesOffset = sizeof(MemorySnapshotHeader);
+	const size_t annotationsOffset = rangesOffset + size_t{ _header.rangeCount } * sizeof(MemorySnapshotRange);
+	const size_t tablesEnd = annotationsOffset + size_t{ _header.annotationCount } * sizeof(MemorySnapshotAnnotation);
+	if (tablesEnd > file.size())
+	{
+		return false;
+	}
+
+	// the tables are 8-byte aligned in the file, and mapped files are page aligned
+	_file = file;
+	_ranges = { reinterpret_cast<const MemorySnapshotRange*>(file.data() + rangesOffset), _header.rangeCount };
+	_annotations = { reinterpret_cast<const MemorySnapshotAnnotation*>(file.data() + annotationsOffset), _header.annotationCount };
+
+	uint64_t prevEnd = 0;
+	for (auto& r : _ranges)
+	{
+		if (r.address < prevEnd || r.size == 0 || r.dataOffset > file.size() || file.size() - r.dataOffset < r.size)
+		{
+			return false;
+		}
+		prevEnd = r.address + r.size;
+	}
+
+	_cache.assign(CacheSize, {});
+	_lookups = 0;
+	_cacheMisses = 0;
+	return true;
+}
+
+std::string_view MemorySnapshot::Game() const
+{
+	const auto& game = _header.game;
+	return { game.data(), static_cast<size_t>(std::find(game.begin(), game.end(), '\0') - game.begin()) };
+}
+
+std::span<const uint8_t> MemorySnapshot::View(uint64_t address)
+{
+	_lookups++;
+	const uint64_t page = address >> PageShift;
+	auto& entry = _cache[page % CacheSize];
+	if (entry.page != page)
+	{
+		// first range that ends after the start of the page, the ones in the page follow it
+		_cacheMisses++;
+		const uint64_t pageStart = page << PageShift;
+		auto it = std::upper_bound(_ranges.begin(), _ranges.end(), pageStart, [](uint64_t a, const MemorySnapshotRange& r) { return a < r.address; });
+		if (it != _ranges.begin() && std::prev(it)->address + std::prev(it)->size > pageStart)
+		{
+			--it;
+		}
+		entry.page = page;
+		entry.range = static_cast<uint32_t>(it - _ranges.begin());
+	}
+
+	for (size_t i = entry.range; i < _ranges.size() && _ranges[i].address <= address; i++)
+	{
+		auto& r = _ranges[i];
+		if (address - r.address < r.size)
+		{
+			const uint64_t offset = address - r.address;
+			return _file.subspan(r.dataOffset + offset, r.size - offset);
+		}
+	}
+	return {};
+}
+
+std::optional<uint64_t> MemorySnapshot::FindAnnotation(uint64_t address, MemorySnapshotAnnotationKind kind) const
+{
+	auto it = std::lower_bound(_annotations.begin(), _annotations.end(), std::make_pair(address, kind),
+		[](const MemorySnapshotAnnotation& a, const auto& key) { return std::make_pair(a.address, a.kind) < key; });
+	if (it != _annotations.end() && it->address == address && it->kind == kind)
+	{
+		return it->value;
+	}
+	return std::nullopt;
+}
+
+MemorySnapshotWriter::MemorySnapshotWriter(std::string_view game, uint64_t imageBase, uint64_t root)
+{
+	_header.magic = MemorySnapshotMagic;
+	_header.version = MemorySnapshotVersion;
+	_header.pointerSize = sizeof(void*);
+	std::memcpy(_header.game.data(), game.data(), std::min(game.size(), _header.game.size()));
+	_header.imageBase = imageBase;
+	_header.root = root;
+}
+
+void MemorySnapshotWriter::AddRange(uint64_t address, std::span<const uint8_t> bytes)
+{
+	if (bytes.empty())
+	{
+		return;
+	}
+
+	uint64_t start = address;
+	uint64_t end = address + bytes.size();
+
+	// first range that may overlap or touch the new one
+	auto it = _ranges.upper_bound(start);
+	if (it != _ranges.begin())
+	{
+		auto prev = std::prev(it);
+		if (prev->first + prev->second.size() >= start)
+		{
+			it = prev;
+		}
+	}
+
+	if (it != _ranges.end() && it->first <= start && it->first + it->second.size() >= end)
+	{
+		// already fully captured, memory is not expected to change between captures
+		return;
+	}
+
+	// merge every range in [start, end] into a single one
+	while (it != _ranges.end() && it->first <= end)
+	{
+		start = std::min(start, it->first);
+		end = std::max(end, it->first + it->second.size());
+		++it;
+	}
+
+	std::vector<uint8_t> merged(end - start);
+	auto first = _ranges.lower_bound(start);
+	for (auto r = first; r != it; ++r)
+	{
+		std::memcpy(merged.data() + (r->first - start), r->second.data(), r->second.size());
+	}
+	std::memcpy(merged.data() + (address - start), bytes.data(), bytes.size());
+	_ranges.erase(first, it);
+	_ranges.emplace(start, std::move(merged));
+}
+
+void MemorySnapshotWriter::AddAnnotation(uint64_t address, MemorySnapshotAnnotationKind kind, uint64_t value)
+{
+	_annotations.push_back({ address, kind, 0, value });
+}
+
+size_t MemorySnapshotWriter::ByteCount() const
+{
+	size_t count = 0;
+	for (auto& [address, bytes] : _ranges)
+	{
+		count += bytes.size();
+	}
+	return count;
+}
+
+bool MemorySnapshotWriter::Save(const std::string& path) const
+{
+	auto annotations = _annotations;
+	std::sort(annotations.begin(), annotations.end(),
+		[](auto& a, auto& b) { return std::make_pair(a.address, a.kind) < std::make_pair(b.address, b.kind); });
+	annotations.erase(std::unique(annotations.begin(), annotations.end(),
+		[](auto& a, auto& b) { return a.address == b.address && a.kind == b.kind; }), annotations.end());
+
+	auto header = _header;
+	header.rangeCount = static_cast<uint32_t>(_ranges.size());
+	header.annotationCount = static_cast<uint32_t>(annotations.size());
+
+	std::vector<MemorySnapshotRange> ranges;
+	ranges.reserve(_ranges.size());
+	uint64_t dataOffset = sizeof(header) + _ranges.size() * sizeof(MemorySnapshotRange) + annotations.size() * sizeof(MemorySnapshotAnnotation);
+	for (auto& [address, bytes] : _ranges)
+	{
+		ranges.push_back({ address, bytes.size(), dataOffset });
+		dataOffset += bytes.size();
+	}
+
+	std::ofstream out{ path, std::ios::out | std::ios::binary | std::ios::trunc };
+	if (!out)
+	{
+		return false;
+	}
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(ranges.data()), ranges.size() * sizeof(MemorySnapshotRange));
+	out.write(reinterpret_cast<const char*>(annotations.data()), annotations.size() * sizeof(MemorySnapshotAnnotation));
+	for (auto& [address, bytes] : _ranges)
+	{
+		out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	}
+	return static_cast<bool>(out);
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Snapshot of the parts of the game memory used by the parser metadata, so it can be walked without the game running (see
+// ParWalker.h). File layout, little-endian:
+//
+//   MemorySnapshotHeader
+//   MemorySnapshotRange[rangeCount]           sorted by address, not overlapping
+//   MemorySnapshotAnnotation[annotationCount] sorted by address and kind
+//   bytes of each range, at its dataOffset
+//
+// Annotations hold what can only be known by calling into game code, e.g. the result of parMember::GetSize.
+constexpr uint32_t MemorySnapshotMagic = 0x504E5350; // 'PSNP'
+constexpr uint16_t MemorySnapshotVersion = 1;
+
+enum class MemorySnapshotAnnotationKind : uint32_t
+{
+	MemberSize = 0,          // parMember::GetSize() of the parMember at the address
+	MemberAlign = 1,         // parMember::FindAlign()
+	StructureAlign = 2,      // parStructure::FindAlign()
+	StructureStaticData = 3, // address of the parStructureStaticData the parStructure was built from
+	GameBuild = 4,           // at address 0, the executable version as major << 48 | minor << 32 | build << 16 | revision
+};
+
+struct MemorySnapshotHeader
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t pointerSize;
+	std::array<char, 8> game; // same names as the DumpTools game argument, zero padded
+	uint64_t imageBase;       // to turn function pointers into RVAs
+	uint64_t root;            // address of the parManager
+	uint32_t rangeCount;
+	uint32_t annotationCount;
+};
+
+struct MemorySnapshotRange
+{
+	uint64_t address;
+	uint64_t size;
+	uint64_t dataOffset; // from the start of the file
+};
+
+struct MemorySnapshotAnnotation
+{
+	uint64_t address;
+	MemorySnapshotAnnotationKind kind;
+	uint32_t padding;
+	uint64_t value;
+};
+
+static_assert(sizeof(MemorySnapshotHeader) == 40);
+static_assert(sizeof(MemorySnapshotRange) == 24);
+static_assert(sizeof(MemorySnapshotAnnotation) == 24);
+
+// Reads memory of another address space, the game process or a snapshot of it.
+class MemoryReader
+{
+public:
+	virtual ~MemoryReader() = default;
+
+	// Bytes available from `address` up to the end of the contiguous memory that contains it, empty if the address is
+	// not available.
+	virtual std::span<const uint8_t> View(uint64_t address) = 0;
+
+	// Copies `size` bytes starting at `address`, spanning adjacent ranges if needed. Returns false if any byte is missing.
+	bool Read(uint64_t address, void* dest, size_t size);
+
+	template<class T>
+	std::optional<T> Read(uint64_t address)
+	{
+		T value;
+		return Read(address, &value, sizeof(T)) ? std::make_optional(value) : std::nullopt;
+	}
+
+	// Null-terminated string at the address, without copying it. Empty if the address is null or the terminator is not
+	// available.
+	std::string_view ReadString(uint64_t address);
+};
+
+// MemoryReader over a snapshot file already loaded in memory (e.g. a MappedFile), which must outlive it. A small direct-mapped
+// cache remembers the first range of recently used pages, so most lookups skip the binary search over all the ranges: reads
+// while walking the metadata tend to be close to the previous ones.
+class MemorySnapshot : public MemoryReader
+{
+public:
+	// Checks the header and tables. The file is not copied.
+	bool Load(std::span<const uint8_t> file);
+
+	const MemorySnapshotHeader& Header() const { return _header; }
+	std::string_view Game() const;
+	std::span<const MemorySnapshotRange> Ranges() const { return _ranges; }
+
+	std::span<const uint8_t> View(uint64_t address) override;
+
+	std::optional<uint64_t> FindAnnotation(uint64_t address, MemorySnapshotAnnotationKind kind) const;
+
+	size_t Lookups() const { return _lookups; }
+	size_t CacheMisses() const { return _cacheMisses; }
+
+private:
+	static constexpr size_t PageShift = 12;
+	static constexpr size_t CacheSize = 1024;
+
+	struct CacheEntry
+	{
+		uint64_t page = UINT64_MAX;
+		uint32_t range = 0; // first range that ends after the start of the page
+	};
+
+	std::span<const uint8_t> _file;
+	MemorySnapshotHeader _header{};
+	std::span<const MemorySnapshotRange> _ranges;
+	std::span<const MemorySnapshotAnnotation> _annotations;
+	std::vector<CacheEntry> _cache;
+	size_t _lookups = 0;
+	size_t _cacheMisses = 0;
+};
+
+// Builds a snapshot file. Ranges can be added in any order and may overlap, they are merged when saved.
+class MemorySnapshotWriter
+{
+public:
+	MemorySnapshotWriter(std::string_view game, uint64_t imageBase, uint64_t root);
+
+	void AddRange(uint64_t address, std::span<const uint8_t> bytes);
+	void AddAnnotation(uint64_t address, MemorySnapshotAnnotationKind kind, uint64_t value);
+
+	size_t RangeCount() const { return _ranges.size(); }
+	size_t ByteCount() const;
+
+	bool Save(const std::string& path) const;
+
+private:
+	MemorySnapshotHeader _header{};
+	std::map<uint64_t, std::vector<uint8_t>> _ranges; // by start address, merged when they overlap or touch
+	std::vector<MemorySnapshotAnnotation> _annotations;
+};
@@ -0,0 +1,270 @@
+#include "NameRegistry.h"
+#include "MappedFile.h"
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+static constexpr std::array<char, 8> name_index_magic{ 'D', 'S', 'N', 'A', 'M', 'E', 'S', '\0' };
+static constexpr uint32_t name_index_version = 1;
+
+struct NameIndexHeader
+{
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t slotCount;
+	uint32_t nameCount;
+	uint32_t charCount;
+	uint64_t duplicates;
+	uint64_t dictionarySize;  // of the dictionary.txt the index was built from
+	int64_t dictionaryTime;   // last write time of the dictionary.txt, in file clock ticks
+};
+
+// Identifies the version of a dictionary.txt, false if it does not exist.
+static bool GetDictionaryStamp(const std::string& dictionaryPath, uint64_t& size, int64_t& time)
+{
+	std::error_code ec;
+	size = std::filesystem::file_size(dictionaryPath, ec);
+	if (ec)
+	{
+		return false;
+	}
+	time = std::filesystem::last_write_time(dictionaryPath, ec).time_since_epoch().count();
+	return !ec;
+}
+
+bool NameDictionary::Load(const std::string& filePath)
+{
+	MappedFile file;
+	if (!file.Open(filePath.c_str()))
+	{
+		return false;
+	}
+
+	AddLines(file.Text());
+	return true;
+}
+
+void NameDictionary::AddLines(std::string_view text)
+{
+	// hashed in batches so JoaatBatch can fill its lanes, small enough to stay in the cache
+	constexpr size_t batch_size = 256;
+	std::array<std::string_view, batch_size> lines;
+	std::array<uint32_t, batch_size> hashes;
+	size_t count = 0;
+	const auto flush = [&]
+	{
+		JoaatBatch({ lines.data(), count }, { hashes.data(), count });
+		for (size_t i = 0; i < count; i++)
+		{
+			Insert(lines[i], hashes[i]);
+		}
+		count = 0;
+	};
+
+	constexpr std::string_view whitespace = " \t\r\n";
+	while (!text.empty())
+	{
+		const size_t end = text.find('\n');
+		std::string_view line = text.substr(0, end);
+		text = end != std::string_view::npos ? text.substr(end + 1) : std::string_view{};
+
+		const size_t first = line.find_first_not_of(whitespace);
+		if (first == std::string_view::npos)
+		{
+			continue;
+		}
+		lines[count++] = line.substr(first, line.find_last_not_of(whitespace) - first + 1);
+		if (count == batch_size)
+		{
+			flush();
+		}
+	}
+	flush();
+}
+
+bool NameDictionary::Add(std::string_view name)
+{
+	return Insert(name, joaat(name));
+}
+
+bool NameDictionary::Insert(std::string_view name, uint32_t hash)
+{
+	// keep the load factor under 1/2 so probe sequences stay short
+	if ((Count() + 1) * 2 > _slots.size())
+	{
+		Grow();
+	}
+
+	const size_t mask = _slots.size() - 1;
+	for (size_t i = SlotIndex(hash);; i = (i + 1) & mask)
+	{
+		auto& slot = _slots[i];
+		if (slot.name == 0)
+		{
+			_chars.append(name);
+			_offsets.push_back(static_cast<uint32_t>(_chars.size()));
+			slot = { hash, static_cast<uint32_t>(Count()) };
+			return true;
+		}
+
+		if (slot.hash == hash)
+		{
+			const auto existing = Name(slot.name - 1);
+			if (existing == name)
+			{
+				_duplicates++;
+			}
+			else
+			{
+				_collisions.push_back({ hash, _collisionNames.Copy(existing), _collisionNames.Copy(name) });
+			}
+			return false;
+		}
+	}
+}
+
+std::string_view NameDictionary::Find(uint32_t hash) const
+{
+	if (_slots.empty())
+	{
+		return {};
+	}
+
+	const size_t mask = _slots.size() - 1;
+	for (size_t i = SlotIndex(hash);; i = (i + 1) & mask)
+	{
+		const auto& slot = _slots[i];
+		if (slot.name == 0)
+		{
+			return {};
+		}
+
+		if (slot.hash == hash)
+		{
+			return Name(slot.name - 1);
+		}
+	}
+}
+
+void NameDictionary::Grow()
+{
+	std::vector<Slot> oldSlots = std::move(_slots);
+	const size_t newSize = oldSlots.empty() ? 1024 : oldSlots.size() * 2;
+	_slots.assign(newSize, Slot{});
+	_shift = 32 - std::countr_zero(newSize);
+
+	const size_t mask = newSize - 1;
+	for (const auto& slot : oldSlots)
+	{
+		if (slot.name == 0)
+		{
+			continue;
+		}
+
+		size_t i = SlotIndex(slot.hash);
+		while (_slots[i].name != 0)
+		{
+			i = (i + 1) & mask;
+		}
+		_slots[i] = slot;
+	}
+}
+
+void NameDictionary::Clear()
+{
+	_slots.clear();
+	_shift = 32;
+	_offsets.assign(1, 0);
+	_chars.clear();
+	_duplicates = 0;
+	_collisions.clear();
+	_collisionNames.Release();
+}
+
+NameIndexLoadResult NameDictionary::LoadIndex(const std::string& indexPath, const std::string& dictionaryPath)
+{
+	Clear();
+
+	MappedFile file;
+	if (!file.Open(indexPath.c_str()))
+	{
+		return NameIndexLoadResult::Missing;
+	}
+
+	NameIndexHeader header;
+	if (file.Size() < sizeof(header))
+	{
+		return NameIndexLoadResult::Corrupt;
+	}
+	std::memcpy(&header, file.Data(), sizeof(header));
+
+	const uint64_t slotsSize = uint64_t{ header.slotCount } * sizeof(Slot);
+	const uint64_t offsetsSize = (uint64_t{ header.nameCount } + 1) * sizeof(uint32_t);
+	if (header.magic != name_index_magic || header.version != name_index_version ||
+		!std::has_single_bit(header.slotCount) || header.slotCount < 1024 || header.nameCount * uint64_t{ 2 } > header.slotCount ||
+		file.Size() != sizeof(header) + slotsSize + offsetsSize + header.charCount)
+	{
+		return NameIndexLoadResult::Corrupt;
+	}
+
+	uint64_t dictionarySize;
+	int64_t dictionaryTime;
+	if (!GetDictionaryStamp(dictionaryPath, dictionarySize, dictionaryTime) ||
+		dictionarySize != header.dictionarySize || dictionaryTime != header.dictionaryTime)
+	{
+		return NameIndexLoadResult::Stale;
+	}
+
+	const uint8_t* data = file.Data() + sizeof(header);
+	_slots.resize(header.slotCount);
+	std::memcpy(_slots.data(), data, slotsSize);
+	data += slotsSize;
+	_offsets.resize(header.nameCount + size_t{ 1 });
+	std::memcpy(_offsets.data(), data, offsetsSize);
+	data += offsetsSize;
+	_chars.assign(reinterpret_cast<const char*>(data), header.charCount);
+
+	// the lookups trust the slots and offsets, check them once here
+	bool valid = _offsets.front() == 0 && _offsets.back() == header.charCount;
+	for (size_t i = 1; i < _offsets.size() && valid; i++)
+	{
+		valid = _offsets[i - 1] <= _offsets[i];
+	}
+	for (const auto& slot : _slots)
+	{
+		valid = valid && slot.name <= header.nameCount;
+	}
+	if (!valid)
+	{
+		Clear();
+		return NameIndexLoadResult::Corrupt;
+	}
+
+	_shift = 32 - std::countr_zero(header.slotCount);
+	_duplicates = static_cast<size_t>(header.duplicates);
+	return NameIndexLoadResult::Loaded;
+}
+
+bool NameDictionary::SaveIndex(const std::string& indexPath, const std::string& dictionaryPath) const
+{
+	NameIndexHeader header{};
+	if (_slots.empty() || !GetDictionaryStamp(dictionaryPath, header.dictionarySize, header.dictionaryTime))
+	{
+		return false;
+	}
+
+	header.magic = name_index_magic;
+	header.version = name_index_version;
+	header.slotCount = static_cast<uint32_t>(_slots.size());
+	header.nameCount = static_cast<uint32_t>(Count());
+	header.charCount = static_cast<uint32_t>(_chars.size());
+	header.duplicates = _duplicates;
+
+	std::ofstream out{ indexPath, std::ios::out | std::ios::binary | std::ios::trunc };
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(_slots.data()), _slots.size() * sizeof(Slot));
+	out.write(reinterpret_cast<const char*>(_offsets.data()), _offsets.size() * sizeof(uint32_t));
+	out.write(_chars.data(), _chars.size());
+	return out.good();
+}
@@ -0,0 +1,216 @@
+#pragma once
+#include "Joaat.h"
+#include "ScratchArena.h"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Turns the JOAAT hashes found in the parser metadata back into names. Names known when building are in StaticNameTables,
+// perfect hash tables built at compile time, and names only known at runtime are loaded from a dictionary.txt (see
+// dumps/README.md) into a NameDictionary. NameRegistry looks up a hash in both.
+
+struct KnownName
+{
+	std::string_view key;  // hashed with joaat()
+	std::string_view name; // what the hash resolves to, may differ from the key (e.g. in casing)
+};
+
+struct StaticNameSlot
+{
+	uint32_t hash;
+	std::string_view name; // empty if the slot is unused
+};
+
+constexpr size_t StaticNameSlotIndex(uint32_t hash, uint32_t seed, uint32_t shift)
+{
+	return static_cast<uint32_t>((hash ^ seed) * 0x9E3779B1u) >> shift;
+}
+
+// Non-template view of a StaticNameTable, so tables of different sizes can be layered in a NameRegistry.
+struct StaticNameLayer
+{
+	std::span<const StaticNameSlot> slots;
+	uint32_t seed;
+	uint32_t shift;
+
+	constexpr std::string_view Find(uint32_t hash) const
+	{
+		const auto& slot = slots[StaticNameSlotIndex(hash, seed, shift)];
+		return slot.hash == hash ? slot.name : std::string_view{};
+	}
+};
+
+void StaticNameTableHasNoPerfectHash(); // not constexpr, calling it from StaticNameTable fails the build
+
+// Perfect hash table of names known at compile time: each hash maps to its own slot, a lookup is a multiply, a shift and a
+// compare. The seed of the slot function is searched when the table is built.
+template<size_t N>
+class StaticNameTable
+{
+public:
+	static constexpr size_t SlotCount = std::bit_ceil(N * 4);
+
+	consteval StaticNameTable(const KnownName (&names)[N])
+	{
+		constexpr uint32_t shift = 32 - std::countr_zero(SlotCount);
+		for (uint32_t seed = 0; seed < 0x10000; seed++)
+		{
+			std::array<StaticNameSlot, SlotCount> slots{};
+			bool perfect = true;
+			for (size_t i = 0; i < N && perfect; i++)
+			{
+				const uint32_t hash = joaat(names[i].key);
+				auto& slot = slots[StaticNameSlotIndex(hash, seed, shift)];
+				perfect = slot.name.empty();
+				slot = { hash, names[i].name };
+			}
+
+			if (perfect)
+			{
+				_slots = slots;
+				_seed = seed;
+				_shift = shift;
+				return;
+			}
+		}
+
+		// also reached if two keys have the same hash
+		StaticNameTableHasNoPerfectHash();
+	}
+
+	constexpr std::string_view Find(uint32_t hash) const { return Layer().Find(hash); }
+
+	constexpr StaticNameLayer Layer() const { return { _slots, _seed, _shift }; }
+
+private:
+	std::array<StaticNameSlot, SlotCount> _slots{};
+	uint32_t _seed = 0;
+	uint32_t _shift = 0;
+};
+
+// Keys of parStructure::callbacks (hashed in lowercase) and the names written in the dumps.
+constexpr KnownName par_callback_known_names[]
+{
+	{ "preloadfast", "PreLoadFast" },
+	{ "preload", "PreLoad" },
+	{ "postload", "PostLoad" },
+	{ "presave", "PreSave" },
+	{ "postsave", "PostSave" },
+	{ "removefromstore", "RemoveFromStore" },
+	{ "preset", "PreSet" },
+	{ "postset", "PostSet" },
+	{ "presetfast", "PreSetFast" },
+	{ "postsetfast", "PostSetFast" },
+	{ "postpsoplace", "PostPsoPlace" },
+	{ "visitor", "Visitor" },
+};
+constexpr StaticNameTable par_callback_names{ par_callback_known_names };
+static_assert(par_callback_names.Find(joaat_literal("postpsoplace")) == "PostPsoPlace");
+static_assert(par_callback_names.Find(joaat_literal("PostPsoPlace")).empty());
+
+// Two different names of a dictionary with the same hash.
+struct NameCollision
+{
+	uint32_t hash;
+	std::string_view kept;    // the first one, what the hash resolves to
+	std::string_view dropped;
+};
+
+enum class NameIndexLoadResult
+{
+	Loaded,
+	Missing, // the index does not exist
+	Stale,   // the index was built from a different version of the dictionary
+	Corrupt, // the index could not be parsed
+};
+
+// Names loaded at runtime, in an open-addressing hash table keyed by their hash. The slots only hold the hash and the index
+// of the name so a probe touches a single cache line, and the names are stored back to back in a single buffer.
+//
+// Loading a large dictionary.txt is mostly hashing, so the lines are hashed in batches with JoaatBatch. The table can also be
+// saved as a binary index next to the dictionary, which later loads with a few reads instead of hashing every line again:
+//
+//   NameIndexHeader
+//   Slot slots[slotCount]
+//   uint32_t offsets[nameCount + 1] // of each name in chars, the last one is the end of the last name
+//   char chars[charCount]
+//
+// The index remembers the size and modification time of the dictionary it was built from, to tell when it is stale.
+class NameDictionary
+{
+public:
+	// Adds each line of a dictionary.txt file, see AddLines. Returns false if the file could not be read.
+	bool Load(const std::string& filePath);
+	// Adds each line of the text, ignoring surrounding whitespace and empty lines.
+	void AddLines(std::string_view text);
+	// Returns false if a name with the same hash was already added, in which case the first one is kept (like
+	// DumpFormatter's dictionary does).
+	bool Add(std::string_view name);
+
+	// Replaces the names with those of the index, if it was built from the current version of `dictionaryPath`. If the index
+	// is missing, stale or corrupt, the dictionary is left empty. Collisions are only known when loading from text.
+	NameIndexLoadResult LoadIndex(const std::string& indexPath, const std::string& dictionaryPath);
+	bool SaveIndex(const std::string& indexPath, const std::string& dictionaryPath) const;
+
+	// Empty if the hash is not known. Valid until the next name is added.
+	std::string_view Find(uint32_t hash) const;
+
+	size_t Count() const { return _offsets.size() - 1; }
+	// Names added more than once.
+	size_t Duplicates() const { return _duplicates; }
+	// Names not added because a different name had the same hash.
+	std::span<const NameCollision> Collisions() const { return _collisions; }
+
+private:
+	struct Slot
+	{
+		uint32_t hash = 0;
+		uint32_t name = 0; // index in _offsets plus one, 0 if the slot is unused
+	};
+
+	void Clear();
+	bool Insert(std::string_view name, uint32_t hash);
+	void Grow();
+	size_t SlotIndex(uint32_t hash) const { return StaticNameSlotIndex(hash, 0, _shift); }
+	std::string_view Name(uint32_t index) const { return { _chars.data() + _offsets[index], _offsets[index + 1] - _offsets[index] }; }
+
+	std::vector<Slot> _slots;
+	uint32_t _shift = 32;
+	std::vector<uint32_t> _offsets{ 0 };
+	std::string _chars;
+	size_t _duplicates = 0;
+	std::vector<NameCollision> _collisions;
+	ScratchArena _collisionNames{ 1024 };
+};
+
+// Looks up a hash in the static tables, in the order they were added, and then in the dictionary.
+class NameRegistry
+{
+public:
+	void AddKnownNames(StaticNameLayer layer) { _known.push_back(layer); }
+
+	NameDictionary& Dictionary() { return _dictionary; }
+	const NameDictionary& Dictionary() const { return _dictionary; }
+
+	// Empty if the hash is not known.
+	std::string_view Find(uint32_t hash) const
+	{
+		for (auto& layer : _known)
+		{
+			if (auto name = layer.Find(hash); !name.empty())
+			{
+				return name;
+			}
+		}
+		return _dictionary.Find(hash);
+	}
+
+private:
+	std::vector<StaticNameLayer> _known;
+	NameDictionary _dictionary;
+};
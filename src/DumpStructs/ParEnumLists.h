@@ -0,0 +1,149 @@
+#pragma once
+#include "EnumNames.h"
+
+// Lists of the rage.h enums written to the dumps (see EnumNames.h), for both 64-bit games. They are kept apart from rage.h
+// so code that handles the games at runtime (e.g. DumpTools) can build the name tables of each one; rage.h picks the lists
+// of the game being built. Lists that differ between the games have a _GTA5 and a _RDR3 version, GTA5G9 uses the GTA5 ones.
+
+#define PAR_ATTRIBUTE_TYPES(X) \
+	X(String, 0) \
+	X(Int64, 1) \
+	X(Double, 2) \
+	X(Bool, 3)
+
+// 0x1CA39C3D
+#define PAR_MEMBER_TYPES_GTA5(X) \
+	X(BOOL, 0) \
+	X(CHAR, 1) \
+	X(UCHAR, 2) \
+	X(SHORT, 3) \
+	X(USHORT, 4) \
+	X(INT, 5) \
+	X(UINT, 6) \
+	X(FLOAT, 7) \
+	X(VECTOR2, 8) \
+	X(VECTOR3, 9) \
+	X(VECTOR4, 10) \
+	X(STRING, 11) \
+	X(STRUCT, 12) \
+	X(ARRAY, 13) \
+	X(ENUM, 14) \
+	X(BITSET, 15) \
+	X(MAP, 16) \
+	X(MATRIX34, 17) \
+	X(MATRIX44, 18) \
+	X(VEC2V, 19) \
+	X(VEC3V, 20) \
+	X(VEC4V, 21) \
+	X(MAT33V, 22) \
+	X(MAT34V, 23) \
+	X(MAT44V, 24) \
+	X(SCALARV, 25) \
+	X(BOOLV, 26) \
+	X(VECBOOLV, 27) \
+	X(PTRDIFFT, 28) \
+	X(SIZET, 29) \
+	X(FLOAT16, 30) \
+	X(INT64, 31) \
+	X(UINT64, 32) \
+	X(DOUBLE, 33)
+#define PAR_MEMBER_TYPES_RDR3(X) \
+	PAR_MEMBER_TYPES_GTA5(X) \
+	X(GUID, 34) \
+	X(VEC2F, 35) \
+	X(QUATV, 36)
+
+// these don't seem to be used while parsing, probably used by internal engine tools
+#define PAR_MEMBER_COMMON_SUBTYPES_GTA5(X) \
+	X(COLOR, 1) /* used with UINT */
+#define PAR_MEMBER_COMMON_SUBTYPES_RDR3(X) \
+	X(COLOR, 1) /* used with UINT, VECTOR3 */ \
+	X(ANGLE, 2) /* used with FLOAT */
+
+// 0xADE25B1B
+#define PAR_MEMBER_ARRAY_SUBTYPES(X) \
+	X(ATARRAY, 0)                       /* 0xABE40192 */ \
+	X(ATFIXEDARRAY, 1)                  /* 0x3A523E81 */ \
+	X(ATRANGEARRAY, 2)                  /* 0x18A25B6B */ \
+	X(POINTER, 3)                       /* 0x47073D6E */ \
+	X(MEMBER, 4)                        /* 0x6CC11BB4 */ \
+	X(_0x2087BB00, 5)                   /* 0x2087BB00 - 32-bit atArray */ \
+	X(POINTER_WITH_COUNT, 6)            /* 0xE2980EB5 */ \
+	X(POINTER_WITH_COUNT_8BIT_IDX, 7)   /* 0x254D33B1 */ \
+	X(POINTER_WITH_COUNT_16BIT_IDX, 8)  /* 0xB66B6752 */ \
+	X(VIRTUAL, 9)                       /* 0xAC01A1DC */
+
+// 0x2721C60A
+#define PAR_MEMBER_ENUM_SUBTYPES_GTA5(X) \
+	X(_32BIT, 0)        /* 0xAF085554 */ \
+	X(_16BIT, 1)        /* 0x0D502D8E */ \
+	X(_8BIT, 2)         /* 0xF2AAF53D */
+#define PAR_MEMBER_ENUM_SUBTYPES_RDR3(X) \
+	X(_64BIT, 0) \
+	X(_32BIT, 1) \
+	X(_16BIT, 2) \
+	X(_8BIT, 3)
+
+#define PAR_MEMBER_BITSET_SUBTYPES_GTA5(X) \
+	X(_32BIT, 0)        /* 0xAF085554 */ \
+	X(_16BIT, 1)        /* 0x0D502D8E */ \
+	X(_8BIT, 2)         /* 0xF2AAF53D */ \
+	X(ATBITSET, 3)      /* 0xB46B5F65 */
+#define PAR_MEMBER_BITSET_SUBTYPES_RDR3(X) \
+	X(_32BIT, 0)        /* 0x4A4F3BEC */ \
+	X(_16BIT, 1)        /* 0x16434158 */ \
+	X(_8BIT, 2)         /* 0x2EFEF517 */ \
+	X(ATBITSET, 3)      /* 0xB46B5F65 */ \
+	X(_64BIT, 4)        /* 0x3BB5B764 */
+
+// 0x9C9F1983
+#define PAR_MEMBER_MAP_SUBTYPES(X) \
+	X(ATMAP, 0)         /* 0xD8C10171 */ \
+	X(ATBINARYMAP, 1)   /* 0x6560BA79 */
+
+// 0xA5CF41A9
+#define PAR_MEMBER_STRING_SUBTYPES_GTA5(X) \
+	X(MEMBER, 0)                /* 0x6CC11BB4 */ \
+	X(POINTER, 1)               /* 0x47073D6E */ \
+	X(CONST_STRING, 2)          /* 0x757C1B9B */ \
+	X(ATSTRING, 3)              /* 0x5CDCA61E */ \
+	X(WIDE_MEMBER, 4)           /* 0xAC508104 */ \
+	X(WIDE_POINTER, 5)          /* 0x99D4A8CD */ \
+	X(ATWIDESTRING, 6)          /* 0x3DED5509 */ \
+	X(ATNONFINALHASHSTRING, 7)  /* 0xDFE6E4AF */ \
+	X(ATFINALHASHSTRING, 8)     /* 0x945E5945 */ \
+	X(ATHASHVALUE, 9)           /* 0xBD3CD157 */ \
+	X(ATPARTIALHASHVALUE, 10)   /* 0xD552B3C8 */ \
+	X(ATNSHASHSTRING, 11)       /* 0x893F9F69 */ \
+	X(ATNSHASHVALUE, 12)        /* 0x3767C917 */
+#define PAR_MEMBER_STRING_SUBTYPES_RDR3(X) \
+	PAR_MEMBER_STRING_SUBTYPES_GTA5(X) \
+	X(ATHASHVALUE16U, 13)       /* 0xE8282E2F */
+
+// 0x76214E40
+#define PAR_MEMBER_STRUCT_SUBTYPES(X) \
+	X(STRUCTURE, 0)                 /* 0x3AC3050F */ \
+	X(EXTERNAL_NAMED, 1)            /* 0xA53F8BA9 */ \
+	X(EXTERNAL_NAMED_USERNULL, 2)   /* 0x2DED4C19 */ \
+	X(POINTER, 3)                   /* 0x47073D6E */ \
+	X(SIMPLE_POINTER, 4)            /* 0x67466543 */
+
+// 0xA73F91EB, RDR3 only
+#define PAR_MEMBER_GUID_SUBTYPES(X) \
+	X(_0xDF7EBE85, 0) /* 0xDF7EBE85 */
+
+#define PAR_MEMBER_ARRAY_ALLOC_FLAGS(X) \
+	X(USE_PHYSICAL_ALLOCATOR, 1 << 0)
+
+#define PAR_STRUCTURE_FLAGS(X) \
+	X(_0xB9C5D274, 1 << 0) /* 0xB9C5D274 - related to alignment. If set, parStructure::FindAlign() starts calculating the alignment with 8, otherwise with 1 */ \
+	X(HAS_NAMES, 1 << 1) /* 0x47AF4932 */ \
+	X(ALWAYS_HAS_NAMES, 1 << 2) /* 0x9804A870 */ \
+	X(_0x25CB183C, 1 << 3) /* 0x25CB183C */ \
+	X(_0x62BE3669, 1 << 4) /* 0x62BE3669 - set when parCguStructure::SetFactories() is called */ \
+	X(_0x22A1FBDB, 1 << 5) /* 0x22A1FBDB */
+
+#define PAR_ENUM_FLAGS(X) \
+	X(ENUM_STATIC, 1 << 0) /* 0x83E077B4 */ \
+	X(ENUM_HAS_NAMES, 1 << 1) /* 0x4725AEB1 */ \
+	X(ENUM_ALWAYS_HAS_NAMES, 1 << 2) /* 0x0227ED1D */
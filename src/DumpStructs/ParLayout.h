@@ -0,0 +1,252 @@
+#pragma once
+#include "ParEnumLists.h"
+#include <cstdint>
+#include <string_view>
+
+// Offsets and sizes of the rage.h structures, for code that reads them out of process (see ParWalker.h) and so can't use the
+// definitions of a single game. rage.cpp checks the table of the game being built against rage.h, any change to those
+// structures must be reflected here too.
+struct ParLayout
+{
+	// parManager
+	uint32_t managerStructures;     // atMap<uint32_t, parStructure*>
+	// atMap
+	uint32_t mapNumBuckets;
+	uint32_t mapCountSize;          // size of NumBuckets/NumEntries
+	uint32_t mapEntryValue;
+	uint32_t mapEntryNext;
+	uint32_t mapEntrySize;
+
+	// parStructure
+	uint32_t structureSize;
+	uint32_t structureName;
+	uint32_t structureBase;
+	uint32_t structureBaseOffset;
+	uint32_t structureStructureSize;
+	uint32_t structureFlags;
+	uint32_t structureFlagsSize;
+	uint32_t structureAlign;
+	uint32_t structureVersionMajor;
+	uint32_t structureVersionMinor;
+	uint32_t structureMembers;      // atArray<parMember*>
+	uint32_t structureExtraAttributes;
+	uint32_t structureFactoryNew;   // parDelegateHolderBase, the function pointer is the second field
+	uint32_t structureFactoryPlacementNew;
+	uint32_t structureGetStructureCB;
+	uint32_t structureFactoryDelete;
+	uint32_t structureCallbacks;    // atBinaryMap<uint32_t, parDelegateHolderBase*>
+
+	// parMember, parMemberArray, parMemberMap
+	uint32_t memberData;
+	uint32_t memberArrayItem;
+	uint32_t memberMapKey;
+	uint32_t memberMapValue;
+
+	// parMemberCommonData and derived types
+	uint32_t dataSize;              // sizeof(parMemberCommonData)
+	uint32_t dataOffset;
+	uint32_t dataType;
+	uint32_t dataSubType;
+	uint32_t dataFlags1;
+	uint32_t dataFlags2;
+	uint32_t dataExtraData;
+	uint32_t dataAttributes;
+	uint32_t dataStructStructure;   // parMemberStructData::structure
+	uint32_t dataStructExternalNamedResolve;
+	uint32_t dataStructExternalNamedGetName;
+	uint32_t dataStructAllocateStruct;
+	uint32_t dataEnumInitValue;
+	uint32_t dataEnumInitValueSize;
+	uint32_t dataEnumEnumData;
+	uint32_t dataArraySize;         // parMemberArrayData::arraySize/countOffset
+	uint32_t dataStringMemberSize;
+	uint32_t dataMapCreateIterator; // parDelegateHolderBase*
+	uint32_t dataMapCreateInterface;
+	uint32_t dataSimpleInitValue;   // float or double, the same size as the enum init value
+	uint32_t dataInitValues;        // parMemberVectorData/parMemberMatrixData::initValues, float[4] or float[16]
+
+	// parAttributeList, parAttribute
+	uint32_t attributeListSize;
+	uint32_t attributeListUserData1;
+	uint32_t attributeListUserData2;
+	uint32_t attributeSize;
+	uint32_t attributeValue;
+	uint32_t attributeType;
+
+	// parEnumData, parEnumValueData
+	uint32_t enumSize;
+	uint32_t enumValueNames;
+	uint32_t enumValueCount;
+	uint32_t enumFlags;
+	uint32_t enumName;
+	uint32_t enumValueSize;
+	uint32_t enumValueValue;
+
+	// parStructureStaticData
+	uint32_t staticDataNameStr;
+	uint32_t staticDataMemberNames;
+};
+
+// parMemberType of all the games with this layout, the types added by RDR3 come after the GTA5 ones
+enum class ParLayoutMemberType : uint8_t
+{
+	PAR_MEMBER_TYPES_RDR3(ENUM_DEFINE_VALUE)
+};
+
+constexpr ParLayout gta5_par_layout
+{
+	.managerStructures = 0x30,
+	.mapNumBuckets = 0x8,
+	.mapCountSize = 2,
+	.mapEntryValue = 0x8,
+	.mapEntryNext = 0x10,
+	.mapEntrySize = 0x18,
+
+	.structureSize = 0xA0,
+	.structureName = 0x8,
+	.structureBase = 0x10,
+	.structureBaseOffset = 0x18,
+	.structureStructureSize = 0x20,
+	.structureFlags = 0x28,
+	.structureFlagsSize = 2,
+	.structureAlign = 0x2A,
+	.structureVersionMajor = 0x2C,
+	.structureVersionMinor = 0x2E,
+	.structureMembers = 0x30,
+	.structureExtraAttributes = 0x40,
+	.structureFactoryNew = 0x48,
+	.structureFactoryPlacementNew = 0x58,
+	.structureGetStructureCB = 0x68,
+	.structureFactoryDelete = 0x78,
+	.structureCallbacks = 0x88,
+
+	.memberData = 0x8,
+	.memberArrayItem = 0x10,
+	.memberMapKey = 0x10,
+	.memberMapValue = 0x18,
+
+	.dataSize = 0x20,
+	.dataOffset = 0x8,
+	.dataType = 0x10,
+	.dataSubType = 0x11,
+	.dataFlags1 = 0x12,
+	.dataFlags2 = 0x14,
+	.dataExtraData = 0x16,
+	.dataAttributes = 0x18,
+	.dataStructStructure = 0x20,
+	.dataStructExternalNamedResolve = 0x28,
+	.dataStructExternalNamedGetName = 0x30,
+	.dataStructAllocateStruct = 0x38,
+	.dataEnumInitValue = 0x20,
+	.dataEnumInitValueSize = 4,
+	.dataEnumEnumData = 0x28,
+	.dataArraySize = 0x28,
+	.dataStringMemberSize = 0x20,
+	.dataMapCreateIterator = 0x20,
+	.dataMapCreateInterface = 0x28,
+	.dataSimpleInitValue = 0x20,
+	.dataInitValues = 0x20,
+
+	.attributeListSize = 0x18,
+	.attributeListUserData1 = 0x10,
+	.attributeListUserData2 = 0x11,
+	.attributeSize = 0x18,
+	.attributeValue = 0x8,
+	.attributeType = 0x10,
+
+	.enumSize = 0x18,
+	.enumValueNames = 0x8,
+	.enumValueCount = 0x10,
+	.enumFlags = 0x12,
+	.enumName = 0x14,
+	.enumValueSize = 0x8,
+	.enumValueValue = 0x4,
+
+	.staticDataNameStr = 0x8,
+	.staticDataMemberNames = 0x28,
+};
+
+constexpr ParLayout gta5g9_par_layout = gta5_par_layout;
+
+constexpr ParLayout rdr3_par_layout
+{
+	.managerStructures = 0x48,
+	.mapNumBuckets = 0x8,
+	.mapCountSize = 4,
+	.mapEntryValue = 0x8,
+	.mapEntryNext = 0x10,
+	.mapEntrySize = 0x18,
+
+	.structureSize = 0xD0,
+	.structureName = 0x30,
+	.structureBase = 0x38,
+	.structureBaseOffset = 0x40,
+	.structureStructureSize = 0x48,
+	.structureFlags = 0x50,
+	.structureFlagsSize = 1,
+	.structureAlign = 0x52,
+	.structureVersionMajor = 0x56,
+	.structureVersionMinor = 0x58,
+	.structureMembers = 0x60,
+	.structureExtraAttributes = 0x70,
+	.structureFactoryNew = 0x78,
+	.structureFactoryPlacementNew = 0x88,
+	.structureGetStructureCB = 0x98,
+	.structureFactoryDelete = 0xA8,
+	.structureCallbacks = 0xB8,
+
+	.memberData = 0x8,
+	.memberArrayItem = 0x10,
+	.memberMapKey = 0x10,
+	.memberMapValue = 0x18,
+
+	.dataSize = 0x20,
+	.dataOffset = 0x8,
+	.dataType = 0x10,
+	.dataSubType = 0x11,
+	.dataFlags1 = 0x12,
+	.dataFlags2 = 0x14,
+	.dataExtraData = 0x16,
+	.dataAttributes = 0x18,
+	.dataStructStructure = 0x20,
+	.dataStructExternalNamedResolve = 0x28,
+	.dataStructExternalNamedGetName = 0x30,
+	.dataStructAllocateStruct = 0x38,
+	.dataEnumInitValue = 0x20,
+	.dataEnumInitValueSize = 8,
+	.dataEnumEnumData = 0x28,
+	.dataArraySize = 0x28,
+	.dataStringMemberSize = 0x20,
+	.dataMapCreateIterator = 0x20,
+	.dataMapCreateInterface = 0x28,
+	.dataSimpleInitValue = 0x20,
+	.dataInitValues = 0x20,
+
+	.attributeListSize = 0x18,
+	.attributeListUserData1 = 0x10,
+	.attributeListUserData2 = 0x11,
+	.attributeSize = 0x18,
+	.attributeValue = 0x8,
+	.attributeType = 0x10,
+
+	.enumSize = 0x18,
+	.enumValueNames = 0x8,
+	.enumValueCount = 0x10,
+	.enumFlags = 0x12,
+	.enumName = 0x14,
+	.enumValueSize = 0x10,
+	.enumValueValue = 0x8,
+
+	.staticDataNameStr = 0x8,
+	.staticDataMemberNames = 0x28,
+};
+
+// Layout of the given game (same names as the DumpTools game argument), null for the 32-bit games and RDR2, which use
+// rage_gta4.h.
+constexpr const ParLayout* FindParLayout(std::string_view game)
+{
+	if (game == "gta5") return &gta5_par_layout;
+	if (game == "gta5g9") return &gta5g9_par_layout;
+	if (game == "rdr3") return &rdr3_par_layout;
+	return nullptr;
+}
@@ -0,0 +1,150 @@
+#include "PatternCache.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+
+static constexpr std::string_view pattern_cache_header = "DumpStructs pattern cache 1";
+
+// Splits the next space-separated token off the start of `line`.
+static std::string_view NextToken(std::string_view& line)
+{
+	const size_t end = std::min(line.find(' '), line.size());
+	const auto token = line.substr(0, end);
+	line.remove_prefix(std::min(end + 1, line.size()));
+	return token;
+}
+
+template<class T>
+static bool ParseNumber(std::string_view str, T& value, int base)
+{
+	auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value, base);
+	return !str.empty() && ec == std::errc{} && ptr == str.data() + str.size();
+}
+
+static bool ParseKey(std::string_view line, PatternCacheKey& key)
+{
+	if (NextToken(line) != "key")
+	{
+		return false;
+	}
+
+	std::string_view build = NextToken(line);
+	for (size_t i = 0; i < key.build.size(); i++)
+	{
+		const size_t end = std::min(build.find('.'), build.size());
+		if (!ParseNumber(build.substr(0, end), key.build[i], 10) || (i + 1 < key.build.size()) == (end == build.size()))
+		{
+			return false;
+		}
+		build.remove_prefix(std::min(end + 1, build.size()));
+	}
+
+	return ParseNumber(NextToken(line), key.timeDateStamp, 16) &&
+		ParseNumber(NextToken(line), key.checkSum, 16) &&
+		ParseNumber(NextToken(line), key.sizeOfImage, 16) &&
+		line.empty();
+}
+
+PatternCache::PatternCache(const PatternCacheKey& key)
+	: _key(key)
+{
+}
+
+PatternCacheLoadResult PatternCache::Load(const std::string& filePath)
+{
+	_entries.clear();
+	_dirty = false;
+
+	std::ifstream in{ filePath, std::ios::in | std::ios::binary };
+	if (!in)
+	{
+		return PatternCacheLoadResult::Missing;
+	}
+
+	std::string line;
+	PatternCacheKey fileKey{};
+	if (!std::getline(in, line) || line != pattern_cache_header ||
+		!std::getline(in, line) || !ParseKey(line, fileKey))
+	{
+		return PatternCacheLoadResult::Corrupt;
+	}
+
+	if (fileKey != _key)
+	{
+		return PatternCacheLoadResult::Stale;
+	}
+
+	while (std::getline(in, line))
+	{
+		std::string_view rest = line;
+		size_t rva;
+		if (!ParseNumber(NextToken(rest), rva, 16) || rest.empty())
+		{
+			_entries.clear();
+			return PatternCacheLoadResult::Corrupt;
+		}
+
+		_entries.insert_or_assign(std::string{ rest }, rva);
+	}
+
+	return PatternCacheLoadResult::Loaded;
+}
+
+bool PatternCache::Save(const std::string& filePath)
+{
+	char buffer[128];
+	std::snprintf(buffer, sizeof(buffer), "\nkey %u.%u.%u.%u %08X %08X %08X\n",
+		_key.build[0], _key.build[1], _key.build[2], _key.build[3], _key.timeDateStamp, _key.checkSum, _key.sizeOfImage);
+
+	std::string contents{ pattern_cache_header };
+	contents += buffer;
+	for (auto& [pattern, rva] : _entries)
+	{
+		std::snprintf(buffer, sizeof(buffer), "%08zX ", rva);
+		contents += buffer;
+		contents += pattern;
+		contents += '\n';
+	}
+
+	std::ofstream out{ filePath, std::ios::out | std::ios::binary | std::ios::trunc };
+	out.write(contents.data(), contents.size());
+	out.close();
+	if (!out)
+	{
+		return false;
+	}
+
+	_dirty = false;
+	return true;
+}
+
+std::optional<size_t> PatternCache::Find(std::string_view pattern) const
+{
+	auto it = _entries.find(pattern);
+	return it != _entries.end() ? std::optional{ it->second } : std::nullopt;
+}
+
+void PatternCache::Set(std::string_view pattern, size_t rva)
+{
+	auto it = _entries.find(pattern);
+	if (it == _entries.end())
+	{
+		_entries.emplace(std::string{ pattern }, rva);
+		_dirty = true;
+	}
+	else if (it->second != rva)
+	{
+		it->second = rva;
+		_dirty = true;
+	}
+}
+
+void PatternCache::Remove(std::string_view pattern)
+{
+	if (auto it = _entries.find(pattern); it != _entries.end())
+	{
+		_entries.erase(it);
+		_dirty = true;
+	}
+}
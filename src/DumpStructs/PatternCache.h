@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Identifies an executable, patterns resolved in one are only reused in executables with the same key.
+struct PatternCacheKey
+{
+	std::array<uint16_t, 4> build; // { major, minor, build, revision } as in GetGameBuild()
+	uint32_t timeDateStamp;        // from the PE file header
+	uint32_t checkSum;             // from the PE optional header
+	uint32_t sizeOfImage;
+
+	bool operator==(const PatternCacheKey&) const = default;
+};
+
+enum class PatternCacheLoadResult
+{
+	Loaded,
+	Missing, // the file does not exist
+	Stale,   // the file is for a different executable
+	Corrupt, // the file could not be parsed
+};
+
+// Remembers the RVA of the first match of each pattern in an executable, so the next time the same executable is loaded
+// the patterns don't need to be scanned again. Stored as a text file:
+//
+//   DumpStructs pattern cache 1
+//   key <major>.<minor>.<build>.<revision> <timeDateStamp> <checkSum> <sizeOfImage>
+//   <rva> <pattern>
+//   ...
+//
+// with all numbers except the build in hex. Entries are not trusted blindly, the caller should check the pattern still
+// matches at the RVA before using it.
+class PatternCache
+{
+public:
+	PatternCache(const PatternCacheKey& key);
+
+	// Replaces the entries with those of the file. If the file is missing, stale or corrupt, the cache is left empty.
+	PatternCacheLoadResult Load(const std::string& filePath);
+	bool Save(const std::string& filePath);
+
+	std::optional<size_t> Find(std::string_view pattern) const;
+	void Set(std::string_view pattern, size_t rva);
+	void Remove(std::string_view pattern);
+
+	size_t Size() const { return _entries.size(); }
+	// Whether the entries changed since the last Load or Save.
+	bool IsDirty() const { return _dirty; }
+
+private:
+	struct StringHash
+	{
+		using is_transparent = void;
+		size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+	};
+
+	PatternCacheKey _key;
+	std::unordered_map<std::string, size_t, StringHash, std::equal_to<>> _entries;
+	bool _dirty = false;
+};
@@ -0,0 +1,275 @@
+#include "PatternScanner.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PATTERN_SCANNER_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PATTERN_SCANNER_AVX2_TARGET
+#else
+#define PATTERN_SCANNER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+size_t PatternScanner::Add(std::string_view pattern)
+{
+	if (auto index = Find(pattern); index != InvalidPattern)
+	{
+		return index;
+	}
+
+	PatternData p{ std::string{ pattern } };
+	size_t pos = 0;
+	while (pos < pattern.size())
+	{
+		if (pattern[pos] == ' ')
+		{
+			pos++;
+			continue;
+		}
+
+		const size_t end = std::min(pattern.find(' ', pos), pattern.size());
+		const auto token = pattern.substr(pos, end - pos);
+		if (token == "?" || token == "??")
+		{
+			p.bytes.push_back(0);
+			p.mask.push_back(0x00);
+		}
+		else
+		{
+			uint8_t value;
+			auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value, 16);
+			if (token.size() != 2 || ec != std::errc{} || ptr != token.data() + token.size())
+			{
+				return InvalidPattern;
+			}
+			p.bytes.push_back(value);
+			p.mask.push_back(0xFF);
+		}
+		pos = end;
+	}
+
+	auto firstFixed = std::find(p.mask.begin(), p.mask.end(), 0xFF);
+	if (firstFixed == p.mask.end())
+	{
+		// only wildcards
+		return InvalidPattern;
+	}
+	p.anchor = firstFixed - p.mask.begin();
+
+	_patternIndices.emplace(p.text, _patterns.size());
+	_patterns.push_back(std::move(p));
+	return _patterns.size() - 1;
+}
+
+size_t PatternScanner::Find(std::string_view pattern) const
+{
+	auto it = _patternIndices.find(pattern);
+	return it != _patternIndices.end() ? it->second : InvalidPattern;
+}
+
+void PatternScanner::ChooseAnchors(const uint8_t* data, size_t size)
+{
+	// byte histogram of a sample of the buffer, spread over all of it so different sections (code, data) are represented
+	constexpr size_t sampleBlockSize = 4096;
+	constexpr size_t sampleBlockCount = 64;
+	std::array<size_t, 256> frequency{};
+	const size_t blockCount = std::min(sampleBlockCount, (size + sampleBlockSize - 1) / sampleBlockSize);
+	for (size_t i = 0; i < blockCount; i++)
+	{
+		const size_t start = size / blockCount * i;
+		const size_t end = std::min(start + sampleBlockSize, size);
+		for (size_t j = start; j < end; j++)
+		{
+			frequency[data[j]]++;
+		}
+	}
+
+	for (auto& list : _patternsByAnchor)
+	{
+		list.clear();
+	}
+	_anchors.clear();
+
+	for (size_t index = 0; index < _patterns.size(); index++)
+	{
+		// rarest fixed byte, the earliest one on ties
+		auto& p = _patterns[index];
+		p.anchor = std::find(p.mask.begin(), p.mask.end(), 0xFF) - p.mask.begin();
+		for (size_t i = p.anchor + 1; i < p.bytes.size(); i++)
+		{
+			if (p.mask[i] == 0xFF && frequency[p.bytes[i]] < frequency[p.bytes[p.anchor]])
+			{
+				p.anchor = i;
+			}
+		}
+
+		auto& list = _patternsByAnchor[p.bytes[p.anchor]];
+		if (list.empty())
+		{
+			_anchors.push_back(p.bytes[p.anchor]);
+		}
+		list.push_back(index);
+	}
+}
+
+void PatternScanner::CheckCandidate(const uint8_t* data, size_t size, size_t pos)
+{
+	_candidates++;
+	for (size_t index : _patternsByAnchor[data[pos]])
+	{
+		auto& p = _patterns[index];
+		if (pos >= p.anchor && p.matches.size() < MaxMatchesPerPattern && IsMatch(index, data, size, pos - p.anchor))
+		{
+			p.matches.push_back(pos - p.anchor);
+		}
+	}
+}
+
+bool PatternScanner::IsMatch(size_t pattern, const uint8_t* data, size_t size, size_t pos) const
+{
+	auto& p = _patterns[pattern];
+	if (pos > size || size - pos < p.bytes.size())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < p.bytes.size(); i++)
+	{
+		if ((data[pos + i] & p.mask[i]) != p.bytes[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+#if PATTERN_SCANNER_X86
+bool PatternScanner::UsesAvx2()
+{
+	static const bool supported = []
+	{
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return false;
+		}
+
+		// the OS must also save the AVX registers on context switches
+		__cpuid(info, 1);
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2") != 0;
+#endif
+	}();
+	return supported;
+}
+
+size_t PatternScanner::ScanSse2(const uint8_t* data, size_t size)
+{
+	__m128i anchors[256];
+	for (size_t i = 0; i < _anchors.size(); i++)
+	{
+		anchors[i] = _mm_set1_epi8(static_cast<char>(_anchors[i]));
+	}
+
+	size_t pos = 0;
+	for (; size - pos >= 16; pos += 16)
+	{
+		const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+		__m128i eq = _mm_cmpeq_epi8(chunk, anchors[0]);
+		for (size_t i = 1; i < _anchors.size(); i++)
+		{
+			eq = _mm_or_si128(eq, _mm_cmpeq_epi8(chunk, anchors[i]));
+		}
+
+		unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(eq));
+		while (mask != 0)
+		{
+			CheckCandidate(data, size, pos + std::countr_zero(mask));
+			mask &= mask - 1;
+		}
+	}
+	return pos;
+}
+
+PATTERN_SCANNER_AVX2_TARGET size_t PatternScanner::ScanAvx2(const uint8_t* data, size_t size)
+{
+	__m256i anchors[256];
+	for (size_t i = 0; i < _anchors.size(); i++)
+	{
+		anchors[i] = _mm256_set1_epi8(static_cast<char>(_anchors[i]));
+	}
+
+	size_t pos = 0;
+	for (; size - pos >= 32; pos += 32)
+	{
+		const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+		__m256i eq = _mm256_cmpeq_epi8(chunk, anchors[0]);
+		for (size_t i = 1; i < _anchors.size(); i++)
+		{
+			eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(chunk, anchors[i]));
+		}
+
+		uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+		while (mask != 0)
+		{
+			CheckCandidate(data, size, pos + std::countr_zero(mask));
+			mask &= mask - 1;
+		}
+	}
+	return pos;
+}
+#else
+bool PatternScanner::UsesAvx2()
+{
+	return false;
+}
+
+size_t PatternScanner::ScanSse2(const uint8_t* data, size_t size)
+{
+	return 0;
+}
+
+size_t PatternScanner::ScanAvx2(const uint8_t* data, size_t size)
+{
+	return 0;
+}
+#endif
+
+void PatternScanner::Scan(const uint8_t* data, size_t size)
+{
+	for (auto& p : _patterns)
+	{
+		p.matches.clear();
+	}
+	_candidates = 0;
+
+	ChooseAnchors(data, size);
+	if (_anchors.empty())
+	{
+		return;
+	}
+
+	size_t pos = UsesAvx2() ? ScanAvx2(data, size) : ScanSse2(data, size);
+	for (; pos < size; pos++)
+	{
+		if (!_patternsByAnchor[data[pos]].empty())
+		{
+			CheckCandidate(data, size, pos);
+		}
+	}
+}
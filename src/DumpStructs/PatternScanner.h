@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Finds multiple byte patterns in a single pass over a buffer, instead of one full pass per pattern like hook::pattern.
+// Patterns use the same format as hook::get_pattern ("48 8B 0D ? ? ? ?"), with '?' or '??' as wildcard bytes.
+//
+// Each pattern is anchored on its rarest fixed byte (based on a sample of the scanned buffer, so e.g. the REX.W prefix 0x48
+// is avoided in x64 code). The buffer is filtered 16/32 bytes at a time with SSE2/AVX2 against the anchor bytes, and only
+// those candidates are compared with the full patterns.
+class PatternScanner
+{
+public:
+	static constexpr size_t InvalidPattern = SIZE_MAX;
+	// more matches than this means the pattern is not useful anyway, stop recording them
+	static constexpr size_t MaxMatchesPerPattern = 16;
+
+	// Returns the index of the pattern, or InvalidPattern if it is malformed. Adding the same pattern twice returns the
+	// same index.
+	size_t Add(std::string_view pattern);
+	// Returns the index of a pattern previously added, or InvalidPattern if not found.
+	size_t Find(std::string_view pattern) const;
+
+	// Scans the buffer and records the matches of every pattern, as offsets from the start of the buffer, in ascending order.
+	void Scan(const uint8_t* data, size_t size);
+
+	size_t PatternCount() const { return _patterns.size(); }
+	std::string_view Pattern(size_t pattern) const { return _patterns[pattern].text; }
+	std::span<const size_t> Matches(size_t pattern) const { return _patterns[pattern].matches; }
+
+	// Whether the pattern matches the buffer at the given offset, without scanning.
+	bool IsMatch(size_t pattern, const uint8_t* data, size_t size, size_t pos) const;
+
+	// Number of positions that passed the anchor filter in the last scan.
+	size_t CandidateCount() const { return _candidates; }
+
+	// Whether the AVX2 filter is used on this CPU.
+	static bool UsesAvx2();
+
+private:
+	struct PatternData
+	{
+		std::string text;
+		std::vector<uint8_t> bytes;
+		std::vector<uint8_t> mask; // 0xFF for fixed bytes, 0x00 for wildcards
+		size_t anchor; // index of the byte used to find candidates, never a wildcard
+		std::vector<size_t> matches;
+	};
+
+	struct StringHash
+	{
+		using is_transparent = void;
+		size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+	};
+
+	void ChooseAnchors(const uint8_t* data, size_t size);
+	size_t ScanSse2(const uint8_t* data, size_t size);
+	size_t ScanAvx2(const uint8_t* data, size_t size);
+	void CheckCandidate(const uint8_t* data, size_t size, size_t pos);
+
+	std::vector<PatternData> _patterns;
+	std::unordered_map<std::string, size_t, StringHash, std::equal_to<>> _patternIndices;
+	// patterns indexed by the value of their anchor byte
+	std::vector<size_t> _patternsByAnchor[256];
+	// distinct anchor byte values
+	std::vector<uint8_t> _anchors;
+	size_t _candidates = 0;
+};
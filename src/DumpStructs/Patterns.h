@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+// How the address of a pattern match is turned into the address we are interested in, same as the hook:: helpers.
+enum class PatternResolve
+{
+	None,     // match + offset
+	Address,  // hook::get_address: rel32 at match + offset, relative to the end of the rel32
+	Call,     // hook::get_call: target of the E8/E9 instruction at match + offset
+	Pointer,  // *(uint32_t*)(match + offset), absolute address used by the 32-bit games
+};
+
+// The patterns DumpStructs uses, the table of each game has those it needs. The code refers to the patterns by id only (see
+// GetPattern in GamePatterns.h), so the table is the single place where each pattern, its offset and how it resolves are.
+enum class GamePattern
+{
+	ParManagerInstance,           // parManager::sm_Instance
+	TheAllocator,                 // rage::s_TheAllocator
+	InitParManager,               // function that initializes parManager before loading TVPlaylists (GTA5)
+	BuildStructureFromStaticData, // parStructure::BuildStructureFromStaticData
+	FindAlign,                    // parStructure::FindAlign
+	UnregisterStructure,          // parManager::UnregisterStructure (MP3)
+	PreDump,                      // function that registers extra structures (GTA4)
+};
+
+struct PatternInfo
+{
+	GamePattern id;
+	std::string_view name;
+	std::string_view pattern; // same format as hook::get_pattern
+	ptrdiff_t offset;
+	PatternResolve resolve;
+};
+
+// All the patterns used by DumpStructs for each game. At startup, the table of the current game is scanned in a single pass
+// (see GamePatterns.h) and GetPattern looks up the results by id. The tables can also be checked against new builds without
+// launching the game (see DumpTools).
+constexpr PatternInfo rdr3_patterns[]
+{
+	{ GamePattern::ParManagerInstance, "parManager::sm_Instance", "48 8B 0D ? ? ? ? E8 ? ? ? ? 84 C0 74 29 48 8B 1D", 3, PatternResolve::Address },
+	{ GamePattern::BuildStructureFromStaticData, "parStructure::BuildStructureFromStaticData", "89 41 30 41 BF ? ? ? ? 4D 85 F6 74 58", -0x24, PatternResolve::None },
+	{ GamePattern::FindAlign, "parStructure::FindAlign", "0F B7 41 52 33 ED 48 8B F9 66 85 C0", -0x14, PatternResolve::None },
+};
+
+constexpr PatternInfo rdr2_patterns[]
+{
+	{ GamePattern::ParManagerInstance, "parManager::sm_Instance", "48 8B 05 ? ? ? ? 8B 70 ? C1 EE ? 40 80 E6 ? 74 ? E8 ? ? ? ? 4C 89 65", 3, PatternResolve::Address },
+};
+
+constexpr PatternInfo gta5_patterns[]
+{
+	{ GamePattern::ParManagerInstance, "parManager::sm_Instance", "48 8B 0D ? ? ? ? 4C 89 74 24 ? 45 33 C0 48 8B D7 C6 44 24 ? ?", 3, PatternResolve::Address },
+	{ GamePattern::TheAllocator, "rage::s_TheAllocator", "48 8D 1D ? ? ? ? A8 08 75 1D 83 C8 08 48 8B CB", 3, PatternResolve::Address },
+	{ GamePattern::InitParManager, "InitParManager (TVPlaylists loader)", "40 53 48 83 EC 40 48 83 3D ? ? ? ? ? 48 8B D9 75 28", 0, PatternResolve::None },
+	{ GamePattern::BuildStructureFromStaticData, "parStructure::BuildStructureFromStaticData", "48 8B 05 ? ? ? ? 48 83 7A ? ? 48 8B FA 44 8A 60 5C 8B 02", -0x1D, PatternResolve::None },
+	{ GamePattern::FindAlign, "parStructure::FindAlign", "0F B7 41 2A 33 F6 48 8B F9 66 85 C0 74 05", -0xF, PatternResolve::None },
+};
+
+constexpr PatternInfo gta5g9_patterns[]
+{
+	{ GamePattern::ParManagerInstance, "parManager::sm_Instance", "48 8B 05 ? ? ? ? 44 0F B6 B8 ? ? ? ? 4C 8B 72", 3, PatternResolve::Address },
+	{ GamePattern::TheAllocator, "rage::s_TheAllocator", "48 8D 3D ? ? ? ? 4C 8D 05 ? ? ? ? 48 89 F9 BA", 3, PatternResolve::Address },
+	{ GamePattern::InitParManager, "InitParManager (TVPlaylists loader)", "48 8D 54 24 ? 4C 89 F9 41 B0 ? E8 ? ? ? ? 48 8B 0D ? ? ? ? 4C 8B 0D", 0, PatternResolve::None },
+	{ GamePattern::BuildStructureFromStaticData, "parStructure::BuildStructureFromStaticData", "48 8B 05 ? ? ? ? 44 0F B6 B8 ? ? ? ? 4C 8B 72", -0x14, PatternResolve::None },
+	{ GamePattern::FindAlign, "parStructure::FindAlign", "56 57 53 48 83 EC ? 0F B7 41 ? 48 85 C0 75", 0, PatternResolve::None },
+};
+
+constexpr PatternInfo mp3_patterns[]
+{
+	{ GamePattern::ParManagerInstance, "parManager::sm_Instance", "8B 15 ? ? ? ? 53 8B 5A 28 C1 EB 12 80 E3 01", 2, PatternResolve::Pointer },
+	{ GamePattern::UnregisterStructure, "parManager::UnregisterStructure", "83 EC 0C 83 7C 24 ? ? 56 8B F1 0F 84 ? ? ? ? A1 ? ? ? ? 53", 0, PatternResolve::None },
+};
+
+constexpr PatternInfo gta4_patterns[]
+{
+	{ GamePattern::ParManagerInstance, "parManager::sm_Instance", "A1 ? ? ? ? 8B 58 28 C1 EB 11 80 E3 01 74 1D", 1, PatternResolve::Pointer },
+	{ GamePattern::TheAllocator, "rage::s_TheAllocator", "8B 00 C7 40 ? ? ? ? ? C7 40 ? ? ? ? ? 8B E5 5D", 5, PatternResolve::Pointer },
+	{ GamePattern::PreDump, "PreDump (register extra structures)", "51 80 3D ? ? ? ? ? 53 56 0F 85 ? ? ? ? A1 ? ? ? ? 64 8B 35", 0, PatternResolve::None },
+};
+
+// Returns the patterns of the game configuration with the given name (rdr3, rdr2, gta5, gta5g9, mp3 or gta4), or an empty
+// span if unknown.
+constexpr std::span<const PatternInfo> GetPatterns(std::string_view game)
+{
+	if (game == "rdr3") return rdr3_patterns;
+	if (game == "rdr2") return rdr2_patterns;
+	if (game == "gta5") return gta5_patterns;
+	if (game == "gta5g9") return gta5g9_patterns;
+	if (game == "mp3") return mp3_patterns;
+	if (game == "gta4") return gta4_patterns;
+	return {};
+}
@@ -0,0 +1,37 @@
+#include "ScratchArena.h"
+#include <array>
+#include <charconv>
+#include <cstring>
+
+std::string_view ScratchArena::Concat(std::span<const std::string_view> parts)
+{
+	size_t size = 0;
+	for (auto part : parts)
+	{
+		size += part.size();
+	}
+
+	char* str = static_cast<char*>(_resource.allocate(size + 1, 1));
+	char* end = str;
+	for (auto part : parts)
+	{
+		std::memcpy(end, part.data(), part.size());
+		end += part.size();
+	}
+	*end = '\0';
+	return { str, size };
+}
+
+std::string_view ByteToString(uint8_t value)
+{
+	static const auto strings = []
+	{
+		std::array<std::array<char, 4>, 256> strings{};
+		for (size_t i = 0; i < strings.size(); i++)
+		{
+			std::to_chars(strings[i].data(), strings[i].data() + 3, i);
+		}
+		return strings;
+	}();
+	return strings[value].data();
+}
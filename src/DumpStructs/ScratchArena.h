@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+
+// Bump allocator for the small strings and containers made while dumping (enum names, lookup maps). Memory
+// is taken from the heap in blocks that grow geometrically and is only released all at once, so the number of heap
+// allocations doesn't grow with the number of strings. Not thread-safe.
+class ScratchArena
+{
+public:
+	explicit ScratchArena(size_t initialSize = 64 * 1024) : _resource{ initialSize } {}
+
+	ScratchArena(const ScratchArena&) = delete;
+	ScratchArena& operator=(const ScratchArena&) = delete;
+
+	// For std::pmr containers whose nodes should live in the arena.
+	std::pmr::memory_resource* Resource() { return &_resource; }
+
+	// Copies the string into the arena, null-terminated so it can also be passed as a C string.
+	std::string_view Copy(std::string_view str) { return Concat({ str }); }
+	std::string_view Concat(std::initializer_list<std::string_view> parts) { return Concat(std::span{ parts.begin(), parts.size() }); }
+	std::string_view Concat(std::span<const std::string_view> parts);
+
+	// Frees every block, invalidating all the strings.
+	void Release() { _resource.release(); }
+
+private:
+	std::pmr::monotonic_buffer_resource _resource;
+};
+
+// Decimal string of a byte value, for the enum values without a name.
+std::string_view ByteToString(uint8_t value);
@@ -3,6 +3,8 @@
 #include <spdlog/sinks/basic_file_sink.h>
 #include "Hooking.Patterns.h"
 #include "Hooking.h"
+#include "GamePatterns.h"
+#include "DumpTrigger.h"
 #include <MinHook.h>
 #include <unordered_map>
 #include <string>
@@ -10,32 +12,24 @@
 #include <unordered_set>
 #include <vector>
 #include <format>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <span>
+#include <thread>
 
 #include "rage.h"
 #include "rage_gta4.h"
 
 #include "JsonWriter.h"
-
-constexpr uint32_t joaat_literal(const char* text)
-{
-	if (!text)
-	{
-		return 0;
-	}
-
-	unsigned int hash = 0;
-	while (*text)
-	{
-		hash += *text;
-		hash += hash << 10;
-		hash ^= hash >> 6;
-		text++;
-	}
-	hash += hash << 3;
-	hash ^= hash >> 11;
-	hash += hash << 15;
-	return hash;
-}
+#include "JsonParallel.h"
+#include "DumpBinaryWriter.h"
+#include "DumpDelta.h"
+#include "EnumNameIndex.h"
+#include "GameCallCache.h"
+#include "MappedFile.h"
+#include "MemorySnapshot.h"
+#include "NameRegistry.h"
 
 static std::tuple<uint16_t, uint16_t, uint16_t, uint16_t> GetGameBuild()
 {
@@ -82,22 +76,24 @@ static std::tuple<uint16_t, uint16_t, uint16_t, uint16_t> GetGameBuild()
 	return { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF };
 }
 
+static std::optional<uint64_t> GetEnvironmentNumber(const char* name)
+{
+	char value[32];
+	const DWORD length = GetEnvironmentVariableA(name, value, sizeof(value));
+	if (length == 0 || length >= sizeof(value))
+	{
+		return std::nullopt;
+	}
+
+	uint64_t number;
+	auto [ptr, ec] = std::from_chars(value, value + length, number);
+	return ec == std::errc{} && ptr == value + length ? std::optional{ number } : std::nullopt;
+}
+
 static void FindParManager()
 {
 	spdlog::info("Searching parManager::sm_Instance...");
-#if RDR3
-	parManager::sm_Instance = hook::get_address<parManager**>(hook::get_pattern("48 8B 0D ? ? ? ? E8 ? ? ? ? 84 C0 74 29 48 8B 1D", 3));
-#elif RDR2
-	parManager::sm_Instance = hook::get_address<parManager**>(hook::get_pattern("48 8B 05 ? ? ? ? 8B 70 ? C1 EE ? 40 80 E6 ? 74 ? E8 ? ? ? ? 4C 89 65", 3));
-#elif GTA5
-	parManager::sm_Instance = hook::get_address<parManager**>(hook::get_pattern("48 8B 0D ? ? ? ? 4C 89 74 24 ? 45 33 C0 48 8B D7 C6 44 24 ? ?", 3));
-#elif GTA5G9
-	parManager::sm_Instance = hook::get_address<parManager**>(hook::get_pattern("48 8B 05 ? ? ? ? 44 0F B6 B8 ? ? ? ? 4C 8B 72", 3));
-#elif MP3
-	parManager::sm_Instance = *hook::get_pattern<parManager**>("8B 15 ? ? ? ? 53 8B 5A 28 C1 EB 12 80 E3 01", 2);
-#elif GTA4
-	parManager::sm_Instance = *hook::get_pattern<parManager**>("A1 ? ? ? ? 8B 58 28 C1 EB 11 80 E3 01 74 1D", 1);
-#endif
+	parManager::sm_Instance = GetPattern<GamePattern::ParManagerInstance, parManager*>();
 	spdlog::info("parManager::sm_Instance = {}", (void*)parManager::sm_Instance);
 }
 
@@ -109,7 +105,7 @@ static void SetAllocatorInTls()
 #elif RDR2
 
 #elif GTA5
-	uintptr_t theAllocatorAddr = hook::get_address<uintptr_t>(hook::get_pattern("48 8D 1D ? ? ? ? A8 08 75 1D 83 C8 08 48 8B CB", 3));
+	uintptr_t theAllocatorAddr = reinterpret_cast<uintptr_t>(GetPattern<GamePattern::TheAllocator>());
 
 	spdlog::info("rage::s_TheAllocator            = {}", (void*)theAllocatorAddr);
 	spdlog::info("rage::s_TheAllocator::__vftable = {}", *(void**)theAllocatorAddr);
@@ -119,7 +115,7 @@ static void SetAllocatorInTls()
 	*(uintptr_t*)(tls + 192) = theAllocatorAddr;
 	*(uintptr_t*)(tls + 184) = theAllocatorAddr;
 #elif GTA5G9
-	uintptr_t theAllocatorAddr = hook::get_address<uintptr_t>(hook::get_pattern("48 8D 3D ? ? ? ? 4C 8D 05 ? ? ? ? 48 89 F9 BA", 3));
+	uintptr_t theAllocatorAddr = reinterpret_cast<uintptr_t>(GetPattern<GamePattern::TheAllocator>());
 
 	spdlog::info("rage::s_TheAllocator            = {}", (void*)theAllocatorAddr);
 	spdlog::info("rage::s_TheAllocator::__vftable = {}", *(void**)theAllocatorAddr);
@@ -130,8 +126,8 @@ static void SetAllocatorInTls()
 #elif MP3
 
 #elif GTA4
-	uint8_t* addr = hook::get_pattern<uint8_t>("8B 00 C7 40 ? ? ? ? ? C7 40 ? ? ? ? ? 8B E5 5D");
-	uintptr_t theAllocatorAddr = *(uintptr_t*)(addr + 5);
+	uint8_t* addr = GetPatternMatch<GamePattern::TheAllocator, uint8_t>();
+	uintptr_t theAllocatorAddr = reinterpret_cast<uintptr_t>(GetPattern<GamePattern::TheAllocator>());
 	int offset1 = *(addr + 4);
 	int offset2 = *(addr + 11);
 
@@ -157,7 +153,7 @@ static void InitParManager()
 
 	// function that loads "common:/data/TVPlaylists", but before it initiliazes parManager if it is not initialized
 	using Fn = bool (*)(void*);
-	void* addr = hook::get_pattern("40 53 48 83 EC 40 48 83 3D ? ? ? ? ? 48 8B D9 75 28");
+	void* addr = GetPattern<GamePattern::InitParManager>();
 
 	// return early to avoid calling rage::parManager::LoadFromStructure, only initialize rage::parManager
 	uint8_t* patchAddr = (uint8_t*)addr + 0x8D;
@@ -175,7 +171,7 @@ static void InitParManager()
 
 	// function that loads "common:/data/TVPlaylists", but before it initiliazes parManager if it is not initialized
 	using Fn = bool (*)(void*);
-	uint8_t* addr = hook::get_pattern<uint8_t>("48 8D 54 24 ? 4C 89 F9 41 B0 ? E8 ? ? ? ? 48 8B 0D ? ? ? ? 4C 8B 0D");
+	uint8_t* addr = GetPattern<GamePattern::InitParManager, uint8_t>();
 
 	// return early to avoid calling rage::parManager::LoadFromStructure, only initialize rage::parManager
 	uint8_t* patchAddr = addr + 0x10;
@@ -209,7 +205,7 @@ static void PreDump()
 	SetAllocatorInTls();
 
 	// call function that registers some more parStructures that are not included in parCguAutoRegistrationNode
-	auto func = (bool (*)())hook::get_pattern("51 80 3D ? ? ? ? ? 53 56 0F 85 ? ? ? ? A1 ? ? ? ? 64 8B 35");
+	auto func = (bool (*)())GetPattern<GamePattern::PreDump>();
 	func();
 #endif
 }
@@ -242,13 +238,67 @@ static std::string GetDumpBaseName()
 #if MP3 || GTA4 || RDR2
 // parEnumData doesn't exist in GTA4/MP3/RDR2 (info included in parMemberEnumData instead)
 using parEnumData = parMemberEnumData;
-static std::unordered_map<parMemberEnumData*, std::string> memberToEnumName;
+static EnumNameIndex enumNames;
 #endif
 
 #if RDR3 || GTA5 || GTA5G9
 static std::unordered_map<parStructure*, parStructureStaticData*> structureToStaticData;
 #endif
 
+// optional dictionary.txt in the game directory, to write the names of the hashes it contains instead of the hashes
+static constexpr const char* name_dictionary_file = "DumpStructs.dictionary.txt";
+// the dictionary hashed by a previous run, rebuilt when the dictionary changes
+static constexpr const char* name_index_file = "DumpStructs.dictionary.index";
+static NameRegistry names;
+
+static void LoadNameDictionary()
+{
+	auto& dictionary = names.Dictionary();
+	const auto indexResult = dictionary.LoadIndex(name_index_file, name_dictionary_file);
+	if (indexResult == NameIndexLoadResult::Loaded)
+	{
+		spdlog::info("Loaded {} names from {}", dictionary.Count(), name_index_file);
+		return;
+	}
+
+	if (!dictionary.Load(name_dictionary_file))
+	{
+		return;
+	}
+
+	spdlog::info("Loaded {} names from {} ({} duplicates, {} hash collisions)", dictionary.Count(), name_dictionary_file,
+		dictionary.Duplicates(), dictionary.Collisions().size());
+	for (auto& collision : dictionary.Collisions())
+	{
+		spdlog::warn("Hash collision 0x{:08X}: '{}' is kept, '{}' is ignored", collision.hash, collision.kept, collision.dropped);
+	}
+
+	if (!dictionary.SaveIndex(name_index_file, name_dictionary_file))
+	{
+		spdlog::warn("Failed to write {}", name_index_file);
+	}
+}
+
+// Writes a name hash, as the name if it is known.
+template<class TWriter>
+static void DumpJsonName(TWriter& w, std::string_view key, uint32_t hash)
+{
+	if (auto name = names.Find(hash); !name.empty())
+	{
+		w.String(key, name);
+	}
+	else
+	{
+		w.UInt(key, hash, json_uint_hex);
+	}
+}
+
+static GameCallCache<parMember, uint32_t> memberSizes;
+#if RDR3 || GTA5 || GTA5G9
+static GameCallCache<parMember, uint32_t> memberAligns;
+static GameCallCache<parStructure, uint32_t> structureAligns;
+#endif
+
 struct CollectResult
 {
 	std::vector<parStructure*> structs;
@@ -265,14 +315,12 @@ static CollectResult CollectStructs(parManager* parMgr)
 		auto* enumData = member->enumData;
 #elif MP3 || GTA4 || RDR2
 		// check duplicate enums
-		if (auto existingEnum = std::find_if(enums.cbegin(), enums.cend(), [member](auto* e) { return member->hasSameEnum(e); });
-			existingEnum != enums.cend())
+		const EnumIdentity identity{ member->values, member->valueNames, member->valueCount };
+		if (!enumNames.Add(member, identity, [&](ScratchArena& arena) { return arena.Concat({ struc->name, "__", member->name, "__enum" }); }))
 		{
-			memberToEnumName[member] = memberToEnumName[*existingEnum];
 			return;
 		}
 
-		memberToEnumName[member] = std::format("{}__{}__enum", struc->name, member->name); // the real enum names do not appear in the .exe
 		auto* enumData = member;
 #endif
 		if (enumsSet.insert(enumData).second)
@@ -344,7 +392,8 @@ static CollectResult CollectStructs(parManager* parMgr)
 }
 
 #if RDR3 || GTA5 || GTA5G9 || MP3 || RDR2
-static void DumpJsonAttributeList(JsonWriter& w, std::optional<std::string_view> key, parAttributeList* attributes)
+template<class TWriter>
+static void DumpJsonAttributeList(TWriter& w, std::optional<std::string_view> key, parAttributeList* attributes)
 {
 	w.BeginObject(key);
 #if RDR3 || GTA5 || GTA5G9
@@ -379,7 +428,8 @@ static void DumpJsonAttributeList(JsonWriter& w, std::optional<std::string_view>
 }
 #endif
 
-static void DumpJsonMember(JsonWriter& w, std::optional<std::string_view> key, parMember* member, std::optional<std::string_view> nameOverride = std::nullopt)
+template<class TWriter>
+static void DumpJsonMember(TWriter& w, std::optional<std::string_view> key, parMember* member, std::optional<std::string_view> nameOverride = std::nullopt)
 {
 	if (member == nullptr)
 	{
@@ -396,15 +446,15 @@ static void DumpJsonMember(JsonWriter& w, std::optional<std::string_view> key, p
 	else
 	{
 #if RDR3 || GTA5 || GTA5G9
-		w.UInt("name", m->name, json_uint_hex);
+		DumpJsonName(w, "name", m->name);
 #elif MP3 || GTA4 || RDR2
 		w.String("name", m->name);
 #endif
 	}
 	w.UInt("offset", m->offset, json_uint_dec);
-	w.UInt("size", member->GetSize(), json_uint_dec);
+	w.UInt("size", memberSizes.Get(member, [member] { return member->GetSize(); }), json_uint_dec);
 #if RDR3 || GTA5 || GTA5G9
-	w.UInt("align", member->FindAlign(), json_uint_dec);
+	w.UInt("align", memberAligns.Get(member, [member] { return member->FindAlign(); }), json_uint_dec);
 #endif
 	w.UInt("flags1", m->flags1, json_uint_hex);
 	w.UInt("flags2", m->flags2, json_uint_hex);
@@ -433,7 +483,7 @@ static void DumpJsonMember(JsonWriter& w, std::optional<std::string_view> key, p
 		if (structData->structure != nullptr)
 		{
 #if RDR3 || GTA5 || GTA5G9
-			w.UInt("structName", structData->structure->name, json_uint_hex);
+			DumpJsonName(w, "structName", structData->structure->name);
 #elif MP3 || GTA4 || RDR2
 			w.String("structName", structData->structure->name);
 #endif
@@ -506,9 +556,9 @@ static void DumpJsonMember(JsonWriter& w, std::optional<std::string_view> key, p
 	{
 		auto* enumData = static_cast<parMemberEnumData*>(m);
 #if RDR3 || GTA5 || GTA5G9
-		w.UInt("enumName", enumData->enumData->name, json_uint_hex);
+		DumpJsonName(w, "enumName", enumData->enumData->name);
 #elif MP3 || GTA4 || RDR2
-		w.String("enumName", memberToEnumName[enumData]);
+		w.String("enumName", enumNames.Find(enumData));
 #endif
 		w.Int("initValue", enumData->initValue);
 	}
@@ -625,7 +675,8 @@ static void DumpJsonMember(JsonWriter& w, std::optional<std::string_view> key, p
 	w.EndObject();
 }
 
-static void DumpJsonStructure(JsonWriter& w, std::optional<std::string_view> key, parStructure* s)
+template<class TWriter>
+static void DumpJsonStructure(TWriter& w, std::optional<std::string_view> key, parStructure* s)
 {
 	if (s == nullptr)
 	{
@@ -634,7 +685,8 @@ static void DumpJsonStructure(JsonWriter& w, std::optional<std::string_view> key
 	}
 
 #if RDR3 || GTA5 || GTA5G9
-	auto* d = structureToStaticData[s];
+	// find instead of operator[], structures may be dumped from multiple threads
+	auto* d = structureToStaticData.find(s)->second;
 #endif
 
 	w.BeginObject(key);
@@ -646,7 +698,7 @@ static void DumpJsonStructure(JsonWriter& w, std::optional<std::string_view> key
 		}
 		else
 		{
-			w.UInt("name", s->name, json_uint_hex);
+			DumpJsonName(w, "name", s->name);
 		}
 #elif MP3 || GTA4 || RDR2
 		w.String("name", s->name);
@@ -655,7 +707,7 @@ static void DumpJsonStructure(JsonWriter& w, std::optional<std::string_view> key
 		{
 			w.BeginObject("base");
 #if RDR3 || GTA5 || GTA5G9
-			w.UInt("name", s->baseStructure->name, json_uint_hex);
+			DumpJsonName(w, "name", s->baseStructure->name);
 #elif MP3 || GTA4 || RDR2
 			w.String("name", s->baseStructure->name);
 #endif
@@ -664,12 +716,13 @@ static void DumpJsonStructure(JsonWriter& w, std::optional<std::string_view> key
 		}
 		w.UInt("size", s->structureSize, json_uint_dec);
 #if RDR3 || GTA5 || GTA5G9
-		w.UInt("align", s->FindAlign(), json_uint_dec);
+		w.UInt("align", structureAligns.Get(s, [s] { return s->FindAlign(); }), json_uint_dec);
 		w.String("flags", FlagsToString(s->flags));
 #elif MP3 || GTA4 || RDR2
 		w.String("flags", "");
 #endif
-		w.String("version", std::format("{}.{}", s->versionMajor, s->versionMinor));
+		char versionBuffer[16];
+		w.String("version", { versionBuffer, std::format_to_n(versionBuffer, sizeof(versionBuffer), "{}.{}", s->versionMajor, s->versionMinor).out });
 		w.BeginArray("members");
 		for (size_t i = 0; i < s->members.Count; i++)
 		{
@@ -734,22 +787,11 @@ static void DumpJsonStructure(JsonWriter& w, std::optional<std::string_view> key
 			for (size_t i = 0; i < s->callbacks.Pairs.Count; i++)
 			{
 				auto& cb = s->callbacks.Pairs.Items[i];
-				std::string key = "";
-				switch (cb.Key)
+				char keyBuffer[32];
+				std::string_view key = par_callback_names.Find(cb.Key);
+				if (key.empty())
 				{
-				case joaat_literal("preloadfast"): key = "PreLoadFast"; break;
-				case joaat_literal("preload"): key = "PreLoad"; break;
-				case joaat_literal("postload"): key = "PostLoad"; break;
-				case joaat_literal("presave"): key = "PreSave"; break;
-				case joaat_literal("postsave"): key = "PostSave"; break;
-				case joaat_literal("removefromstore"): key = "RemoveFromStore"; break;
-				case joaat_literal("preset"): key = "PreSet"; break;
-				case joaat_literal("postset"): key = "PostSet"; break;
-				case joaat_literal("presetfast"): key = "PreSetFast"; break;
-				case joaat_literal("postsetfast"): key = "PostSetFast"; break;
-				case joaat_literal("postpsoplace"): key = "PostPsoPlace"; break;
-				case joaat_literal("visitor"): key = "Visitor"; break;
-				default: key = std::format("callback_0x{:0{}X}", cb.Key, 8); break;
+					key = { keyBuffer, std::format_to_n(keyBuffer, sizeof(keyBuffer), "callback_0x{:08X}", cb.Key).out };
 				}
 
 				w.UInt(key, (uintptr_t)cb.Value->func - (uintptr_t)GetModuleHandle(NULL), json_uint_hex_no_zero_pad);
@@ -760,7 +802,8 @@ static void DumpJsonStructure(JsonWriter& w, std::optional<std::string_view> key
 	w.EndObject();
 }
 
-static void DumpJsonEnum(JsonWriter& w, std::optional<std::string_view> key, parEnumData* e)
+template<class TWriter>
+static void DumpJsonEnum(TWriter& w, std::optional<std::string_view> key, parEnumData* e)
 {
 	if (e == nullptr)
 	{
@@ -770,10 +813,10 @@ static void DumpJsonEnum(JsonWriter& w, std::optional<std::string_view> key, par
 
 	w.BeginObject(key);
 #if RDR3 || GTA5 || GTA5G9
-	w.UInt("name", e->name, json_uint_hex);
+	DumpJsonName(w, "name", e->name);
 	w.String("flags", FlagsToString(e->flags));
 #elif MP3 || GTA4 || RDR2
-	w.String("name", memberToEnumName[e]);
+	w.String("name", enumNames.Find(e));
 	w.String("flags", "");
 #endif
 	w.BeginArray("values");
@@ -787,7 +830,7 @@ static void DumpJsonEnum(JsonWriter& w, std::optional<std::string_view> key, par
 		}
 		else
 		{
-			w.UInt("name", v.name, json_uint_hex);
+			DumpJsonName(w, "name", v.name);
 		}
 		w.Int("value", v.value);
 		w.EndObject();
@@ -796,15 +839,36 @@ static void DumpJsonEnum(JsonWriter& w, std::optional<std::string_view> key, par
 	w.EndObject();
 }
 
-static void DumpJson(parManager* parMgr)
+// Writes the dump through any writer with the JsonWriter interface (JsonWriter or DumpBinaryWriter).
+// Number of threads used to serialize the structs and enums to JSON, set with the DUMPSTRUCTS_THREADS environment variable
+// (0 = one per core). Single-threaded by default. The calls into game code while dumping (GetSize, FindAlign) go through
+// GameCallCache, which serializes them.
+static size_t dumpThreads = 1;
+
+template<class TWriter, class T, class TFunc>
+static void DumpJsonItems(TWriter& w, std::span<T> items, TFunc dumpItem)
+{
+	if constexpr (std::is_same_v<TWriter, JsonWriter>)
+	{
+		// same output as the loop below, only faster. The game code called while dumping may allocate, so the worker threads
+		// need the allocator in TLS like the game threads.
+		WriteJsonItemsParallel(w, items, dumpThreads, dumpItem, [] { SetAllocatorInTls(); });
+	}
+	else
+	{
+		for (auto& item : items)
+		{
+			dumpItem(w, item);
+		}
+	}
+}
+
+template<class TWriter>
+static void DumpJson(TWriter& w, const CollectResult& collection)
 {
-	const auto collection = CollectStructs(parMgr);
 	auto& structs = collection.structs;
 	auto& enums = collection.enums;
 
-	auto baseName = GetDumpBaseName();
-	JsonWriter w{ baseName + ".json" };
-
 	w.BeginObject();
 #if RDR3
 	w.String("game", "rdr3");
@@ -827,26 +891,299 @@ static void DumpJson(parManager* parMgr)
 #endif
 
 	w.BeginArray("structs");
-	for (parStructure* s : structs)
-	{
-		DumpJsonStructure(w, std::nullopt, s);
-	}
+	DumpJsonItems(w, std::span{ structs }, [](auto& w, parStructure* s) { DumpJsonStructure(w, std::nullopt, s); });
 	w.EndArray();
 	w.BeginArray("enums");
-	for (parEnumData* e : enums)
-	{
-		DumpJsonEnum(w, std::nullopt, e);
-	}
+	DumpJsonItems(w, std::span{ enums }, [](auto& w, parEnumData* e) { DumpJsonEnum(w, std::nullopt, e); });
 	w.EndArray();
 	w.EndObject();
 }
 
+// optional dump of an earlier build (usually the previous one) in the game directory, to also write the dump as the changes
+// since it, see DumpDelta.h
+static constexpr const char* baseline_dump_file = "DumpStructs.baseline.json";
+
+static void DumpDelta(const std::string& baseName)
+{
+	MappedFile baseline;
+	if (!baseline.Open(baseline_dump_file))
+	{
+		return;
+	}
+
+	MappedFile dump;
+	if (!dump.Open((baseName + ".json").c_str()))
+	{
+		spdlog::error("Failed to read {}.json to write the delta", baseName);
+		return;
+	}
+
+	try
+	{
+		const auto start = std::chrono::steady_clock::now();
+		JsonWriter w{ baseName + ".delta.json" };
+		const auto stats = WriteDumpDelta(w, baseline.Text(), dump.Text());
+		const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		spdlog::info("Wrote {}.delta.json against build {} in {} ms: {} added, {} changed, {} unchanged, {} removed", baseName,
+			stats.baselineBuild, elapsed.count(), stats.added, stats.changed, stats.unchanged, stats.removed);
+	}
+	catch (const std::exception& ex)
+	{
+		spdlog::error("Failed to write delta dump: {}", ex.what());
+	}
+}
+
+static void DumpJson(parManager* parMgr)
+{
+	const auto collection = CollectStructs(parMgr);
+	auto baseName = GetDumpBaseName();
+	LoadNameDictionary();
+	if (auto threads = GetEnvironmentNumber("DUMPSTRUCTS_THREADS"))
+	{
+		dumpThreads = threads.value() != 0 ? threads.value() : std::max(1u, std::thread::hardware_concurrency());
+	}
+	{
+		const auto start = std::chrono::steady_clock::now();
+		JsonWriter w{ baseName + ".json" };
+		DumpJson(w, collection);
+		const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		spdlog::info("Wrote {}.json in {} ms ({} threads)", baseName, elapsed.count(), dumpThreads);
+	}
+	DumpDelta(baseName);
+	try
+	{
+		DumpBinaryWriter w{ baseName + ".pardump" };
+		DumpJson(w, collection);
+	}
+	catch (const std::exception& ex)
+	{
+		spdlog::error("Failed to write binary dump: {}", ex.what());
+	}
+
+	// the binary dump should not need any call, it gets everything from the cache filled by the JSON dump
+	spdlog::info("Game calls: parMember::GetSize {} ({} cached)", memberSizes.Calls(), memberSizes.Hits());
+#if RDR3 || GTA5 || GTA5G9
+	spdlog::info("            parMember::FindAlign {} ({} cached)", memberAligns.Calls(), memberAligns.Hits());
+	spdlog::info("            parStructure::FindAlign {} ({} cached)", structureAligns.Calls(), structureAligns.Hits());
+#endif
+}
+
+#if RDR3 || GTA5 || GTA5G9
+static void CaptureRange(MemorySnapshotWriter& w, const void* ptr, size_t size)
+{
+	if (ptr != nullptr && size != 0)
+	{
+		w.AddRange(reinterpret_cast<uintptr_t>(ptr), { static_cast<const uint8_t*>(ptr), size });
+	}
+}
+
+static void CaptureString(MemorySnapshotWriter& w, const char* str)
+{
+	if (str != nullptr)
+	{
+		CaptureRange(w, str, strlen(str) + 1);
+	}
+}
+
+static size_t MemberDataSize(parMemberType type)
+{
+	switch (type)
+	{
+	case parMemberType::STRUCT: return sizeof(parMemberStructData);
+	case parMemberType::ARRAY: return sizeof(parMemberArrayData);
+	case parMemberType::ENUM:
+	case parMemberType::BITSET: return sizeof(parMemberEnumData);
+	case parMemberType::MAP: return sizeof(parMemberMapData);
+	case parMemberType::STRING: return sizeof(parMemberStringData);
+	case parMemberType::MATRIX34:
+	case parMemberType::MATRIX44:
+	case parMemberType::MAT33V:
+	case parMemberType::MAT34V:
+	case parMemberType::MAT44V: return sizeof(parMemberMatrixData);
+	case parMemberType::VECTOR2:
+	case parMemberType::VECTOR3:
+	case parMemberType::VECTOR4:
+	case parMemberType::VEC2V:
+	case parMemberType::VEC3V:
+	case parMemberType::VEC4V:
+	case parMemberType::VECBOOLV:
+#if RDR3
+	case parMemberType::VEC2F:
+	case parMemberType::QUATV:
+#endif
+		return sizeof(parMemberVectorData);
+	default: return sizeof(parMemberSimpleData);
+	}
+}
+
+static void CaptureAttributeList(MemorySnapshotWriter& w, parAttributeList* attributes)
+{
+	if (attributes == nullptr)
+	{
+		return;
+	}
+
+	CaptureRange(w, attributes, sizeof(parAttributeList));
+	auto& list = attributes->attributes;
+	CaptureRange(w, list.Items, list.Count * sizeof(parAttribute));
+	for (size_t i = 0; i < list.Count; i++)
+	{
+		CaptureString(w, list.Items[i].name);
+		if (list.Items[i].type == parAttribute::String)
+		{
+			CaptureString(w, list.Items[i].value.asString);
+		}
+	}
+}
+
+static void CaptureMember(MemorySnapshotWriter& w, parMember* member)
+{
+	if (member == nullptr)
+	{
+		return;
+	}
+
+	auto* m = member->data;
+	CaptureRange(w, m, MemberDataSize(m->type));
+	CaptureAttributeList(w, m->attributes);
+	w.AddAnnotation(reinterpret_cast<uintptr_t>(member), MemorySnapshotAnnotationKind::MemberSize, memberSizes.Get(member, [member] { return member->GetSize(); }));
+	w.AddAnnotation(reinterpret_cast<uintptr_t>(member), MemorySnapshotAnnotationKind::MemberAlign, memberAligns.Get(member, [member] { return member->FindAlign(); }));
+	switch (m->type)
+	{
+	case parMemberType::ARRAY:
+	{
+		auto* array = static_cast<parMemberArray*>(member);
+		CaptureRange(w, array, sizeof(parMemberArray));
+		CaptureRange(w, static_cast<parMemberArrayData*>(m)->virtualCallback, sizeof(parDelegateHolderBase));
+		CaptureMember(w, array->item);
+	}
+	break;
+	case parMemberType::MAP:
+	{
+		auto* map = static_cast<parMemberMap*>(member);
+		auto* mapData = static_cast<parMemberMapData*>(m);
+		CaptureRange(w, map, sizeof(parMemberMap));
+		CaptureRange(w, mapData->createIterator, sizeof(parDelegateHolderBase));
+		CaptureRange(w, mapData->createInterface, sizeof(parDelegateHolderBase));
+		CaptureMember(w, map->key);
+		CaptureMember(w, map->value);
+	}
+	break;
+	default:
+		CaptureRange(w, member, sizeof(parMember));
+		break;
+	}
+}
+
+static void CaptureEnum(MemorySnapshotWriter& w, parEnumData* e)
+{
+	if (e == nullptr)
+	{
+		return;
+	}
+
+	CaptureRange(w, e, sizeof(parEnumData));
+	CaptureRange(w, e->values, e->valueCount * sizeof(parEnumValueData));
+	if (e->valueNames != nullptr)
+	{
+		CaptureRange(w, e->valueNames, e->valueCount * sizeof(const char*));
+		for (size_t i = 0; i < e->valueCount; i++)
+		{
+			CaptureString(w, e->valueNames[i]);
+		}
+	}
+}
+
+// Saves the memory read while dumping, plus the results of the game calls, so the dump can be redone offline from the
+// snapshot (see DumpTools snapshot-dump). The values that need a game call are recorded as annotations.
+static void CaptureSnapshot(parManager* parMgr)
+{
+	const auto start = std::chrono::steady_clock::now();
+	const auto collection = CollectStructs(parMgr);
+#if RDR3
+	MemorySnapshotWriter w{ "rdr3", reinterpret_cast<uintptr_t>(GetModuleHandle(NULL)), reinterpret_cast<uintptr_t>(parMgr) };
+#elif GTA5
+	MemorySnapshotWriter w{ "gta5", reinterpret_cast<uintptr_t>(GetModuleHandle(NULL)), reinterpret_cast<uintptr_t>(parMgr) };
+#elif GTA5G9
+	MemorySnapshotWriter w{ "gta5g9", reinterpret_cast<uintptr_t>(GetModuleHandle(NULL)), reinterpret_cast<uintptr_t>(parMgr) };
+#endif
+
+	CaptureRange(w, parMgr, sizeof(parManager));
+	auto& map = parMgr->structures;
+	CaptureRange(w, map.Buckets, map.NumBuckets * sizeof(*map.Buckets));
+	for (size_t i = 0; i < map.NumBuckets; i++)
+	{
+		for (auto* entry = map.Buckets[i]; entry != nullptr; entry = entry->next)
+		{
+			CaptureRange(w, entry, sizeof(*entry));
+		}
+	}
+
+	for (parStructure* s : collection.structs)
+	{
+		CaptureRange(w, s, sizeof(parStructure));
+		CaptureRange(w, s->members.Items, s->members.Count * sizeof(parMember*));
+		for (size_t i = 0; i < s->members.Count; i++)
+		{
+			CaptureMember(w, s->members.Items[i]);
+		}
+		CaptureAttributeList(w, s->extraAttributes);
+		CaptureRange(w, s->callbacks.Pairs.Items, s->callbacks.Pairs.Count * sizeof(*s->callbacks.Pairs.Items));
+		for (size_t i = 0; i < s->callbacks.Pairs.Count; i++)
+		{
+			CaptureRange(w, s->callbacks.Pairs.Items[i].Value, sizeof(parDelegateHolderBase));
+		}
+		w.AddAnnotation(reinterpret_cast<uintptr_t>(s), MemorySnapshotAnnotationKind::StructureAlign, structureAligns.Get(s, [s] { return s->FindAlign(); }));
+
+		if (auto it = structureToStaticData.find(s); it != structureToStaticData.end())
+		{
+			auto* d = it->second;
+			CaptureRange(w, d, sizeof(parStructureStaticData));
+			CaptureString(w, d->nameStr);
+			if (d->memberNames != nullptr)
+			{
+				CaptureRange(w, d->memberNames, s->members.Count * sizeof(const char*));
+				for (size_t i = 0; i < s->members.Count; i++)
+				{
+					CaptureString(w, d->memberNames[i]);
+				}
+			}
+			w.AddAnnotation(reinterpret_cast<uintptr_t>(s), MemorySnapshotAnnotationKind::StructureStaticData, reinterpret_cast<uintptr_t>(d));
+		}
+	}
+
+	for (parEnumData* e : collection.enums)
+	{
+		CaptureEnum(w, e);
+	}
+
+	auto [major, minor, build, revision] = GetGameBuild();
+	w.AddAnnotation(0, MemorySnapshotAnnotationKind::GameBuild,
+		static_cast<uint64_t>(major) << 48 | static_cast<uint64_t>(minor) << 32 | static_cast<uint64_t>(build) << 16 | revision);
+
+	const auto path = GetDumpBaseName() + ".snapshot";
+	if (!w.Save(path))
+	{
+		spdlog::error("Failed to write {}", path);
+		return;
+	}
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+	spdlog::info("Wrote {} in {} ms ({} structures, {} enums, {} ranges, {} bytes)", path, elapsed.count(),
+		collection.structs.size(), collection.enums.size(), w.RangeCount(), w.ByteCount());
+}
+#endif
+
+
+// calls to the hooks that see parStructures being registered, used to detect when the game is done registering them
+static std::atomic<uint32_t> numRegistrations = 0;
 
 #if RDR3 || GTA5 || GTA5G9
 static void(*rage__parStructure__BuildStructureFromStaticData_orig)(parStructure* This, parStructureStaticData* staticData);
 static void rage__parStructure__BuildStructureFromStaticData_detour(parStructure* This, parStructureStaticData* staticData)
 {
 	structureToStaticData[This] = staticData;
+	numRegistrations++;
 	
 	rage__parStructure__BuildStructureFromStaticData_orig(This, staticData);
 }
@@ -855,14 +1192,7 @@ static void rage__parStructure__BuildStructureFromStaticData_detour(parStructure
 static void EarlyInit()
 {
 #if RDR3 || GTA5 || GTA5G9
-	void* rage__parStructure__BuildStructureFromStaticData =
-#if RDR3
-		hook::get_pattern("89 41 30 41 BF ? ? ? ? 4D 85 F6 74 58", -0x24);
-#elif GTA5
-		hook::get_pattern("48 8B 05 ? ? ? ? 48 83 7A ? ? 48 8B FA 44 8A 60 5C 8B 02", -0x1D);
-#elif GTA5G9
-		hook::get_pattern("48 8B 05 ? ? ? ? 44 0F B6 B8 ? ? ? ? 4C 8B 72", -0x14);
-#endif
+	void* rage__parStructure__BuildStructureFromStaticData = GetPattern<GamePattern::BuildStructureFromStaticData>();
 
 	MH_Initialize();
 	MH_CreateHook(rage__parStructure__BuildStructureFromStaticData, &rage__parStructure__BuildStructureFromStaticData_detour, (void**)&rage__parStructure__BuildStructureFromStaticData_orig);
@@ -870,7 +1200,7 @@ static void EarlyInit()
 #elif MP3
 	// the game unregisters some structs after using them
 	// disable rage::parManager::UnregisterStructure
-	uint8_t* rage__parManager__UnregisterStructure = hook::get_pattern<uint8_t>("83 EC 0C 83 7C 24 ? ? 56 8B F1 0F 84 ? ? ? ? A1 ? ? ? ? 53");
+	uint8_t* rage__parManager__UnregisterStructure = GetPattern<GamePattern::UnregisterStructure, uint8_t>();
 	spdlog::info("*rage__parManager__UnregisterStructure = {}", (void*)rage__parManager__UnregisterStructure); spdlog::default_logger()->flush();
 	DWORD  oldProtect;
 	VirtualProtect(rage__parManager__UnregisterStructure, 3, PAGE_EXECUTE_READWRITE, &oldProtect);
@@ -882,18 +1212,75 @@ static void EarlyInit()
 #endif
 }
 
+// Waits until the game has registered all the parStructures.
+static void WaitForDump()
+{
+	DumpTriggerOptions options;
+#if RDR3 || GTA5 || GTA5G9
+	// parManager may only be initialized later by InitParManager, but the BuildStructureFromStaticData hook sees the
+	// structures being registered
+	options.requireManager = false;
+#endif
+	if (auto timeout = GetEnvironmentNumber("DUMPSTRUCTS_TIMEOUT"))
+	{
+		options.timeoutMs = timeout.value() * 1000;
+	}
+	if (auto stable = GetEnvironmentNumber("DUMPSTRUCTS_STABLE"))
+	{
+		options.stableMs = stable.value() * 1000;
+	}
+	if (auto quiet = GetEnvironmentNumber("DUMPSTRUCTS_QUIET"))
+	{
+		options.quietMs = quiet.value() * 1000;
+	}
+	spdlog::info("Waiting for the game to register its structures (timeout {} s, stable {} s, quiet {} s)...",
+		options.timeoutMs / 1000, options.stableMs / 1000, options.quietMs / 1000); spdlog::default_logger()->flush();
+
+	DumpTrigger trigger{ options, GetTickCount64() };
+	DumpTriggerState lastState = trigger.State();
+	while (!trigger.IsDone())
+	{
+		Sleep(100);
+
+		parManager* parMgr = *parManager::sm_Instance;
+		const DumpTriggerState state = trigger.Update({ GetTickCount64(), parMgr != nullptr, parMgr ? parMgr->structures.NumEntries : 0u, numRegistrations.load() });
+		if (state != lastState)
+		{
+			spdlog::info("  {} after {} ms ({} structures, {} registrations)", EnumToString(state), trigger.ElapsedMs(),
+				parMgr ? parMgr->structures.NumEntries : 0u, numRegistrations.load());
+			lastState = state;
+		}
+	}
+
+	if (trigger.State() == DumpTriggerState::TimedOut)
+	{
+		spdlog::warn("Timed out after {} ms, dumping anyway", trigger.ElapsedMs());
+	}
+	else
+	{
+		spdlog::info("Ready to dump after {} ms", trigger.ElapsedMs());
+	}
+	spdlog::default_logger()->flush();
+}
+
 static DWORD WINAPI Main()
 {
 	spdlog::set_default_logger(spdlog::basic_logger_mt("file_logger", "DumpStructs.log"));
 	spdlog::info("Initializing...");
 
+	if (!InitPatterns(GetGameBuild()))
+	{
+		spdlog::error("Not every pattern was found, returning"); spdlog::default_logger()->flush();
+		return 0;
+	}
+
 	EarlyInit();
 	
 	FindParManager();
 
 	spdlog::info("Initialization finished");spdlog::default_logger()->flush();
 
-	Sleep(25'000);
+	WaitForDump();
 	
 	spdlog::info("*parManager::sm_Instance = {}", (void*)*parManager::sm_Instance); spdlog::default_logger()->flush();
 	if (*parManager::sm_Instance == nullptr)
@@ -910,6 +1297,23 @@ static DWORD WINAPI Main()
 
 	PreDump();
 
+#if RDR3 || GTA5 || GTA5G9
+	if (const auto snapshotMode = GetEnvironmentNumber("DUMPSTRUCTS_SNAPSHOT").value_or(0); snapshotMode != 0)
+	{
+		// only the snapshot is taken and the game closed as soon as possible, the dumps are made offline from it. With
+		// DUMPSTRUCTS_SNAPSHOT=2 the dumps are also written in the game, to check the offline ones against them (see
+		// DumpTools snapshot-check)
+		if (snapshotMode == 2)
+		{
+			DumpJson(*parManager::sm_Instance);
+		}
+		CaptureSnapshot(*parManager::sm_Instance);
+		spdlog::info("Snapshot captured, closing the game"); spdlog::default_logger()->flush();
+		TerminateProcess(GetCurrentProcess(), 0);
+		return 0;
+	}
+#endif
+
 	DumpJson(*parManager::sm_Instance);
 	return 0;
 }
@@ -1,226 +1,173 @@
 #if RDR3 || GTA5 || GTA5G9
 #include "rage.h"
-#include <Hooking.Patterns.h>
+#include "GamePatterns.h"
+#include "ParLayout.h"
+#include "ScratchArena.h"
+#include <cstddef>
 
 parManager** parManager::sm_Instance = nullptr;
 
-
-uint32_t parStructure::FindAlign()
-{
-	using fn_t = uint32_t(parStructure*);
-	static fn_t* fn =
+// the out-of-process walker reads these structures through ParLayout
 #if RDR3
-		hook::get_pattern<fn_t>("0F B7 41 52 33 ED 48 8B F9 66 85 C0", -0x14);
+constexpr const ParLayout& par_layout = rdr3_par_layout;
 #elif GTA5
-		hook::get_pattern<fn_t>("0F B7 41 2A 33 F6 48 8B F9 66 85 C0 74 05", -0xF);
+constexpr const ParLayout& par_layout = gta5_par_layout;
 #elif GTA5G9
-		hook::get_pattern<fn_t>("56 57 53 48 83 EC ? 0F B7 41 ? 48 85 C0 75");
+constexpr const ParLayout& par_layout = gta5g9_par_layout;
 #endif
+using parStructureMap = atMap<uint32_t, parStructure*>;
+static_assert(offsetof(parManager, structures) == par_layout.managerStructures);
+static_assert(offsetof(parStructureMap, NumBuckets) == par_layout.mapNumBuckets);
+static_assert(sizeof(parManager::structures.NumBuckets) == par_layout.mapCountSize);
+static_assert(offsetof(parStructureMap::Entry, value) == par_layout.mapEntryValue);
+static_assert(offsetof(parStructureMap::Entry, next) == par_layout.mapEntryNext);
+static_assert(sizeof(parStructureMap::Entry) == par_layout.mapEntrySize);
+static_assert(sizeof(parStructure) == par_layout.structureSize);
+static_assert(offsetof(parStructure, name) == par_layout.structureName);
+static_assert(offsetof(parStructure, baseStructure) == par_layout.structureBase);
+static_assert(offsetof(parStructure, baseOffset) == par_layout.structureBaseOffset);
+static_assert(offsetof(parStructure, structureSize) == par_layout.structureStructureSize);
+static_assert(offsetof(parStructure, flags) == par_layout.structureFlags);
+static_assert(sizeof(parStructure::Flags) == par_layout.structureFlagsSize);
+static_assert(offsetof(parStructure, align) == par_layout.structureAlign);
+static_assert(offsetof(parStructure, versionMajor) == par_layout.structureVersionMajor);
+static_assert(offsetof(parStructure, versionMinor) == par_layout.structureVersionMinor);
+static_assert(offsetof(parStructure, members) == par_layout.structureMembers);
+static_assert(offsetof(parStructure, extraAttributes) == par_layout.structureExtraAttributes);
+static_assert(offsetof(parStructure, factoryNew) == par_layout.structureFactoryNew);
+static_assert(offsetof(parStructure, factoryPlacementNew) == par_layout.structureFactoryPlacementNew);
+static_assert(offsetof(parStructure, getStructureCB) == par_layout.structureGetStructureCB);
+static_assert(offsetof(parStructure, factoryDelete) == par_layout.structureFactoryDelete);
+static_assert(offsetof(parStructure, callbacks) == par_layout.structureCallbacks);
+static_assert(sizeof(parMemberCommonData) == par_layout.dataSize);
+static_assert(offsetof(parMemberCommonData, offset) == par_layout.dataOffset);
+static_assert(offsetof(parMemberCommonData, type) == par_layout.dataType);
+static_assert(offsetof(parMemberCommonData, subType) == par_layout.dataSubType);
+static_assert(offsetof(parMemberCommonData, flags1) == par_layout.dataFlags1);
+static_assert(offsetof(parMemberCommonData, flags2) == par_layout.dataFlags2);
+static_assert(offsetof(parMemberCommonData, extraData) == par_layout.dataExtraData);
+static_assert(offsetof(parMemberCommonData, attributes) == par_layout.dataAttributes);
+static_assert(offsetof(parMemberStructData, structure) == par_layout.dataStructStructure);
+static_assert(offsetof(parMemberStructData, externalNamedResolve) == par_layout.dataStructExternalNamedResolve);
+static_assert(offsetof(parMemberStructData, externalNamedGetName) == par_layout.dataStructExternalNamedGetName);
+static_assert(offsetof(parMemberStructData, allocateStruct) == par_layout.dataStructAllocateStruct);
+static_assert(offsetof(parMemberEnumData, initValue) == par_layout.dataEnumInitValue);
+static_assert(sizeof(parMemberEnumData::initValue) == par_layout.dataEnumInitValueSize);
+static_assert(offsetof(parMemberEnumData, enumData) == par_layout.dataEnumEnumData);
+static_assert(offsetof(parMemberArrayData, arraySize) == par_layout.dataArraySize);
+static_assert(offsetof(parMemberStringData, memberSize) == par_layout.dataStringMemberSize);
+static_assert(offsetof(parMemberMapData, createIterator) == par_layout.dataMapCreateIterator);
+static_assert(offsetof(parMemberMapData, createInterface) == par_layout.dataMapCreateInterface);
+static_assert(offsetof(parMemberSimpleData, initValue) == par_layout.dataSimpleInitValue);
+static_assert(sizeof(parMemberSimpleData::initValue) == par_layout.dataEnumInitValueSize);
+static_assert(offsetof(parMemberVectorData, initValues) == par_layout.dataInitValues);
+static_assert(offsetof(parMemberMatrixData, initValues) == par_layout.dataInitValues);
+static_assert(sizeof(parAttributeList) == par_layout.attributeListSize);
+static_assert(offsetof(parAttributeList, UserData1) == par_layout.attributeListUserData1);
+static_assert(offsetof(parAttributeList, UserData2) == par_layout.attributeListUserData2);
+static_assert(sizeof(parAttribute) == par_layout.attributeSize);
+static_assert(offsetof(parAttribute, value) == par_layout.attributeValue);
+static_assert(offsetof(parAttribute, type) == par_layout.attributeType);
+static_assert(sizeof(parEnumData) == par_layout.enumSize);
+static_assert(offsetof(parEnumData, valueNames) == par_layout.enumValueNames);
+static_assert(offsetof(parEnumData, valueCount) == par_layout.enumValueCount);
+static_assert(offsetof(parEnumData, flags) == par_layout.enumFlags);
+static_assert(offsetof(parEnumData, name) == par_layout.enumName);
+static_assert(sizeof(parEnumValueData) == par_layout.enumValueSize);
+static_assert(offsetof(parEnumValueData, value) == par_layout.enumValueValue);
+static_assert(offsetof(parStructureStaticData, nameStr) == par_layout.staticDataNameStr);
+static_assert(offsetof(parStructureStaticData, memberNames) == par_layout.staticDataMemberNames);
+// ParLayoutMemberType is built from the RDR3 list, of which the GTA5 one is the start
+#define PAR_CHECK_MEMBER_TYPE(name, value) static_assert(static_cast<uint8_t>(parMemberType::name) == static_cast<uint8_t>(ParLayoutMemberType::name));
+PAR_MEMBER_TYPES(PAR_CHECK_MEMBER_TYPE)
+#undef PAR_CHECK_MEMBER_TYPE
+
+
+uint32_t parStructure::FindAlign()
+{
+	using fn_t = uint32_t(parStructure*);
+	static fn_t* fn = GetPattern<GamePattern::FindAlign, fn_t>();
 
 	return fn(this);
 }
 
-std::string SubtypeToStr(parMemberType type, uint8_t subtype)
-{
-	switch (type)
-	{
-	case parMemberType::ARRAY:
-		switch (static_cast<parMemberArraySubtype>(subtype))
-		{
-		case parMemberArraySubtype::ATARRAY: return "ATARRAY";
-		case parMemberArraySubtype::ATFIXEDARRAY: return "ATFIXEDARRAY";
-		case parMemberArraySubtype::ATRANGEARRAY: return "ATRANGEARRAY";
-		case parMemberArraySubtype::POINTER: return "POINTER";
-		case parMemberArraySubtype::MEMBER: return "MEMBER";
-		case parMemberArraySubtype::_0x2087BB00: return "_0x2087BB00";
-		case parMemberArraySubtype::POINTER_WITH_COUNT: return "POINTER_WITH_COUNT";
-		case parMemberArraySubtype::POINTER_WITH_COUNT_8BIT_IDX: return "POINTER_WITH_COUNT_8BIT_IDX";
-		case parMemberArraySubtype::POINTER_WITH_COUNT_16BIT_IDX: return "POINTER_WITH_COUNT_16BIT_IDX";
-		case parMemberArraySubtype::VIRTUAL: return "VIRTUAL";
-		}
-		break;
-	case parMemberType::ENUM:
-		switch (static_cast<parMemberEnumSubtype>(subtype))
-		{
-#if RDR3
-		case parMemberEnumSubtype::_64BIT: return "_64BIT";
-#endif
-		case parMemberEnumSubtype::_32BIT: return "_32BIT";
-		case parMemberEnumSubtype::_16BIT: return "_16BIT";
-		case parMemberEnumSubtype::_8BIT: return "_8BIT";
-		}
-		break;
-	case parMemberType::BITSET:
-		switch (static_cast<parMemberBitsetSubtype>(subtype))
-		{
+constexpr auto member_type_names = ENUM_NAME_TABLE(parMemberType, PAR_MEMBER_TYPES);
+constexpr auto attribute_type_names = ENUM_NAME_TABLE(parAttribute::Type, PAR_ATTRIBUTE_TYPES);
+constexpr auto common_subtype_names = ENUM_NAME_TABLE(parMemberCommonSubtype, PAR_MEMBER_COMMON_SUBTYPES);
+constexpr auto array_subtype_names = ENUM_NAME_TABLE(parMemberArraySubtype, PAR_MEMBER_ARRAY_SUBTYPES);
+constexpr auto enum_subtype_names = ENUM_NAME_TABLE(parMemberEnumSubtype, PAR_MEMBER_ENUM_SUBTYPES);
+constexpr auto bitset_subtype_names = ENUM_NAME_TABLE(parMemberBitsetSubtype, PAR_MEMBER_BITSET_SUBTYPES);
+constexpr auto map_subtype_names = ENUM_NAME_TABLE(parMemberMapSubtype, PAR_MEMBER_MAP_SUBTYPES);
+constexpr auto string_subtype_names = ENUM_NAME_TABLE(parMemberStringSubtype, PAR_MEMBER_STRING_SUBTYPES);
+constexpr auto struct_subtype_names = ENUM_NAME_TABLE(parMemberStructSubtype, PAR_MEMBER_STRUCT_SUBTYPES);
 #if RDR3
-		case parMemberBitsetSubtype::_64BIT: return "_64BIT";
+constexpr auto guid_subtype_names = ENUM_NAME_TABLE(parMemberGuidSubtype, PAR_MEMBER_GUID_SUBTYPES);
 #endif
-		case parMemberBitsetSubtype::_32BIT: return "_32BIT";
-		case parMemberBitsetSubtype::_16BIT: return "_16BIT";
-		case parMemberBitsetSubtype::_8BIT: return "_8BIT";
-		case parMemberBitsetSubtype::ATBITSET: return "ATBITSET";
-		}
-		break;
-	case parMemberType::MAP:
-		switch (static_cast<parMemberMapSubtype>(subtype))
-		{
-		case parMemberMapSubtype::ATMAP: return "ATMAP";
-		case parMemberMapSubtype::ATBINARYMAP: return "ATBINARYMAP";
-		}
-		break;
-	case parMemberType::STRING:
-		switch (static_cast<parMemberStringSubtype>(subtype))
-		{
-		case parMemberStringSubtype::MEMBER: return "MEMBER";
-		case parMemberStringSubtype::POINTER: return "POINTER";
-		case parMemberStringSubtype::CONST_STRING: return "CONST_STRING";
-		case parMemberStringSubtype::ATSTRING: return "ATSTRING";
-		case parMemberStringSubtype::WIDE_MEMBER: return "WIDE_MEMBER";
-		case parMemberStringSubtype::WIDE_POINTER: return "WIDE_POINTER";
-		case parMemberStringSubtype::ATWIDESTRING: return "ATWIDESTRING";
-		case parMemberStringSubtype::ATNONFINALHASHSTRING: return "ATNONFINALHASHSTRING";
-		case parMemberStringSubtype::ATFINALHASHSTRING: return "ATFINALHASHSTRING";
-		case parMemberStringSubtype::ATHASHVALUE: return "ATHASHVALUE";
-		case parMemberStringSubtype::ATPARTIALHASHVALUE: return "ATPARTIALHASHVALUE";
-		case parMemberStringSubtype::ATNSHASHSTRING: return "ATNSHASHSTRING";
-		case parMemberStringSubtype::ATNSHASHVALUE: return "ATNSHASHVALUE";
-#if RDR3
-		case parMemberStringSubtype::ATHASHVALUE16U: return "ATHASHVALUE16U";
-#endif
-		}
-		break;
-	case parMemberType::STRUCT:
-		switch (static_cast<parMemberStructSubtype>(subtype))
-		{
-		case parMemberStructSubtype::STRUCTURE: return "STRUCTURE";
-		case parMemberStructSubtype::EXTERNAL_NAMED: return "EXTERNAL_NAMED";
-		case parMemberStructSubtype::EXTERNAL_NAMED_USERNULL: return "EXTERNAL_NAMED_USERNULL";
-		case parMemberStructSubtype::POINTER: return "POINTER";
-		case parMemberStructSubtype::SIMPLE_POINTER: return "SIMPLE_POINTER";
-		}
-		break;
-#if RDR3
-	case parMemberType::GUID:
-		switch (static_cast<parMemberGuidSubtype>(subtype))
-		{
-		case parMemberGuidSubtype::_0xDF7EBE85: return "_0xDF7EBE85";
-		}
-		break;
-#endif
-	default:
-		switch (static_cast<parMemberCommonSubtype>(subtype))
-		{
-		case parMemberCommonSubtype::COLOR: return "COLOR";
+constexpr auto enum_flags_names = FLAG_NAME_TABLE(parEnumFlags, PAR_ENUM_FLAGS);
+constexpr auto structure_flags_names = FLAG_NAME_TABLE(parStructure::Flags, PAR_STRUCTURE_FLAGS);
+constexpr auto array_alloc_flags_names = FLAG_NAME_TABLE(parMemberArrayData::AllocFlags, PAR_MEMBER_ARRAY_ALLOC_FLAGS);
+
+// the enums are numbered from 0 with no gaps, besides the common subtypes which start at 1
+static_assert(member_type_names.HasUniqueValues() && member_type_names.IsDense());
+static_assert(attribute_type_names.HasUniqueValues() && attribute_type_names.IsDense());
+static_assert(common_subtype_names.HasUniqueValues());
+static_assert(array_subtype_names.HasUniqueValues() && array_subtype_names.IsDense());
+static_assert(enum_subtype_names.HasUniqueValues() && enum_subtype_names.IsDense());
+static_assert(bitset_subtype_names.HasUniqueValues() && bitset_subtype_names.IsDense());
+static_assert(map_subtype_names.HasUniqueValues() && map_subtype_names.IsDense());
+static_assert(string_subtype_names.HasUniqueValues() && string_subtype_names.IsDense());
+static_assert(struct_subtype_names.HasUniqueValues() && struct_subtype_names.IsDense());
 #if RDR3
-		case parMemberCommonSubtype::ANGLE: return "ANGLE";
+static_assert(guid_subtype_names.HasUniqueValues() && guid_subtype_names.IsDense());
 #endif
-		}
-	}
-
-	return std::to_string(subtype);
-}
+static_assert(enum_flags_names.IsBitPerFlag());
+static_assert(structure_flags_names.IsBitPerFlag());
+static_assert(array_alloc_flags_names.IsBitPerFlag());
+static_assert(member_type_names(parMemberType::DOUBLE) == "DOUBLE");
+static_assert(structure_flags_names(parStructure::Flags::HAS_NAMES | parStructure::Flags::_0x22A1FBDB) == "HAS_NAMES, _0x22A1FBDB");
 
-const char* EnumToString(parMemberType type)
+std::string_view SubtypeToStr(parMemberType type, uint8_t subtype)
 {
+	std::string_view name;
 	switch (type)
 	{
-	case parMemberType::BOOL: return "BOOL";
-	case parMemberType::CHAR: return "CHAR";
-	case parMemberType::UCHAR: return "UCHAR";
-	case parMemberType::SHORT: return "SHORT";
-	case parMemberType::USHORT: return "USHORT";
-	case parMemberType::INT: return "INT";
-	case parMemberType::UINT: return "UINT";
-	case parMemberType::FLOAT: return "FLOAT";
-	case parMemberType::VECTOR2: return "VECTOR2";
-	case parMemberType::VECTOR3: return "VECTOR3";
-	case parMemberType::VECTOR4: return "VECTOR4";
-	case parMemberType::STRING: return "STRING";
-	case parMemberType::STRUCT: return "STRUCT";
-	case parMemberType::ARRAY: return "ARRAY";
-	case parMemberType::ENUM: return "ENUM";
-	case parMemberType::BITSET: return "BITSET";
-	case parMemberType::MAP: return "MAP";
-	case parMemberType::MATRIX34: return "MATRIX34";
-	case parMemberType::MATRIX44: return "MATRIX44";
-	case parMemberType::VEC2V: return "VEC2V";
-	case parMemberType::VEC3V: return "VEC3V";
-	case parMemberType::VEC4V: return "VEC4V";
-	case parMemberType::MAT33V: return "MAT33V";
-	case parMemberType::MAT34V: return "MAT34V";
-	case parMemberType::MAT44V: return "MAT44V";
-	case parMemberType::SCALARV: return "SCALARV";
-	case parMemberType::BOOLV: return "BOOLV";
-	case parMemberType::VECBOOLV: return "VECBOOLV";
-	case parMemberType::PTRDIFFT: return "PTRDIFFT";
-	case parMemberType::SIZET: return "SIZET";
-	case parMemberType::FLOAT16: return "FLOAT16";
-	case parMemberType::INT64: return "INT64";
-	case parMemberType::UINT64: return "UINT64";
-	case parMemberType::DOUBLE: return "DOUBLE";
+	case parMemberType::ARRAY: name = array_subtype_names(static_cast<parMemberArraySubtype>(subtype)); break;
+	case parMemberType::ENUM: name = enum_subtype_names(static_cast<parMemberEnumSubtype>(subtype)); break;
+	case parMemberType::BITSET: name = bitset_subtype_names(static_cast<parMemberBitsetSubtype>(subtype)); break;
+	case parMemberType::MAP: name = map_subtype_names(static_cast<parMemberMapSubtype>(subtype)); break;
+	case parMemberType::STRING: name = string_subtype_names(static_cast<parMemberStringSubtype>(subtype)); break;
+	case parMemberType::STRUCT: name = struct_subtype_names(static_cast<parMemberStructSubtype>(subtype)); break;
 #if RDR3
-	case parMemberType::GUID: return "GUID";
-	case parMemberType::VEC2F: return "VEC2F";
-	case parMemberType::QUATV: return "QUATV";
+	case parMemberType::GUID: name = guid_subtype_names(static_cast<parMemberGuidSubtype>(subtype)); break;
 #endif
-	default: return "UNKNOWN";
+	default: name = common_subtype_names(static_cast<parMemberCommonSubtype>(subtype)); break;
 	}
+
+	return !name.empty() ? name : ByteToString(subtype);
 }
 
-const char* EnumToString(parAttribute::Type type)
+std::string_view EnumToString(parMemberType type)
 {
-	switch (type)
-	{
-	case parAttribute::Type::String: return "String";
-	case parAttribute::Type::Int64:  return "Int64";
-	case parAttribute::Type::Double: return "Double";
-	case parAttribute::Type::Bool:   return "Bool";
-	default: return "UNKNOWN";
-	}
+	return member_type_names(type, "UNKNOWN");
 }
 
-static void FlagsToStringAppend(std::string& s, const char* flagStr)
+std::string_view EnumToString(parAttribute::Type type)
 {
-	if (s.size() > 0) s += ", ";
-	s += flagStr;
+	return attribute_type_names(type, "UNKNOWN");
 }
 
-#define FLAG_APPEND(flag) if ((flags & FLAG_TYPE::flag) == FLAG_TYPE::flag) FlagsToStringAppend(result, #flag)
-
-std::string FlagsToString(parEnumFlags flags)
+std::string_view FlagsToString(parEnumFlags flags)
 {
-	std::string result = "";
-#define FLAG_TYPE parEnumFlags
-	FLAG_APPEND(ENUM_STATIC);
-	FLAG_APPEND(ENUM_HAS_NAMES);
-	FLAG_APPEND(ENUM_ALWAYS_HAS_NAMES);
-#undef FLAG_TYPE
-	return result;
+	return enum_flags_names(flags);
 }
 
-std::string FlagsToString(parStructure::Flags flags)
+std::string_view FlagsToString(parStructure::Flags flags)
 {
-	std::string result = "";
-#define FLAG_TYPE parStructure::Flags
-	FLAG_APPEND(_0xB9C5D274);
-	FLAG_APPEND(HAS_NAMES);
-	FLAG_APPEND(ALWAYS_HAS_NAMES);
-	FLAG_APPEND(_0x25CB183C);
-	FLAG_APPEND(_0x62BE3669);
-	FLAG_APPEND(_0x22A1FBDB);
-#undef FLAG_TYPE
-	return result;
+	return structure_flags_names(flags);
 }
 
-std::string FlagsToString(parMemberArrayData::AllocFlags flags)
+std::string_view FlagsToString(parMemberArrayData::AllocFlags flags)
 {
-	std::string result = "";
-#define FLAG_TYPE parMemberArrayData::AllocFlags
-	FLAG_APPEND(USE_PHYSICAL_ALLOCATOR);
-#undef FLAG_TYPE
-	return result;
+	return array_alloc_flags_names(flags);
 }
-
-#undef FLAG_APPEND
 #endif
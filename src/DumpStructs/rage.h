@@ -1,8 +1,11 @@
 #pragma once
 #if RDR3 || GTA5 || GTA5G9
 
+#include "EnumNames.h"
+#include "ParEnumLists.h"
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <Windows.h>
 
 
@@ -61,10 +64,7 @@ struct parAttribute
 {
 	enum Type : uint8_t
 	{
-		String = 0,
-		Int64 = 1,
-		Double = 2,
-		Bool = 3,
+		PAR_ATTRIBUTE_TYPES(ENUM_DEFINE_VALUE)
 	};
 
 	union Value
@@ -101,141 +101,88 @@ struct parAttributeList
 	Flags flags;
 };
 
-enum class parMemberType : uint8_t // 0x1CA39C3D
-{
-	BOOL = 0,
-	CHAR = 1,
-	UCHAR = 2,
-	SHORT = 3,
-	USHORT = 4,
-	INT = 5,
-	UINT = 6,
-	FLOAT = 7,
-	VECTOR2 = 8,
-	VECTOR3 = 9,
-	VECTOR4 = 10,
-	STRING = 11,
-	STRUCT = 12,
-	ARRAY = 13,
-	ENUM = 14,
-	BITSET = 15,
-	MAP = 16,
-	MATRIX34 = 17,
-	MATRIX44 = 18,
-	VEC2V = 19,
-	VEC3V = 20,
-	VEC4V = 21,
-	MAT33V = 22,
-	MAT34V = 23,
-	MAT44V = 24,
-	SCALARV = 25,
-	BOOLV = 26,
-	VECBOOLV = 27,
-	PTRDIFFT = 28,
-	SIZET = 29,
-	FLOAT16 = 30,
-	INT64 = 31,
-	UINT64 = 32,
-	DOUBLE = 33,
+// 0x1CA39C3D
 #if RDR3
-	GUID = 34,
-	VEC2F = 35,
-	QUATV = 36,
+#define PAR_MEMBER_TYPES(X) PAR_MEMBER_TYPES_RDR3(X)
+#else
+#define PAR_MEMBER_TYPES(X) PAR_MEMBER_TYPES_GTA5(X)
 #endif
-};
 
-enum class parMemberCommonSubtype
+enum class parMemberType : uint8_t
 {
-	// these don't seem to be used while parsing, probably used by internal engine tools
-	COLOR = 1, // used with UINT, VECTOR3 (RDR3)
+	PAR_MEMBER_TYPES(ENUM_DEFINE_VALUE)
+};
+
+// these don't seem to be used while parsing, probably used by internal engine tools
 #if RDR3
-	ANGLE = 2, // used with FLOAT
+#define PAR_MEMBER_COMMON_SUBTYPES(X) PAR_MEMBER_COMMON_SUBTYPES_RDR3(X)
+#else
+#define PAR_MEMBER_COMMON_SUBTYPES(X) PAR_MEMBER_COMMON_SUBTYPES_GTA5(X)
 #endif
-};
 
-enum class parMemberArraySubtype  // 0xADE25B1B
+enum class parMemberCommonSubtype
 {
-	ATARRAY = 0,                        // 0xABE40192
-	ATFIXEDARRAY = 1,                   // 0x3A523E81
-	ATRANGEARRAY = 2,                   // 0x18A25B6B
-	POINTER = 3,                        // 0x47073D6E
-	MEMBER = 4,                         // 0x6CC11BB4
-	_0x2087BB00 = 5,                    // 0x2087BB00 - 32-bit atArray
-	POINTER_WITH_COUNT = 6,             // 0xE2980EB5
-	POINTER_WITH_COUNT_8BIT_IDX = 7,    // 0x254D33B1
-	POINTER_WITH_COUNT_16BIT_IDX = 8,   // 0xB66B6752
-	VIRTUAL = 9,                        // 0xAC01A1DC
+	PAR_MEMBER_COMMON_SUBTYPES(ENUM_DEFINE_VALUE)
 };
 
-enum class parMemberEnumSubtype  // 0x2721C60A
+// 0xADE25B1B
+enum class parMemberArraySubtype
 {
+	PAR_MEMBER_ARRAY_SUBTYPES(ENUM_DEFINE_VALUE)
+};
+
+// 0x2721C60A
 #if RDR3
-	_64BIT = 0,
-	_32BIT = 1,
-	_16BIT = 2,
-	_8BIT = 3,
+#define PAR_MEMBER_ENUM_SUBTYPES(X) PAR_MEMBER_ENUM_SUBTYPES_RDR3(X)
 #else
-	_32BIT = 0,         // 0xAF085554
-	_16BIT = 1,         // 0x0D502D8E
-	_8BIT = 2,          // 0xF2AAF53D
+#define PAR_MEMBER_ENUM_SUBTYPES(X) PAR_MEMBER_ENUM_SUBTYPES_GTA5(X)
 #endif
-};
 
-enum class parMemberBitsetSubtype
+enum class parMemberEnumSubtype
 {
+	PAR_MEMBER_ENUM_SUBTYPES(ENUM_DEFINE_VALUE)
+};
+
 #if RDR3
-	_32BIT = 0,         // 0x4A4F3BEC
-	_16BIT = 1,         // 0x16434158
-	_8BIT = 2,          // 0x2EFEF517
-	ATBITSET = 3,       // 0xB46B5F65
-	_64BIT = 4,         // 0x3BB5B764
+#define PAR_MEMBER_BITSET_SUBTYPES(X) PAR_MEMBER_BITSET_SUBTYPES_RDR3(X)
 #else
-	_32BIT = 0,         // 0xAF085554
-	_16BIT = 1,         // 0x0D502D8E
-	_8BIT = 2,          // 0xF2AAF53D
-	ATBITSET = 3,       // 0xB46B5F65
+#define PAR_MEMBER_BITSET_SUBTYPES(X) PAR_MEMBER_BITSET_SUBTYPES_GTA5(X)
 #endif
-};
 
-enum class parMemberMapSubtype  // 0x9C9F1983
+enum class parMemberBitsetSubtype
 {
-	ATMAP = 0,          // 0xD8C10171
-	ATBINARYMAP = 1,    // 0x6560BA79
+	PAR_MEMBER_BITSET_SUBTYPES(ENUM_DEFINE_VALUE)
 };
 
-enum class parMemberStringSubtype  // 0xA5CF41A9
+// 0x9C9F1983
+enum class parMemberMapSubtype
 {
-	MEMBER = 0,                 // 0x6CC11BB4
-	POINTER = 1,                // 0x47073D6E
-	CONST_STRING = 2,           // 0x757C1B9B
-	ATSTRING = 3,               // 0x5CDCA61E
-	WIDE_MEMBER = 4,            // 0xAC508104
-	WIDE_POINTER = 5,           // 0x99D4A8CD
-	ATWIDESTRING = 6,           // 0x3DED5509
-	ATNONFINALHASHSTRING = 7,   // 0xDFE6E4AF
-	ATFINALHASHSTRING = 8,      // 0x945E5945
-	ATHASHVALUE = 9,            // 0xBD3CD157
-	ATPARTIALHASHVALUE = 10,    // 0xD552B3C8
-	ATNSHASHSTRING = 11,        // 0x893F9F69
-	ATNSHASHVALUE = 12,         // 0x3767C917
+	PAR_MEMBER_MAP_SUBTYPES(ENUM_DEFINE_VALUE)
+};
+
+// 0xA5CF41A9
 #if RDR3
-	ATHASHVALUE16U = 13,           // 0xE8282E2F
+#define PAR_MEMBER_STRING_SUBTYPES(X) PAR_MEMBER_STRING_SUBTYPES_RDR3(X)
+#else
+#define PAR_MEMBER_STRING_SUBTYPES(X) PAR_MEMBER_STRING_SUBTYPES_GTA5(X)
 #endif
+
+enum class parMemberStringSubtype
+{
+	PAR_MEMBER_STRING_SUBTYPES(ENUM_DEFINE_VALUE)
 };
 
-enum class parMemberStructSubtype  // 0x76214E40
+// 0x76214E40
+enum class parMemberStructSubtype
 {
-	STRUCTURE = 0,                  // 0x3AC3050F
-	EXTERNAL_NAMED = 1,             // 0xA53F8BA9
-	EXTERNAL_NAMED_USERNULL = 2,    // 0x2DED4C19
-	POINTER = 3,                    // 0x47073D6E
-	SIMPLE_POINTER = 4,             // 0x67466543
+	PAR_MEMBER_STRUCT_SUBTYPES(ENUM_DEFINE_VALUE)
 };
 
 #if RDR3
-enum class parMemberGuidSubtype  // 0xA73F91EB
+// 0xA73F91EB
+enum class parMemberGuidSubtype
 {
-	_0xDF7EBE85 = 0, // 0xDF7EBE85
+	PAR_MEMBER_GUID_SUBTYPES(ENUM_DEFINE_VALUE)
 };
 #endif
 
@@ -307,7 +254,7 @@ struct parMemberArrayData : parMemberCommonData
 {
 	enum class AllocFlags : uint16_t
 	{
-		USE_PHYSICAL_ALLOCATOR = 1 << 0,
+		PAR_MEMBER_ARRAY_ALLOC_FLAGS(ENUM_DEFINE_VALUE)
 	};
 
 	uint64_t itemByteSize;
@@ -366,12 +313,7 @@ struct parStructure
 		: uint16_t
 #endif
 	{
-		_0xB9C5D274 = 1 << 0, // 0xB9C5D274 - related to alignment. If set, parStructure::FindAlign() starts calculating the alignment with 8, otherwise with 1
-		HAS_NAMES = 1 << 1, // 0x47AF4932
-		ALWAYS_HAS_NAMES = 1 << 2, // 0x9804A870
-		_0x25CB183C = 1 << 3, // 0x25CB183C
-		_0x62BE3669 = 1 << 4, // 0x62BE3669 - set when parCguStructure::SetFactories() is called
-		_0x22A1FBDB = 1 << 5, // 0x22A1FBDB
+		PAR_STRUCTURE_FLAGS(ENUM_DEFINE_VALUE)
 	};
 
 	void* __vftable;
@@ -433,9 +375,7 @@ struct parEnumValueData
 
 enum class parEnumFlags : uint16_t
 {
-	ENUM_STATIC = 1 << 0, // 0x83E077B4
-	ENUM_HAS_NAMES = 1 << 1, // 0x4725AEB1
-	ENUM_ALWAYS_HAS_NAMES = 1 << 2, // 0x0227ED1D
+	PAR_ENUM_FLAGS(ENUM_DEFINE_VALUE)
 };
 DEFINE_ENUM_FLAG_OPERATORS(parEnumFlags);
 
@@ -462,12 +402,12 @@ struct parManager
 };
 
 
-std::string SubtypeToStr(parMemberType type, uint8_t subtype);
+std::string_view SubtypeToStr(parMemberType type, uint8_t subtype);
 
-const char* EnumToString(parMemberType type);
-const char* EnumToString(parAttribute::Type type);
+std::string_view EnumToString(parMemberType type);
+std::string_view EnumToString(parAttribute::Type type);
 
-std::string FlagsToString(parEnumFlags flags);
-std::string FlagsToString(parStructure::Flags flags);
-std::string FlagsToString(parMemberArrayData::AllocFlags flags);
+std::string_view FlagsToString(parEnumFlags flags);
+std::string_view FlagsToString(parStructure::Flags flags);
+std::string_view FlagsToString(parMemberArrayData::AllocFlags flags);
 #endif // RDR3 || GTA5 || GTA5G9
@@ -1,5 +1,6 @@
 #if MP3 || GTA4 || RDR2
 #include "rage_gta4.h"
+#include "ScratchArena.h"
 #include <Hooking.Patterns.h>
 
 parManager** parManager::sm_Instance = nullptr;
@@ -25,109 +26,52 @@ bool parMemberEnumData::hasSameEnum(const parMemberEnumData* other) const
 	return values == other->values && valueNames == other->valueNames && valueCount == other->valueCount;
 }
 
-std::string SubtypeToStr(parMemberType type, uint8_t subtype)
-{
-	switch (type)
-	{
-	case parMemberType::ARRAY:
-		switch (static_cast<parMemberArraySubtype>(subtype))
-		{
-		case parMemberArraySubtype::ATARRAY: return "ATARRAY";
-		case parMemberArraySubtype::ATFIXEDARRAY: return "ATFIXEDARRAY";
-		case parMemberArraySubtype::ATRANGEARRAY: return "ATRANGEARRAY";
-		case parMemberArraySubtype::POINTER: return "POINTER";
-		case parMemberArraySubtype::MEMBER: return "MEMBER";
-		case parMemberArraySubtype::_UNKNOWN_5: return "_UNKNOWN_5";
-		case parMemberArraySubtype::_UNKNOWN_6: return "_UNKNOWN_6";
-		case parMemberArraySubtype::_0x2087BB00: return "_0x2087BB00";
+constexpr auto member_type_names = ENUM_NAME_TABLE(parMemberType, PAR_MEMBER_TYPES);
 #if MP3 || RDR2
-		case parMemberArraySubtype::POINTER_WITH_COUNT: return "POINTER_WITH_COUNT";
-#if MP3
-		case parMemberArraySubtype::POINTER_WITH_COUNT_8BIT_IDX: return "POINTER_WITH_COUNT_8BIT_IDX";
-		case parMemberArraySubtype::POINTER_WITH_COUNT_16BIT_IDX: return "POINTER_WITH_COUNT_16BIT_IDX";
-#endif
+constexpr auto attribute_type_names = ENUM_NAME_TABLE(parAttribute::Type, PAR_ATTRIBUTE_TYPES);
+constexpr auto enum_subtype_names = ENUM_NAME_TABLE(parMemberEnumSubtype, PAR_MEMBER_ENUM_SUBTYPES);
 #endif
-		}
-		break;
+constexpr auto common_subtype_names = ENUM_NAME_TABLE(parMemberCommonSubtype, PAR_MEMBER_COMMON_SUBTYPES);
+constexpr auto array_subtype_names = ENUM_NAME_TABLE(parMemberArraySubtype, PAR_MEMBER_ARRAY_SUBTYPES);
+constexpr auto string_subtype_names = ENUM_NAME_TABLE(parMemberStringSubtype, PAR_MEMBER_STRING_SUBTYPES);
+constexpr auto struct_subtype_names = ENUM_NAME_TABLE(parMemberStructSubtype, PAR_MEMBER_STRUCT_SUBTYPES);
+
+// the enums are numbered from 0 with no gaps, besides the common subtypes which start at 1
+static_assert(member_type_names.HasUniqueValues() && member_type_names.IsDense());
 #if MP3 || RDR2
-	case parMemberType::ENUM:
-		switch (static_cast<parMemberEnumSubtype>(subtype))
-		{
-		case parMemberEnumSubtype::_32BIT: return "_32BIT";
-		case parMemberEnumSubtype::_16BIT: return "_16BIT";
-		case parMemberEnumSubtype::_8BIT: return "_8BIT";
-		}
-		break;
+static_assert(attribute_type_names.HasUniqueValues() && attribute_type_names.IsDense());
+static_assert(enum_subtype_names.HasUniqueValues() && enum_subtype_names.IsDense());
 #endif
-	case parMemberType::STRING:
-		switch (static_cast<parMemberStringSubtype>(subtype))
-		{
-		case parMemberStringSubtype::MEMBER: return "MEMBER";
-		case parMemberStringSubtype::POINTER: return "POINTER";
-		case parMemberStringSubtype::_UNKNOWN_2: return "_UNKNOWN_2";
-		case parMemberStringSubtype::CONST_STRING: return "CONST_STRING";
+static_assert(common_subtype_names.HasUniqueValues());
+static_assert(array_subtype_names.HasUniqueValues() && array_subtype_names.IsDense());
+static_assert(string_subtype_names.HasUniqueValues() && string_subtype_names.IsDense());
+static_assert(struct_subtype_names.HasUniqueValues() && struct_subtype_names.IsDense());
+static_assert(member_type_names(parMemberType::MATRIX44) == "MATRIX44");
+
+std::string_view SubtypeToStr(parMemberType type, uint8_t subtype)
+{
+	std::string_view name;
+	switch (type)
+	{
+	case parMemberType::ARRAY: name = array_subtype_names(static_cast<parMemberArraySubtype>(subtype)); break;
 #if MP3 || RDR2
-		case parMemberStringSubtype::ATSTRING: return "ATSTRING";
-		case parMemberStringSubtype::WIDE_MEMBER: return "WIDE_MEMBER";
-		case parMemberStringSubtype::WIDE_POINTER: return "WIDE_POINTER";
-		case parMemberStringSubtype::ATWIDESTRING: return "ATWIDESTRING";
+	case parMemberType::ENUM: name = enum_subtype_names(static_cast<parMemberEnumSubtype>(subtype)); break;
 #endif
-		}
-		break;
-	case parMemberType::STRUCT:
-		switch (static_cast<parMemberStructSubtype>(subtype))
-		{
-		case parMemberStructSubtype::STRUCTURE: return "STRUCTURE";
-		case parMemberStructSubtype::EXTERNAL_NAMED: return "EXTERNAL_NAMED";
-		case parMemberStructSubtype::EXTERNAL_NAMED_USERNULL: return "EXTERNAL_NAMED_USERNULL";
-		case parMemberStructSubtype::POINTER: return "POINTER";
-		case parMemberStructSubtype::SIMPLE_POINTER: return "SIMPLE_POINTER";
-		}
-		break;
-	default:
-		switch (static_cast<parMemberCommonSubtype>(subtype))
-		{
-		case parMemberCommonSubtype::COLOR: return "COLOR";
-		}
+	case parMemberType::STRING: name = string_subtype_names(static_cast<parMemberStringSubtype>(subtype)); break;
+	case parMemberType::STRUCT: name = struct_subtype_names(static_cast<parMemberStructSubtype>(subtype)); break;
+	default: name = common_subtype_names(static_cast<parMemberCommonSubtype>(subtype)); break;
 	}
 
-	return std::to_string(subtype);
+	return !name.empty() ? name : ByteToString(subtype);
 }
 
-const char* EnumToString(parMemberType type)
+std::string_view EnumToString(parMemberType type)
 {
-	switch (type)
-	{
-	case parMemberType::BOOL: return "BOOL";
-	case parMemberType::CHAR: return "CHAR";
-	case parMemberType::UCHAR: return "UCHAR";
-	case parMemberType::SHORT: return "SHORT";
-	case parMemberType::USHORT: return "USHORT";
-	case parMemberType::INT: return "INT";
-	case parMemberType::UINT: return "UINT";
-	case parMemberType::FLOAT: return "FLOAT";
-	case parMemberType::VECTOR2: return "VECTOR2";
-	case parMemberType::VECTOR3: return "VECTOR3";
-	case parMemberType::VECTOR4: return "VECTOR4";
-	case parMemberType::STRING: return "STRING";
-	case parMemberType::STRUCT: return "STRUCT";
-	case parMemberType::ARRAY: return "ARRAY";
-	case parMemberType::ENUM: return "ENUM";
-	case parMemberType::MATRIX34: return "MATRIX34";
-	case parMemberType::MATRIX44: return "MATRIX44";
-	default: return "UNKNOWN";
-	}
+	return member_type_names(type, "UNKNOWN");
 }
 
-const char* EnumToString(parAttribute::Type type)
+std::string_view EnumToString(parAttribute::Type type)
 {
-	switch (type)
-	{
-	case parAttribute::Type::String: return "String";
-	case parAttribute::Type::Int64:  return "Int64";
-	case parAttribute::Type::Double: return "Double";
-	case parAttribute::Type::Bool:   return "Bool";
-	default: return "UNKNOWN";
-	}
+	return attribute_type_names(type, "UNKNOWN");
 }
 #endif
@@ -7,8 +7,10 @@
 #endif
 #endif
 
+#include "EnumNames.h"
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 
 template<class T>
@@ -67,12 +69,16 @@ struct Func
 #if MP3 || RDR2
 struct parAttribute
 {
+	// Int64 and Double are actually int32 and float, using int64/double for compatibility with RDR3/GTA5 dumps
+#define PAR_ATTRIBUTE_TYPES(X) \
+	X(String, 0) \
+	X(Int64, 1) \
+	X(Double, 2) \
+	X(Bool, 3)
+
 	enum Type : uint8_t
 	{
-		String = 0,
-		Int64 = 1, // actually int32 and float, using int64/double for compatibility with RDR3/GTA5 dumps
-		Double = 2,
-		Bool = 3,
+		PAR_ATTRIBUTE_TYPES(ENUM_DEFINE_VALUE)
 	};
 
 	union Value
@@ -108,82 +114,109 @@ struct parAttributeList
 };
 #endif
 
+#define PAR_MEMBER_TYPES(X) \
+	X(BOOL, 0) \
+	X(CHAR, 1) \
+	X(UCHAR, 2) \
+	X(SHORT, 3) \
+	X(USHORT, 4) \
+	X(INT, 5) \
+	X(UINT, 6) \
+	X(FLOAT, 7) \
+	X(VECTOR2, 8) \
+	X(VECTOR3, 9) \
+	X(VECTOR4, 10) \
+	X(STRING, 11) \
+	X(STRUCT, 12) \
+	X(ARRAY, 13) \
+	X(ENUM, 14) \
+	X(MATRIX34, 15) \
+	X(MATRIX44, 16)
+
 enum class parMemberType : uint8_t
 {
-	BOOL = 0,
-	CHAR = 1,
-	UCHAR = 2,
-	SHORT = 3,
-	USHORT = 4,
-	INT = 5,
-	UINT = 6,
-	FLOAT = 7,
-	VECTOR2 = 8,
-	VECTOR3 = 9,
-	VECTOR4 = 10,
-	STRING = 11,
-	STRUCT = 12,
-	ARRAY = 13,
-	ENUM = 14,
-	MATRIX34 = 15,
-	MATRIX44 = 16,
+	PAR_MEMBER_TYPES(ENUM_DEFINE_VALUE)
 };
 
+// these don't seem to be used while parsing, probably used by internal engine tools
+#define PAR_MEMBER_COMMON_SUBTYPES(X) \
+	X(COLOR, 1) /* used with UINT, VECTOR3 */
+
 enum class parMemberCommonSubtype
 {
-	// these don't seem to be used while parsing, probably used by internal engine tools
-	COLOR = 1, // used with UINT, VECTOR3
+	PAR_MEMBER_COMMON_SUBTYPES(ENUM_DEFINE_VALUE)
 };
 
 #if MP3 || RDR2
+#define PAR_MEMBER_ENUM_SUBTYPES(X) \
+	X(_32BIT, 0) \
+	X(_16BIT, 1) \
+	X(_8BIT, 2)
+
 enum class parMemberEnumSubtype
 {
-	_32BIT = 0,
-	_16BIT = 1,
-	_8BIT = 2,
+	PAR_MEMBER_ENUM_SUBTYPES(ENUM_DEFINE_VALUE)
 };
 #endif
 
+#define PAR_MEMBER_ARRAY_SUBTYPES(X) \
+	X(ATARRAY, 0) \
+	X(ATFIXEDARRAY, 1) \
+	X(ATRANGEARRAY, 2) \
+	X(POINTER, 3) \
+	X(MEMBER, 4) \
+	X(_UNKNOWN_5, 5)    /* struct { void *begin, *end }; maybe? */ \
+	X(_UNKNOWN_6, 6)    /* unused */ \
+	X(_0x2087BB00, 7)   /* unused, 32-bit atArray */ \
+	PAR_MEMBER_ARRAY_SUBTYPES_MP3_RDR2(X)
+#if MP3
+#define PAR_MEMBER_ARRAY_SUBTYPES_MP3_RDR2(X) \
+	X(POINTER_WITH_COUNT, 8) \
+	X(POINTER_WITH_COUNT_8BIT_IDX, 9) \
+	X(POINTER_WITH_COUNT_16BIT_IDX, 10)
+#elif RDR2
+#define PAR_MEMBER_ARRAY_SUBTYPES_MP3_RDR2(X) \
+	X(POINTER_WITH_COUNT, 8)
+#else
+#define PAR_MEMBER_ARRAY_SUBTYPES_MP3_RDR2(X)
+#endif
+
 enum class parMemberArraySubtype
 {
-	ATARRAY = 0,
-	ATFIXEDARRAY = 1,
-	ATRANGEARRAY = 2,
-	POINTER = 3,
-	MEMBER = 4,
-	_UNKNOWN_5 = 5,	// struct { void *begin, *end }; maybe?
-	_UNKNOWN_6 = 6, // unused
-	_0x2087BB00 = 7, // unused, 32-bit atArray
+	PAR_MEMBER_ARRAY_SUBTYPES(ENUM_DEFINE_VALUE)
+};
+
+#define PAR_MEMBER_STRING_SUBTYPES(X) \
+	X(MEMBER, 0) \
+	X(POINTER, 1) \
+	X(_UNKNOWN_2, 2)    /* std::string? */ \
+	X(CONST_STRING, 3) \
+	PAR_MEMBER_STRING_SUBTYPES_MP3_RDR2(X)
 #if MP3 || RDR2
-	POINTER_WITH_COUNT = 8,
-#if MP3
-	POINTER_WITH_COUNT_8BIT_IDX = 9,
-	POINTER_WITH_COUNT_16BIT_IDX = 10,
-#endif
+#define PAR_MEMBER_STRING_SUBTYPES_MP3_RDR2(X) \
+	X(ATSTRING, 4) \
+	X(WIDE_MEMBER, 5) \
+	X(WIDE_POINTER, 6) \
+	X(ATWIDESTRING, 7)
+#else
+#define PAR_MEMBER_STRING_SUBTYPES_MP3_RDR2(X)
 #endif
-};
 
 enum class parMemberStringSubtype
 {
-	MEMBER = 0,
-	POINTER = 1,
-	_UNKNOWN_2 = 2, // std::string?
-	CONST_STRING = 3,
-#if MP3 || RDR2
-	ATSTRING = 4,
-	WIDE_MEMBER = 5,
-	WIDE_POINTER = 6,
-	ATWIDESTRING = 7,
-#endif
+	PAR_MEMBER_STRING_SUBTYPES(ENUM_DEFINE_VALUE)
 };
 
+#define PAR_MEMBER_STRUCT_SUBTYPES(X) \
+	X(STRUCTURE, 0) \
+	X(EXTERNAL_NAMED, 1) \
+	X(EXTERNAL_NAMED_USERNULL, 2) \
+	X(POINTER, 3) \
+	X(SIMPLE_POINTER, 4)
+
 enum class parMemberStructSubtype
 {
-	STRUCTURE = 0,
-	EXTERNAL_NAMED = 1,
-	EXTERNAL_NAMED_USERNULL = 2,
-	POINTER = 3,
-	SIMPLE_POINTER = 4,
+	PAR_MEMBER_STRUCT_SUBTYPES(ENUM_DEFINE_VALUE)
 };
 
 struct parMemberCommonData
@@ -336,8 +369,8 @@ struct parManager
 };
 
 
-std::string SubtypeToStr(parMemberType type, uint8_t subtype);
+std::string_view SubtypeToStr(parMemberType type, uint8_t subtype);
 
-const char* EnumToString(parMemberType type);
-const char* EnumToString(parAttribute::Type type);
+std::string_view EnumToString(parMemberType type);
+std::string_view EnumToString(parAttribute::Type type);
 #endif // GTA4 || MP3
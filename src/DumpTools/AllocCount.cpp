@@ -0,0 +1,272 @@
+#include "AllocCount.h"
+#include "Commands.h"
+#include "EnumNameIndex.h"
+#include "EnumNames.h"
+#include "ScratchArena.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+#include <deque>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Counts every heap allocation of the process while `counting` is set. The aligned overloads are needed too, the standard
+// library may use them for all the allocations of std::pmr::new_delete_resource.
+static bool counting = false;
+static size_t allocations = 0;
+
+static void* CountedAlloc(size_t size, size_t alignment)
+{
+	if (counting)
+	{
+		allocations++;
+	}
+
+	size = size != 0 ? size : 1;
+#ifdef _MSC_VER
+	void* p = alignment != 0 ? _aligned_malloc(size, alignment) : std::malloc(size);
+#else
+	void* p = alignment != 0 ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment) : std::malloc(size);
+#endif
+	if (p == nullptr)
+	{
+		throw std::bad_alloc{};
+	}
+	return p;
+}
+
+static void CountedFree(void* p, size_t alignment)
+{
+#ifdef _MSC_VER
+	alignment != 0 ? _aligned_free(p) : std::free(p);
+#else
+	(void)alignment;
+	std::free(p);
+#endif
+}
+
+void* operator new(size_t size) { return CountedAlloc(size, 0); }
+void* operator new[](size_t size) { return CountedAlloc(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment) { return CountedAlloc(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return CountedAlloc(size, static_cast<size_t>(alignment)); }
+void operator delete(void* p) noexcept { CountedFree(p, 0); }
+void operator delete[](void* p) noexcept { CountedFree(p, 0); }
+void operator delete(void* p, size_t) noexcept { CountedFree(p, 0); }
+void operator delete[](void* p, size_t) noexcept { CountedFree(p, 0); }
+void operator delete(void* p, std::align_val_t alignment) noexcept { CountedFree(p, static_cast<size_t>(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment) noexcept { CountedFree(p, static_cast<size_t>(alignment)); }
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept { CountedFree(p, static_cast<size_t>(alignment)); }
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept { CountedFree(p, static_cast<size_t>(alignment)); }
+
+void StartCountingAllocations()
+{
+	allocations = 0;
+	counting = true;
+}
+
+size_t StopCountingAllocations()
+{
+	counting = false;
+	return allocations;
+}
+
+namespace
+{
+	// The strings a struct of the dump needs, as read from the game.
+	struct FakeStruct
+	{
+		std::string name;
+		uint32_t flags;
+		uint16_t versionMajor;
+		uint16_t versionMinor;
+		std::vector<uint32_t> callbackKeys;  // none of them with a known name, so all need formatting
+		std::vector<std::string> memberNames;
+		std::vector<uint8_t> memberSubtypes; // no names, so all become numbers
+		std::vector<uintptr_t> memberEnums;  // identity of the enum of each member, 0 if not an enum
+	};
+
+	// Consumes the strings so they are not optimized away and the two implementations can be compared.
+	struct StringHash
+	{
+		uint64_t hash = 14695981039346656037ull;
+
+		void Add(std::string_view str)
+		{
+			for (char c : str)
+			{
+				hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+			}
+			hash = (hash ^ 0xFF) * 1099511628211ull;
+		}
+	};
+}
+
+// same as parStructure::Flags
+#define FAKE_STRUCTURE_FLAGS(X) \
+	X(_0xB9C5D274, 1 << 0) \
+	X(HAS_NAMES, 1 << 1) \
+	X(ALWAYS_HAS_NAMES, 1 << 2) \
+	X(_0x25CB183C, 1 << 3) \
+	X(_0x62BE3669, 1 << 4) \
+	X(_0x22A1FBDB, 1 << 5)
+
+enum class FakeStructureFlags : uint32_t
+{
+	FAKE_STRUCTURE_FLAGS(ENUM_DEFINE_VALUE)
+};
+
+static constexpr EnumNameEntry structureFlagNames[]{ FAKE_STRUCTURE_FLAGS(ENUM_NAME_ENTRY) };
+static constexpr auto structureFlags = FLAG_NAME_TABLE(FakeStructureFlags, FAKE_STRUCTURE_FLAGS);
+
+static std::vector<FakeStruct> GenerateStructs(size_t numStructs)
+{
+	std::vector<FakeStruct> structs(numStructs);
+	for (size_t i = 0; i < numStructs; i++)
+	{
+		auto& s = structs[i];
+		s.name = "CStruct" + std::to_string(i);
+		s.flags = static_cast<uint32_t>(i * 7 % 64);
+		s.versionMajor = static_cast<uint16_t>(i % 3);
+		s.versionMinor = static_cast<uint16_t>(i % 100);
+		s.callbackKeys.push_back(static_cast<uint32_t>(i * 2654435761u));
+		for (size_t m = 0; m < 6; m++)
+		{
+			s.memberNames.push_back("m_Member" + std::to_string(m));
+			s.memberSubtypes.push_back(static_cast<uint8_t>((i + m) % 40));
+			// every other member is an enum, a few enums are shared by many members
+			s.memberEnums.push_back(m % 2 == 0 ? 0 : (i % 4 == 0 ? 0x1000 + m : 0x100000 + i * 8 + m));
+		}
+	}
+	return structs;
+}
+
+// What the dump did before: a std::string for each flags value, version, callback key, subtype and enum name.
+static uint64_t DumpLegacy(const std::vector<FakeStruct>& structs)
+{
+	StringHash h;
+	std::unordered_map<uintptr_t, std::string_view> enumIdentityNames;
+	std::unordered_map<const void*, std::string_view> enumMemberNames;
+	std::deque<std::string> enumNames;
+	for (auto& s : structs)
+	{
+		std::string flags = "";
+		for (auto& f : structureFlagNames)
+		{
+			if ((s.flags & f.value) == f.value)
+			{
+				if (flags.size() > 0) flags += ", ";
+				flags += f.name;
+			}
+		}
+		h.Add(flags);
+
+		h.Add(std::to_string(s.versionMajor) + "." + std::to_string(s.versionMinor));
+
+		for (uint32_t key : s.callbackKeys)
+		{
+			char buffer[32];
+			std::snprintf(buffer, sizeof(buffer), "callback_0x%08X", key);
+			h.Add(std::string{ buffer });
+		}
+
+		for (size_t m = 0; m < s.memberNames.size(); m++)
+		{
+			h.Add(std::to_string(s.memberSubtypes[m]));
+			if (s.memberEnums[m] != 0)
+			{
+				auto [it, inserted] = enumIdentityNames.try_emplace(s.memberEnums[m]);
+				if (inserted)
+				{
+					it->second = enumNames.emplace_back(s.name + "__" + s.memberNames[m] + "__enum");
+				}
+				enumMemberNames[&s.memberNames[m]] = it->second;
+				h.Add(it->second);
+			}
+		}
+	}
+	return h.hash;
+}
+
+// The same strings with FlagNameTable, ByteToString, stack buffers and the arena-backed EnumNameIndex.
+static uint64_t DumpArena(const std::vector<FakeStruct>& structs)
+{
+	StringHash h;
+	EnumNameIndex enumNames;
+	for (auto& s : structs)
+	{
+		h.Add(structureFlags(static_cast<FakeStructureFlags>(s.flags)));
+
+		char versionBuffer[16];
+		const int versionLength = std::snprintf(versionBuffer, sizeof(versionBuffer), "%u.%u", s.versionMajor, s.versionMinor);
+		h.Add({ versionBuffer, static_cast<size_t>(versionLength) });
+
+		for (uint32_t key : s.callbackKeys)
+		{
+			char keyBuffer[32];
+			const int keyLength = std::snprintf(keyBuffer, sizeof(keyBuffer), "callback_0x%08X", key);
+			h.Add({ keyBuffer, static_cast<size_t>(keyLength) });
+		}
+
+		for (size_t m = 0; m < s.memberNames.size(); m++)
+		{
+			h.Add(ByteToString(s.memberSubtypes[m]));
+			if (s.memberEnums[m] != 0)
+			{
+				const auto* identity = reinterpret_cast<const void*>(s.memberEnums[m]);
+				enumNames.Add(&s.memberNames[m], { identity, identity, 1 },
+					[&](ScratchArena& arena) { return arena.Concat({ s.name, "__", s.memberNames[m], "__enum" }); });
+				h.Add(enumNames.Find(&s.memberNames[m]));
+			}
+		}
+	}
+	return h.hash;
+}
+
+int CountAllocs(size_t maxStructs)
+{
+	// build the lazily initialized tables first, they are allocated once per process
+	DumpArena(GenerateStructs(1));
+
+	std::printf("%8s %12s %12s %14s\n", "structs", "legacy", "arena", "arena/struct");
+
+	bool ok = true;
+	size_t previousArenaAllocations = 0;
+	size_t numStructs = 0;
+	for (size_t count = 1'000; count <= maxStructs; count *= 4)
+	{
+		const auto structs = GenerateStructs(count);
+
+		uint64_t legacyHash = 0, arenaHash = 0;
+		const size_t legacyAllocations = CountAllocations([&] { legacyHash = DumpLegacy(structs); });
+		const size_t arenaAllocations = CountAllocations([&] { arenaHash = DumpArena(structs); });
+
+		const bool matches = legacyHash == arenaHash;
+		ok = ok && matches;
+		std::printf("%8zu %12zu %12zu %14.4f%s\n", count, legacyAllocations, arenaAllocations,
+			static_cast<double>(arenaAllocations) / count, matches ? "" : "  MISMATCH");
+
+		// the arena blocks grow geometrically, 4x the structs must take far less than 4x the allocations
+		if (previousArenaAllocations != 0 && arenaAllocations > previousArenaAllocations * 2)
+		{
+			std::printf("  arena allocations grow with the number of structs\n");
+			ok = false;
+		}
+		previousArenaAllocations = arenaAllocations;
+		numStructs = count;
+	}
+
+	if (numStructs == 0)
+	{
+		std::printf("max-structs must be at least 1000\n");
+		return 1;
+	}
+
+	std::printf("%s\n", ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+
+// Counts the heap allocations of the process, with the replacements of the global operator new in AllocCount.cpp. Only the
+// allocations of the thread running the function should be happening, the counter is not atomic.
+void StartCountingAllocations();
+// Returns the number of allocations since StartCountingAllocations.
+size_t StopCountingAllocations();
+
+template<class TFunc>
+size_t CountAllocations(TFunc func)
+{
+	StartCountingAllocations();
+	func();
+	return StopCountingAllocations();
+}
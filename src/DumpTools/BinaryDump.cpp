@@ -0,0 +1,166 @@
+#include "Commands.h"
+#include "DumpBinaryWriter.h"
+#include "DumpBinaryReplay.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int ToBinary(const char* inputPath, const char* outputPath)
+{
+	MappedFile input;
+	if (!input.Open(inputPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", inputPath);
+		return 1;
+	}
+
+	DumpBinaryWriter w{ outputPath };
+	JsonReader{ input.Text() }.Replay(w);
+	return 0;
+}
+
+int ToJson(const char* inputPath, const char* outputPath)
+{
+	MappedFile input;
+	if (!input.Open(inputPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", inputPath);
+		return 1;
+	}
+
+	DumpBinaryView dump{ input.Data(), input.Size() };
+	if (!dump.Validate())
+	{
+		std::fprintf(stderr, "'%s' is not a valid binary dump\n", inputPath);
+		return 1;
+	}
+
+	JsonWriter w{ outputPath };
+	DumpBinaryReplay{ dump, w }.Run();
+	return 0;
+}
+
+static std::string_view TrimTrailingNewLines(std::string_view str)
+{
+	while (!str.empty() && (str.back() == '\n' || str.back() == '\r'))
+	{
+		str.remove_suffix(1);
+	}
+	return str;
+}
+
+static double Seconds(std::chrono::steady_clock::duration d)
+{
+	return std::chrono::duration<double>(d).count();
+}
+
+int RoundTrip(const char* dumpsDir)
+{
+	using clock = std::chrono::steady_clock;
+
+	std::vector<fs::path> paths;
+	for (auto& entry : fs::recursive_directory_iterator(dumpsDir))
+	{
+		// only the dumps, which are inside a subdirectory per game
+		if (entry.is_regular_file() && entry.path().extension() == ".json" && entry.path().parent_path() != fs::path{ dumpsDir })
+		{
+			paths.push_back(entry.path());
+		}
+	}
+	std::sort(paths.begin(), paths.end());
+
+	const auto tmpPath = (fs::temp_directory_path() / "DumpTools_roundtrip.json").string();
+	const auto tmpCanonicalPath = (fs::temp_directory_path() / "DumpTools_roundtrip_canonical.json").string();
+	size_t failures = 0;
+	size_t totalJsonSize = 0, totalBinarySize = 0;
+	double totalParseTime = 0.0, totalLoadTime = 0.0;
+	std::printf("%-40s %12s %12s %10s %10s %8s\n", "dump", "json bytes", "binary bytes", "parse ms", "load ms", "result");
+	for (auto& path : paths)
+	{
+		const auto pathStr = path.string();
+		MappedFile input;
+		if (!input.Open(pathStr.c_str()))
+		{
+			std::printf("%-40s failed to open\n", pathStr.c_str());
+			failures++;
+			continue;
+		}
+
+		std::vector<uint8_t> binary;
+		double parseTime = 0.0;
+		try
+		{
+			const auto start = clock::now();
+			DumpBinaryWriter w;
+			JsonReader{ input.Text() }.Replay(w);
+			binary = w.Serialize();
+			parseTime = Seconds(clock::now() - start);
+		}
+		catch (const std::exception& ex)
+		{
+			std::printf("%-40s %s\n", pathStr.c_str(), ex.what());
+			failures++;
+			continue;
+		}
+
+		// the serialized buffer is already suitably aligned, this measures validating and walking the dump without any parsing
+		const auto loadStart = clock::now();
+		DumpBinaryView dump{ binary.data(), binary.size() };
+		const bool valid = dump.Validate();
+		size_t memberCount = 0;
+		for (auto& s : dump.Structs())
+		{
+			memberCount += dump.Members(s).size();
+		}
+		const double loadTime = Seconds(clock::now() - loadStart);
+
+		// compare against the original re-written by the current JsonWriter, older dumps were written with slightly
+		// different formatting (e.g. empty arrays on a single line)
+		const char* result = "MISMATCH";
+		if (valid && memberCount == dump.Members().size())
+		{
+			{
+				JsonWriter w{ tmpPath };
+				DumpBinaryReplay{ dump, w }.Run();
+			}
+			{
+				JsonWriter w{ tmpCanonicalPath };
+				JsonReader{ input.Text() }.Replay(w);
+			}
+
+			MappedFile output, canonical;
+			if (output.Open(tmpPath.c_str()) && canonical.Open(tmpCanonicalPath.c_str()) && output.Text() == canonical.Text())
+			{
+				// the dumps in the repository may have a trailing newline added by editors
+				result = TrimTrailingNewLines(output.Text()) == TrimTrailingNewLines(input.Text()) ? "OK" : "OK*";
+			}
+		}
+
+		std::printf("%-40s %12zu %12zu %10.2f %10.4f %8s\n",
+			fs::relative(path, dumpsDir).string().c_str(), input.Size(), binary.size(), parseTime * 1000.0, loadTime * 1000.0, result);
+		const bool identical = result[0] == 'O';
+		failures += identical ? 0 : 1;
+		totalJsonSize += input.Size();
+		totalBinarySize += binary.size();
+		totalParseTime += parseTime;
+		totalLoadTime += loadTime;
+	}
+	fs::remove(tmpPath);
+	fs::remove(tmpCanonicalPath);
+
+	std::printf("\n%zu dumps, %zu failed (OK* = matches after re-formatting the original with the current JsonWriter)\n", paths.size(), failures);
+	std::printf("JSON:   %.2f MiB, parsed at %.1f MiB/s\n", totalJsonSize / (1024.0 * 1024.0), totalJsonSize / (1024.0 * 1024.0) / totalParseTime);
+	std::printf("Binary: %.2f MiB (%.1f%% of JSON), loaded in %.3f ms total\n",
+		totalBinarySize / (1024.0 * 1024.0), 100.0 * totalBinarySize / totalJsonSize, totalLoadTime * 1000.0);
+	return failures == 0 ? 0 : 1;
+}
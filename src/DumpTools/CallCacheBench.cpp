@@ -0,0 +1,153 @@
+#include "Commands.h"
+#include "GameCallCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	size_t gameCalls = 0; // every virtual call, including those the game code makes internally
+
+	struct MockStructure;
+
+	// Stand-ins for parMember/parStructure, the virtual functions count how often they are called like game code would be.
+	struct MockMember
+	{
+		uint32_t size;
+		MockStructure* structure; // for STRUCT members
+		size_t directCalls = 0;
+
+		virtual ~MockMember() = default;
+		virtual uint32_t GetSize() { gameCalls++; directCalls++; return size; }
+		virtual uint32_t FindAlign();
+	};
+
+	struct MockStructure
+	{
+		std::vector<std::unique_ptr<MockMember>> members;
+		MockStructure* base = nullptr;
+		size_t directCalls = 0;
+
+		virtual ~MockStructure() = default;
+		// like parStructure::FindAlign, recurses through the base structure and the members
+		virtual uint32_t FindAlign()
+		{
+			gameCalls++;
+			uint32_t align = base != nullptr ? base->FindAlign() : 1;
+			for (auto& m : members)
+			{
+				align = std::max(align, m->FindAlign());
+			}
+			return align;
+		}
+	};
+
+	uint32_t MockMember::FindAlign()
+	{
+		gameCalls++;
+		return structure != nullptr ? structure->FindAlign() : size;
+	}
+}
+
+// A registry where a few common structures (e.g. a Vector3 wrapper) are used by many STRUCT members.
+static std::vector<std::unique_ptr<MockStructure>> GenerateRegistry(size_t count)
+{
+	std::mt19937 rng{ 1234 };
+	std::uniform_int_distribution<uint32_t> u32;
+	std::vector<std::unique_ptr<MockStructure>> structs;
+	for (size_t i = 0; i < count; i++)
+	{
+		auto s = std::make_unique<MockStructure>();
+		if (i > 0 && u32(rng) % 4 == 0)
+		{
+			s->base = structs[u32(rng) % i].get();
+		}
+
+		const size_t numMembers = u32(rng) % 16;
+		for (size_t j = 0; j < numMembers; j++)
+		{
+			auto m = std::make_unique<MockMember>();
+			m->size = 1u << (u32(rng) % 4);
+			// only reference earlier structures so there are no cycles, mostly the first few
+			m->structure = i > 0 && u32(rng) % 4 == 0 ? structs[u32(rng) % std::min<size_t>(i, 8)].get() : nullptr;
+			s->members.push_back(std::move(m));
+		}
+		structs.push_back(std::move(s));
+	}
+	return structs;
+}
+
+// Same calls as DumpJsonStructure/DumpJsonMember, for both the JSON and the binary dump. Returns a checksum of the results.
+template<class TGetSize, class TMemberAlign, class TStructureAlign>
+static uint64_t Dump(const std::vector<std::unique_ptr<MockStructure>>& structs, TGetSize getSize, TMemberAlign memberAlign, TStructureAlign structureAlign)
+{
+	uint64_t checksum = 0;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (auto& s : structs)
+		{
+			checksum = checksum * 31 + structureAlign(s.get());
+			for (auto& m : s->members)
+			{
+				checksum = checksum * 31 + getSize(m.get());
+				checksum = checksum * 31 + memberAlign(m.get());
+			}
+		}
+	}
+	return checksum;
+}
+
+int BenchCallCache(size_t numStructs)
+{
+	const auto structs = GenerateRegistry(numStructs);
+
+	gameCalls = 0;
+	const uint64_t uncachedChecksum = Dump(structs,
+		[](MockMember* m) { return m->GetSize(); },
+		[](MockMember* m) { return m->FindAlign(); },
+		[](MockStructure* s) { s->directCalls++; return s->FindAlign(); });
+	const size_t uncachedCalls = gameCalls;
+
+	for (auto& s : structs)
+	{
+		s->directCalls = 0;
+		for (auto& m : s->members)
+		{
+			m->directCalls = 0;
+		}
+	}
+
+	GameCallCache<MockMember, uint32_t> memberSizes;
+	GameCallCache<MockMember, uint32_t> memberAligns;
+	GameCallCache<MockStructure, uint32_t> structureAligns;
+	gameCalls = 0;
+	const uint64_t cachedChecksum = Dump(structs,
+		[&](MockMember* m) { return memberSizes.Get(m, [m] { return m->GetSize(); }); },
+		[&](MockMember* m) { return memberAligns.Get(m, [m] { return m->FindAlign(); }); },
+		[&](MockStructure* s) { return structureAligns.Get(s, [s] { s->directCalls++; return s->FindAlign(); }); });
+	const size_t cachedCalls = gameCalls;
+
+	// GetSize is only called directly, so it must have been called exactly once per member
+	size_t numMembers = 0, repeated = 0;
+	for (auto& s : structs)
+	{
+		repeated += s->directCalls > 1;
+		for (auto& m : s->members)
+		{
+			numMembers++;
+			repeated += m->directCalls > 1;
+		}
+	}
+
+	std::printf("%zu structs, %zu members\n", structs.size(), numMembers);
+	std::printf("  uncached: %8zu game calls\n", uncachedCalls);
+	std::printf("  cached:   %8zu game calls (%zu GetSize, %zu parMember::FindAlign, %zu parStructure::FindAlign, %zu cache hits)\n",
+		cachedCalls, memberSizes.Calls(), memberAligns.Calls(), structureAligns.Calls(),
+		memberSizes.Hits() + memberAligns.Hits() + structureAligns.Hits());
+
+	const bool ok = cachedChecksum == uncachedChecksum && repeated == 0 && memberSizes.Calls() == numMembers && structureAligns.Calls() == structs.size();
+	std::printf("%s\n", ok ? "results identical, one call per object" : "FAILED");
+	return ok ? 0 : 1;
+}
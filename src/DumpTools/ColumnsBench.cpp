@@ -0,0 +1,332 @@
+#include "Commands.h"
+#include "DumpBinaryWriter.h"
+#include "DumpColumns.h"
+#include "DumpReader.h"
+#include "JsonReader.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	// The usual object model of a dump, like DumpFormatter's ParStructure/ParMember: an object per struct and member, each with
+	// its own strings.
+	struct PtrMember
+	{
+		std::string name;
+		uint32_t nameHash;
+		uint64_t offset;
+		uint32_t size;
+		uint32_t align;
+		std::string type;
+		std::string subtype;
+		uint16_t flags1;
+		uint16_t flags2;
+		std::string refName;
+		std::unique_ptr<PtrMember> item;
+		std::unique_ptr<PtrMember> value;
+	};
+
+	struct PtrStruct
+	{
+		std::string name;
+		uint32_t nameHash;
+		uint64_t size;
+		uint32_t align;
+		std::vector<std::unique_ptr<PtrMember>> members;
+	};
+
+	struct PtrBuild
+	{
+		std::string game;
+		std::string build;
+		std::vector<std::unique_ptr<PtrStruct>> structs;
+	};
+
+	std::unique_ptr<PtrMember> MakeMember(const DumpModel& model, const DumpModelMember& m)
+	{
+		auto member = std::make_unique<PtrMember>();
+		member->name = m.name;
+		member->nameHash = DumpColumns::NameHash(m.name);
+		member->offset = m.offset;
+		member->size = static_cast<uint32_t>(m.size);
+		member->align = m.align;
+		member->type = m.type;
+		member->subtype = m.subtype;
+		member->flags1 = static_cast<uint16_t>(m.flags1);
+		member->flags2 = static_cast<uint16_t>(m.flags2);
+		member->refName = !m.structName.empty() ? m.structName : m.enumName;
+		if (m.item != -1)
+		{
+			member->item = MakeMember(model, model.subMembers[m.item]);
+		}
+		if (m.value != -1)
+		{
+			member->value = MakeMember(model, model.subMembers[m.value]);
+		}
+		return member;
+	}
+
+	PtrBuild MakeBuild(const DumpModel& model)
+	{
+		PtrBuild build{ std::string{ model.game }, std::string{ model.build }, {} };
+		for (auto& s : model.structs)
+		{
+			auto structure = std::make_unique<PtrStruct>();
+			structure->name = s.name;
+			structure->nameHash = DumpColumns::NameHash(s.name);
+			structure->size = s.size;
+			structure->align = s.align;
+			for (uint32_t i = s.firstMember; i < s.firstMember + s.memberCount; i++)
+			{
+				structure->members.push_back(MakeMember(model, model.members[i]));
+			}
+			build.structs.push_back(std::move(structure));
+		}
+		return build;
+	}
+
+	template<class TFunc>
+	void ForEachMember(const std::vector<PtrBuild>& builds, TFunc f)
+	{
+		for (auto& build : builds)
+		{
+			for (auto& structure : build.structs)
+			{
+				for (auto& member : structure->members)
+				{
+					f(*structure, *member);
+				}
+			}
+		}
+	}
+
+	struct Query
+	{
+		const char* description;
+		std::function<size_t()> pointers;
+		std::function<size_t()> columns;
+	};
+}
+
+static double Seconds(std::chrono::steady_clock::duration d)
+{
+	return std::chrono::duration<double>(d).count();
+}
+
+// Best of a few runs.
+static double Time(const std::function<size_t()>& query, size_t& result)
+{
+	using clock = std::chrono::steady_clock;
+
+	double best = 0.0;
+	for (int run = 0; run < 10; run++)
+	{
+		const auto start = clock::now();
+		result = query();
+		const double time = Seconds(clock::now() - start);
+		best = run == 0 ? time : std::min(best, time);
+	}
+	return best;
+}
+
+int BenchColumns(const char* dumpsDir)
+{
+	std::vector<fs::path> paths;
+	for (auto& entry : fs::recursive_directory_iterator(dumpsDir))
+	{
+		// only the dumps, which are inside a subdirectory per game
+		if (entry.is_regular_file() && entry.path().extension() == ".json" && entry.path().parent_path() != fs::path{ dumpsDir })
+		{
+			paths.push_back(entry.path());
+		}
+	}
+	std::sort(paths.begin(), paths.end());
+
+	// the same dumps through both ways of filling the columns, which must agree
+	DumpColumns columns, binaryColumns;
+	std::vector<PtrBuild> builds;
+	DumpModel model;
+	DumpReader reader;
+	for (auto& path : paths)
+	{
+		MappedFile dump;
+		if (!dump.Open(path.string().c_str()))
+		{
+			std::fprintf(stderr, "Failed to open '%s'\n", path.string().c_str());
+			return 1;
+		}
+
+		reader.Read(dump.Text(), model);
+		columns.AddBuild(model);
+		builds.push_back(MakeBuild(model));
+
+		DumpBinaryWriter w;
+		JsonReader{ dump.Text() }.Replay(w);
+		const auto binary = w.Serialize();
+		DumpBinaryView binaryDump{ binary.data(), binary.size() };
+		if (!binaryDump.Validate())
+		{
+			std::fprintf(stderr, "'%s' did not convert to a valid binary dump\n", path.string().c_str());
+			return 1;
+		}
+		binaryColumns.AddBuild(binaryDump);
+	}
+
+	const bool sameColumns = columns.strings == binaryColumns.strings && columns.builds == binaryColumns.builds &&
+		columns.structs == binaryColumns.structs && columns.members == binaryColumns.members &&
+		columns.subMembers == binaryColumns.subMembers && columns.attributes == binaryColumns.attributes && columns.enums == binaryColumns.enums &&
+		columns.enumValues == binaryColumns.enumValues;
+	std::printf("%zu builds, %zu structs, %zu members, %zu sub-members, %zu strings, %.2f MiB of columns\n",
+		columns.builds.size(), columns.structs.Size(), columns.members.Size(), columns.subMembers.Size(), columns.strings.Size(),
+		columns.MemoryUsage() / (1024.0 * 1024.0));
+	std::printf("Columns from the JSON and binary dumps: %s\n\n", sameColumns ? "same" : "DIFFERENT");
+
+	const auto& m = columns.members;
+	const auto& s = columns.structs;
+	const uint32_t arrayType = columns.strings.Find("ARRAY");
+	const uint32_t fixedArraySubtype = columns.strings.Find("ATFIXEDARRAY");
+	const uint32_t structType = columns.strings.Find("STRUCT");
+	const uint32_t hashName = DumpColumns::NameHash("Name");
+	const std::vector<Query> queries
+	{
+		{
+			"ARRAY members with subtype ATFIXEDARRAY",
+			[&]
+			{
+				size_t count = 0;
+				ForEachMember(builds, [&](const PtrStruct&, const PtrMember& mb) { count += mb.type == "ARRAY" && mb.subtype == "ATFIXEDARRAY"; });
+				return count;
+			},
+			[&]
+			{
+				size_t count = 0;
+				for (size_t i = 0; i < m.Size(); i++)
+				{
+					count += m.type[i] == arrayType && m.subtype[i] == fixedArraySubtype;
+				}
+				return count;
+			},
+		},
+		{
+			"members named 'Name' (by hash)",
+			[&]
+			{
+				size_t count = 0;
+				ForEachMember(builds, [&](const PtrStruct&, const PtrMember& mb) { count += mb.nameHash == hashName; });
+				return count;
+			},
+			[&]
+			{
+				return static_cast<size_t>(std::count(m.nameHash.begin(), m.nameHash.end(), hashName));
+			},
+		},
+		{
+			"members that end past the end of their struct",
+			[&]
+			{
+				size_t count = 0;
+				ForEachMember(builds, [&](const PtrStruct& st, const PtrMember& mb) { count += mb.offset + mb.size > st.size; });
+				return count;
+			},
+			[&]
+			{
+				size_t count = 0;
+				for (size_t i = 0; i < m.Size(); i++)
+				{
+					count += m.offset[i] + m.size[i] > s.size[m.owner[i]];
+				}
+				return count;
+			},
+		},
+		{
+			"largest member alignment, summed per struct",
+			[&]
+			{
+				size_t total = 0;
+				for (auto& b : builds)
+				{
+					for (auto& st : b.structs)
+					{
+						uint32_t maxAlign = 0;
+						for (auto& mb : st->members)
+						{
+							maxAlign = std::max(maxAlign, mb->align);
+						}
+						total += maxAlign;
+					}
+				}
+				return total;
+			},
+			[&]
+			{
+				size_t total = 0;
+				for (size_t i = 0; i < s.Size(); i++)
+				{
+					uint32_t maxAlign = 0;
+					for (uint32_t j = s.memberBegin[i]; j < s.memberEnd[i]; j++)
+					{
+						maxAlign = std::max(maxAlign, m.align[j]);
+					}
+					total += maxAlign;
+				}
+				return total;
+			},
+		},
+		{
+			"distinct types of STRUCT members (by name hash)",
+			[&]
+			{
+				std::map<uint32_t, size_t> refs;
+				ForEachMember(builds, [&](const PtrStruct&, const PtrMember& mb)
+				{
+					if (mb.type == "STRUCT")
+					{
+						refs[DumpColumns::NameHash(mb.refName)]++;
+					}
+				});
+				return refs.size();
+			},
+			[&]
+			{
+				std::vector<uint32_t> refs;
+				for (size_t i = 0; i < m.Size(); i++)
+				{
+					if (m.type[i] == structType)
+					{
+						refs.push_back(m.refNameHash[i]);
+					}
+				}
+				std::sort(refs.begin(), refs.end());
+				return static_cast<size_t>(std::unique(refs.begin(), refs.end()) - refs.begin());
+			},
+		},
+	};
+
+	size_t failures = sameColumns ? 0 : 1;
+	std::printf("%-50s %10s %12s %12s %8s %8s\n", "query", "result", "pointers ms", "columns ms", "speedup", "check");
+	for (auto& query : queries)
+	{
+		size_t pointersResult = 0, columnsResult = 0;
+		const double pointersTime = Time(query.pointers, pointersResult);
+		const double columnsTime = Time(query.columns, columnsResult);
+		const bool match = pointersResult == columnsResult;
+		std::printf("%-50s %10zu %12.3f %12.3f %7.1fx %8s\n", query.description, columnsResult, pointersTime * 1000.0,
+			columnsTime * 1000.0, pointersTime / columnsTime, match ? "OK" : "MISMATCH");
+		failures += match ? 0 : 1;
+	}
+
+	std::printf("\n%zu failed\n", failures);
+	return failures == 0 ? 0 : 1;
+}
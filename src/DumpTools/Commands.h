@@ -0,0 +1,140 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+// BinaryDump.cpp
+int ToBinary(const char* inputPath, const char* outputPath);
+int ToJson(const char* inputPath, const char* outputPath);
+// Converts every JSON dump in the directory to the binary format and back, checking that the result matches the original.
+int RoundTrip(const char* dumpsDir);
+
+// PatternScan.cpp
+// Resolves the patterns used by DumpStructs for the given game in each executable, without running the game. If
+// `cachePath` is not null, verified entries of the pattern cache are used instead of scanning and the cache is updated,
+// so it can be prepared for DumpStructs ahead of time.
+int ScanPatterns(std::string_view game, std::span<const char* const> executablePaths, bool mapped, const char* cachePath);
+
+// PatternBench.cpp
+// Plants the patterns of every game in a synthetic buffer of the given size (or in the image of an executable) and compares
+// PatternScanner with one naive pass per pattern, checking both find the same matches.
+int BenchPatterns(size_t sizeMiB, const char* executablePath);
+
+// PatternCacheCheck.cpp
+// Resolves the GTA5 patterns planted in a synthetic image with valid, stale, truncated and corrupt pattern cache files,
+// the way InitPatterns does, and checks which entries are used, when the image is rescanned and when the file is rewritten.
+int CheckPatternCache();
+
+// TriggerSim.cpp
+// Runs DumpTrigger on simulated registration timelines (fast/slow machines, lazily initialized parManager, ...) and
+// checks when it decides to dump.
+int SimulateTrigger();
+
+// CallCacheBench.cpp
+// Dumps a registry of mock parStructures/parMembers that count their virtual calls, with and without GameCallCache,
+// checking the results match and each object is called at most once with the cache.
+int BenchCallCache(size_t numStructs);
+
+// EnumBench.cpp
+// Compares the old linear duplicate-enum search of CollectStructs (GTA4/MP3/RDR2) with EnumNameIndex on synthetic
+// registries of increasing size, up to `maxCount` enum members.
+int BenchEnums(size_t maxCount);
+
+// JsonBench.cpp
+// Writes a synthetic dump with `numStructs` structs sequentially and with WriteJsonItemsParallel at increasing thread
+// counts, checking the output is byte-identical.
+int BenchJson(size_t numStructs);
+// Regenerates a JSON dump with JsonWriter `numRuns` times, from the same writer calls DumpStructs makes, and reports the
+// throughput and the heap allocations of each run.
+int BenchWriter(const char* dumpPath, size_t numRuns);
+
+// EscapeFuzz.cpp
+// Checks the strings and keys written by JsonWriter against a reference escaper, with every special character at every
+// position of a few 16-byte blocks and on `numStrings` random strings.
+int FuzzEscape(size_t numStrings);
+// Re-emits every JSON dump in the directory with JsonWriter with and without escaping the strings, `numRuns` times each,
+// and compares the time taken.
+int BenchEscape(const char* dumpsDir, size_t numRuns);
+
+// SnapshotWalk.cpp
+// Walks the parser metadata in a memory snapshot taken by DumpStructs, without the game, and reports what was found. The
+// dump of the walk is written as JSON and as a binary dump, which must have the same content.
+int WalkSnapshot(const char* snapshotPath);
+// Writes the dump DumpStructs would have written in the game from a snapshot, as JSON or as a binary dump depending on the
+// extension of `outputPath`. `dictionaryPath` is the DumpStructs dictionary the names are taken from, optional.
+int DumpSnapshot(const char* snapshotPath, const char* outputPath, const char* dictionaryPath);
+// Checks the JSON dump made from a snapshot is byte for byte the one DumpStructs wrote in the game when it took the snapshot.
+// DumpStructs only writes that dump in capture mode with DUMPSTRUCTS_SNAPSHOT=2, =1 takes the snapshot alone.
+int CheckSnapshotDump(const char* snapshotPath, const char* dumpPath, const char* dictionaryPath);
+// Generates GTA5 and RDR3 snapshots of a synthetic registry with `numStructs` structures, walks them and checks the walker
+// finds every structure, member, enum, attribute, callback and init value, and that the dump of the walk can be written.
+int BenchWalk(size_t numStructs);
+
+// AllocCount.cpp
+// Counts the heap allocations made for the strings of a synthetic dump, with a std::string per value as the dump used to and
+// with ScratchArena/FlagNameTable, at increasing sizes up to `maxStructs` structs. Checks both produce the same strings and
+// the arena allocations don't grow with the dump size.
+int CountAllocs(size_t maxStructs);
+
+// NameBench.cpp
+// Measures the lookup throughput of NameRegistry over every name hash of a dump, against an unordered_map dictionary and,
+// for StaticNameTable, against the callback name switch DumpStructs used before. Without a dictionary.txt, a synthetic one
+// is generated.
+int BenchNames(const char* dumpPath, const char* dictionaryPath);
+// Loads a dictionary.txt with NameDictionary, reports the names with the same hash and the line lengths, and compares the
+// load time with hashing it line by line into an unordered_map, as DumpFormatter does. If `indexPath` is not null, the
+// binary index is written there (DumpStructs.dictionary.index in the game directory) and loaded back.
+int BuildNameIndex(const char* dictionaryPath, const char* indexPath);
+
+// DeltaDump.cpp
+// Writes the changes of a dump since a baseline dump, see DumpDelta.h.
+int MakeDelta(const char* baselinePath, const char* dumpPath, const char* outputPath);
+// Rebuilds the full dump from its baseline and the delta.
+int Reconstruct(const char* baselinePath, const char* deltaPath, const char* outputPath);
+// Writes the delta of every JSON dump in the directory against the previous build of the same game and reconstructs it,
+// checking the result matches the original, and reports how much smaller the deltas are.
+int CheckDeltas(const char* dumpsDir);
+// Orders dump files by their build numbers ("372" < "2944", "1.0.0.255" < "1.2.0.59"), the file names don't sort that way.
+bool BuildLess(const std::filesystem::path& a, const std::filesystem::path& b);
+
+// StoreImport.cpp
+// Imports every JSON dump in the directory into a definition store (see DefinitionStore.h), then exports each build back,
+// checking the result matches the original, and reports how much smaller the store is.
+int ImportStore(const char* dumpsDir, const char* storePath);
+// Writes a build of the store as a JSON dump.
+int ExportStoreBuild(const char* storePath, std::string_view game, std::string_view build, const char* outputPath);
+// Lists the distinct definitions of a struct or enum and the builds with each of them.
+int FindDefinitions(const char* storePath, std::string_view name);
+
+// ReaderBench.cpp
+// Reads every JSON dump in the directory with DumpReader, checking the model against JsonReader, and compares the time taken
+// by both.
+int BenchReader(const char* dumpsDir);
+
+// ColumnsBench.cpp
+// Loads every JSON dump in the directory into DumpColumns, from the JSON and from the binary dump, and into an object per
+// struct/member, and compares typical queries over all the members of all the builds on both models.
+int BenchColumns(const char* dumpsDir);
+
+// QueryCommand.cpp
+// Prints the structs or members of the dumps in the directory that match a filter (see DumpQuery.h), of every build or only
+// the given ones ("gta5/2944"), scanning the builds in `numThreads` threads. With `changedField`, prints the rows of the
+// second build whose field changed since the first. With `stream`, prints a JSON object per row as each build is scanned.
+int RunQuery(const char* dumpsDir, std::string_view target, std::span<const char* const> builds, const char* changedField,
+	size_t numThreads, bool stream, const char* filter);
+
+// UsageCommand.cpp
+// Builds the usage index (see UsageIndex.h) of every JSON dump in the directory, checking each lookup against scanning the
+// build for the struct or enum like JsonTreeFormatter does, and compares the time taken by both.
+int BuildUsageIndex(const char* dumpsDir, const char* indexPath);
+// Lists the structs that use a struct or enum of a build of the index.
+int FindUsage(const char* indexPath, std::string_view game, std::string_view build, std::string_view name);
+
+// SearchCommand.cpp
+// Writes the search index (see SearchIndex.h) of every build of the registry with a JSON dump in the directory, as
+// <output-dir>/<game>/b<build>.search, with the names resolved through the dictionary if given. Reports the size of the
+// indices and the time taken, and checks a few searches through the index find the same as matching every name.
+int BuildSearchIndex(const char* registryPath, const char* dumpsDir, const char* outputDir, const char* dictionaryPath);
+// Searches the structs and enums of a build like the page does.
+int SearchNames(const char* indexPath, std::string_view text, bool matchCase, bool regex, bool matchMembers);
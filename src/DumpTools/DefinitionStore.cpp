@@ -0,0 +1,379 @@
+#include "DefinitionStore.h"
+#include "DumpRecords.h"
+#include "JsonReader.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+
+static constexpr std::array<char, 8> store_magic{ 'D', 'S', 'S', 'T', 'O', 'R', 'E', '\0' };
+static constexpr uint32_t store_version = 1;
+
+// As written by DumpJsonStructure/DumpJsonMember, "0x" and the uppercase hex digits without leading zeros.
+static std::string FormatAddress(uint64_t address)
+{
+	char buffer[2 + 16] = { '0', 'x' };
+	const auto [end, ec] = std::to_chars(buffer + 2, std::end(buffer), address, 16);
+	std::transform(buffer + 2, end, buffer + 2, [](char c) { return c >= 'a' && c <= 'f' ? static_cast<char>(c - 'a' + 'A') : c; });
+	return { buffer, end };
+}
+
+static uint64_t ParseAddress(std::string_view text)
+{
+	uint64_t address = 0;
+	const bool parsed = text.size() > 2 && text.starts_with("0x") &&
+		std::from_chars(text.data() + 2, text.data() + text.size(), address, 16).ptr == text.data() + text.size();
+	// stored as a number, so it must come back as the same text
+	if (!parsed || FormatAddress(address) != text)
+	{
+		throw std::runtime_error("unexpected function address '" + std::string{ text } + "'");
+	}
+	return address;
+}
+
+static uint64_t HashText(std::string_view text)
+{
+	uint64_t hash = 0xCBF29CE484222325;
+	for (const char c : text)
+	{
+		hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3;
+	}
+	return hash;
+}
+
+namespace
+{
+	// Writes a record replayed by JsonReader as compact JSON, the canonical form of a definition. The function addresses are
+	// written as "" and kept aside.
+	class CanonicalRecordWriter
+	{
+	public:
+		void Null(std::optional<std::string_view> key) { Value(key); text += "null"; }
+		void String(std::optional<std::string_view> key, std::string_view value)
+		{
+			Value(key);
+			if (_tracker.IsAddress(key))
+			{
+				addresses.push_back(ParseAddress(value));
+				text += "\"\"";
+				return;
+			}
+
+			if (_tracker.Depth() == 1 && key == "name")
+			{
+				name = value;
+			}
+			Quoted(value);
+		}
+		void Bool(std::optional<std::string_view> key, bool value) { Value(key); text += value ? "true" : "false"; }
+		void Int(std::optional<std::string_view> key, std::signed_integral auto value) { Value(key); Number(value); }
+		void UInt(std::optional<std::string_view> key, std::unsigned_integral auto value, JsonUIntOptions) { Value(key); Number(value); }
+		void Double(std::optional<std::string_view> key, double value) { Value(key); Number(value); }
+		void BeginObject(std::optional<std::string_view> key = std::nullopt) { Value(key); text += '{'; _first = true; _tracker.Begin(key, true); }
+		void EndObject() { text += '}'; _first = false; _tracker.End(); }
+		void BeginArray(std::optional<std::string_view> key = std::nullopt) { Value(key); text += '['; _first = true; _tracker.Begin(key, false); }
+		void EndArray() { text += ']'; _first = false; _tracker.End(); }
+
+		std::string text;
+		std::string name;
+		std::vector<uint64_t> addresses;
+
+	private:
+		void Value(std::optional<std::string_view> key)
+		{
+			if (!_first)
+			{
+				text += ',';
+			}
+			_first = false;
+			if (key.has_value())
+			{
+				Quoted(*key);
+				text += ':';
+			}
+		}
+
+		void Quoted(std::string_view str)
+		{
+			text += '"';
+			for (const char c : str)
+			{
+				if (c == '"' || c == '\\')
+				{
+					text += '\\';
+					text += c;
+				}
+				else if (static_cast<uint8_t>(c) < 0x20)
+				{
+					constexpr char digits[] = "0123456789ABCDEF";
+					text += "\\u00";
+					text += digits[c >> 4];
+					text += digits[c & 0xF];
+				}
+				else
+				{
+					text += c;
+				}
+			}
+			text += '"';
+		}
+
+		// shortest representation that parses back to the same value
+		void Number(auto value)
+		{
+			char buffer[32];
+			const auto [end, ec] = std::to_chars(buffer, std::end(buffer), value);
+			text.append(buffer, end);
+		}
+
+		bool _first = true;
+		AddressTracker _tracker;
+	};
+}
+
+size_t DefinitionStoreBuilder::AddDump(std::string_view dumpText)
+{
+	const uint32_t buildIndex = static_cast<uint32_t>(_builds.size());
+	Build build{};
+	build.firstRecord = static_cast<uint32_t>(_records.size());
+	size_t added = 0;
+	JsonScanner{ dumpText }.Members([&](std::string_view key, std::string_view value)
+	{
+		if (key == "game")
+		{
+			build.game = JsonScanner::StringValue(value);
+		}
+		else if (key == "build")
+		{
+			build.build = JsonScanner::StringValue(value);
+		}
+		else if (key == "structs" || key == "enums")
+		{
+			// the records of a build are its structs and then its enums
+			if (key == "structs" && build.enumCount != 0)
+			{
+				throw std::runtime_error("the structs of the dump are after the enums");
+			}
+
+			JsonScanner{ value }.Items([&](std::string_view item)
+			{
+				CanonicalRecordWriter w;
+				JsonReader{ item }.Replay(w);
+
+				const uint64_t hash = HashText(w.text);
+				const auto [it, inserted] = _definitionsByHash.try_emplace(hash, static_cast<uint32_t>(_definitions.size()));
+				if (inserted)
+				{
+					_definitions.push_back({ hash, std::move(w.text), std::move(w.name), {} });
+					added++;
+				}
+				else if (_definitions[it->second].text != w.text)
+				{
+					throw std::runtime_error("two definitions of '" + w.name + "' have the same hash");
+				}
+
+				auto& builds = _definitions[it->second].builds;
+				if (builds.empty() || builds.back() != buildIndex)
+				{
+					builds.push_back(buildIndex);
+				}
+				_records.push_back({ it->second, static_cast<uint32_t>(_addresses.size()), static_cast<uint32_t>(w.addresses.size()) });
+				_addresses.insert(_addresses.end(), w.addresses.begin(), w.addresses.end());
+				(key == "structs" ? build.structCount : build.enumCount)++;
+			});
+		}
+	});
+	_builds.push_back(std::move(build));
+	return added;
+}
+
+bool DefinitionStoreBuilder::Save(const char* path) const
+{
+	// sorted by hash for FindDefinition, the records refer to the definitions by their new index
+	std::vector<uint32_t> order(_definitions.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return _definitions[a].hash < _definitions[b].hash; });
+	std::vector<uint32_t> newIndex(_definitions.size());
+	for (uint32_t i = 0; i < order.size(); i++)
+	{
+		newIndex[order[i]] = i;
+	}
+
+	std::string chars;
+	const auto addChars = [&chars](std::string_view str, uint32_t& offset, uint32_t& size)
+	{
+		offset = static_cast<uint32_t>(chars.size());
+		size = static_cast<uint32_t>(str.size());
+		chars.append(str);
+	};
+
+	std::vector<StoreDefinition> definitions(order.size());
+	std::vector<uint32_t> containingBuilds;
+	for (uint32_t i = 0; i < order.size(); i++)
+	{
+		auto& source = _definitions[order[i]];
+		auto& definition = definitions[i];
+		definition.hash = source.hash;
+		addChars(source.text, definition.textOffset, definition.textSize);
+		addChars(source.name, definition.nameOffset, definition.nameSize);
+		definition.firstBuild = static_cast<uint32_t>(containingBuilds.size());
+		definition.buildCount = static_cast<uint32_t>(source.builds.size());
+		containingBuilds.insert(containingBuilds.end(), source.builds.begin(), source.builds.end());
+	}
+
+	std::vector<StoreBuild> builds(_builds.size());
+	for (size_t i = 0; i < _builds.size(); i++)
+	{
+		addChars(_builds[i].game, builds[i].gameOffset, builds[i].gameSize);
+		addChars(_builds[i].build, builds[i].buildOffset, builds[i].buildSize);
+		builds[i].firstRecord = _builds[i].firstRecord;
+		builds[i].structCount = _builds[i].structCount;
+		builds[i].enumCount = _builds[i].enumCount;
+	}
+
+	std::vector<StoreRecord> records = _records;
+	for (auto& record : records)
+	{
+		record.definition = newIndex[record.definition];
+	}
+
+	if (chars.size() > UINT32_MAX || _addresses.size() > UINT32_MAX)
+	{
+		return false;
+	}
+
+	StoreHeader header{};
+	header.magic = store_magic;
+	header.version = store_version;
+	header.definitionCount = static_cast<uint32_t>(definitions.size());
+	header.addressCount = static_cast<uint32_t>(_addresses.size());
+	header.buildCount = static_cast<uint32_t>(builds.size());
+	header.recordCount = static_cast<uint32_t>(records.size());
+	header.containingCount = static_cast<uint32_t>(containingBuilds.size());
+	header.charCount = chars.size();
+
+	std::ofstream out{ path, std::ios::out | std::ios::binary | std::ios::trunc };
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(definitions.data()), definitions.size() * sizeof(StoreDefinition));
+	out.write(reinterpret_cast<const char*>(_addresses.data()), _addresses.size() * sizeof(uint64_t));
+	out.write(reinterpret_cast<const char*>(builds.data()), builds.size() * sizeof(StoreBuild));
+	out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(StoreRecord));
+	out.write(reinterpret_cast<const char*>(containingBuilds.data()), containingBuilds.size() * sizeof(uint32_t));
+	out.write(chars.data(), chars.size());
+	return out.good();
+}
+
+bool DefinitionStore::Open(const char* path)
+{
+	if (!_file.Open(path) || _file.Size() < sizeof(StoreHeader))
+	{
+		return false;
+	}
+
+	std::memcpy(&_header, _file.Data(), sizeof(_header));
+	const auto& h = _header;
+	const uint64_t expectedSize = sizeof(StoreHeader) + uint64_t{ h.definitionCount } * sizeof(StoreDefinition) +
+		uint64_t{ h.addressCount } * sizeof(uint64_t) + uint64_t{ h.buildCount } * sizeof(StoreBuild) +
+		uint64_t{ h.recordCount } * sizeof(StoreRecord) + uint64_t{ h.containingCount } * sizeof(uint32_t) + h.charCount;
+	if (h.magic != store_magic || h.version != store_version || h.charCount > UINT32_MAX || _file.Size() != expectedSize)
+	{
+		return false;
+	}
+
+	// each section is aligned for its elements, the mapping itself is page-aligned
+	const uint8_t* data = _file.Data() + sizeof(StoreHeader);
+	_definitions = reinterpret_cast<const StoreDefinition*>(data);
+	data += h.definitionCount * sizeof(StoreDefinition);
+	_addresses = reinterpret_cast<const uint64_t*>(data);
+	data += h.addressCount * sizeof(uint64_t);
+	_builds = reinterpret_cast<const StoreBuild*>(data);
+	data += h.buildCount * sizeof(StoreBuild);
+	_records = reinterpret_cast<const StoreRecord*>(data);
+	data += h.recordCount * sizeof(StoreRecord);
+	_containingBuilds = reinterpret_cast<const uint32_t*>(data);
+	data += h.containingCount * sizeof(uint32_t);
+	_chars = reinterpret_cast<const char*>(data);
+
+	// the lookups trust the offsets and indices, check them once here
+	const auto inRange = [](uint64_t offset, uint64_t size, uint64_t total) { return offset <= total && size <= total - offset; };
+	bool valid = true;
+	for (auto& d : Definitions())
+	{
+		valid = valid && inRange(d.textOffset, d.textSize, h.charCount) && inRange(d.nameOffset, d.nameSize, h.charCount) &&
+			inRange(d.firstBuild, d.buildCount, h.containingCount);
+	}
+	for (auto& b : Builds())
+	{
+		valid = valid && inRange(b.gameOffset, b.gameSize, h.charCount) && inRange(b.buildOffset, b.buildSize, h.charCount) &&
+			inRange(b.firstRecord, uint64_t{ b.structCount } + b.enumCount, h.recordCount);
+	}
+	for (uint32_t i = 0; i < h.recordCount; i++)
+	{
+		valid = valid && _records[i].definition < h.definitionCount &&
+			inRange(_records[i].firstAddress, _records[i].addressCount, h.addressCount);
+	}
+	for (uint32_t i = 0; i < h.containingCount; i++)
+	{
+		valid = valid && _containingBuilds[i] < h.buildCount;
+	}
+	if (!valid)
+	{
+		_file.Close();
+	}
+	return valid;
+}
+
+const StoreBuild* DefinitionStore::FindBuild(std::string_view game, std::string_view build) const
+{
+	for (auto& b : Builds())
+	{
+		if (Game(b) == game && Build(b) == build)
+		{
+			return &b;
+		}
+	}
+	return nullptr;
+}
+
+const StoreDefinition* DefinitionStore::FindDefinition(uint64_t hash) const
+{
+	const auto definitions = Definitions();
+	const auto it = std::lower_bound(definitions.begin(), definitions.end(), hash,
+		[](const StoreDefinition& d, uint64_t hash) { return d.hash < hash; });
+	return it != definitions.end() && it->hash == hash ? &*it : nullptr;
+}
+
+void DefinitionStore::WriteDump(JsonWriter& w, const StoreBuild& build) const
+{
+	w.BeginObject();
+	w.String("game", Game(build));
+	w.String("build", Build(build));
+	WriteRecords(w, "structs", build.firstRecord, build.structCount);
+	WriteRecords(w, "enums", build.firstRecord + build.structCount, build.enumCount);
+	w.EndObject();
+}
+
+void DefinitionStore::WriteRecords(JsonWriter& w, std::string_view key, uint32_t firstRecord, uint32_t count) const
+{
+	std::vector<std::string> addresses;
+	w.BeginArray(key);
+	for (uint32_t i = firstRecord; i < firstRecord + count; i++)
+	{
+		const auto& record = _records[i];
+		addresses.clear();
+		for (uint32_t a = 0; a < record.addressCount; a++)
+		{
+			addresses.push_back(FormatAddress(_addresses[record.firstAddress + a]));
+		}
+
+		AddressPatcher patcher{ w, std::span<const std::string>{ addresses } };
+		JsonReader{ Text(_definitions[record.definition]) }.Replay(patcher);
+		if (!patcher.UsedAllAddresses())
+		{
+			throw std::runtime_error("a record has more addresses than its definition");
+		}
+	}
+	w.EndArray();
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include "JsonWriter.h"
+#include "MappedFile.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Content-addressed store of the structs and enums of many dumps. Each distinct definition is stored once, under a hash of its
+// canonical form (the record as compact JSON, without the function addresses, which move in every build), and each build is a
+// list of definitions plus the addresses of its records. Most definitions are the same in every build, so the store is a
+// fraction of the size of the dumps.
+//
+// The store is a single file meant to be memory-mapped:
+//
+//   StoreHeader
+//   StoreDefinition definitions[definitionCount] // sorted by hash
+//   uint64_t addresses[addressCount]             // of the records, in order
+//   StoreBuild builds[buildCount]
+//   StoreRecord records[recordCount]             // of each build, its structs and then its enums
+//   uint32_t containingBuilds[containingCount]   // of each definition, the builds with a record of it
+//   char chars[charCount]                        // texts of the definitions, names, games and builds
+
+struct StoreHeader
+{
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t definitionCount;
+	uint32_t addressCount;
+	uint32_t buildCount;
+	uint32_t recordCount;
+	uint32_t containingCount;
+	uint64_t charCount;
+};
+
+struct StoreDefinition
+{
+	uint64_t hash;       // FNV-1a of the text
+	uint32_t textOffset; // in chars, the record as compact JSON with "" in place of the function addresses
+	uint32_t textSize;
+	uint32_t nameOffset;
+	uint32_t nameSize;
+	uint32_t firstBuild; // in containingBuilds
+	uint32_t buildCount;
+};
+
+struct StoreBuild
+{
+	uint32_t gameOffset;
+	uint32_t gameSize;
+	uint32_t buildOffset;
+	uint32_t buildSize;
+	uint32_t firstRecord;
+	uint32_t structCount;
+	uint32_t enumCount;
+};
+
+struct StoreRecord
+{
+	uint32_t definition; // index in definitions
+	uint32_t firstAddress;
+	uint32_t addressCount;
+};
+
+// Builds a store from JSON dumps.
+class DefinitionStoreBuilder
+{
+public:
+	// Adds the structs and enums of a dump, returns how many of its definitions were not in the store yet. Throws
+	// std::runtime_error if the dump is malformed.
+	size_t AddDump(std::string_view dumpText);
+	bool Save(const char* path) const;
+
+	size_t DefinitionCount() const { return _definitions.size(); }
+	size_t RecordCount() const { return _records.size(); }
+
+private:
+	struct Definition
+	{
+		uint64_t hash;
+		std::string text;
+		std::string name;
+		std::vector<uint32_t> builds;
+	};
+
+	struct Build
+	{
+		std::string game;
+		std::string build;
+		uint32_t firstRecord;
+		uint32_t structCount;
+		uint32_t enumCount;
+	};
+
+	std::deque<Definition> _definitions;
+	std::unordered_map<uint64_t, uint32_t> _definitionsByHash;
+	std::vector<Build> _builds;
+	std::vector<StoreRecord> _records;
+	std::vector<uint64_t> _addresses;
+};
+
+// Read-only view of a store file.
+class DefinitionStore
+{
+public:
+	// Returns false if the file could not be read or is not a valid store.
+	bool Open(const char* path);
+
+	std::span<const StoreDefinition> Definitions() const { return { _definitions, _header.definitionCount }; }
+	std::span<const StoreBuild> Builds() const { return { _builds, _header.buildCount }; }
+
+	std::string_view Game(const StoreBuild& build) const { return Chars(build.gameOffset, build.gameSize); }
+	std::string_view Build(const StoreBuild& build) const { return Chars(build.buildOffset, build.buildSize); }
+	std::string_view Name(const StoreDefinition& definition) const { return Chars(definition.nameOffset, definition.nameSize); }
+	std::string_view Text(const StoreDefinition& definition) const { return Chars(definition.textOffset, definition.textSize); }
+	// Indices in Builds() of the builds with a record of the definition.
+	std::span<const uint32_t> BuildsContaining(const StoreDefinition& definition) const
+	{
+		return { _containingBuilds + definition.firstBuild, definition.buildCount };
+	}
+
+	// nullptr if not found.
+	const StoreBuild* FindBuild(std::string_view game, std::string_view build) const;
+	const StoreDefinition* FindDefinition(uint64_t hash) const;
+
+	// Writes the build as the JSON dump it was imported from (as formatted by the current JsonWriter).
+	void WriteDump(JsonWriter& w, const StoreBuild& build) const;
+
+	size_t Size() const { return _file.Size(); }
+
+private:
+	std::string_view Chars(uint32_t offset, uint32_t size) const { return { _chars + offset, size }; }
+	void WriteRecords(JsonWriter& w, std::string_view key, uint32_t firstRecord, uint32_t count) const;
+
+	MappedFile _file;
+	StoreHeader _header{};
+	const StoreDefinition* _definitions = nullptr;
+	const uint64_t* _addresses = nullptr;
+	const StoreBuild* _builds = nullptr;
+	const StoreRecord* _records = nullptr;
+	const uint32_t* _containingBuilds = nullptr;
+	const char* _chars = nullptr;
+};
@@ -0,0 +1,190 @@
+#include "Commands.h"
+#include "DumpDelta.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int MakeDelta(const char* baselinePath, const char* dumpPath, const char* outputPath)
+{
+	MappedFile baseline, dump;
+	if (!baseline.Open(baselinePath) || !dump.Open(dumpPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s' or '%s'\n", baselinePath, dumpPath);
+		return 1;
+	}
+
+	JsonWriter w{ outputPath };
+	const auto stats = WriteDumpDelta(w, baseline.Text(), dump.Text());
+	std::printf("Against build %s: %zu added, %zu changed, %zu unchanged, %zu removed\n",
+		stats.baselineBuild.c_str(), stats.added, stats.changed, stats.unchanged, stats.removed);
+	return 0;
+}
+
+int Reconstruct(const char* baselinePath, const char* deltaPath, const char* outputPath)
+{
+	MappedFile baseline, delta;
+	if (!baseline.Open(baselinePath) || !delta.Open(deltaPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s' or '%s'\n", baselinePath, deltaPath);
+		return 1;
+	}
+
+	JsonWriter w{ outputPath };
+	ReconstructDump(w, baseline.Text(), delta.Text());
+	return 0;
+}
+
+bool BuildLess(const fs::path& a, const fs::path& b)
+{
+	const auto numbers = [](const std::string& name)
+	{
+		std::vector<uint64_t> result;
+		for (size_t i = 0; i < name.size();)
+		{
+			if (name[i] < '0' || name[i] > '9')
+			{
+				i++;
+				continue;
+			}
+
+			uint64_t n = 0;
+			for (; i < name.size() && name[i] >= '0' && name[i] <= '9'; i++)
+			{
+				n = n * 10 + (name[i] - '0');
+			}
+			result.push_back(n);
+		}
+		return result;
+	};
+	return numbers(a.stem().string()) < numbers(b.stem().string());
+}
+
+static double Seconds(std::chrono::steady_clock::duration d)
+{
+	return std::chrono::duration<double>(d).count();
+}
+
+int CheckDeltas(const char* dumpsDir)
+{
+	using clock = std::chrono::steady_clock;
+
+	std::map<fs::path, std::vector<fs::path>> games;
+	for (auto& entry : fs::recursive_directory_iterator(dumpsDir))
+	{
+		// only the dumps, which are inside a subdirectory per game
+		if (entry.is_regular_file() && entry.path().extension() == ".json" && entry.path().parent_path() != fs::path{ dumpsDir })
+		{
+			games[entry.path().parent_path()].push_back(entry.path());
+		}
+	}
+
+	const auto tmpDeltaPath = (fs::temp_directory_path() / "DumpTools_delta.json").string();
+	const auto tmpOutputPath = (fs::temp_directory_path() / "DumpTools_delta_output.json").string();
+	const auto tmpCanonicalPath = (fs::temp_directory_path() / "DumpTools_delta_canonical.json").string();
+	size_t failures = 0, numDeltas = 0;
+	size_t totalJsonSize = 0, totalStoredSize = 0;
+	double totalDeltaTime = 0.0, totalReconstructTime = 0.0;
+	std::printf("%-40s %-10s %12s %12s %6s %6s %6s %6s %8s %8s %8s\n",
+		"dump", "baseline", "json bytes", "delta bytes", "added", "chang.", "unch.", "rem.", "delta ms", "rec. ms", "result");
+	for (auto& [game, paths] : games)
+	{
+		// each build against the previous one, the first build of each game is stored in full
+		std::sort(paths.begin(), paths.end(), BuildLess);
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			MappedFile dump;
+			if (!dump.Open(paths[i].string().c_str()))
+			{
+				std::printf("%-40s failed to open\n", paths[i].string().c_str());
+				failures++;
+				continue;
+			}
+			totalJsonSize += dump.Size();
+			if (i == 0)
+			{
+				totalStoredSize += dump.Size();
+				continue;
+			}
+
+			MappedFile baseline;
+			if (!baseline.Open(paths[i - 1].string().c_str()))
+			{
+				std::printf("%-40s failed to open the baseline\n", paths[i].string().c_str());
+				failures++;
+				continue;
+			}
+
+			const char* result = "MISMATCH";
+			DumpDeltaStats stats;
+			size_t deltaSize = 0;
+			double deltaTime = 0.0, reconstructTime = 0.0;
+			try
+			{
+				auto start = clock::now();
+				{
+					JsonWriter w{ tmpDeltaPath };
+					stats = WriteDumpDelta(w, baseline.Text(), dump.Text());
+				}
+				deltaTime = Seconds(clock::now() - start);
+
+				MappedFile delta;
+				if (delta.Open(tmpDeltaPath.c_str()))
+				{
+					deltaSize = delta.Size();
+					start = clock::now();
+					{
+						JsonWriter w{ tmpOutputPath };
+						ReconstructDump(w, baseline.Text(), delta.Text());
+					}
+					reconstructTime = Seconds(clock::now() - start);
+				}
+
+				// compared against the original re-written by the current JsonWriter, like roundtrip does
+				{
+					JsonWriter w{ tmpCanonicalPath };
+					JsonReader{ dump.Text() }.Replay(w);
+				}
+				MappedFile output, canonical;
+				if (output.Open(tmpOutputPath.c_str()) && canonical.Open(tmpCanonicalPath.c_str()) && output.Text() == canonical.Text())
+				{
+					result = "OK";
+				}
+			}
+			catch (const std::exception& ex)
+			{
+				std::printf("%-40s %s\n", paths[i].string().c_str(), ex.what());
+				failures++;
+				continue;
+			}
+
+			std::printf("%-40s %-10s %12zu %12zu %6zu %6zu %6zu %6zu %8.2f %8.2f %8s\n",
+				fs::relative(paths[i], dumpsDir).string().c_str(), stats.baselineBuild.c_str(), dump.Size(), deltaSize,
+				stats.added, stats.changed, stats.unchanged, stats.removed, deltaTime * 1000.0, reconstructTime * 1000.0, result);
+			failures += result[0] == 'O' ? 0 : 1;
+			numDeltas++;
+			totalStoredSize += deltaSize;
+			totalDeltaTime += deltaTime;
+			totalReconstructTime += reconstructTime;
+		}
+	}
+	fs::remove(tmpDeltaPath);
+	fs::remove(tmpOutputPath);
+	fs::remove(tmpCanonicalPath);
+
+	std::printf("\n%zu deltas, %zu failed\n", numDeltas, failures);
+	std::printf("Full dumps:            %.2f MiB\n", totalJsonSize / (1024.0 * 1024.0));
+	std::printf("First builds + deltas: %.2f MiB (%.1f%%)\n", totalStoredSize / (1024.0 * 1024.0), 100.0 * totalStoredSize / totalJsonSize);
+	std::printf("Delta %.1f ms, reconstruct %.1f ms in total\n", totalDeltaTime * 1000.0, totalReconstructTime * 1000.0);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,305 @@
+#pragma once
+#include "DumpBinary.h"
+#include "JsonWriter.h"
+#include <charconv>
+#include <optional>
+#include <string_view>
+
+// Replays a binary dump as calls to a writer with the JsonWriter interface, in the same order and with the same
+// formatting options used by DumpStructs, so replaying into a JsonWriter reproduces the original JSON dump.
+template<class TWriter>
+class DumpBinaryReplay
+{
+public:
+	DumpBinaryReplay(const DumpBinaryView& dump, TWriter& w)
+		: _d{ dump }, _w{ w }, _simpleInitValueIsDouble{ dump.Game() == "rdr3" }
+	{
+	}
+
+	void Run()
+	{
+		_w.BeginObject();
+		_w.String("game", _d.Game());
+		_w.String("build", _d.Build());
+		_w.BeginArray("structs");
+		for (auto& s : _d.Structs())
+		{
+			Struct(s);
+		}
+		_w.EndArray();
+		_w.BeginArray("enums");
+		for (auto& e : _d.Enums())
+		{
+			Enum(e);
+		}
+		_w.EndArray();
+		_w.EndObject();
+	}
+
+private:
+	void Name(std::string_view key, const DumpName& name)
+	{
+		if (name.IsHashOnly())
+		{
+			_w.UInt(key, name.hash, json_uint_hex);
+		}
+		else
+		{
+			_w.String(key, _d.String(name.string));
+		}
+	}
+
+	void Pointer(std::string_view key, uint64_t value)
+	{
+		if (value == DumpNullPointer)
+		{
+			_w.Null(key);
+		}
+		else
+		{
+			_w.UInt(key, value, json_uint_hex_no_zero_pad);
+		}
+	}
+
+	void Struct(const DumpStructRecord& s)
+	{
+		_w.BeginObject();
+		Name("name", s.name);
+		if (s.presence & DumpStructKey_Base)
+		{
+			_w.BeginObject("base");
+			Name("name", s.baseName);
+			_w.UInt("offset", s.baseOffset, json_uint_dec);
+			_w.EndObject();
+		}
+		_w.UInt("size", s.size, json_uint_dec);
+		if (s.presence & DumpStructKey_Align)
+		{
+			_w.UInt("align", s.align, json_uint_dec);
+		}
+		_w.String("flags", _d.String(s.flags));
+		char version[16];
+		auto* versionEnd = std::to_chars(version, version + sizeof(version), s.versionMajor).ptr;
+		*versionEnd++ = '.';
+		versionEnd = std::to_chars(versionEnd, version + sizeof(version), s.versionMinor).ptr;
+		_w.String("version", std::string_view{ version, static_cast<size_t>(versionEnd - version) });
+		_w.BeginArray("members");
+		for (auto& m : _d.Members(s))
+		{
+			Member(std::nullopt, m);
+		}
+		_w.EndArray();
+		if (s.presence & DumpStructKey_ExtraAttributes)
+		{
+			AttributeList("extraAttributes", _d.AttributeLists()[s.extraAttributes]);
+		}
+		_w.BeginObject("factories");
+		if (s.presence & DumpStructKey_FactoryNew)
+		{
+			Pointer("new", s.factoryNew);
+		}
+		if (s.presence & DumpStructKey_FactoryPlacementNew)
+		{
+			Pointer("placementNew", s.factoryPlacementNew);
+		}
+		if (s.presence & DumpStructKey_FactoryDelete)
+		{
+			Pointer("delete", s.factoryDelete);
+		}
+		_w.EndObject();
+		if (s.presence & DumpStructKey_GetStructureCB)
+		{
+			Pointer("getStructureCB", s.getStructureCB);
+		}
+		if (s.presence & DumpStructKey_Callbacks)
+		{
+			_w.BeginObject("callbacks");
+			for (auto& cb : _d.Callbacks(s))
+			{
+				_w.UInt(_d.String(cb.name), cb.func, json_uint_hex_no_zero_pad);
+			}
+			_w.EndObject();
+		}
+		_w.EndObject();
+	}
+
+	void SubMember(std::string_view key, uint32_t index)
+	{
+		if (index == DumpNoIndex)
+		{
+			_w.Null(key);
+		}
+		else
+		{
+			Member(key, _d.SubMembers()[index]);
+		}
+	}
+
+	void Member(std::optional<std::string_view> key, const DumpMemberRecord& m)
+	{
+		_w.BeginObject(key);
+		Name("name", m.name);
+		_w.UInt("offset", m.offset, json_uint_dec);
+		_w.UInt("size", m.size, json_uint_dec);
+		if (m.presence & DumpMemberKey_Align)
+		{
+			_w.UInt("align", m.align, json_uint_dec);
+		}
+		_w.UInt("flags1", m.flags1, json_uint_hex);
+		_w.UInt("flags2", m.flags2, json_uint_hex);
+		if (m.presence & DumpMemberKey_ExtraData)
+		{
+			_w.UInt("extraData", m.extraData, json_uint_hex);
+		}
+		_w.String("type", _d.String(m.type));
+		_w.String("subtype", _d.String(m.subtype));
+		if (m.presence & DumpMemberKey_Attributes)
+		{
+			AttributeList("attributes", _d.AttributeLists()[m.attributes]);
+		}
+		if (m.presence & DumpMemberKey_StructName)
+		{
+			if (m.presence & DumpMemberKey_StructNameNull)
+			{
+				_w.Null("structName");
+			}
+			else
+			{
+				Name("structName", m.refName);
+			}
+		}
+		if (m.presence & DumpMemberKey_ExternalNamedResolveFunc)
+		{
+			Pointer("externalNamedResolveFunc", m.funcs[DumpMemberRecord::ExternalNamedResolveFunc]);
+		}
+		if (m.presence & DumpMemberKey_ExternalNamedGetNameFunc)
+		{
+			Pointer("externalNamedGetNameFunc", m.funcs[DumpMemberRecord::ExternalNamedGetNameFunc]);
+		}
+		if (m.presence & DumpMemberKey_AllocateStructFunc)
+		{
+			Pointer("allocateStructFunc", m.funcs[DumpMemberRecord::AllocateStructFunc]);
+		}
+		if (m.presence & DumpMemberKey_Item)
+		{
+			SubMember("item", m.children[DumpMemberRecord::Item]);
+		}
+		if (m.presence & DumpMemberKey_AllocFlags)
+		{
+			_w.String("allocFlags", _d.String(m.allocFlags));
+		}
+		if (m.presence & DumpMemberKey_ArraySize)
+		{
+			_w.UInt("arraySize", m.count, json_uint_dec);
+		}
+		if (m.presence & DumpMemberKey_CountOffset)
+		{
+			_w.UInt("countOffset", m.count, json_uint_hex);
+		}
+		if (m.presence & DumpMemberKey_EnumName)
+		{
+			Name("enumName", m.refName);
+		}
+		if (m.presence & DumpMemberKey_InitValue)
+		{
+			if (m.presence & DumpMemberKey_InitValueIsInt)
+			{
+				_w.Int("initValue", m.initValueInt);
+			}
+			else if (_simpleInitValueIsDouble)
+			{
+				_w.Double("initValue", m.initValue);
+			}
+			else
+			{
+				_w.Float("initValue", static_cast<float>(m.initValue));
+			}
+		}
+		if (m.presence & DumpMemberKey_Key)
+		{
+			SubMember("key", m.children[DumpMemberRecord::Key]);
+		}
+		if (m.presence & DumpMemberKey_Value)
+		{
+			SubMember("value", m.children[DumpMemberRecord::Value]);
+		}
+		if (m.presence & DumpMemberKey_CreateIteratorFunc)
+		{
+			Pointer("createIteratorFunc", m.funcs[DumpMemberRecord::CreateIteratorFunc]);
+		}
+		if (m.presence & DumpMemberKey_CreateInterfaceFunc)
+		{
+			Pointer("createInterfaceFunc", m.funcs[DumpMemberRecord::CreateInterfaceFunc]);
+		}
+		if (m.presence & DumpMemberKey_MemberSize)
+		{
+			_w.UInt("memberSize", m.count, json_uint_dec);
+		}
+		if (m.presence & DumpMemberKey_NamespaceIndex)
+		{
+			_w.UInt("namespaceIndex", m.count, json_uint_dec);
+		}
+		if (m.presence & DumpMemberKey_InitValues)
+		{
+			_w.BeginArray("initValues");
+			for (double v : _d.InitValues(m))
+			{
+				_w.Float(std::nullopt, static_cast<float>(v));
+			}
+			_w.EndArray();
+		}
+		_w.EndObject();
+	}
+
+	void AttributeList(std::string_view key, const DumpAttributeListRecord& l)
+	{
+		_w.BeginObject(key);
+		if (l.presence & DumpAttributeListKey_UserData1)
+		{
+			_w.UInt("userData1", l.userData1, json_uint_dec);
+		}
+		if (l.presence & DumpAttributeListKey_UserData2)
+		{
+			_w.UInt("userData2", l.userData2, json_uint_dec);
+		}
+		_w.BeginArray("list");
+		for (auto& a : _d.Attributes(l))
+		{
+			_w.BeginObject();
+			_w.String("name", _d.String(a.name));
+			_w.String("type", _d.String(a.type));
+			switch (a.valueKind)
+			{
+			case DumpAttributeValueKind::String: _w.String("value", _d.String(a.asString)); break;
+			case DumpAttributeValueKind::Int: _w.Int("value", a.asInt); break;
+			case DumpAttributeValueKind::Double: _w.Double("value", a.asDouble); break;
+			case DumpAttributeValueKind::Bool: _w.Bool("value", a.asBool); break;
+			case DumpAttributeValueKind::None: break;
+			}
+			_w.EndObject();
+		}
+		_w.EndArray();
+		_w.EndObject();
+	}
+
+	void Enum(const DumpEnumRecord& e)
+	{
+		_w.BeginObject();
+		Name("name", e.name);
+		_w.String("flags", _d.String(e.flags));
+		_w.BeginArray("values");
+		for (auto& v : _d.Values(e))
+		{
+			_w.BeginObject();
+			Name("name", v.name);
+			_w.Int("value", v.value);
+			_w.EndObject();
+		}
+		_w.EndArray();
+		_w.EndObject();
+	}
+
+	const DumpBinaryView& _d;
+	TWriter& _w;
+	bool _simpleInitValueIsDouble;
+};
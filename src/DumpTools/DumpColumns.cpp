@@ -0,0 +1,266 @@
+#include "DumpColumns.h"
+#include "Joaat.h"
+#include <charconv>
+
+uint32_t StringInterner::Intern(std::string_view str)
+{
+	if (const auto it = _ids.find(str); it != _ids.end())
+	{
+		return it->second;
+	}
+
+	const auto copy = _arena.Copy(str);
+	const uint32_t id = static_cast<uint32_t>(_strings.size());
+	_strings.push_back(copy);
+	_ids.emplace(copy, id);
+	return id;
+}
+
+uint32_t StringInterner::Find(std::string_view str) const
+{
+	const auto it = _ids.find(str);
+	return it != _ids.end() ? it->second : UINT32_MAX;
+}
+
+// Like DumpBinaryWriter::SetName, names without a known string are written as the hash in hex.
+static bool ParseHashName(std::string_view name, uint32_t& hash)
+{
+	return name.size() == 10 && name.starts_with("0x") &&
+		std::from_chars(name.data() + 2, name.data() + name.size(), hash, 16).ptr == name.data() + name.size();
+}
+
+uint32_t DumpColumns::NameHash(std::string_view name)
+{
+	uint32_t hash = 0;
+	return ParseHashName(name, hash) ? hash : joaat(name);
+}
+
+DumpColumns::NameIds DumpColumns::Name(std::string_view name)
+{
+	uint32_t hash = 0;
+	if (ParseHashName(name, hash))
+	{
+		return { hash, 0 };
+	}
+	return { joaat(name), strings.Intern(name) };
+}
+
+DumpColumns::NameIds DumpColumns::Name(const DumpBinaryView& dump, const DumpName& name)
+{
+	return { name.hash, name.IsHashOnly() ? 0 : strings.Intern(dump.String(name.string)) };
+}
+
+uint32_t DumpColumns::AddMemberRow(MemberColumns& columns, uint32_t owner, const MemberRow& row)
+{
+	columns.nameHash.push_back(row.name.hash);
+	columns.name.push_back(row.name.string);
+	columns.offset.push_back(row.offset);
+	columns.size.push_back(row.size);
+	columns.align.push_back(row.align);
+	columns.type.push_back(row.type);
+	columns.subtype.push_back(row.subtype);
+	columns.flags1.push_back(row.flags1);
+	columns.flags2.push_back(row.flags2);
+	columns.refNameHash.push_back(row.refNameHash);
+	columns.owner.push_back(owner);
+	columns.item.push_back(-1);
+	columns.value.push_back(-1);
+	// the attributes are added right after the row
+	columns.attributeBegin.push_back(static_cast<uint32_t>(attributes.Size()));
+	columns.attributeEnd.push_back(static_cast<uint32_t>(attributes.Size()));
+	return static_cast<uint32_t>(columns.Size() - 1);
+}
+
+// Both AddBuild overloads intern the strings in the same order, so they give the same string ids.
+
+uint32_t DumpColumns::AddMember(MemberColumns& columns, uint32_t owner, const DumpModel& model, const DumpModelMember& m)
+{
+	MemberRow row{};
+	row.name = Name(m.name);
+	row.offset = m.offset;
+	row.size = static_cast<uint32_t>(m.size);
+	row.align = m.align;
+	row.type = strings.Intern(m.type);
+	row.subtype = strings.Intern(m.subtype);
+	row.flags1 = static_cast<uint16_t>(m.flags1);
+	row.flags2 = static_cast<uint16_t>(m.flags2);
+	row.refNameHash = Name(!m.structName.empty() ? m.structName : m.enumName).hash;
+	const uint32_t index = AddMemberRow(columns, owner, row);
+	for (uint32_t i = m.firstAttribute; i < m.firstAttribute + m.attributeCount; i++)
+	{
+		attributes.name.push_back(strings.Intern(model.attributes[i].name));
+		attributes.type.push_back(strings.Intern(model.attributes[i].type));
+	}
+	columns.attributeEnd[index] = static_cast<uint32_t>(attributes.Size());
+
+	// columns may be subMembers, so they are indexed again after adding the children
+	if (m.item != -1)
+	{
+		const int32_t item = static_cast<int32_t>(AddMember(subMembers, owner, model, model.subMembers[m.item]));
+		columns.item[index] = item;
+	}
+	if (m.value != -1)
+	{
+		const int32_t value = static_cast<int32_t>(AddMember(subMembers, owner, model, model.subMembers[m.value]));
+		columns.value[index] = value;
+	}
+	return index;
+}
+
+uint32_t DumpColumns::AddMember(MemberColumns& columns, uint32_t owner, const DumpBinaryView& dump, const DumpMemberRecord& m)
+{
+	MemberRow row{};
+	row.name = Name(dump, m.name);
+	row.offset = m.offset;
+	row.size = m.size;
+	row.align = m.presence & DumpMemberKey_Align ? m.align : 0;
+	row.type = strings.Intern(dump.String(m.type));
+	row.subtype = strings.Intern(dump.String(m.subtype));
+	row.flags1 = m.flags1;
+	row.flags2 = m.flags2;
+	row.refNameHash = Name(dump, m.refName).hash;
+	const uint32_t index = AddMemberRow(columns, owner, row);
+	if (m.presence & DumpMemberKey_Attributes)
+	{
+		for (auto& a : dump.Attributes(dump.AttributeLists()[m.attributes]))
+		{
+			attributes.name.push_back(strings.Intern(dump.String(a.name)));
+			attributes.type.push_back(strings.Intern(dump.String(a.type)));
+		}
+	}
+	columns.attributeEnd[index] = static_cast<uint32_t>(attributes.Size());
+
+	const auto subMemberRecords = dump.SubMembers();
+	if (m.children[DumpMemberRecord::Item] != DumpNoIndex)
+	{
+		const int32_t item = static_cast<int32_t>(AddMember(subMembers, owner, dump, subMemberRecords[m.children[DumpMemberRecord::Item]]));
+		columns.item[index] = item;
+	}
+	if (m.children[DumpMemberRecord::Value] != DumpNoIndex)
+	{
+		const int32_t value = static_cast<int32_t>(AddMember(subMembers, owner, dump, subMemberRecords[m.children[DumpMemberRecord::Value]]));
+		columns.value[index] = value;
+	}
+	return index;
+}
+
+void DumpColumns::AddBuild(const DumpModel& model)
+{
+	const uint32_t buildIndex = static_cast<uint32_t>(builds.size());
+	DumpColumnsBuild build{};
+	build.game = strings.Intern(model.game);
+	build.build = strings.Intern(model.build);
+	build.structBegin = static_cast<uint32_t>(structs.Size());
+	for (auto& s : model.structs)
+	{
+		const uint32_t structIndex = static_cast<uint32_t>(structs.Size());
+		const auto name = Name(s.name);
+		structs.nameHash.push_back(name.hash);
+		structs.name.push_back(name.string);
+		structs.baseNameHash.push_back(Name(s.baseName).hash);
+		structs.size.push_back(s.size);
+		structs.align.push_back(s.align);
+		structs.memberBegin.push_back(static_cast<uint32_t>(members.Size()));
+		for (uint32_t i = s.firstMember; i < s.firstMember + s.memberCount; i++)
+		{
+			AddMember(members, structIndex, model, model.members[i]);
+		}
+		structs.memberEnd.push_back(static_cast<uint32_t>(members.Size()));
+		structs.build.push_back(buildIndex);
+	}
+	build.structEnd = static_cast<uint32_t>(structs.Size());
+
+	build.enumBegin = static_cast<uint32_t>(enums.Size());
+	for (auto& e : model.enums)
+	{
+		const auto name = Name(e.name);
+		enums.nameHash.push_back(name.hash);
+		enums.name.push_back(name.string);
+		enums.valueBegin.push_back(static_cast<uint32_t>(enumValues.Size()));
+		for (uint32_t i = e.firstValue; i < e.firstValue + e.valueCount; i++)
+		{
+			const auto valueName = Name(model.enumValues[i].name);
+			enumValues.nameHash.push_back(valueName.hash);
+			enumValues.name.push_back(valueName.string);
+			enumValues.value.push_back(model.enumValues[i].value);
+		}
+		enums.valueEnd.push_back(static_cast<uint32_t>(enumValues.Size()));
+		enums.build.push_back(buildIndex);
+	}
+	build.enumEnd = static_cast<uint32_t>(enums.Size());
+	builds.push_back(build);
+}
+
+void DumpColumns::AddBuild(const DumpBinaryView& dump)
+{
+	const uint32_t buildIndex = static_cast<uint32_t>(builds.size());
+	DumpColumnsBuild build{};
+	build.game = strings.Intern(dump.Game());
+	build.build = strings.Intern(dump.Build());
+	build.structBegin = static_cast<uint32_t>(structs.Size());
+	for (auto& s : dump.Structs())
+	{
+		const uint32_t structIndex = static_cast<uint32_t>(structs.Size());
+		const auto name = Name(dump, s.name);
+		structs.nameHash.push_back(name.hash);
+		structs.name.push_back(name.string);
+		structs.baseNameHash.push_back(s.presence & DumpStructKey_Base ? Name(dump, s.baseName).hash : 0);
+		structs.size.push_back(s.size);
+		structs.align.push_back(s.presence & DumpStructKey_Align ? s.align : 0);
+		structs.memberBegin.push_back(static_cast<uint32_t>(members.Size()));
+		for (auto& m : dump.Members(s))
+		{
+			AddMember(members, structIndex, dump, m);
+		}
+		structs.memberEnd.push_back(static_cast<uint32_t>(members.Size()));
+		structs.build.push_back(buildIndex);
+	}
+	build.structEnd = static_cast<uint32_t>(structs.Size());
+
+	build.enumBegin = static_cast<uint32_t>(enums.Size());
+	for (auto& e : dump.Enums())
+	{
+		const auto name = Name(dump, e.name);
+		enums.nameHash.push_back(name.hash);
+		enums.name.push_back(name.string);
+		enums.valueBegin.push_back(static_cast<uint32_t>(enumValues.Size()));
+		for (auto& v : dump.Values(e))
+		{
+			const auto valueName = Name(dump, v.name);
+			enumValues.nameHash.push_back(valueName.hash);
+			enumValues.name.push_back(valueName.string);
+			enumValues.value.push_back(v.value);
+		}
+		enums.valueEnd.push_back(static_cast<uint32_t>(enumValues.Size()));
+		enums.build.push_back(buildIndex);
+	}
+	build.enumEnd = static_cast<uint32_t>(enums.Size());
+	builds.push_back(build);
+}
+
+template<class T>
+static size_t Bytes(const std::vector<T>& column)
+{
+	return column.size() * sizeof(T);
+}
+
+size_t DumpColumns::MemoryUsage() const
+{
+	size_t bytes = Bytes(builds);
+	for (auto* m : { &members, &subMembers })
+	{
+		bytes += Bytes(m->nameHash) + Bytes(m->name) + Bytes(m->offset) + Bytes(m->size) + Bytes(m->align) + Bytes(m->type) +
+			Bytes(m->subtype) + Bytes(m->flags1) + Bytes(m->flags2) + Bytes(m->refNameHash) + Bytes(m->owner) + Bytes(m->item) +
+			Bytes(m->value) + Bytes(m->attributeBegin) + Bytes(m->attributeEnd);
+	}
+	bytes += Bytes(structs.nameHash) + Bytes(structs.name) + Bytes(structs.baseNameHash) + Bytes(structs.size) +
+		Bytes(structs.align) + Bytes(structs.memberBegin) + Bytes(structs.memberEnd) + Bytes(structs.build);
+	bytes += Bytes(attributes.name) + Bytes(attributes.type);
+	bytes += Bytes(enums.nameHash) + Bytes(enums.name) + Bytes(enums.valueBegin) + Bytes(enums.valueEnd) + Bytes(enums.build);
+	bytes += Bytes(enumValues.nameHash) + Bytes(enumValues.name) + Bytes(enumValues.value);
+	for (uint32_t i = 0; i < strings.Size(); i++)
+	{
+		bytes += strings.Get(i).size() + 1;
+	}
+	return bytes;
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include "DumpBinary.h"
+#include "DumpReader.h"
+#include "ScratchArena.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Gives each distinct string an id, its index. Id 0 is the empty string.
+class StringInterner
+{
+public:
+	StringInterner() { Intern({}); }
+
+	StringInterner(const StringInterner&) = delete;
+	StringInterner& operator=(const StringInterner&) = delete;
+
+	uint32_t Intern(std::string_view str);
+	// UINT32_MAX if the string was never interned.
+	uint32_t Find(std::string_view str) const;
+	std::string_view Get(uint32_t id) const { return _strings[id]; }
+	size_t Size() const { return _strings.size(); }
+
+	bool operator==(const StringInterner& other) const { return _strings == other._strings; }
+
+private:
+	ScratchArena _arena;
+	std::vector<std::string_view> _strings;
+	std::unordered_map<std::string_view, uint32_t> _ids;
+};
+
+// The fields of a DumpColumns table are parallel arrays, one element per row, so scanning a field only reads that field.
+// Names are kept as their hash (the JOAAT of the string, or the hash itself for names without a known string) plus the
+// string id, 0 if there is no string.
+
+struct MemberColumns
+{
+	std::vector<uint32_t> nameHash;
+	std::vector<uint32_t> name;
+	std::vector<uint64_t> offset;
+	std::vector<uint32_t> size;
+	std::vector<uint32_t> align;
+	std::vector<uint32_t> type;        // string id
+	std::vector<uint32_t> subtype;     // string id
+	std::vector<uint16_t> flags1;
+	std::vector<uint16_t> flags2;
+	std::vector<uint32_t> refNameHash; // structName or enumName, 0 if none
+	std::vector<uint32_t> owner;       // index of the struct in DumpColumns::structs
+	std::vector<int32_t> item;         // ARRAY: index of the item in DumpColumns::subMembers, MAP: index of the key, -1 if none
+	std::vector<int32_t> value;        // MAP: index of the value
+	std::vector<uint32_t> attributeBegin; // the attributes of the member are [attributeBegin, attributeEnd) in DumpColumns::attributes
+	std::vector<uint32_t> attributeEnd;
+
+	size_t Size() const { return nameHash.size(); }
+	bool operator==(const MemberColumns&) const = default;
+};
+
+struct AttributeColumns
+{
+	std::vector<uint32_t> name; // string id
+	std::vector<uint32_t> type; // string id
+
+	size_t Size() const { return name.size(); }
+	bool operator==(const AttributeColumns&) const = default;
+};
+
+struct StructColumns
+{
+	std::vector<uint32_t> nameHash;
+	std::vector<uint32_t> name;
+	std::vector<uint32_t> baseNameHash; // 0 if none
+	std::vector<uint64_t> size;
+	std::vector<uint32_t> align;
+	std::vector<uint32_t> memberBegin;  // the members of the struct are [memberBegin, memberEnd) in DumpColumns::members
+	std::vector<uint32_t> memberEnd;
+	std::vector<uint32_t> build;        // index in DumpColumns::builds
+
+	size_t Size() const { return nameHash.size(); }
+	bool operator==(const StructColumns&) const = default;
+};
+
+struct EnumColumns
+{
+	std::vector<uint32_t> nameHash;
+	std::vector<uint32_t> name;
+	std::vector<uint32_t> valueBegin;   // in DumpColumns::enumValues
+	std::vector<uint32_t> valueEnd;
+	std::vector<uint32_t> build;
+
+	size_t Size() const { return nameHash.size(); }
+	bool operator==(const EnumColumns&) const = default;
+};
+
+struct EnumValueColumns
+{
+	std::vector<uint32_t> nameHash;
+	std::vector<uint32_t> name;
+	std::vector<int64_t> value;
+
+	size_t Size() const { return nameHash.size(); }
+	bool operator==(const EnumValueColumns&) const = default;
+};
+
+struct DumpColumnsBuild
+{
+	uint32_t game;        // string id
+	uint32_t build;       // string id
+	uint32_t structBegin; // in DumpColumns::structs
+	uint32_t structEnd;
+	uint32_t enumBegin;   // in DumpColumns::enums
+	uint32_t enumEnd;
+
+	bool operator==(const DumpColumnsBuild&) const = default;
+};
+
+// Columnar model of any number of dumps, for queries over every member of every build. Filled from the JSON dumps through
+// DumpReader or from the binary dumps, both give the same columns. Array items and map keys/values are rows of subMembers,
+// in the order they are found, so the members of each struct stay contiguous.
+class DumpColumns
+{
+public:
+	void AddBuild(const DumpModel& model);
+	void AddBuild(const DumpBinaryView& dump);
+
+	// Hash of a name as written in the JSON dumps, like DumpBinaryWriter::SetName: names without a known string are the hash
+	// in hex, the others are hashed with JOAAT.
+	static uint32_t NameHash(std::string_view name);
+
+	// Bytes used by the columns and strings, without the containers' spare capacity.
+	size_t MemoryUsage() const;
+
+	StringInterner strings;
+	std::vector<DumpColumnsBuild> builds;
+	StructColumns structs;
+	MemberColumns members;
+	MemberColumns subMembers;
+	AttributeColumns attributes;
+	EnumColumns enums;
+	EnumValueColumns enumValues;
+
+private:
+	struct NameIds
+	{
+		uint32_t hash;
+		uint32_t string;
+	};
+
+	struct MemberRow
+	{
+		NameIds name;
+		uint64_t offset;
+		uint32_t size;
+		uint32_t align;
+		uint32_t type;
+		uint32_t subtype;
+		uint16_t flags1;
+		uint16_t flags2;
+		uint32_t refNameHash;
+	};
+
+	NameIds Name(std::string_view name);
+	NameIds Name(const DumpBinaryView& dump, const DumpName& name);
+	uint32_t AddMemberRow(MemberColumns& columns, uint32_t owner, const MemberRow& row);
+	uint32_t AddMember(MemberColumns& columns, uint32_t owner, const DumpModel& model, const DumpModelMember& m);
+	uint32_t AddMember(MemberColumns& columns, uint32_t owner, const DumpBinaryView& dump, const DumpMemberRecord& m);
+};
@@ -0,0 +1,638 @@
+#include "DumpQuery.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+	enum class FieldKind
+	{
+		Number,
+		Flags,
+		String, // string id
+		Name,   // name hash
+	};
+
+	struct FieldInfo
+	{
+		std::string_view name;
+		QueryField field;
+		FieldKind kind;
+		bool structs;
+		bool members;
+	};
+
+	constexpr FieldInfo field_infos[]
+	{
+		{ "name", QueryField::Name, FieldKind::Name, true, true },
+		{ "base", QueryField::Base, FieldKind::Name, true, false },
+		{ "size", QueryField::Size, FieldKind::Number, true, true },
+		{ "align", QueryField::Align, FieldKind::Number, true, true },
+		{ "members", QueryField::MemberCount, FieldKind::Number, true, false },
+		{ "struct", QueryField::Struct, FieldKind::Name, false, true },
+		{ "offset", QueryField::Offset, FieldKind::Number, false, true },
+		{ "type", QueryField::Type, FieldKind::String, false, true },
+		{ "subtype", QueryField::Subtype, FieldKind::String, false, true },
+		{ "flags1", QueryField::Flags1, FieldKind::Flags, false, true },
+		{ "flags2", QueryField::Flags2, FieldKind::Flags, false, true },
+		{ "structName", QueryField::StructName, FieldKind::Name, false, true },
+		{ "enumName", QueryField::EnumName, FieldKind::Name, false, true },
+		{ "attribute", QueryField::Attribute, FieldKind::String, false, true },
+	};
+
+	constexpr QueryField struct_fields[]
+	{
+		QueryField::Name, QueryField::Base, QueryField::Size, QueryField::Align, QueryField::MemberCount,
+	};
+
+	constexpr QueryField member_fields[]
+	{
+		QueryField::Struct, QueryField::Name, QueryField::Offset, QueryField::Size, QueryField::Align, QueryField::Type,
+		QueryField::Subtype, QueryField::Flags1, QueryField::Flags2, QueryField::StructName, QueryField::EnumName,
+	};
+
+	const FieldInfo& Info(QueryField field)
+	{
+		for (auto& info : field_infos)
+		{
+			if (info.field == field)
+			{
+				return info;
+			}
+		}
+		throw std::logic_error{ "Unknown query field" };
+	}
+
+	struct Token
+	{
+		enum class Kind { End, Word, Number, String, Symbol } kind;
+		std::string_view text;
+		size_t column;
+	};
+
+	bool IsWordStart(char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+	}
+
+	bool IsWordChar(char c)
+	{
+		return IsWordStart(c) || (c >= '0' && c <= '9') || c == ':';
+	}
+}
+
+class DumpQuery::Parser
+{
+public:
+	Parser(DumpQuery& query, std::string_view expression)
+		: _query{ query }, _expression{ expression }
+	{
+		Next();
+	}
+
+	uint32_t Parse()
+	{
+		if (_token.kind == Token::Kind::End)
+		{
+			return Add({ Node::Kind::All });
+		}
+
+		const uint32_t root = Or();
+		if (_token.kind != Token::Kind::End)
+		{
+			Error("expected '&&', '||' or the end of the filter");
+		}
+		return root;
+	}
+
+private:
+	void Next()
+	{
+		while (_pos < _expression.size() && (_expression[_pos] == ' ' || _expression[_pos] == '\t'))
+		{
+			_pos++;
+		}
+
+		const size_t start = _pos;
+		if (_pos == _expression.size())
+		{
+			_token = { Token::Kind::End, {}, start };
+			return;
+		}
+
+		const char c = _expression[_pos];
+		if (IsWordStart(c))
+		{
+			while (_pos < _expression.size() && IsWordChar(_expression[_pos]))
+			{
+				_pos++;
+			}
+			_token = { Token::Kind::Word, _expression.substr(start, _pos - start), start };
+		}
+		else if (c >= '0' && c <= '9')
+		{
+			while (_pos < _expression.size() && IsWordChar(_expression[_pos]))
+			{
+				_pos++;
+			}
+			_token = { Token::Kind::Number, _expression.substr(start, _pos - start), start };
+		}
+		else if (c == '\'' || c == '"')
+		{
+			const size_t end = _expression.find(c, start + 1);
+			if (end == std::string_view::npos)
+			{
+				Error("unterminated string");
+			}
+			_pos = end + 1;
+			_token = { Token::Kind::String, _expression.substr(start + 1, end - start - 1), start };
+		}
+		else
+		{
+			static constexpr std::string_view symbols[]{ "==", "!=", "<=", ">=", "&&", "||", "<", ">", "&", "!", "(", ")" };
+			for (auto symbol : symbols)
+			{
+				if (_expression.substr(start).starts_with(symbol))
+				{
+					_pos += symbol.size();
+					_token = { Token::Kind::Symbol, symbol, start };
+					return;
+				}
+			}
+			Error("unexpected character");
+		}
+	}
+
+	bool TryConsume(std::string_view symbol)
+	{
+		if (_token.kind == Token::Kind::Symbol && _token.text == symbol)
+		{
+			Next();
+			return true;
+		}
+		return false;
+	}
+
+	uint32_t Add(const Node& node)
+	{
+		_query._nodes.push_back(node);
+		return static_cast<uint32_t>(_query._nodes.size() - 1);
+	}
+
+	uint32_t Binary(Node::Kind kind, uint32_t left, uint32_t right)
+	{
+		Node node{ kind };
+		node.left = left;
+		node.right = right;
+		return Add(node);
+	}
+
+	uint32_t Or()
+	{
+		uint32_t left = And();
+		while (TryConsume("||"))
+		{
+			left = Binary(Node::Kind::Or, left, And());
+		}
+		return left;
+	}
+
+	uint32_t And()
+	{
+		uint32_t left = Unary();
+		while (TryConsume("&&"))
+		{
+			left = Binary(Node::Kind::And, left, Unary());
+		}
+		return left;
+	}
+
+	uint32_t Unary()
+	{
+		if (TryConsume("!"))
+		{
+			Node node{ Node::Kind::Not };
+			node.left = Unary();
+			return Add(node);
+		}
+		if (TryConsume("("))
+		{
+			const uint32_t node = Or();
+			if (!TryConsume(")"))
+			{
+				Error("expected ')'");
+			}
+			return node;
+		}
+		return Comparison();
+	}
+
+	uint32_t Comparison()
+	{
+		if (_token.kind != Token::Kind::Word)
+		{
+			Error("expected a field");
+		}
+		const auto field = FindField(_query._target, _token.text);
+		if (!field)
+		{
+			Error("unknown field '" + std::string{ _token.text } + "'");
+		}
+		const auto& info = Info(*field);
+		Next();
+
+		static constexpr std::pair<std::string_view, Op> ops[]
+		{
+			{ "==", Op::Equal }, { "!=", Op::NotEqual }, { "<", Op::Less }, { "<=", Op::LessEqual },
+			{ ">", Op::Greater }, { ">=", Op::GreaterEqual }, { "&", Op::AnyBits },
+		};
+		const auto op = std::find_if(std::begin(ops), std::end(ops),
+			[&](auto& o) { return _token.kind == Token::Kind::Symbol && _token.text == o.first; });
+		if (op == std::end(ops))
+		{
+			Error("expected a comparison");
+		}
+		const bool equality = op->second == Op::Equal || op->second == Op::NotEqual;
+		if ((info.kind == FieldKind::String || info.kind == FieldKind::Name) && !equality)
+		{
+			Error("'" + std::string{ info.name } + "' can only be compared with == or !=");
+		}
+		if (op->second == Op::AnyBits && info.kind != FieldKind::Flags)
+		{
+			Error("'&' is only valid with flags1 and flags2");
+		}
+		Next();
+
+		if (_token.kind == Token::Kind::End || _token.kind == Token::Kind::Symbol)
+		{
+			Error("expected a value");
+		}
+		Node node{ Node::Kind::Compare };
+		node.field = *field;
+		node.op = op->second;
+		node.value = Value(info);
+		Next();
+
+		if (*field == QueryField::Attribute)
+		{
+			node.kind = Node::Kind::HasAttribute;
+			if (node.op == Op::NotEqual)
+			{
+				Node negated{ Node::Kind::Not };
+				negated.left = Add(node);
+				return Add(negated);
+			}
+		}
+		return Add(node);
+	}
+
+	uint64_t Value(const FieldInfo& info)
+	{
+		const auto text = _token.text;
+		switch (info.kind)
+		{
+		case FieldKind::Name:
+			// a number is the hash itself, so `enumName != 0` is any member with an enum
+			return _token.kind == Token::Kind::Number ? Number(text, UINT32_MAX) : DumpColumns::NameHash(text);
+		case FieldKind::Number:
+		case FieldKind::Flags:
+			if (_token.kind != Token::Kind::Number)
+			{
+				Error("expected a number");
+			}
+			return Number(text, info.kind == FieldKind::Flags ? UINT16_MAX : UINT64_MAX);
+		case FieldKind::String:
+		{
+			// a string that is in no dump can't match any row
+			const uint32_t id = _query._columns.strings.Find(text);
+			return id == UINT32_MAX ? UINT64_MAX : id;
+		}
+		}
+		return 0;
+	}
+
+	// `max` is the largest value of the field, the flags are 16-bit and the hashes 32-bit
+	uint64_t Number(std::string_view text, uint64_t max) const
+	{
+		const bool hex = text.starts_with("0x") || text.starts_with("0X");
+		const auto digits = hex ? text.substr(2) : text;
+		uint64_t value = 0;
+		const auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value, hex ? 16 : 10);
+		if (digits.empty() || end != digits.data() + digits.size() || ec == std::errc::invalid_argument)
+		{
+			Error("expected a number");
+		}
+		if (ec == std::errc::result_out_of_range || value > max)
+		{
+			Error("number out of range");
+		}
+		return value;
+	}
+
+	[[noreturn]] void Error(const std::string& message) const
+	{
+		throw std::runtime_error{ "Invalid filter at column " + std::to_string(_token.column + 1) + ": " + message };
+	}
+
+	DumpQuery& _query;
+	std::string_view _expression;
+	size_t _pos = 0;
+	Token _token{};
+};
+
+DumpQuery::DumpQuery(const DumpColumns& columns, QueryTarget target, std::string_view expression)
+	: _columns{ columns }, _target{ target }
+{
+	const uint32_t enumType = columns.strings.Find("ENUM");
+	const uint32_t bitsetType = columns.strings.Find("BITSET");
+	_enumType = enumType == UINT32_MAX ? UINT64_MAX : enumType;
+	_bitsetType = bitsetType == UINT32_MAX ? UINT64_MAX : bitsetType;
+
+	_root = Parser{ *this, expression }.Parse();
+
+	// each And/Or keeps the mask of its left side while evaluating the right side
+	const auto depth = [this](auto& self, uint32_t index) -> size_t
+	{
+		const auto& node = _nodes[index];
+		switch (node.kind)
+		{
+		case Node::Kind::And:
+		case Node::Kind::Or:
+			return 1 + std::max(self(self, node.left), self(self, node.right));
+		case Node::Kind::Not:
+			return self(self, node.left);
+		default:
+			return 1;
+		}
+	};
+	_depth = depth(depth, _root);
+
+	const auto addNames = [this](const std::vector<uint32_t>& hashes, const std::vector<uint32_t>& names)
+	{
+		for (size_t i = 0; i < hashes.size(); i++)
+		{
+			if (names[i] != 0)
+			{
+				_namesByHash.emplace(hashes[i], names[i]);
+			}
+		}
+	};
+	addNames(columns.structs.nameHash, columns.structs.name);
+	addNames(columns.enums.nameHash, columns.enums.name);
+	if (target == QueryTarget::Members)
+	{
+		addNames(columns.members.nameHash, columns.members.name);
+	}
+}
+
+std::span<const QueryField> DumpQuery::Fields() const
+{
+	if (_target == QueryTarget::Structs)
+	{
+		return struct_fields;
+	}
+	return member_fields;
+}
+
+std::optional<QueryField> DumpQuery::FindField(QueryTarget target, std::string_view name)
+{
+	for (auto& info : field_infos)
+	{
+		if (info.name == name && (target == QueryTarget::Structs ? info.structs : info.members))
+		{
+			return info.field;
+		}
+	}
+	return std::nullopt;
+}
+
+std::string_view DumpQuery::FieldName(QueryField field)
+{
+	return Info(field).name;
+}
+
+bool DumpQuery::IsNumber(QueryField field)
+{
+	return Info(field).kind == FieldKind::Number;
+}
+
+std::pair<uint32_t, uint32_t> DumpQuery::Rows(uint32_t build) const
+{
+	const auto& b = _columns.builds[build];
+	if (_target == QueryTarget::Structs)
+	{
+		return { b.structBegin, b.structEnd };
+	}
+	if (b.structBegin == b.structEnd)
+	{
+		return { 0, 0 };
+	}
+	// the members of the structs of a build are contiguous
+	return { _columns.structs.memberBegin[b.structBegin], _columns.structs.memberEnd[b.structEnd - 1] };
+}
+
+template<class T, class TFunc>
+static void Gather(const std::vector<T>& column, uint32_t first, size_t count, uint64_t* values, TFunc f)
+{
+	const T* src = column.data() + first;
+	for (size_t i = 0; i < count; i++)
+	{
+		values[i] = f(src[i]);
+	}
+}
+
+template<class T>
+static void Gather(const std::vector<T>& column, uint32_t first, size_t count, uint64_t* values)
+{
+	Gather(column, first, count, values, [](T v) { return static_cast<uint64_t>(v); });
+}
+
+void DumpQuery::Load(QueryField field, uint32_t first, size_t count, uint64_t* values) const
+{
+	const auto& s = _columns.structs;
+	const auto& m = _columns.members;
+	if (_target == QueryTarget::Structs)
+	{
+		switch (field)
+		{
+		case QueryField::Name: Gather(s.nameHash, first, count, values); return;
+		case QueryField::Base: Gather(s.baseNameHash, first, count, values); return;
+		case QueryField::Size: Gather(s.size, first, count, values); return;
+		case QueryField::Align: Gather(s.align, first, count, values); return;
+		case QueryField::MemberCount:
+			for (size_t i = 0; i < count; i++)
+			{
+				values[i] = s.memberEnd[first + i] - s.memberBegin[first + i];
+			}
+			return;
+		default: break;
+		}
+	}
+	else
+	{
+		switch (field)
+		{
+		case QueryField::Name: Gather(m.nameHash, first, count, values); return;
+		case QueryField::Struct: Gather(m.owner, first, count, values, [&](uint32_t owner) { return uint64_t{ s.nameHash[owner] }; }); return;
+		case QueryField::Offset: Gather(m.offset, first, count, values); return;
+		case QueryField::Size: Gather(m.size, first, count, values); return;
+		case QueryField::Align: Gather(m.align, first, count, values); return;
+		case QueryField::Type: Gather(m.type, first, count, values); return;
+		case QueryField::Subtype: Gather(m.subtype, first, count, values); return;
+		case QueryField::Flags1: Gather(m.flags1, first, count, values); return;
+		case QueryField::Flags2: Gather(m.flags2, first, count, values); return;
+		case QueryField::StructName:
+		case QueryField::EnumName:
+		{
+			// both names share the refNameHash column, the type tells which one it is
+			const bool wantEnum = field == QueryField::EnumName;
+			const uint32_t* type = m.type.data() + first;
+			const uint32_t* ref = m.refNameHash.data() + first;
+			for (size_t i = 0; i < count; i++)
+			{
+				const bool isEnum = type[i] == _enumType || type[i] == _bitsetType;
+				values[i] = isEnum == wantEnum ? ref[i] : 0;
+			}
+			return;
+		}
+		default: break;
+		}
+	}
+	throw std::logic_error{ "Query field not valid for the target" };
+}
+
+template<class TFunc>
+static void CompareBatch(const uint64_t* values, size_t count, uint8_t* out, TFunc f)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = f(values[i]) ? 1 : 0;
+	}
+}
+
+void DumpQuery::EvaluateNode(uint32_t index, uint32_t first, size_t count, uint8_t* out, Scratch& scratch, size_t depth) const
+{
+	const auto& node = _nodes[index];
+	switch (node.kind)
+	{
+	case Node::Kind::All:
+		std::memset(out, 1, count);
+		break;
+	case Node::Kind::And:
+	case Node::Kind::Or:
+	{
+		EvaluateNode(node.left, first, count, out, scratch, depth);
+		uint8_t* right = scratch.masks[depth].data();
+		EvaluateNode(node.right, first, count, right, scratch, depth + 1);
+		if (node.kind == Node::Kind::And)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				out[i] &= right[i];
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				out[i] |= right[i];
+			}
+		}
+		break;
+	}
+	case Node::Kind::Not:
+		EvaluateNode(node.left, first, count, out, scratch, depth);
+		for (size_t i = 0; i < count; i++)
+		{
+			out[i] ^= 1;
+		}
+		break;
+	case Node::Kind::Compare:
+	{
+		uint64_t* values = scratch.values.data();
+		Load(node.field, first, count, values);
+		const uint64_t v = node.value;
+		switch (node.op)
+		{
+		case Op::Equal: CompareBatch(values, count, out, [v](uint64_t x) { return x == v; }); break;
+		case Op::NotEqual: CompareBatch(values, count, out, [v](uint64_t x) { return x != v; }); break;
+		case Op::Less: CompareBatch(values, count, out, [v](uint64_t x) { return x < v; }); break;
+		case Op::LessEqual: CompareBatch(values, count, out, [v](uint64_t x) { return x <= v; }); break;
+		case Op::Greater: CompareBatch(values, count, out, [v](uint64_t x) { return x > v; }); break;
+		case Op::GreaterEqual: CompareBatch(values, count, out, [v](uint64_t x) { return x >= v; }); break;
+		case Op::AnyBits: CompareBatch(values, count, out, [v](uint64_t x) { return (x & v) != 0; }); break;
+		}
+		break;
+	}
+	case Node::Kind::HasAttribute:
+	{
+		const auto& m = _columns.members;
+		const auto& names = _columns.attributes.name;
+		for (size_t i = 0; i < count; i++)
+		{
+			const auto begin = names.begin() + m.attributeBegin[first + i];
+			const auto end = names.begin() + m.attributeEnd[first + i];
+			out[i] = std::find(begin, end, node.value) != end ? 1 : 0;
+		}
+		break;
+	}
+	}
+}
+
+void DumpQuery::Evaluate(uint32_t build, std::vector<uint32_t>& rows) const
+{
+	Scratch scratch;
+	scratch.values.resize(batch_size);
+	scratch.masks.resize(_depth, std::vector<uint8_t>(batch_size));
+	std::vector<uint8_t> mask(batch_size);
+
+	const auto [begin, end] = Rows(build);
+	for (uint32_t first = begin; first < end; first += batch_size)
+	{
+		const size_t count = std::min<size_t>(batch_size, end - first);
+		EvaluateNode(_root, first, count, mask.data(), scratch, 0);
+		for (size_t i = 0; i < count; i++)
+		{
+			if (mask[i])
+			{
+				rows.push_back(first + static_cast<uint32_t>(i));
+			}
+		}
+	}
+}
+
+uint64_t DumpQuery::Value(QueryField field, uint32_t row) const
+{
+	uint64_t value = 0;
+	Load(field, row, 1, &value);
+	return value;
+}
+
+std::string DumpQuery::FormatValue(QueryField field, uint64_t value) const
+{
+	char buffer[32];
+	switch (Info(field).kind)
+	{
+	case FieldKind::Number:
+		return std::to_string(value);
+	case FieldKind::Flags:
+		std::snprintf(buffer, sizeof(buffer), "0x%04X", static_cast<unsigned>(value));
+		return buffer;
+	case FieldKind::String:
+		return std::string{ _columns.strings.Get(static_cast<uint32_t>(value)) };
+	case FieldKind::Name:
+		if (value == 0 && field != QueryField::Name && field != QueryField::Struct)
+		{
+			return {};
+		}
+		if (const auto it = _namesByHash.find(static_cast<uint32_t>(value)); it != _namesByHash.end())
+		{
+			return std::string{ _columns.strings.Get(it->second) };
+		}
+		std::snprintf(buffer, sizeof(buffer), "0x%08X", static_cast<uint32_t>(value));
+		return buffer;
+	}
+	return {};
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include "DumpColumns.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class QueryTarget
+{
+	Structs,
+	Members,
+};
+
+// Fields of the rows of a query. Every field is read as a number: string ids for types and subtypes, hashes for names.
+enum class QueryField
+{
+	Name,
+	// structs
+	Base,
+	Size,
+	Align,
+	MemberCount,
+	// members
+	Struct, // name of the struct of the member
+	Offset,
+	Type,
+	Subtype,
+	Flags1,
+	Flags2,
+	StructName,
+	EnumName,
+	Attribute, // only in filters, a member has several
+};
+
+// Filter over the structs or the top-level members of a DumpColumns, parsed from an expression like
+//
+//   type == ARRAY && subtype == ATFIXEDARRAY
+//   flags1 & 0x8
+//   struct == CPed && (size > 16 || attribute == initHashValue)
+//
+// Comparisons are ==, !=, <, <=, >, >= and & (any of the bits set), joined with &&, || and !. Types, subtypes and names are
+// only compared for (in)equality; names match by hash, so 0x1234ABCD matches a name whose string is unknown. Values that
+// aren't a plain word or number are quoted with ' or ".
+//
+// Rows are evaluated in batches, field by field: each comparison loads its field for the whole batch and writes a byte mask,
+// which the compiler vectorizes, instead of walking the expression tree per row.
+class DumpQuery
+{
+public:
+	// Throws std::runtime_error if the expression is not valid. An empty expression matches every row.
+	DumpQuery(const DumpColumns& columns, QueryTarget target, std::string_view expression);
+
+	QueryTarget Target() const { return _target; }
+
+	// Appends the rows of the build that match (indices in DumpColumns::structs or members), in order. Can be called from several
+	// threads at once.
+	void Evaluate(uint32_t build, std::vector<uint32_t>& rows) const;
+
+	// The fields of the target, except Attribute, in the order they are printed.
+	std::span<const QueryField> Fields() const;
+	static std::optional<QueryField> FindField(QueryTarget target, std::string_view name);
+	static std::string_view FieldName(QueryField field);
+	// Whether FormatValue gives a plain number rather than text.
+	static bool IsNumber(QueryField field);
+
+	uint64_t Value(QueryField field, uint32_t row) const;
+	// The value as text: type strings, names (or their hash if the string is unknown), flags in hex.
+	std::string FormatValue(QueryField field, uint64_t value) const;
+
+private:
+	enum class Op { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual, AnyBits };
+
+	struct Node
+	{
+		enum class Kind { All, And, Or, Not, Compare, HasAttribute } kind;
+		QueryField field;
+		Op op;
+		uint64_t value;
+		uint32_t left;  // And, Or, Not
+		uint32_t right; // And, Or
+	};
+
+	static constexpr size_t batch_size = 1024;
+
+	struct Scratch
+	{
+		std::vector<uint64_t> values;
+		std::vector<std::vector<uint8_t>> masks; // one per depth of the expression
+	};
+
+	class Parser;
+
+	void EvaluateNode(uint32_t node, uint32_t first, size_t count, uint8_t* out, Scratch& scratch, size_t depth) const;
+	void Load(QueryField field, uint32_t first, size_t count, uint64_t* values) const;
+	std::pair<uint32_t, uint32_t> Rows(uint32_t build) const;
+
+	const DumpColumns& _columns;
+	QueryTarget _target;
+	std::vector<Node> _nodes;
+	uint32_t _root = 0;
+	size_t _depth = 1;
+	uint64_t _enumType;   // string ids of the types with an enumName
+	uint64_t _bitsetType;
+	std::unordered_map<uint32_t, uint32_t> _namesByHash; // string ids of the struct and enum names, to print them
+};
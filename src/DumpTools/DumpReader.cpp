@@ -0,0 +1,597 @@
+#include "DumpReader.h"
+#include "JsonReader.h"
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define DUMP_READER_SSE2 1
+#endif
+
+void DumpModel::Clear()
+{
+	game = {};
+	build = {};
+	structs.clear();
+	members.clear();
+	subMembers.clear();
+	attributes.clear();
+	enums.clear();
+	enumValues.clear();
+	unescaped.Release();
+}
+
+struct BlockMasks
+{
+	uint64_t quotes;
+	uint64_t backslashes;
+	uint64_t structurals; // {}[]:,
+};
+
+// One bit per character of the 64-byte block.
+static BlockMasks ClassifyBlock(const char* block)
+{
+	BlockMasks m{};
+#if DUMP_READER_SSE2
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i lowerBit = _mm_set1_epi8(0x20);
+	const __m128i openBrace = _mm_set1_epi8('{');
+	const __m128i closeBrace = _mm_set1_epi8('}');
+	const __m128i colon = _mm_set1_epi8(':');
+	const __m128i comma = _mm_set1_epi8(',');
+	for (int i = 0; i < 4; i++)
+	{
+		const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+		// '[' and ']' are '{' and '}' without the 0x20 bit, nothing else becomes a brace by setting it
+		const __m128i folded = _mm_or_si128(chunk, lowerBit);
+		const __m128i isStructural = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(folded, openBrace), _mm_cmpeq_epi8(folded, closeBrace)),
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, colon), _mm_cmpeq_epi8(chunk, comma)));
+		const int shift = i * 16;
+		m.quotes |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))) << shift;
+		m.backslashes |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)))) << shift;
+		m.structurals |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(isStructural))) << shift;
+	}
+#else
+	for (int i = 0; i < 64; i++)
+	{
+		const char c = block[i];
+		const uint64_t bit = uint64_t{ 1 } << i;
+		m.quotes |= c == '"' ? bit : 0;
+		m.backslashes |= c == '\\' ? bit : 0;
+		m.structurals |= (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') ? bit : 0;
+	}
+#endif
+	return m;
+}
+
+// Characters escaped by a backslash. Backslashes are rare in the dumps, so this is only called for the blocks that have any.
+static uint64_t EscapedMask(uint64_t backslashes, bool& escapeNext)
+{
+	uint64_t escaped = 0;
+	for (int i = 0; i < 64; i++)
+	{
+		if (escapeNext)
+		{
+			escaped |= uint64_t{ 1 } << i;
+			escapeNext = false;
+		}
+		else if (backslashes & (uint64_t{ 1 } << i))
+		{
+			escapeNext = true;
+		}
+	}
+	return escaped;
+}
+
+// Each bit becomes the XOR of itself and all the bits below it, so from the quotes the characters inside strings are set
+// (the opening quote included, the closing quote not).
+static uint64_t PrefixXor(uint64_t x)
+{
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+}
+
+void DumpReader::IndexStructurals()
+{
+	if (_text.size() > UINT32_MAX)
+	{
+		throw std::runtime_error("the dump is too large");
+	}
+
+	_structurals.clear();
+	// about one structural character every 7 bytes in the dumps
+	_structurals.reserve(_text.size() / 6);
+	uint64_t prevInString = 0; // all ones if the previous block ended inside a string
+	bool escapeNext = false;
+	for (size_t base = 0; base < _text.size(); base += 64)
+	{
+		const char* block = _text.data() + base;
+		char padded[64];
+		if (_text.size() - base < 64)
+		{
+			std::memset(padded, ' ', sizeof(padded));
+			std::memcpy(padded, block, _text.size() - base);
+			block = padded;
+		}
+
+		const BlockMasks m = ClassifyBlock(block);
+		const uint64_t escaped = m.backslashes != 0 || escapeNext ? EscapedMask(m.backslashes, escapeNext) : 0;
+		const uint64_t quotes = m.quotes & ~escaped;
+		const uint64_t inString = PrefixXor(quotes) ^ prevInString;
+		prevInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+		uint64_t structurals = (m.structurals & ~inString) | quotes;
+		while (structurals != 0)
+		{
+			_structurals.push_back(static_cast<uint32_t>(base + std::countr_zero(structurals)));
+			structurals &= structurals - 1;
+		}
+	}
+
+	if (prevInString != 0)
+	{
+		throw std::runtime_error("unterminated string");
+	}
+}
+
+void DumpReader::Read(std::string_view text, DumpModel& model)
+{
+	_text = text;
+	_model = &model;
+	_next = 0;
+	model.Clear();
+	IndexStructurals();
+
+	Object([&](std::string_view key)
+	{
+		if (key == "game")
+		{
+			model.game = String();
+		}
+		else if (key == "build")
+		{
+			model.build = String();
+		}
+		else if (key == "structs")
+		{
+			Array([&] { ReadStruct(); });
+		}
+		else if (key == "enums")
+		{
+			Array([&] { ReadEnum(); });
+		}
+		else
+		{
+			Skip();
+		}
+	});
+
+	if (_next != _structurals.size() ||
+		_text.find_first_not_of(" \t\r\n", _structurals.empty() ? 0 : _structurals.back() + 1) != std::string_view::npos)
+	{
+		Error("trailing characters");
+	}
+}
+
+void DumpReader::ReadStruct()
+{
+	auto& members = _model->members;
+	DumpModelStruct s{};
+	s.firstMember = static_cast<uint32_t>(members.size());
+	Object([&](std::string_view key)
+	{
+		if (key == "name")
+		{
+			s.name = String();
+		}
+		else if (key == "base")
+		{
+			Object([&](std::string_view baseKey)
+			{
+				if (baseKey == "name")
+				{
+					s.baseName = String();
+				}
+				else if (baseKey == "offset")
+				{
+					s.baseOffset = UInt();
+				}
+				else
+				{
+					Skip();
+				}
+			});
+		}
+		else if (key == "size")
+		{
+			s.size = UInt();
+		}
+		else if (key == "align")
+		{
+			s.align = static_cast<uint32_t>(UInt());
+		}
+		else if (key == "flags")
+		{
+			s.flags = String();
+		}
+		else if (key == "version")
+		{
+			s.version = String();
+		}
+		else if (key == "members")
+		{
+			Array([&] { ReadMember(members); });
+		}
+		else
+		{
+			Skip();
+		}
+	});
+	s.memberCount = static_cast<uint32_t>(members.size()) - s.firstMember;
+	_model->structs.push_back(s);
+}
+
+int32_t DumpReader::ReadMember(std::vector<DumpModelMember>& members)
+{
+	const size_t index = members.size();
+	members.emplace_back();
+	Object([&](std::string_view key)
+	{
+		// the item, key and value are added to subMembers, which may be `members`, so no reference is kept across them
+		if (key == "item" || key == "key")
+		{
+			const int32_t item = ReadMember(_model->subMembers);
+			members[index].item = item;
+			return;
+		}
+		else if (key == "value" && Peek() == '{')
+		{
+			const int32_t value = ReadMember(_model->subMembers);
+			members[index].value = value;
+			return;
+		}
+
+		auto& m = members[index];
+		if (key == "name")
+		{
+			m.name = String();
+		}
+		else if (key == "type")
+		{
+			m.type = String();
+		}
+		else if (key == "subtype")
+		{
+			m.subtype = String();
+		}
+		else if (key == "structName")
+		{
+			m.structName = StringOrNull();
+		}
+		else if (key == "enumName")
+		{
+			m.enumName = String();
+		}
+		else if (key == "offset")
+		{
+			m.offset = UInt();
+		}
+		else if (key == "size")
+		{
+			m.size = UInt();
+		}
+		else if (key == "align")
+		{
+			m.align = static_cast<uint32_t>(UInt());
+		}
+		else if (key == "flags1")
+		{
+			m.flags1 = HexString();
+		}
+		else if (key == "flags2")
+		{
+			m.flags2 = HexString();
+		}
+		else if (key == "attributes")
+		{
+			m.firstAttribute = static_cast<uint32_t>(_model->attributes.size());
+			ReadAttributes();
+			m.attributeCount = static_cast<uint32_t>(_model->attributes.size()) - m.firstAttribute;
+		}
+		else
+		{
+			Skip();
+		}
+	});
+	return static_cast<int32_t>(index);
+}
+
+void DumpReader::ReadAttributes()
+{
+	Object([&](std::string_view key)
+	{
+		if (key != "list")
+		{
+			Skip();
+			return;
+		}
+
+		Array([&]
+		{
+			DumpModelAttribute a{};
+			Object([&](std::string_view attributeKey)
+			{
+				if (attributeKey == "name")
+				{
+					a.name = String();
+				}
+				else if (attributeKey == "type")
+				{
+					a.type = String();
+				}
+				else
+				{
+					Skip();
+				}
+			});
+			_model->attributes.push_back(a);
+		});
+	});
+}
+
+void DumpReader::ReadEnum()
+{
+	auto& values = _model->enumValues;
+	DumpModelEnum e{};
+	e.firstValue = static_cast<uint32_t>(values.size());
+	Object([&](std::string_view key)
+	{
+		if (key == "name")
+		{
+			e.name = String();
+		}
+		else if (key == "flags")
+		{
+			e.flags = String();
+		}
+		else if (key == "values")
+		{
+			Array([&]
+			{
+				DumpModelEnumValue v{};
+				Object([&](std::string_view valueKey)
+				{
+					if (valueKey == "name")
+					{
+						v.name = String();
+					}
+					else if (valueKey == "value")
+					{
+						v.value = Int();
+					}
+					else
+					{
+						Skip();
+					}
+				});
+				values.push_back(v);
+			});
+		}
+		else
+		{
+			Skip();
+		}
+	});
+	e.valueCount = static_cast<uint32_t>(values.size()) - e.firstValue;
+	_model->enums.push_back(e);
+}
+
+template<class TFunc>
+void DumpReader::Object(TFunc f)
+{
+	Expect('{');
+	if (TryConsume('}'))
+	{
+		return;
+	}
+	do
+	{
+		const auto key = String();
+		Expect(':');
+		f(key);
+	} while (TryConsume(','));
+	Expect('}');
+}
+
+template<class TFunc>
+void DumpReader::Array(TFunc f)
+{
+	Expect('[');
+	if (TryConsume(']'))
+	{
+		return;
+	}
+	do
+	{
+		f();
+	} while (TryConsume(','));
+	Expect(']');
+}
+
+char DumpReader::Peek() const
+{
+	return _next < _structurals.size() ? _text[_structurals[_next]] : '\0';
+}
+
+bool DumpReader::TryConsume(char c)
+{
+	if (Peek() == c)
+	{
+		_next++;
+		return true;
+	}
+	return false;
+}
+
+void DumpReader::Expect(char c)
+{
+	if (!TryConsume(c))
+	{
+		Error(std::string{ "expected '" } + c + "'");
+	}
+}
+
+void DumpReader::Skip()
+{
+	switch (Peek())
+	{
+	case '"':
+		_next += 2;
+		break;
+	case '{':
+	case '[':
+	{
+		// quotes are in the index too, but only the brackets change the depth
+		size_t depth = 0;
+		do
+		{
+			if (_next >= _structurals.size())
+			{
+				Error("unexpected end of input");
+			}
+			const char c = _text[_structurals[_next++]];
+			depth += c == '{' || c == '[';
+			depth -= c == '}' || c == ']';
+		} while (depth > 0);
+		break;
+	}
+	default:
+		Scalar();
+		break;
+	}
+}
+
+namespace
+{
+	// Gets the value of a JSON string with JsonReader.
+	struct StringCapture
+	{
+		void Null(std::optional<std::string_view>) {}
+		void String(std::optional<std::string_view>, std::string_view value) { result = arena.Copy(value); }
+		void Bool(std::optional<std::string_view>, bool) {}
+		void Int(std::optional<std::string_view>, std::signed_integral auto) {}
+		void UInt(std::optional<std::string_view>, std::unsigned_integral auto, JsonUIntOptions) {}
+		void Double(std::optional<std::string_view>, double) {}
+		void BeginObject(std::optional<std::string_view> = std::nullopt) {}
+		void EndObject() {}
+		void BeginArray(std::optional<std::string_view> = std::nullopt) {}
+		void EndArray() {}
+
+		ScratchArena& arena;
+		std::string_view result;
+	};
+}
+
+std::string_view DumpReader::String()
+{
+	if (Peek() != '"')
+	{
+		Error("expected a string");
+	}
+
+	// quotes always come in pairs in the index, IndexStructurals checks the last string is terminated
+	const uint32_t open = _structurals[_next];
+	const uint32_t close = _structurals[_next + 1];
+	_next += 2;
+	const auto value = _text.substr(open + 1, close - open - 1);
+	if (value.find('\\') == std::string_view::npos)
+	{
+		return value;
+	}
+
+	StringCapture capture{ _model->unescaped };
+	JsonReader{ _text.substr(open, close - open + 1) }.Replay(capture);
+	return capture.result;
+}
+
+std::string_view DumpReader::StringOrNull()
+{
+	if (Peek() == '"')
+	{
+		return String();
+	}
+	if (Scalar() != "null")
+	{
+		Error("expected a string or null");
+	}
+	return {};
+}
+
+// Numbers and literals are not in the index, they are the text between the previous structural character and the next one.
+std::string_view DumpReader::Scalar()
+{
+	const size_t begin = _next > 0 ? _structurals[_next - 1] + 1 : 0;
+	const size_t end = _next < _structurals.size() ? _structurals[_next] : _text.size();
+	auto value = _text.substr(begin, end - begin);
+	const size_t first = value.find_first_not_of(" \t\r\n");
+	if (first == std::string_view::npos)
+	{
+		Error("expected a value");
+	}
+	value.remove_prefix(first);
+	value.remove_suffix(value.size() - value.find_last_not_of(" \t\r\n") - 1);
+	return value;
+}
+
+uint64_t DumpReader::UInt()
+{
+	const auto text = Scalar();
+	uint64_t value = 0;
+	if (std::from_chars(text.data(), text.data() + text.size(), value).ptr != text.data() + text.size())
+	{
+		Error("expected an unsigned integer");
+	}
+	return value;
+}
+
+int64_t DumpReader::Int()
+{
+	const auto text = Scalar();
+	int64_t value = 0;
+	if (std::from_chars(text.data(), text.data() + text.size(), value).ptr != text.data() + text.size())
+	{
+		Error("expected an integer");
+	}
+	return value;
+}
+
+// Like the flags1/flags2 values written with json_uint_hex.
+uint32_t DumpReader::HexString()
+{
+	const auto text = String();
+	uint32_t value = 0;
+	if (text.size() <= 2 || !text.starts_with("0x") ||
+		std::from_chars(text.data() + 2, text.data() + text.size(), value, 16).ptr != text.data() + text.size())
+	{
+		Error("expected a hexadecimal string");
+	}
+	return value;
+}
+
+void DumpReader::Error(std::string_view message) const
+{
+	const size_t offset = _next < _structurals.size() ? _structurals[_next] : _text.size();
+	throw std::runtime_error(std::string{ message } + " at offset " + std::to_string(offset));
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include "ScratchArena.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Flat model of a JSON dump as read by DumpReader, with the structures, members and enums each in a single array. Strings are
+// views into the dump text. Only the fields most tools need are kept, the rest of the dump (init values, attribute values,
+// function addresses, ...) is skipped.
+struct DumpModelMember
+{
+	std::string_view name;
+	std::string_view type;
+	std::string_view subtype;
+	std::string_view structName; // STRUCT, POINTER: name of the structure, empty if none
+	std::string_view enumName;   // ENUM, BITSET
+	uint64_t offset;
+	uint64_t size;
+	uint32_t align;              // 0 if not in the dump, older dumps don't have it
+	uint32_t flags1;
+	uint32_t flags2;
+	int32_t item = -1;           // ARRAY: index of the item in DumpModel::subMembers, MAP: index of the key
+	int32_t value = -1;          // MAP: index of the value
+	uint32_t firstAttribute;     // in DumpModel::attributes
+	uint32_t attributeCount;
+};
+
+struct DumpModelAttribute
+{
+	std::string_view name;
+	std::string_view type;
+};
+
+struct DumpModelStruct
+{
+	std::string_view name;
+	std::string_view baseName;   // empty if the structure has no base
+	uint64_t baseOffset;
+	uint64_t size;
+	uint32_t align;
+	std::string_view flags;
+	std::string_view version;
+	uint32_t firstMember;        // members of the structure are [firstMember, firstMember + memberCount) in DumpModel::members
+	uint32_t memberCount;
+};
+
+struct DumpModelEnumValue
+{
+	std::string_view name;
+	int64_t value;
+};
+
+struct DumpModelEnum
+{
+	std::string_view name;
+	std::string_view flags;
+	uint32_t firstValue;         // in DumpModel::enumValues
+	uint32_t valueCount;
+};
+
+struct DumpModel
+{
+	std::string_view game;
+	std::string_view build;
+	std::vector<DumpModelStruct> structs;
+	std::vector<DumpModelMember> members;    // top-level members of each structure
+	std::vector<DumpModelMember> subMembers; // array items and map keys/values, at any depth
+	std::vector<DumpModelAttribute> attributes;
+	std::vector<DumpModelEnum> enums;
+	std::vector<DumpModelEnumValue> enumValues;
+	ScratchArena unescaped{ 4096 };          // the few strings with escape sequences, which can't point into the text
+
+	// Keeps the capacity of the arrays, so reading dumps of similar size into the same model doesn't allocate.
+	void Clear();
+};
+
+// Reads the JSON dumps written by DumpStructs (DumpJsonStructure/DumpJsonMember/DumpJsonEnum) straight into a DumpModel,
+// without building a DOM or replaying every value like JsonReader does.
+//
+// Works in two passes, like simdjson: the first classifies 64 bytes at a time with SSE2 and records the offset of every
+// structural character ({}[]:, and quotes) outside of strings, the second walks that index with the schema of the dump in
+// mind, so skipped values and string contents are never looked at character by character.
+class DumpReader
+{
+public:
+	// Replaces the contents of the model with the dump. The model points into `text`, which must outlive it.
+	// Throws std::runtime_error on malformed input or input that is not a dump.
+	void Read(std::string_view text, DumpModel& model);
+
+private:
+	void IndexStructurals();
+
+	template<class TFunc>
+	void Object(TFunc f);
+	template<class TFunc>
+	void Array(TFunc f);
+
+	char Peek() const;
+	bool TryConsume(char c);
+	void Expect(char c);
+	void Skip();
+	std::string_view String();
+	std::string_view StringOrNull();
+	std::string_view Scalar();
+	uint64_t UInt();
+	int64_t Int();
+	uint32_t HexString();
+
+	void ReadStruct();
+	int32_t ReadMember(std::vector<DumpModelMember>& members);
+	void ReadAttributes();
+	void ReadEnum();
+	[[noreturn]] void Error(std::string_view message) const;
+
+	std::string_view _text;
+	std::vector<uint32_t> _structurals; // kept between reads
+	size_t _next = 0;                   // in _structurals
+	DumpModel* _model = nullptr;
+};
@@ -0,0 +1,111 @@
+#include "Commands.h"
+#include "EnumNameIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// Same layout as the GTA4/MP3/RDR2 parMemberEnumData fields used to identify an enum.
+	struct FakeEnumMember
+	{
+		std::string structName;
+		std::string memberName;
+		const void* values;
+		const void* valueNames;
+		uint32_t valueCount;
+
+		bool hasSameEnum(const FakeEnumMember* other) const
+		{
+			return values == other->values && valueNames == other->valueNames && valueCount == other->valueCount;
+		}
+	};
+}
+
+// Enum members as found in a registry: most enums are used by a single member, some are shared by many (e.g. eHudColour).
+static std::vector<FakeEnumMember> GenerateMembers(size_t count, std::mt19937& rng)
+{
+	const size_t enumCount = count * 3 / 4;
+	std::uniform_int_distribution<size_t> sharedDist{ 0, enumCount / 16 };
+	std::uniform_int_distribution<int> sharedChance{ 0, 3 };
+
+	std::vector<FakeEnumMember> members;
+	members.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const size_t e = sharedChance(rng) == 0 ? sharedDist(rng) : std::min(i * 3 / 4, enumCount - 1);
+		members.push_back({
+			"CStruct" + std::to_string(i / 8),
+			"m_Member" + std::to_string(i % 8),
+			reinterpret_cast<const void*>(0x10000000 + e * 16), // never dereferenced, only compared
+			reinterpret_cast<const void*>(0x20000000 + e * 16),
+			static_cast<uint32_t>(e % 32 + 1),
+		});
+	}
+	return members;
+}
+
+// What CollectStructs used to do: linear search over the enums found so far, name copied into a map for every member.
+static std::unordered_map<const FakeEnumMember*, std::string> CollectLinear(const std::vector<FakeEnumMember>& members)
+{
+	std::unordered_map<const FakeEnumMember*, std::string> memberToEnumName;
+	std::vector<const FakeEnumMember*> enums;
+	for (auto& member : members)
+	{
+		if (auto existingEnum = std::find_if(enums.cbegin(), enums.cend(), [&](auto* e) { return member.hasSameEnum(e); });
+			existingEnum != enums.cend())
+		{
+			memberToEnumName[&member] = memberToEnumName[*existingEnum];
+			continue;
+		}
+
+		memberToEnumName[&member] = member.structName + "__" + member.memberName + "__enum";
+		enums.push_back(&member);
+	}
+	return memberToEnumName;
+}
+
+static void CollectIndexed(const std::vector<FakeEnumMember>& members, EnumNameIndex& index)
+{
+	for (auto& member : members)
+	{
+		index.Add(&member, { member.values, member.valueNames, member.valueCount },
+			[&](ScratchArena& arena) { return arena.Concat({ member.structName, "__", member.memberName, "__enum" }); });
+	}
+}
+
+template<class TFunc>
+static double Measure(TFunc func)
+{
+	const auto start = std::chrono::steady_clock::now();
+	func();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int BenchEnums(size_t maxCount)
+{
+	std::mt19937 rng{ 1234 };
+	size_t failures = 0;
+	std::printf("%8s %8s %12s %12s %8s\n", "members", "enums", "linear ms", "indexed ms", "speedup");
+	for (size_t count = 1250; count <= maxCount; count *= 2)
+	{
+		const auto members = GenerateMembers(count, rng);
+
+		std::unordered_map<const FakeEnumMember*, std::string> linearNames;
+		EnumNameIndex index;
+		const double linearSeconds = Measure([&] { linearNames = CollectLinear(members); });
+		const double indexedSeconds = Measure([&] { CollectIndexed(members, index); });
+
+		// both must give every member the same name
+		const bool same = std::all_of(members.begin(), members.end(), [&](auto& m) { return linearNames[&m] == index.Find(&m); });
+		failures += same ? 0 : 1;
+
+		std::printf("%8zu %8zu %12.2f %12.2f %7.1fx%s\n", count, index.EnumCount(), linearSeconds * 1000.0, indexedSeconds * 1000.0,
+			linearSeconds / indexedSeconds, same ? "" : "  MISMATCH");
+	}
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+#include "Commands.h"
+#include "DumpBinaryReplay.h"
+#include "DumpBinaryWriter.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// One character at a time, the escaping JsonWriter must produce.
+static std::string ReferenceEscape(std::string_view str)
+{
+	static constexpr char digits[] = "0123456789ABCDEF";
+
+	std::string escaped;
+	for (const char c : str)
+	{
+		const auto u = static_cast<unsigned char>(c);
+		switch (c)
+		{
+		case '"':  escaped += "\\\""; break;
+		case '\\': escaped += "\\\\"; break;
+		case '\b': escaped += "\\b"; break;
+		case '\f': escaped += "\\f"; break;
+		case '\n': escaped += "\\n"; break;
+		case '\r': escaped += "\\r"; break;
+		case '\t': escaped += "\\t"; break;
+		default:
+			if (u < 0x20)
+			{
+				escaped += "\\u00";
+				escaped += digits[u >> 4];
+				escaped += digits[u & 0xF];
+			}
+			else
+			{
+				escaped += c;
+			}
+			break;
+		}
+	}
+	return escaped;
+}
+
+namespace
+{
+	// Writes each string as a value and as a key with a memory JsonWriter and compares the output with ReferenceEscape.
+	class EscapeChecker
+	{
+	public:
+		size_t numChecked = 0;
+		size_t numFailed = 0;
+
+		void Check(std::string_view str)
+		{
+			const auto expected = ReferenceEscape(str);
+
+			_w.String(std::nullopt, str);
+			Compare(str, "\"" + expected + "\"");
+			_w.Null(str);
+			Compare(str, "\"" + expected + "\": null");
+		}
+
+	private:
+		void Compare(std::string_view str, const std::string& expected)
+		{
+			// every value but the first starts with the comma, then the new-line
+			std::string fragment = _w.TakeFragment();
+			const size_t prefix = fragment.starts_with(",\n") ? 2 : fragment.starts_with("\n") ? 1 : 0;
+			numChecked++;
+			if (std::string_view{ fragment }.substr(prefix) != expected)
+			{
+				if (numFailed++ < 10)
+				{
+					std::printf("MISMATCH for");
+					for (const char c : str)
+					{
+						std::printf(" %02X", static_cast<unsigned char>(c));
+					}
+					std::printf("\n  expected %s\n  written  %s\n", expected.c_str(), fragment.c_str() + prefix);
+				}
+			}
+		}
+
+		JsonWriter _w{ 0, true };
+	};
+}
+
+int FuzzEscape(size_t numStrings)
+{
+	// the characters that take a different path: control characters with and without a short escape, the quote, the
+	// backslash, the first bytes that need no escaping on either side and bytes >= 0x80, which the SSE2 compare must not
+	// mistake for control characters
+	static constexpr unsigned char special[]{ 0x00, 0x01, 0x08, 0x09, 0x0A, 0x0C, 0x0D, 0x1F, '"', '\\', 0x20, 0x21, 0x7F,
+		0x80, 0x9F, 0xC3, 0xFF };
+
+	EscapeChecker checker;
+
+	// each special character at every position of the first blocks of 16 bytes and of the tail after them, alone and
+	// followed by another one
+	for (size_t size = 1; size <= 49; size++)
+	{
+		for (size_t position = 0; position < size; position++)
+		{
+			for (const unsigned char c : special)
+			{
+				std::string str(size, 'a');
+				str[position] = static_cast<char>(c);
+				checker.Check(str);
+				str[size - 1] = static_cast<char>(c == '"' ? '\\' : '"');
+				checker.Check(str);
+			}
+		}
+	}
+	const size_t numSystematic = checker.numChecked;
+
+	// random strings, mostly printable like the names in the dumps
+	std::mt19937 rng{ 1234 };
+	std::uniform_int_distribution<size_t> sizeDist{ 0, 100 };
+	std::uniform_int_distribution<int> kindDist{ 0, 99 };
+	std::uniform_int_distribution<int> byteDist{ 0, 255 };
+	std::string str;
+	for (size_t i = 0; i < numStrings; i++)
+	{
+		str.resize(sizeDist(rng));
+		for (char& c : str)
+		{
+			const int kind = kindDist(rng);
+			const int b = byteDist(rng);
+			c = static_cast<char>(kind < 70 ? 0x20 + b % 0x5F : kind < 80 ? b % 0x20 : kind < 85 ? '"' : kind < 90 ? '\\' : 0x80 | b);
+		}
+		checker.Check(str);
+	}
+
+	std::printf("%zu systematic and %zu random checks, %zu failed\n", numSystematic, checker.numChecked - numSystematic,
+		checker.numFailed);
+	return checker.numFailed == 0 ? 0 : 1;
+}
+
+int BenchEscape(const char* dumpsDir, size_t numRuns)
+{
+	std::vector<fs::path> paths;
+	for (auto& entry : fs::recursive_directory_iterator(dumpsDir))
+	{
+		if (entry.is_regular_file() && entry.path().extension() == ".json")
+		{
+			paths.push_back(entry.path());
+		}
+	}
+	std::sort(paths.begin(), paths.end(), BuildLess);
+
+	const auto escapedPath = (fs::temp_directory_path() / "DumpTools_escaped.json").string();
+	const auto rawPath = (fs::temp_directory_path() / "DumpTools_raw.json").string();
+	size_t failures = 0, totalSize = 0;
+	double totalEscaped = 0.0, totalRaw = 0.0;
+	std::printf("%-40s %10s %12s %12s %9s %8s\n", "dump", "json KiB", "escaped ms", "as is ms", "overhead", "output");
+	for (auto& path : paths)
+	{
+		const auto pathStr = path.string();
+		MappedFile input;
+		if (!input.Open(pathStr.c_str()))
+		{
+			std::printf("%-40s failed to open\n", pathStr.c_str());
+			failures++;
+			continue;
+		}
+
+		// the writer calls DumpStructs makes for this dump, replayed from the binary dump so parsing the JSON is not measured
+		std::vector<uint8_t> binary;
+		try
+		{
+			DumpBinaryWriter w;
+			JsonReader{ input.Text() }.Replay(w);
+			binary = w.Serialize();
+		}
+		catch (const std::exception& ex)
+		{
+			std::printf("%-40s %s\n", pathStr.c_str(), ex.what());
+			failures++;
+			continue;
+		}
+		DumpBinaryView dump{ binary.data(), binary.size() };
+		if (!dump.Validate())
+		{
+			std::printf("%-40s not a valid dump\n", pathStr.c_str());
+			failures++;
+			continue;
+		}
+
+		// alternated so both see the same cache and frequency conditions, the best run of each is kept
+		double escapedSeconds = std::numeric_limits<double>::infinity(), rawSeconds = escapedSeconds;
+		for (size_t run = 0; run < numRuns; run++)
+		{
+			for (const bool escape : { true, false })
+			{
+				const auto start = std::chrono::steady_clock::now();
+				{
+					JsonWriter w{ escape ? escapedPath : rawPath };
+					w.SetEscaping(escape);
+					DumpBinaryReplay{ dump, w }.Run();
+				}
+				const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				double& best = escape ? escapedSeconds : rawSeconds;
+				best = std::min(best, seconds);
+			}
+		}
+
+		// none of the names in the dumps need escaping, so both outputs must be the same
+		MappedFile escaped, raw;
+		const bool same = escaped.Open(escapedPath.c_str()) && raw.Open(rawPath.c_str()) && escaped.Text() == raw.Text();
+		failures += same ? 0 : 1;
+		totalSize += input.Size();
+		totalEscaped += escapedSeconds;
+		totalRaw += rawSeconds;
+		std::printf("%-40s %10.1f %12.2f %12.2f %8.1f%% %8s\n", fs::relative(path, dumpsDir).string().c_str(), input.Size() / 1024.0,
+			escapedSeconds * 1000.0, rawSeconds * 1000.0, 100.0 * (escapedSeconds - rawSeconds) / rawSeconds,
+			same ? "same" : "DIFFERENT");
+	}
+
+	std::error_code ec;
+	fs::remove(escapedPath, ec);
+	fs::remove(rawPath, ec);
+	std::printf("\n%zu dumps, %zu failed, %.2f MiB\n", paths.size(), failures, totalSize / (1024.0 * 1024.0));
+	if (totalRaw > 0.0)
+	{
+		std::printf("Escaped %.1f ms, as is %.1f ms, overhead %.1f%%\n", totalEscaped * 1000.0, totalRaw * 1000.0,
+			100.0 * (totalEscaped - totalRaw) / totalRaw);
+	}
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,221 @@
+#include "AllocCount.h"
+#include "Commands.h"
+#include "DumpBinaryReplay.h"
+#include "DumpBinaryWriter.h"
+#include "JsonParallel.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	struct SyntheticMember
+	{
+		std::string name;
+		uint32_t offset;
+		uint32_t size;
+		const char* type;
+		std::vector<uint32_t> values; // for arrays/enums
+	};
+
+	struct SyntheticStruct
+	{
+		std::string name;
+		uint32_t hash;
+		uint32_t size;
+		uint32_t align;
+		std::vector<SyntheticMember> members;
+	};
+}
+
+// Roughly the shape of the structs in a GTA5 dump.
+static std::vector<SyntheticStruct> GenerateStructs(size_t count)
+{
+	static constexpr const char* types[]{ "BOOL", "CHAR", "UCHAR", "INT", "UINT", "FLOAT", "VEC3V", "STRING", "STRUCT", "ARRAY", "ENUM", "MAP" };
+	std::mt19937 rng{ 1234 };
+	std::uniform_int_distribution<uint32_t> u32;
+	std::uniform_int_distribution<size_t> memberCount{ 0, 24 };
+	std::uniform_int_distribution<size_t> valueCount{ 0, 6 };
+
+	std::vector<SyntheticStruct> structs(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		auto& s = structs[i];
+		s.name = "CSynthetic" + std::to_string(i) + (i % 97 == 0 ? "<\"quoted\">" : "");
+		s.hash = u32(rng);
+		s.align = 1u << (u32(rng) % 5);
+		s.members.resize(memberCount(rng));
+		uint32_t offset = 0;
+		for (auto& m : s.members)
+		{
+			m.name = "m_Member" + std::to_string(u32(rng) % 1000);
+			m.type = types[u32(rng) % std::size(types)];
+			m.offset = offset;
+			m.size = 1u << (u32(rng) % 5);
+			offset += m.size;
+			m.values.resize(valueCount(rng));
+			for (auto& v : m.values)
+			{
+				v = u32(rng);
+			}
+		}
+		s.size = offset;
+	}
+	return structs;
+}
+
+static void WriteStruct(JsonWriter& w, const SyntheticStruct& s)
+{
+	w.BeginObject();
+	w.String("name", s.name);
+	w.UInt("hash", s.hash, json_uint_hex);
+	w.UInt("size", s.size, json_uint_dec);
+	w.UInt("align", s.align, json_uint_dec);
+	w.BeginArray("members");
+	for (auto& m : s.members)
+	{
+		w.BeginObject();
+		w.String("name", m.name);
+		w.UInt("offset", m.offset, json_uint_dec);
+		w.UInt("size", m.size, json_uint_dec);
+		w.String("type", m.type);
+		if (!m.values.empty())
+		{
+			w.BeginArray("values");
+			for (uint32_t v : m.values)
+			{
+				w.UInt(std::nullopt, v, json_uint_hex_no_zero_pad);
+			}
+			w.EndArray();
+		}
+		w.Float("weight", m.size / 3.0f);
+		w.EndObject();
+	}
+	w.EndArray();
+	w.EndObject();
+}
+
+// Writes the document with the structs array serialized by `numThreads` threads, 0 for the plain sequential loop.
+static double WriteDocument(const fs::path& path, const std::vector<SyntheticStruct>& structs, size_t numThreads)
+{
+	const auto start = std::chrono::steady_clock::now();
+	{
+		JsonWriter w{ path.string() };
+		w.BeginObject();
+		w.String("game", "synthetic");
+		w.BeginArray("structs");
+		if (numThreads == 0)
+		{
+			for (auto& s : structs)
+			{
+				WriteStruct(w, s);
+			}
+		}
+		else
+		{
+			WriteJsonItemsParallel(w, std::span{ structs }, numThreads, WriteStruct);
+		}
+		w.EndArray();
+		w.BeginArray("enums");
+		w.EndArray();
+		w.EndObject();
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int BenchJson(size_t numStructs)
+{
+	const auto structs = GenerateStructs(numStructs);
+	const fs::path dir = fs::temp_directory_path();
+	const fs::path serialPath = dir / "DumpTools_serial.json";
+	const fs::path parallelPath = dir / "DumpTools_parallel.json";
+
+	const double serialSeconds = WriteDocument(serialPath, structs, 0);
+	MappedFile serial;
+	if (!serial.Open(serialPath.string().c_str()))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", serialPath.string().c_str());
+		return 1;
+	}
+
+	std::printf("%zu structs, %.1f MiB of JSON\n", structs.size(), serial.Size() / (1024.0 * 1024.0));
+	std::printf("  serial        %8.1f ms\n", serialSeconds * 1000.0);
+
+	size_t failures = 0;
+	const size_t maxThreads = std::max(8u, std::thread::hardware_concurrency());
+	for (size_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+	{
+		const double seconds = WriteDocument(parallelPath, structs, numThreads);
+		MappedFile parallel;
+		const bool same = parallel.Open(parallelPath.string().c_str()) && parallel.Text() == serial.Text();
+		failures += same ? 0 : 1;
+		std::printf("  %2zu threads    %8.1f ms  %5.2fx  %s\n", numThreads, seconds * 1000.0, serialSeconds / seconds, same ? "identical" : "DIFFERENT");
+	}
+
+	serial.Close();
+	std::error_code ec;
+	fs::remove(serialPath, ec);
+	fs::remove(parallelPath, ec);
+	return failures == 0 ? 0 : 1;
+}
+
+int BenchWriter(const char* dumpPath, size_t numRuns)
+{
+	MappedFile input;
+	if (!input.Open(dumpPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", dumpPath);
+		return 1;
+	}
+
+	// the writer calls DumpStructs makes for this dump, replayed from the binary dump so parsing the JSON is not measured
+	std::vector<uint8_t> binary;
+	{
+		DumpBinaryWriter w;
+		JsonReader{ input.Text() }.Replay(w);
+		binary = w.Serialize();
+	}
+	DumpBinaryView dump{ binary.data(), binary.size() };
+	if (!dump.Validate())
+	{
+		std::fprintf(stderr, "'%s' is not a valid dump\n", dumpPath);
+		return 1;
+	}
+
+	const auto outputPath = (fs::temp_directory_path() / "DumpTools_writer.json").string();
+	double bestSeconds = std::numeric_limits<double>::infinity(), totalSeconds = 0.0;
+	size_t maxAllocations = 0;
+	for (size_t run = 0; run < numRuns; run++)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const size_t numAllocations = CountAllocations([&]
+		{
+			JsonWriter w{ outputPath };
+			DumpBinaryReplay{ dump, w }.Run();
+		});
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		bestSeconds = std::min(bestSeconds, seconds);
+		totalSeconds += seconds;
+		maxAllocations = std::max(maxAllocations, numAllocations);
+	}
+
+	std::error_code ec;
+	const double sizeMiB = fs::file_size(outputPath, ec) / (1024.0 * 1024.0);
+	fs::remove(outputPath, ec);
+	std::printf("%s: %.2f MiB of JSON, %zu runs\n", dumpPath, sizeMiB, numRuns);
+	std::printf("  best    %8.1f ms  %8.1f MiB/s\n", bestSeconds * 1000.0, sizeMiB / bestSeconds);
+	std::printf("  average %8.1f ms  %8.1f MiB/s\n", totalSeconds / numRuns * 1000.0, sizeMiB * numRuns / totalSeconds);
+	std::printf("  %zu heap allocations per run\n", maxAllocations);
+	return 0;
+}
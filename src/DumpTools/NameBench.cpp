@@ -0,0 +1,329 @@
+#include "Commands.h"
+#include "JsonReader.h"
+#include "MappedFile.h"
+#include "NameRegistry.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// Writer for JsonReader that keeps the hashes written as names ("0x1234ABCD") and ignores everything else.
+	struct NameHashCollector
+	{
+		std::vector<uint32_t> hashes;
+
+		void String(std::optional<std::string_view> key, std::string_view value)
+		{
+			if (!key.has_value() || (key != "name" && key != "structName" && key != "enumName"))
+			{
+				return;
+			}
+
+			uint32_t hash = 0;
+			if (value.size() == 10 && value.starts_with("0x") &&
+				std::from_chars(value.data() + 2, value.data() + value.size(), hash, 16).ptr == value.data() + value.size())
+			{
+				hashes.push_back(hash);
+			}
+		}
+
+		void Null(std::optional<std::string_view>) {}
+		void Bool(std::optional<std::string_view>, bool) {}
+		void Int(std::optional<std::string_view>, std::signed_integral auto) {}
+		void UInt(std::optional<std::string_view>, std::unsigned_integral auto, JsonUIntOptions) {}
+		void Float(std::optional<std::string_view>, float) {}
+		void Double(std::optional<std::string_view>, double) {}
+		void BeginObject(std::optional<std::string_view> = std::nullopt) {}
+		void EndObject() {}
+		void BeginArray(std::optional<std::string_view> = std::nullopt) {}
+		void EndArray() {}
+	};
+}
+
+// What DumpStructs did before NameRegistry, the switch of DumpJsonStructure.
+static std::string_view CallbackNameSwitch(uint32_t key)
+{
+	switch (key)
+	{
+	case joaat_literal("preloadfast"): return "PreLoadFast";
+	case joaat_literal("preload"): return "PreLoad";
+	case joaat_literal("postload"): return "PostLoad";
+	case joaat_literal("presave"): return "PreSave";
+	case joaat_literal("postsave"): return "PostSave";
+	case joaat_literal("removefromstore"): return "RemoveFromStore";
+	case joaat_literal("preset"): return "PreSet";
+	case joaat_literal("postset"): return "PostSet";
+	case joaat_literal("presetfast"): return "PreSetFast";
+	case joaat_literal("postsetfast"): return "PostSetFast";
+	case joaat_literal("postpsoplace"): return "PostPsoPlace";
+	case joaat_literal("visitor"): return "Visitor";
+	default: return {};
+	}
+}
+
+// The names of a dictionary.txt, as NameDictionary::AddLines reads them.
+static std::vector<std::string_view> SplitLines(std::string_view text)
+{
+	constexpr std::string_view whitespace = " \t\r\n";
+	std::vector<std::string_view> lines;
+	while (!text.empty())
+	{
+		const size_t end = text.find('\n');
+		std::string_view line = text.substr(0, end);
+		text = end != std::string_view::npos ? text.substr(end + 1) : std::string_view{};
+		const size_t first = line.find_first_not_of(whitespace);
+		if (first != std::string_view::npos)
+		{
+			lines.push_back(line.substr(first, line.find_last_not_of(whitespace) - first + 1));
+		}
+	}
+	return lines;
+}
+
+// Names shaped like the ones in dictionary.txt, for when no dictionary is given.
+static std::vector<std::string> GenerateNames(size_t count)
+{
+	static constexpr const char* prefixes[]{ "C", "m_", "e", "s", "Cam", "CPed", "CVehicle", "rage__", "" };
+	static constexpr const char* words[]{ "Component", "Info", "Data", "Settings", "Flags", "Type", "Params", "Metadata", "Def", "List" };
+	std::mt19937 rng{ 1234 };
+	std::vector<std::string> names;
+	names.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		std::string name = prefixes[rng() % std::size(prefixes)];
+		name += words[rng() % std::size(words)];
+		name += words[rng() % std::size(words)];
+		name += std::to_string(i);
+		names.push_back(std::move(name));
+	}
+	return names;
+}
+
+template<class TFunc>
+static double Measure(TFunc func)
+{
+	const auto start = std::chrono::steady_clock::now();
+	func();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int BenchNames(const char* dumpPath, const char* dictionaryPath)
+{
+	MappedFile dump;
+	if (!dump.Open(dumpPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", dumpPath);
+		return 1;
+	}
+
+	NameHashCollector collector;
+	JsonReader{ dump.Text() }.Replay(collector);
+	if (collector.hashes.empty())
+	{
+		std::fprintf(stderr, "No name hashes in '%s'\n", dumpPath);
+		return 1;
+	}
+
+	NameRegistry registry;
+	registry.AddKnownNames(par_callback_names.Layer());
+	std::unordered_map<uint32_t, std::string> baseline; // like the dictionary of DumpFormatter
+	size_t dictionaryMs = 0;
+	if (dictionaryPath != nullptr)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		if (!registry.Dictionary().Load(dictionaryPath))
+		{
+			std::fprintf(stderr, "Failed to open '%s'\n", dictionaryPath);
+			return 1;
+		}
+		dictionaryMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+		// the baseline keeps the first of the names with the same hash too
+		MappedFile text;
+		text.Open(dictionaryPath);
+		for (auto line : SplitLines(text.Text()))
+		{
+			baseline.try_emplace(joaat(line), line);
+		}
+	}
+	else
+	{
+		// a synthetic dictionary where the dump hashes are missing, plus the names of half of them so lookups also hit
+		const auto names = GenerateNames(200'000);
+		for (auto& name : names)
+		{
+			registry.Dictionary().Add(name);
+			baseline.try_emplace(joaat(name), name);
+		}
+		for (size_t i = 0; i < collector.hashes.size() && i < names.size(); i += 2)
+		{
+			collector.hashes[i] = joaat(names[i]);
+		}
+	}
+
+	std::printf("%zu name hashes in %s, %zu names in the dictionary (%zu duplicates)", collector.hashes.size(), dumpPath,
+		registry.Dictionary().Count(), registry.Dictionary().Duplicates());
+	if (dictionaryPath != nullptr)
+	{
+		std::printf(", loaded in %zu ms", dictionaryMs);
+	}
+	std::printf("\n");
+
+	// check both resolve the same names
+	size_t found = 0;
+	bool ok = true;
+	for (uint32_t hash : collector.hashes)
+	{
+		const auto name = registry.Find(hash);
+		const auto it = baseline.find(hash);
+		const bool sameAsBaseline = it != baseline.end() ? name == it->second : name.empty() || !par_callback_names.Find(hash).empty();
+		ok = ok && sameAsBaseline;
+		found += !name.empty();
+	}
+	for (auto& known : par_callback_known_names)
+	{
+		const uint32_t hash = joaat_literal(known.key.data());
+		ok = ok && par_callback_names.Find(hash) == CallbackNameSwitch(hash) && registry.Find(hash) == known.name;
+	}
+
+	const size_t repeats = std::max<size_t>(1, 20'000'000 / collector.hashes.size());
+	const size_t lookups = repeats * collector.hashes.size();
+	size_t checksum = 0;
+	const auto measureLookups = [&](auto find)
+	{
+		size_t sum = 0;
+		const double seconds = Measure([&]
+		{
+			for (size_t r = 0; r < repeats; r++)
+			{
+				for (uint32_t hash : collector.hashes)
+				{
+					sum += find(hash).size();
+				}
+			}
+		});
+		checksum += sum; // printed, so the lookups are not optimized away
+		return seconds;
+	};
+	const double registrySeconds = measureLookups([&](uint32_t hash) { return registry.Find(hash); });
+	const double baselineSeconds = measureLookups([&](uint32_t hash)
+	{
+		auto it = baseline.find(hash);
+		return it != baseline.end() ? std::string_view{ it->second } : std::string_view{};
+	});
+	const double staticSeconds = measureLookups([](uint32_t hash) { return par_callback_names.Find(hash); });
+	const double switchSeconds = measureLookups([](uint32_t hash) { return CallbackNameSwitch(hash); });
+
+	const auto rate = [lookups](double seconds) { return lookups / seconds / 1e6; };
+	std::printf("%zu lookups, %zu of %zu hashes resolved (checksum %zu)\n", lookups, found, collector.hashes.size(), checksum);
+	std::printf("  %-32s %8.1f M/s\n", "NameRegistry", rate(registrySeconds));
+	std::printf("  %-32s %8.1f M/s\n", "unordered_map<uint32_t, string>", rate(baselineSeconds));
+	std::printf("  %-32s %8.1f M/s\n", "StaticNameTable (callbacks)", rate(staticSeconds));
+	std::printf("  %-32s %8.1f M/s\n", "switch (callbacks)", rate(switchSeconds));
+	std::printf("%s\n", ok ? "OK" : "FAILED, the lookups don't match");
+	return ok ? 0 : 1;
+}
+
+int BuildNameIndex(const char* dictionaryPath, const char* indexPath)
+{
+	MappedFile text;
+	if (!text.Open(dictionaryPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", dictionaryPath);
+		return 1;
+	}
+
+	const auto lines = SplitLines(text.Text());
+	size_t chars = 0;
+	std::vector<size_t> lengths;
+	lengths.reserve(lines.size());
+	for (auto line : lines)
+	{
+		chars += line.size();
+		lengths.push_back(line.size());
+	}
+	std::sort(lengths.begin(), lengths.end());
+
+	// the hashing kernels alone
+	std::vector<uint32_t> scalarHashes(lines.size()), batchHashes(lines.size());
+	const double scalarSeconds = Measure([&]
+	{
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			scalarHashes[i] = joaat(lines[i]);
+		}
+	});
+	const double batchSeconds = Measure([&] { JoaatBatch(lines, batchHashes); });
+	bool ok = scalarHashes == batchHashes;
+
+	// what DumpFormatter's Joaat.LoadDictionary does, a map filled line by line
+	std::unordered_map<uint32_t, std::string> baseline;
+	const double baselineSeconds = Measure([&]
+	{
+		for (auto line : lines)
+		{
+			baseline.try_emplace(joaat(line), line);
+		}
+	});
+
+	NameDictionary dictionary;
+	const double loadSeconds = Measure([&] { ok = dictionary.Load(dictionaryPath) && ok; });
+	ok = ok && dictionary.Count() == baseline.size();
+	for (auto& [hash, name] : baseline)
+	{
+		ok = ok && dictionary.Find(hash) == name;
+	}
+
+	std::printf("%zu lines (%zu chars) in %s: %zu names, %zu duplicates, %zu hash collisions\n", lines.size(), chars,
+		dictionaryPath, dictionary.Count(), dictionary.Duplicates(), dictionary.Collisions().size());
+	for (auto& collision : dictionary.Collisions())
+	{
+		std::printf("  0x%08X  kept '%.*s', ignored '%.*s'\n", collision.hash, static_cast<int>(collision.kept.size()),
+			collision.kept.data(), static_cast<int>(collision.dropped.size()), collision.dropped.data());
+	}
+
+	// how much JoaatBatch gains depends on the line lengths, so they are printed with the times
+	if (!lengths.empty())
+	{
+		const auto percentile = [&](size_t p) { return lengths[(lengths.size() - 1) * p / 100]; };
+		std::printf("  line lengths: min %zu, p10 %zu, median %zu, p90 %zu, max %zu\n", lengths.front(), percentile(10),
+			percentile(50), percentile(90), lengths.back());
+	}
+
+	const auto rate = [chars](double seconds) { return chars / seconds / (1024.0 * 1024.0); };
+	std::printf("  %-36s %10.3f ms %10.1f MiB/s\n", "joaat, one line at a time", scalarSeconds * 1000.0, rate(scalarSeconds));
+	std::printf("  %-36s %10.3f ms %10.1f MiB/s\n", "JoaatBatch", batchSeconds * 1000.0, rate(batchSeconds));
+	std::printf("  %-36s %10.3f ms\n", "unordered_map<uint32_t, string>", baselineSeconds * 1000.0);
+	std::printf("  %-36s %10.3f ms\n", "NameDictionary::Load", loadSeconds * 1000.0);
+
+	if (indexPath != nullptr)
+	{
+		if (!dictionary.SaveIndex(indexPath, dictionaryPath))
+		{
+			std::fprintf(stderr, "Failed to write '%s'\n", indexPath);
+			return 1;
+		}
+
+		NameDictionary indexed;
+		NameIndexLoadResult result{};
+		const double indexSeconds = Measure([&] { result = indexed.LoadIndex(indexPath, dictionaryPath); });
+		ok = ok && result == NameIndexLoadResult::Loaded && indexed.Count() == dictionary.Count() &&
+			indexed.Duplicates() == dictionary.Duplicates();
+		for (auto& [hash, name] : baseline)
+		{
+			ok = ok && indexed.Find(hash) == name;
+		}
+		std::printf("  %-36s %10.3f ms\n", "NameDictionary::LoadIndex", indexSeconds * 1000.0);
+	}
+
+	std::printf("%s\n", ok ? "OK" : "FAILED, the dictionaries don't match");
+	return ok ? 0 : 1;
+}
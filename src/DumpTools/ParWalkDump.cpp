@@ -0,0 +1,507 @@
+#include "ParWalkDump.h"
+#include "DumpBinaryWriter.h"
+#include "EnumNames.h"
+#include "JsonWriter.h"
+#include "NameRegistry.h"
+#include "ParEnumLists.h"
+#include "ScratchArena.h"
+#include <bit>
+#include <cstdio>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+// the name tables of rage.cpp for both games, indexed by the raw values since the rage.h enums are only defined for the game
+// being built
+constexpr auto gta5_member_type_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_TYPES_GTA5);
+constexpr auto rdr3_member_type_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_TYPES_RDR3);
+constexpr auto attribute_type_names = ENUM_NAME_TABLE(uint8_t, PAR_ATTRIBUTE_TYPES);
+constexpr auto gta5_common_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_COMMON_SUBTYPES_GTA5);
+constexpr auto rdr3_common_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_COMMON_SUBTYPES_RDR3);
+constexpr auto array_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_ARRAY_SUBTYPES);
+constexpr auto gta5_enum_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_ENUM_SUBTYPES_GTA5);
+constexpr auto rdr3_enum_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_ENUM_SUBTYPES_RDR3);
+constexpr auto gta5_bitset_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_BITSET_SUBTYPES_GTA5);
+constexpr auto rdr3_bitset_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_BITSET_SUBTYPES_RDR3);
+constexpr auto map_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_MAP_SUBTYPES);
+constexpr auto gta5_string_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_STRING_SUBTYPES_GTA5);
+constexpr auto rdr3_string_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_STRING_SUBTYPES_RDR3);
+constexpr auto struct_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_STRUCT_SUBTYPES);
+constexpr auto guid_subtype_names = ENUM_NAME_TABLE(uint8_t, PAR_MEMBER_GUID_SUBTYPES);
+constexpr auto enum_flags_names = FLAG_NAME_TABLE(uint16_t, PAR_ENUM_FLAGS);
+constexpr auto structure_flags_names = FLAG_NAME_TABLE(uint16_t, PAR_STRUCTURE_FLAGS);
+constexpr auto array_alloc_flags_names = FLAG_NAME_TABLE(uint16_t, PAR_MEMBER_ARRAY_ALLOC_FLAGS);
+
+namespace
+{
+	// parMemberArraySubtype, parMemberStringSubtype and parAttribute::Type values that change what is written, the same in
+	// both games
+	enum : uint8_t
+	{
+		array_atfixedarray = 1,
+		array_atrangearray = 2,
+		array_pointer = 3,
+		array_member = 4,
+		array_pointer_with_count = 6,
+		array_pointer_with_count_8bit_idx = 7,
+		array_pointer_with_count_16bit_idx = 8,
+		array_virtual = 9,
+		string_member = 0,
+		string_wide_member = 4,
+		string_atnshashstring = 11,
+		string_atnshashvalue = 12,
+		attribute_string = 0,
+		attribute_int64 = 1,
+		attribute_double = 2,
+		attribute_bool = 3,
+	};
+
+	template<class TWriter>
+	class ParWalkDumpWriter
+	{
+	public:
+		ParWalkDumpWriter(TWriter& w, const ParWalkResult& result, const ParWalkDumpInfo& info)
+			: _w{ w }, _result{ result }, _info{ info }, _layout{ FindParLayout(info.game) }, _rdr3{ info.game == "rdr3" }
+		{
+			if (_layout == nullptr)
+			{
+				throw std::runtime_error("no layout for game '" + std::string{ info.game } + "'");
+			}
+		}
+
+		void Write()
+		{
+			_w.BeginObject();
+			_w.String("game", _rdr3 ? "rdr3" : "gta5");
+			_w.String("build", _info.build);
+
+			_w.BeginArray("structs");
+			for (auto& s : _result.structures)
+			{
+				WriteStructure(s);
+			}
+			_w.EndArray();
+			_w.BeginArray("enums");
+			for (auto* e : CollectEnums())
+			{
+				WriteEnum(*e);
+			}
+			_w.EndArray();
+			_w.EndObject();
+		}
+
+	private:
+		// The walker also finds the enums of nested arrays and maps, CollectStructs only looks at the members of the
+		// structures and at their array items and map keys/values, in that order.
+		std::vector<const WalkedEnum*> CollectEnums() const
+		{
+			std::vector<const WalkedEnum*> enums;
+			std::unordered_set<uint64_t> added;
+			const auto addEnum = [&](int32_t index)
+			{
+				if (index < 0)
+				{
+					return;
+				}
+
+				auto& m = _result.members[index];
+				const auto type = static_cast<ParLayoutMemberType>(m.type);
+				if (type != ParLayoutMemberType::ENUM && type != ParLayoutMemberType::BITSET)
+				{
+					return;
+				}
+
+				auto* e = _result.FindEnum(m.enumData);
+				if (e != nullptr && added.insert(m.enumData).second)
+				{
+					enums.push_back(e);
+				}
+			};
+
+			for (auto& s : _result.structures)
+			{
+				for (uint32_t i = s.firstMember; i < s.firstMember + s.memberCount; i++)
+				{
+					auto& m = _result.members[i];
+					switch (static_cast<ParLayoutMemberType>(m.type))
+					{
+					case ParLayoutMemberType::ENUM:
+					case ParLayoutMemberType::BITSET:
+						addEnum(static_cast<int32_t>(i));
+						break;
+					case ParLayoutMemberType::ARRAY:
+						addEnum(m.item);
+						break;
+					case ParLayoutMemberType::MAP:
+						addEnum(m.item);
+						addEnum(m.value);
+						break;
+					default:
+						break;
+					}
+				}
+			}
+			return enums;
+		}
+
+		void WriteName(std::string_view key, uint32_t hash)
+		{
+			if (auto name = _info.names != nullptr ? _info.names->Find(hash) : std::string_view{}; !name.empty())
+			{
+				_w.String(key, name);
+			}
+			else
+			{
+				_w.UInt(key, hash, json_uint_hex);
+			}
+		}
+
+		void WriteFunction(std::string_view key, uint64_t function)
+		{
+			_w.UInt(key, function - _info.imageBase, json_uint_hex_no_zero_pad);
+		}
+
+		std::string_view SubtypeName(uint8_t type, uint8_t subtype) const
+		{
+			std::string_view name;
+			switch (static_cast<ParLayoutMemberType>(type))
+			{
+			case ParLayoutMemberType::ARRAY: name = array_subtype_names(subtype); break;
+			case ParLayoutMemberType::ENUM: name = _rdr3 ? rdr3_enum_subtype_names(subtype) : gta5_enum_subtype_names(subtype); break;
+			case ParLayoutMemberType::BITSET: name = _rdr3 ? rdr3_bitset_subtype_names(subtype) : gta5_bitset_subtype_names(subtype); break;
+			case ParLayoutMemberType::MAP: name = map_subtype_names(subtype); break;
+			case ParLayoutMemberType::STRING: name = _rdr3 ? rdr3_string_subtype_names(subtype) : gta5_string_subtype_names(subtype); break;
+			case ParLayoutMemberType::STRUCT: name = struct_subtype_names(subtype); break;
+			case ParLayoutMemberType::GUID:
+				if (_rdr3)
+				{
+					name = guid_subtype_names(subtype);
+					break;
+				}
+				[[fallthrough]];
+			default: name = _rdr3 ? rdr3_common_subtype_names(subtype) : gta5_common_subtype_names(subtype); break;
+			}
+
+			return !name.empty() ? name : ByteToString(subtype);
+		}
+
+		void WriteAttributeList(std::string_view key, const WalkedAttributeList& list)
+		{
+			_w.BeginObject(key);
+			if (list.userData1 != 0)
+			{
+				_w.UInt("userData1", list.userData1, json_uint_dec);
+			}
+			if (list.userData2 != 0)
+			{
+				_w.UInt("userData2", list.userData2, json_uint_dec);
+			}
+			_w.BeginArray("list");
+			for (uint32_t i = list.firstAttribute; i < list.firstAttribute + list.attributeCount; i++)
+			{
+				auto& attr = _result.attributes[i];
+				_w.BeginObject();
+				_w.String("name", attr.name);
+				_w.String("type", attribute_type_names(attr.type, "UNKNOWN"));
+				switch (attr.type)
+				{
+				case attribute_string: _w.String("value", attr.string); break;
+				case attribute_int64:  _w.Int("value", static_cast<int64_t>(attr.value)); break;
+				case attribute_double: _w.Double("value", std::bit_cast<double>(attr.value)); break;
+				case attribute_bool:   _w.Bool("value", static_cast<uint8_t>(attr.value) != 0); break;
+				}
+				_w.EndObject();
+			}
+			_w.EndArray();
+			_w.EndObject();
+		}
+
+		void WriteMember(std::optional<std::string_view> key, int32_t index, std::optional<std::string_view> nameOverride = std::nullopt)
+		{
+			if (index < 0 || _result.members[index].address == 0)
+			{
+				_w.Null(key);
+				return;
+			}
+
+			auto& m = _result.members[index];
+			if (!m.size.has_value() || !m.align.has_value())
+			{
+				char message[64];
+				std::snprintf(message, sizeof(message), "no size or align annotation for parMember 0x%llX",
+					static_cast<unsigned long long>(m.address));
+				throw std::runtime_error(message);
+			}
+
+			const auto type = static_cast<ParLayoutMemberType>(m.type);
+			_w.BeginObject(key);
+			if (nameOverride.has_value())
+			{
+				_w.String("name", nameOverride.value());
+			}
+			else
+			{
+				WriteName("name", m.name);
+			}
+			_w.UInt("offset", m.offset, json_uint_dec);
+			_w.UInt("size", m.size.value(), json_uint_dec);
+			_w.UInt("align", m.align.value(), json_uint_dec);
+			_w.UInt("flags1", m.flags1, json_uint_hex);
+			_w.UInt("flags2", m.flags2, json_uint_hex);
+			const bool usesExtraData = type == ParLayoutMemberType::ARRAY || type == ParLayoutMemberType::STRING;
+			if (m.extraData != 0 && !usesExtraData)
+			{
+				_w.UInt("extraData", m.extraData, json_uint_hex);
+			}
+			_w.String("type", _rdr3 ? rdr3_member_type_names(m.type, "UNKNOWN") : gta5_member_type_names(m.type, "UNKNOWN"));
+			_w.String("subtype", SubtypeName(m.type, m.subType));
+			if (m.attributeList >= 0)
+			{
+				WriteAttributeList("attributes", _result.attributeLists[m.attributeList]);
+			}
+
+			switch (type)
+			{
+			case ParLayoutMemberType::STRUCT:
+				if (m.structure != 0)
+				{
+					// only the registered structures are walked, the name of any other one is not known
+					auto* s = _result.FindStructure(m.structure);
+					if (s != nullptr)
+					{
+						WriteName("structName", s->name);
+					}
+					else
+					{
+						_w.Null("structName");
+					}
+				}
+				else
+				{
+					_w.Null("structName");
+				}
+				if (m.functions[0] != 0)
+				{
+					WriteFunction("externalNamedResolveFunc", m.functions[0]);
+				}
+				if (m.functions[1] != 0)
+				{
+					WriteFunction("externalNamedGetNameFunc", m.functions[1]);
+				}
+				if (m.functions[2] != 0)
+				{
+					WriteFunction("allocateStructFunc", m.functions[2]);
+				}
+				break;
+			case ParLayoutMemberType::ARRAY:
+				WriteMember("item", m.item);
+				if (m.extraData != 0)
+				{
+					_w.String("allocFlags", array_alloc_flags_names(m.extraData));
+				}
+				switch (m.subType)
+				{
+				case array_atfixedarray:
+				case array_atrangearray:
+				case array_pointer:
+				case array_member:
+				case array_virtual:
+					_w.UInt("arraySize", m.arraySize, json_uint_dec);
+					break;
+				case array_pointer_with_count:
+				case array_pointer_with_count_8bit_idx:
+				case array_pointer_with_count_16bit_idx:
+					_w.UInt("countOffset", m.arraySize, json_uint_hex);
+					break;
+				}
+				break;
+			case ParLayoutMemberType::ENUM:
+			case ParLayoutMemberType::BITSET:
+				if (auto* e = _result.FindEnum(m.enumData))
+				{
+					WriteName("enumName", e->name);
+				}
+				else
+				{
+					_w.Null("enumName");
+				}
+				_w.Int("initValue", m.initValue);
+				break;
+			case ParLayoutMemberType::MAP:
+				WriteMember("key", m.item);
+				WriteMember("value", m.value);
+				if (m.functions[0] != 0)
+				{
+					WriteFunction("createIteratorFunc", m.functions[0]);
+				}
+				if (m.functions[1] != 0)
+				{
+					WriteFunction("createInterfaceFunc", m.functions[1]);
+				}
+				break;
+			case ParLayoutMemberType::STRING:
+				switch (m.subType)
+				{
+				case string_member:
+				case string_wide_member:
+					_w.UInt("memberSize", m.arraySize, json_uint_dec);
+					break;
+				case string_atnshashstring:
+				case string_atnshashvalue:
+					_w.UInt("namespaceIndex", static_cast<uint8_t>(m.extraData), json_uint_dec);
+					break;
+				}
+				break;
+			default:
+				// the simple types have a single init value, a double in the games where the enum one is 64-bit
+				if (m.initValueCount == 1 && _layout->dataEnumInitValueSize == sizeof(double))
+				{
+					_w.Double("initValue", _result.initValues[m.firstInitValue]);
+				}
+				else if (m.initValueCount == 1)
+				{
+					_w.Float("initValue", static_cast<float>(_result.initValues[m.firstInitValue]));
+				}
+				else if (m.initValueCount != 0)
+				{
+					_w.BeginArray("initValues");
+					for (uint32_t i = m.firstInitValue; i < m.firstInitValue + m.initValueCount; i++)
+					{
+						_w.Float(std::nullopt, static_cast<float>(_result.initValues[i]));
+					}
+					_w.EndArray();
+				}
+				break;
+			}
+			_w.EndObject();
+		}
+
+		void WriteStructure(const WalkedStructure& s)
+		{
+			_w.BeginObject();
+			if (!s.nameStr.empty())
+			{
+				_w.String("name", s.nameStr);
+			}
+			else
+			{
+				WriteName("name", s.name);
+			}
+			if (s.base != 0)
+			{
+				_w.BeginObject("base");
+				if (auto* base = _result.FindStructure(s.base))
+				{
+					WriteName("name", base->name);
+				}
+				else
+				{
+					_w.Null("name");
+				}
+				_w.UInt("offset", s.baseOffset, json_uint_dec);
+				_w.EndObject();
+			}
+			_w.UInt("size", s.size, json_uint_dec);
+			_w.UInt("align", s.align, json_uint_dec);
+			_w.String("flags", structure_flags_names(s.flags));
+			char versionBuffer[16];
+			const int versionLength = std::snprintf(versionBuffer, sizeof(versionBuffer), "%u.%u", s.versionMajor, s.versionMinor);
+			_w.String("version", { versionBuffer, static_cast<size_t>(versionLength) });
+			_w.BeginArray("members");
+			for (uint32_t i = 0; i < s.memberCount; i++)
+			{
+				auto nameOverride = s.firstMemberName != UINT32_MAX ? std::make_optional(_result.memberNames[s.firstMemberName + i]) : std::nullopt;
+				WriteMember(std::nullopt, static_cast<int32_t>(s.firstMember + i), nameOverride);
+			}
+			_w.EndArray();
+
+			if (s.extraAttributeList >= 0)
+			{
+				WriteAttributeList("extraAttributes", _result.attributeLists[s.extraAttributeList]);
+			}
+
+			_w.BeginObject("factories");
+			for (auto [key, function] : { std::pair{ "new", s.factoryNew }, std::pair{ "placementNew", s.factoryPlacementNew }, std::pair{ "delete", s.factoryDelete } })
+			{
+				if (function != 0)
+				{
+					WriteFunction(key, function);
+				}
+				else
+				{
+					_w.Null(key);
+				}
+			}
+			_w.EndObject();
+
+			if (s.getStructureCB != 0)
+			{
+				WriteFunction("getStructureCB", s.getStructureCB);
+			}
+			else
+			{
+				_w.Null("getStructureCB");
+			}
+
+			if (s.callbackCount > 0)
+			{
+				_w.BeginObject("callbacks");
+				for (uint32_t i = s.firstCallback; i < s.firstCallback + s.callbackCount; i++)
+				{
+					auto& cb = _result.callbacks[i];
+					char keyBuffer[32];
+					std::string_view key = par_callback_names.Find(cb.name);
+					if (key.empty())
+					{
+						key = { keyBuffer, static_cast<size_t>(std::snprintf(keyBuffer, sizeof(keyBuffer), "callback_0x%08X", cb.name)) };
+					}
+					WriteFunction(key, cb.function);
+				}
+				_w.EndObject();
+			}
+			_w.EndObject();
+		}
+
+		void WriteEnum(const WalkedEnum& e)
+		{
+			_w.BeginObject();
+			WriteName("name", e.name);
+			_w.String("flags", enum_flags_names(e.flags));
+			_w.BeginArray("values");
+			for (uint32_t i = e.firstValue; i < e.firstValue + e.valueCount; i++)
+			{
+				auto& v = _result.enumValues[i];
+				_w.BeginObject();
+				if (!v.nameStr.empty())
+				{
+					_w.String("name", v.nameStr);
+				}
+				else
+				{
+					WriteName("name", v.name);
+				}
+				_w.Int("value", v.value);
+				_w.EndObject();
+			}
+			_w.EndArray();
+			_w.EndObject();
+		}
+
+		TWriter& _w;
+		const ParWalkResult& _result;
+		const ParWalkDumpInfo& _info;
+		const ParLayout* _layout;
+		bool _rdr3;
+	};
+}
+
+void WriteParWalkDump(JsonWriter& w, const ParWalkResult& result, const ParWalkDumpInfo& info)
+{
+	ParWalkDumpWriter{ w, result, info }.Write();
+}
+
+void WriteParWalkDump(DumpBinaryWriter& w, const ParWalkResult& result, const ParWalkDumpInfo& info)
+{
+	ParWalkDumpWriter{ w, result, info }.Write();
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "ParWalker.h"
+#include <cstdint>
+#include <string_view>
+
+class DumpBinaryWriter;
+class JsonWriter;
+class NameRegistry;
+
+struct ParWalkDumpInfo
+{
+	std::string_view game;               // the snapshot game: gta5, gta5g9 or rdr3
+	std::string_view build;              // written as is, e.g. "3323" or "3323g9"
+	uint64_t imageBase;                  // to write the function pointers as RVAs
+	const NameRegistry* names = nullptr; // to write the names of the known hashes, like DumpStructs does with its dictionary
+};
+
+// Writes a walked registry as the dump DumpStructs writes in the game (see DumpJson in dllmain.cpp): the same keys in the
+// same order, the structures in the order they were walked and the enums in the order CollectStructs finds them. The sizes
+// and alignments that need a game call come from the snapshot annotations, so the walk must have been made with them.
+// Throws std::runtime_error if the game has no layout or an annotation is missing.
+void WriteParWalkDump(JsonWriter& w, const ParWalkResult& result, const ParWalkDumpInfo& info);
+void WriteParWalkDump(DumpBinaryWriter& w, const ParWalkResult& result, const ParWalkDumpInfo& info);
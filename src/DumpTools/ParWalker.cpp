@@ -0,0 +1,466 @@
+#include "ParWalker.h"
+#include <array>
+#include <cstring>
+
+template<class T>
+static T Field(const uint8_t* object, uint32_t offset)
+{
+	T value;
+	std::memcpy(&value, object + offset, sizeof(T));
+	return value;
+}
+
+// fields whose size depends on the game
+static uint64_t UIntField(const uint8_t* object, uint32_t offset, uint32_t size)
+{
+	switch (size)
+	{
+	case 1: return Field<uint8_t>(object, offset);
+	case 2: return Field<uint16_t>(object, offset);
+	case 4: return Field<uint32_t>(object, offset);
+	default: return Field<uint64_t>(object, offset);
+	}
+}
+
+static int64_t IntField(const uint8_t* object, uint32_t offset, uint32_t size)
+{
+	switch (size)
+	{
+	case 1: return Field<int8_t>(object, offset);
+	case 2: return Field<int16_t>(object, offset);
+	case 4: return Field<int32_t>(object, offset);
+	default: return Field<int64_t>(object, offset);
+	}
+}
+
+// atArray and atBinaryMap::Pairs
+static constexpr uint32_t arrayItems = 0x0;
+static constexpr uint32_t arrayCount = 0x8;
+static constexpr uint32_t binaryMapPairs = 0x8;
+// atBinaryMap<uint32_t, parDelegateHolderBase*>::DataPair
+static constexpr uint32_t callbackPairValue = 0x8;
+static constexpr uint32_t callbackPairSize = 0x10;
+// parDelegateHolderBase
+static constexpr uint32_t delegateFunc = 0x8;
+// parAttribute
+static constexpr uint32_t attributeName = 0x0;
+static constexpr uint8_t attributeTypeString = 0;
+
+const WalkedStructure* ParWalkResult::FindStructure(uint64_t address) const
+{
+	auto it = structureIndices.find(address);
+	return it != structureIndices.end() ? &structures[it->second] : nullptr;
+}
+
+const WalkedEnum* ParWalkResult::FindEnum(uint64_t address) const
+{
+	auto it = enumIndices.find(address);
+	return it != enumIndices.end() ? &enums[it->second] : nullptr;
+}
+
+ParWalker::ParWalker(MemoryReader& reader, const ParLayout& layout, const MemorySnapshot* annotations)
+	: _reader{ reader }, _layout{ layout }, _annotations{ annotations }
+{
+}
+
+ParWalkResult ParWalker::Walk(uint64_t parManager)
+{
+	_result = {};
+
+	const uint64_t map = parManager + _layout.managerStructures;
+	std::array<uint8_t, 16> header;
+	if (!_reader.Read(map, header.data(), _layout.mapNumBuckets + _layout.mapCountSize))
+	{
+		_result.failedReads++;
+		return std::move(_result);
+	}
+
+	const uint64_t buckets = Field<uint64_t>(header.data(), 0);
+	const size_t numBuckets = UIntField(header.data(), _layout.mapNumBuckets, _layout.mapCountSize);
+	std::vector<uint64_t> bucketEntries;
+	if (!ReadPointers(buckets, numBuckets, bucketEntries))
+	{
+		_result.failedReads++;
+		return std::move(_result);
+	}
+
+	std::array<uint8_t, 32> entry;
+	for (uint64_t e : bucketEntries)
+	{
+		while (e != 0)
+		{
+			if (!_reader.Read(e, entry.data(), _layout.mapEntrySize))
+			{
+				_result.failedReads++;
+				break;
+			}
+
+			WalkStructure(Field<uint64_t>(entry.data(), _layout.mapEntryValue));
+			e = Field<uint64_t>(entry.data(), _layout.mapEntryNext);
+		}
+	}
+
+	return std::move(_result);
+}
+
+void ParWalker::WalkStructure(uint64_t address)
+{
+	_structure.resize(_layout.structureSize);
+	if (address == 0 || !_reader.Read(address, _structure.data(), _structure.size()))
+	{
+		_result.failedReads++;
+		return;
+	}
+
+	const uint8_t* s = _structure.data();
+	WalkedStructure w{};
+	w.address = address;
+	w.name = Field<uint32_t>(s, _layout.structureName);
+	w.base = Field<uint64_t>(s, _layout.structureBase);
+	w.baseOffset = Field<uint64_t>(s, _layout.structureBaseOffset);
+	w.size = Field<uint64_t>(s, _layout.structureStructureSize);
+	w.flags = static_cast<uint16_t>(UIntField(s, _layout.structureFlags, _layout.structureFlagsSize));
+	w.align = Field<uint16_t>(s, _layout.structureAlign);
+	w.versionMajor = Field<uint16_t>(s, _layout.structureVersionMajor);
+	w.versionMinor = Field<uint16_t>(s, _layout.structureVersionMinor);
+	w.extraAttributes = Field<uint64_t>(s, _layout.structureExtraAttributes);
+	w.extraAttributeList = AddAttributeList(w.extraAttributes);
+	w.factoryNew = Field<uint64_t>(s, _layout.structureFactoryNew + delegateFunc);
+	w.factoryPlacementNew = Field<uint64_t>(s, _layout.structureFactoryPlacementNew + delegateFunc);
+	w.getStructureCB = Field<uint64_t>(s, _layout.structureGetStructureCB + delegateFunc);
+	w.factoryDelete = Field<uint64_t>(s, _layout.structureFactoryDelete + delegateFunc);
+	w.firstMemberName = UINT32_MAX;
+	AddCallbacks(s, w);
+
+	const uint64_t membersItems = Field<uint64_t>(s, _layout.structureMembers + arrayItems);
+	const uint16_t membersCount = Field<uint16_t>(s, _layout.structureMembers + arrayCount);
+	if (!ReadPointers(membersItems, membersCount, _members))
+	{
+		_result.failedReads++;
+		return;
+	}
+
+	if (_annotations != nullptr)
+	{
+		if (auto align = _annotations->FindAnnotation(address, MemorySnapshotAnnotationKind::StructureAlign))
+		{
+			w.align = static_cast<uint16_t>(*align);
+		}
+
+		if (auto staticData = _annotations->FindAnnotation(address, MemorySnapshotAnnotationKind::StructureStaticData))
+		{
+			w.nameStr = _reader.ReadString(_reader.Read<uint64_t>(*staticData + _layout.staticDataNameStr).value_or(0));
+			const uint64_t memberNames = _reader.Read<uint64_t>(*staticData + _layout.staticDataMemberNames).value_or(0);
+			if (memberNames != 0 && ReadPointers(memberNames, membersCount, _names))
+			{
+				w.firstMemberName = static_cast<uint32_t>(_result.memberNames.size());
+				for (uint64_t name : _names)
+				{
+					_result.memberNames.push_back(_reader.ReadString(name));
+				}
+			}
+		}
+	}
+
+	// reserve the slots of the top-level members first, so they are contiguous; nested members are appended after them
+	w.firstMember = static_cast<uint32_t>(_result.members.size());
+	w.memberCount = membersCount;
+	_result.members.resize(_result.members.size() + membersCount);
+	for (size_t i = 0; i < _members.size(); i++)
+	{
+		if (!ReadMember(_members[i], w.firstMember + i))
+		{
+			_result.failedReads++;
+		}
+	}
+
+	_result.structureIndices.emplace(address, static_cast<uint32_t>(_result.structures.size()));
+	_result.structures.push_back(w);
+}
+
+int32_t ParWalker::WalkMember(uint64_t address)
+{
+	if (address == 0)
+	{
+		return -1;
+	}
+
+	const size_t index = _result.members.size();
+	_result.members.emplace_back();
+	if (!ReadMember(address, index))
+	{
+		_result.failedReads++;
+		return -1;
+	}
+	return static_cast<int32_t>(index);
+}
+
+bool ParWalker::ReadMember(uint64_t address, size_t index)
+{
+	// vftable and data pointer, the item/key/value pointers are only read for arrays and maps
+	std::array<uint8_t, 32> member;
+	std::array<uint8_t, 64> data;
+	if (!_reader.Read(address, member.data(), _layout.memberData + 8))
+	{
+		return false;
+	}
+
+	const uint64_t dataAddress = Field<uint64_t>(member.data(), _layout.memberData);
+	if (dataAddress == 0 || !_reader.Read(dataAddress, data.data(), _layout.dataSize))
+	{
+		return false;
+	}
+
+	const uint8_t* d = data.data();
+	WalkedMember m{};
+	m.address = address;
+	m.data = dataAddress;
+	m.name = Field<uint32_t>(d, 0);
+	m.offset = Field<uint64_t>(d, _layout.dataOffset);
+	m.type = Field<uint8_t>(d, _layout.dataType);
+	m.subType = Field<uint8_t>(d, _layout.dataSubType);
+	m.flags1 = Field<uint16_t>(d, _layout.dataFlags1);
+	m.flags2 = Field<uint16_t>(d, _layout.dataFlags2);
+	m.extraData = Field<uint16_t>(d, _layout.dataExtraData);
+	m.attributes = Field<uint64_t>(d, _layout.dataAttributes);
+	m.attributeList = AddAttributeList(m.attributes);
+	if (_annotations != nullptr)
+	{
+		if (auto size = _annotations->FindAnnotation(address, MemorySnapshotAnnotationKind::MemberSize))
+		{
+			m.size = static_cast<uint32_t>(*size);
+		}
+		if (auto align = _annotations->FindAnnotation(address, MemorySnapshotAnnotationKind::MemberAlign))
+		{
+			m.align = static_cast<uint32_t>(*align);
+		}
+	}
+
+	uint64_t item = 0, key = 0, value = 0;
+	switch (static_cast<ParLayoutMemberType>(m.type))
+	{
+	case ParLayoutMemberType::STRUCT:
+		if (_reader.Read(dataAddress + _layout.dataStructStructure, data.data(), _layout.dataStructAllocateStruct + 8 - _layout.dataStructStructure))
+		{
+			m.structure = Field<uint64_t>(d, 0);
+			m.functions[0] = Field<uint64_t>(d, _layout.dataStructExternalNamedResolve - _layout.dataStructStructure);
+			m.functions[1] = Field<uint64_t>(d, _layout.dataStructExternalNamedGetName - _layout.dataStructStructure);
+			m.functions[2] = Field<uint64_t>(d, _layout.dataStructAllocateStruct - _layout.dataStructStructure);
+		}
+		break;
+	case ParLayoutMemberType::ENUM:
+	case ParLayoutMemberType::BITSET:
+		if (_reader.Read(dataAddress + _layout.dataEnumInitValue, data.data(), _layout.dataEnumEnumData + 8 - _layout.dataEnumInitValue))
+		{
+			m.initValue = IntField(d, 0, _layout.dataEnumInitValueSize);
+			m.enumData = Field<uint64_t>(d, _layout.dataEnumEnumData - _layout.dataEnumInitValue);
+		}
+		AddEnum(m.enumData);
+		break;
+	case ParLayoutMemberType::ARRAY:
+		m.arraySize = _reader.Read<uint32_t>(dataAddress + _layout.dataArraySize).value_or(0);
+		if (_reader.Read(address + _layout.memberArrayItem, member.data(), 8))
+		{
+			item = Field<uint64_t>(member.data(), 0);
+		}
+		break;
+	case ParLayoutMemberType::MAP:
+		if (_reader.Read(address + _layout.memberMapKey, member.data(), _layout.memberMapValue + 8 - _layout.memberMapKey))
+		{
+			key = Field<uint64_t>(member.data(), 0);
+			value = Field<uint64_t>(member.data(), _layout.memberMapValue - _layout.memberMapKey);
+		}
+		m.functions[0] = ReadDelegateFunction(_reader.Read<uint64_t>(dataAddress + _layout.dataMapCreateIterator).value_or(0));
+		m.functions[1] = ReadDelegateFunction(_reader.Read<uint64_t>(dataAddress + _layout.dataMapCreateInterface).value_or(0));
+		break;
+	case ParLayoutMemberType::STRING:
+		m.arraySize = _reader.Read<uint32_t>(dataAddress + _layout.dataStringMemberSize).value_or(0);
+		break;
+	default:
+		AddInitValues(dataAddress, m);
+		break;
+	}
+
+	_result.members[index] = m;
+
+	// may reallocate the members vector, `m` is a copy
+	if (item != 0)
+	{
+		const int32_t itemIndex = WalkMember(item);
+		_result.members[index].item = itemIndex;
+	}
+	if (key != 0 || value != 0)
+	{
+		const int32_t keyIndex = WalkMember(key);
+		const int32_t valueIndex = WalkMember(value);
+		_result.members[index].item = keyIndex;
+		_result.members[index].value = valueIndex;
+	}
+	return true;
+}
+
+void ParWalker::AddEnum(uint64_t address)
+{
+	if (address == 0 || !_result.enumIndices.try_emplace(address, static_cast<uint32_t>(_result.enums.size())).second)
+	{
+		return;
+	}
+
+	std::array<uint8_t, 32> data;
+	if (!_reader.Read(address, data.data(), _layout.enumSize))
+	{
+		_result.failedReads++;
+		return;
+	}
+
+	const uint8_t* e = data.data();
+	WalkedEnum w{};
+	w.address = address;
+	w.name = Field<uint32_t>(e, _layout.enumName);
+	w.flags = Field<uint16_t>(e, _layout.enumFlags);
+	w.valueCount = Field<uint16_t>(e, _layout.enumValueCount);
+	w.firstValue = static_cast<uint32_t>(_result.enumValues.size());
+
+	// the values array in a single read, then the names
+	const uint64_t values = Field<uint64_t>(e, 0);
+	std::vector<uint8_t> valuesData(size_t{ w.valueCount } * _layout.enumValueSize);
+	if (!_reader.Read(values, valuesData.data(), valuesData.size()))
+	{
+		_result.failedReads++;
+		w.valueCount = 0;
+	}
+
+	const uint64_t valueNames = Field<uint64_t>(e, _layout.enumValueNames);
+	const bool hasNames = valueNames != 0 && ReadPointers(valueNames, w.valueCount, _names);
+	for (size_t i = 0; i < w.valueCount; i++)
+	{
+		const uint8_t* v = valuesData.data() + i * _layout.enumValueSize;
+		_result.enumValues.push_back({
+			Field<uint32_t>(v, 0),
+			IntField(v, _layout.enumValueValue, _layout.enumValueSize - _layout.enumValueValue),
+			hasNames ? _reader.ReadString(_names[i]) : std::string_view{},
+		});
+	}
+
+	_result.enums.push_back(w);
+}
+
+int32_t ParWalker::AddAttributeList(uint64_t address)
+{
+	if (address == 0)
+	{
+		return -1;
+	}
+
+	std::array<uint8_t, 32> list;
+	if (!_reader.Read(address, list.data(), _layout.attributeListSize))
+	{
+		_result.failedReads++;
+		return -1;
+	}
+
+	WalkedAttributeList w{};
+	w.userData1 = Field<uint8_t>(list.data(), _layout.attributeListUserData1);
+	w.userData2 = Field<uint8_t>(list.data(), _layout.attributeListUserData2);
+	w.firstAttribute = static_cast<uint32_t>(_result.attributes.size());
+	w.attributeCount = Field<uint16_t>(list.data(), arrayCount);
+
+	std::vector<uint8_t> attributes(size_t{ w.attributeCount } * _layout.attributeSize);
+	if (!_reader.Read(Field<uint64_t>(list.data(), arrayItems), attributes.data(), attributes.size()))
+	{
+		_result.failedReads++;
+		return -1;
+	}
+
+	for (size_t i = 0; i < w.attributeCount; i++)
+	{
+		const uint8_t* a = attributes.data() + i * _layout.attributeSize;
+		const uint8_t type = Field<uint8_t>(a, _layout.attributeType);
+		const uint64_t value = Field<uint64_t>(a, _layout.attributeValue);
+		_result.attributes.push_back({
+			_reader.ReadString(Field<uint64_t>(a, attributeName)),
+			type,
+			value,
+			type == attributeTypeString ? _reader.ReadString(value) : std::string_view{},
+		});
+	}
+
+	_result.attributeLists.push_back(w);
+	return static_cast<int32_t>(_result.attributeLists.size() - 1);
+}
+
+void ParWalker::AddCallbacks(const uint8_t* structure, WalkedStructure& w)
+{
+	const uint64_t pairs = Field<uint64_t>(structure, _layout.structureCallbacks + binaryMapPairs + arrayItems);
+	w.firstCallback = static_cast<uint32_t>(_result.callbacks.size());
+	w.callbackCount = Field<uint16_t>(structure, _layout.structureCallbacks + binaryMapPairs + arrayCount);
+
+	std::vector<uint8_t> pairsData(size_t{ w.callbackCount } * callbackPairSize);
+	if (!_reader.Read(pairs, pairsData.data(), pairsData.size()))
+	{
+		_result.failedReads++;
+		w.callbackCount = 0;
+		return;
+	}
+
+	for (size_t i = 0; i < w.callbackCount; i++)
+	{
+		const uint8_t* p = pairsData.data() + i * callbackPairSize;
+		_result.callbacks.push_back({ Field<uint32_t>(p, 0), ReadDelegateFunction(Field<uint64_t>(p, callbackPairValue)) });
+	}
+}
+
+void ParWalker::AddInitValues(uint64_t dataAddress, WalkedMember& m)
+{
+	using enum ParLayoutMemberType;
+
+	size_t count = 0;
+	switch (static_cast<ParLayoutMemberType>(m.type))
+	{
+	case BOOL: case CHAR: case UCHAR: case SHORT: case USHORT: case INT: case UINT: case FLOAT:
+	case SCALARV: case BOOLV: case PTRDIFFT: case SIZET: case FLOAT16: case INT64: case UINT64: case DOUBLE:
+		count = 1;
+		break;
+	case VECTOR2: case VECTOR3: case VECTOR4: case VEC2V: case VEC3V: case VEC4V: case VECBOOLV: case VEC2F: case QUATV:
+		count = 4;
+		break;
+	case MATRIX34: case MATRIX44: case MAT33V: case MAT34V: case MAT44V:
+		count = 16;
+		break;
+	default:
+		return;
+	}
+
+	// the simple init value is a double where the enum one is 64-bit (RDR3), otherwise all are floats
+	const bool isDouble = count == 1 && _layout.dataEnumInitValueSize == sizeof(double);
+	const uint32_t offset = count == 1 ? _layout.dataSimpleInitValue : _layout.dataInitValues;
+	std::array<float, 16> values;
+	double value;
+	if (!_reader.Read(dataAddress + offset, isDouble ? static_cast<void*>(&value) : values.data(), isDouble ? sizeof(double) : count * sizeof(float)))
+	{
+		_result.failedReads++;
+		return;
+	}
+
+	m.firstInitValue = static_cast<uint32_t>(_result.initValues.size());
+	m.initValueCount = static_cast<uint8_t>(count);
+	if (isDouble)
+	{
+		_result.initValues.push_back(value);
+	}
+	else
+	{
+		_result.initValues.insert(_result.initValues.end(), values.begin(), values.begin() + count);
+	}
+}
+
+uint64_t ParWalker::ReadDelegateFunction(uint64_t holder)
+{
+	return holder != 0 ? _reader.Read<uint64_t>(holder + delegateFunc).value_or(0) : 0;
+}
+
+bool ParWalker::ReadPointers(uint64_t address, size_t count, std::vector<uint64_t>& pointers)
+{
+	pointers.resize(count);
+	return count == 0 || (address != 0 && _reader.Read(address, pointers.data(), count * sizeof(uint64_t)));
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include "MemorySnapshot.h"
+#include "ParLayout.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// A parMember and its parMemberCommonData as read by ParWalker. Fields that only apply to some types are zero otherwise.
+struct WalkedMember
+{
+	uint64_t address;       // parMember
+	uint64_t data;          // parMemberCommonData
+	uint32_t name;
+	uint64_t offset;
+	uint8_t type;
+	uint8_t subType;
+	uint16_t flags1;
+	uint16_t flags2;
+	uint16_t extraData;
+	uint64_t attributes;
+	int32_t attributeList = -1; // in ParWalkResult::attributeLists
+	uint64_t structure;     // STRUCT: parStructure
+	uint64_t enumData;      // ENUM, BITSET: parEnumData
+	int64_t initValue;      // ENUM, BITSET
+	uint32_t arraySize;     // ARRAY: arraySize or countOffset, STRING: memberSize
+	int32_t item = -1;      // ARRAY: index of the item in ParWalkResult::members, MAP: index of the key
+	int32_t value = -1;     // MAP: index of the value
+	// STRUCT: externalNamedResolve, externalNamedGetName, allocateStruct; MAP: the functions of createIterator and
+	// createInterface
+	std::array<uint64_t, 3> functions;
+	uint32_t firstInitValue; // in ParWalkResult::initValues: 1 for the simple types, 4 for the vectors, 16 for the matrices
+	uint8_t initValueCount;
+	std::optional<uint32_t> size;  // snapshot annotations, these need a call into the game
+	std::optional<uint32_t> align;
+};
+
+struct WalkedStructure
+{
+	uint64_t address;
+	uint32_t name;
+	std::string_view nameStr; // from the parStructureStaticData, empty if not available
+	uint64_t base;
+	uint64_t baseOffset;
+	uint64_t size;
+	uint16_t flags;
+	uint16_t align;           // parStructure::FindAlign() if annotated, otherwise the cached parStructure::align
+	uint16_t versionMajor;
+	uint16_t versionMinor;
+	uint64_t extraAttributes;
+	int32_t extraAttributeList; // in ParWalkResult::attributeLists, -1 if none
+	uint64_t factoryNew;
+	uint64_t factoryPlacementNew;
+	uint64_t getStructureCB;
+	uint64_t factoryDelete;
+	uint32_t firstCallback;   // in ParWalkResult::callbacks
+	uint32_t callbackCount;
+	uint32_t firstMember;     // members of the structure are [firstMember, firstMember + memberCount) in ParWalkResult::members
+	uint32_t memberCount;
+	uint32_t firstMemberName; // in ParWalkResult::memberNames if the static data has member names, otherwise UINT32_MAX
+};
+
+struct WalkedAttribute
+{
+	std::string_view name;
+	uint8_t type;             // parAttribute::Type
+	uint64_t value;           // the bits of the int64/double/bool value
+	std::string_view string;  // the value of the String attributes
+};
+
+struct WalkedAttributeList
+{
+	uint8_t userData1;
+	uint8_t userData2;
+	uint32_t firstAttribute;  // in ParWalkResult::attributes
+	uint32_t attributeCount;
+};
+
+struct WalkedCallback
+{
+	uint32_t name;
+	uint64_t function;
+};
+
+struct WalkedEnumValue
+{
+	uint32_t name;
+	int64_t value;
+	std::string_view nameStr; // empty if the enum has no value names
+};
+
+struct WalkedEnum
+{
+	uint64_t address;
+	uint32_t name;
+	uint16_t flags;
+	uint32_t firstValue;      // in ParWalkResult::enumValues
+	uint32_t valueCount;
+};
+
+// Everything CollectStructs finds in the parManager, plus the member and enum details used by the dump.
+struct ParWalkResult
+{
+	std::vector<WalkedStructure> structures;
+	std::vector<WalkedMember> members;       // top-level members of each structure, then the array items and map keys/values
+	std::vector<std::string_view> memberNames;
+	std::vector<WalkedEnum> enums;
+	std::vector<WalkedEnumValue> enumValues;
+	std::vector<double> initValues;          // the float ones widened to double
+	std::vector<WalkedAttributeList> attributeLists;
+	std::vector<WalkedAttribute> attributes;
+	std::vector<WalkedCallback> callbacks;
+	std::unordered_map<uint64_t, uint32_t> structureIndices; // by address
+	std::unordered_map<uint64_t, uint32_t> enumIndices;      // by address
+	size_t failedReads = 0;                  // objects skipped because their memory was not available
+
+	const WalkedStructure* FindStructure(uint64_t address) const;
+	const WalkedEnum* FindEnum(uint64_t address) const;
+};
+
+// Walks the parser metadata of the 64-bit games out of process, through a MemoryReader and the ParLayout of the game,
+// instead of the rage.h structures. Each object is fetched with a single read of its whole size and the fields are picked
+// from the local copy, arrays of pointers (buckets, members) are also read at once.
+class ParWalker
+{
+public:
+	ParWalker(MemoryReader& reader, const ParLayout& layout, const MemorySnapshot* annotations = nullptr);
+
+	ParWalkResult Walk(uint64_t parManager);
+
+private:
+	void WalkStructure(uint64_t address);
+	int32_t WalkMember(uint64_t address);
+	bool ReadMember(uint64_t address, size_t index);
+	void AddEnum(uint64_t address);
+	int32_t AddAttributeList(uint64_t address);
+	void AddCallbacks(const uint8_t* structure, WalkedStructure& w);
+	void AddInitValues(uint64_t dataAddress, WalkedMember& m);
+
+	// function of a parDelegateHolderBase, 0 if the holder is null
+	uint64_t ReadDelegateFunction(uint64_t holder);
+	bool ReadPointers(uint64_t address, size_t count, std::vector<uint64_t>& pointers);
+
+	MemoryReader& _reader;
+	const ParLayout& _layout;
+	const MemorySnapshot* _annotations;
+	ParWalkResult _result;
+	std::vector<uint8_t> _structure;
+	std::vector<uint64_t> _members;
+	std::vector<uint64_t> _names;
+};
@@ -0,0 +1,196 @@
+#include "Commands.h"
+#include "MappedFile.h"
+#include "Patterns.h"
+#include "PatternScanner.h"
+#include "PeImage.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct BenchPattern
+	{
+		std::string_view text;
+		std::vector<uint8_t> bytes;
+		std::vector<uint8_t> mask;
+		size_t planted;
+		std::vector<size_t> naiveMatches;
+		size_t scannerIndex;
+	};
+}
+
+static BenchPattern ParseBenchPattern(std::string_view text)
+{
+	BenchPattern p{ text };
+	for (size_t pos = 0; pos < text.size(); pos++)
+	{
+		if (text[pos] == ' ')
+		{
+			continue;
+		}
+
+		if (text[pos] == '?')
+		{
+			p.bytes.push_back(0);
+			p.mask.push_back(0x00);
+			pos += pos + 1 < text.size() && text[pos + 1] == '?';
+		}
+		else
+		{
+			p.bytes.push_back(static_cast<uint8_t>(std::stoul(std::string{ text.substr(pos, 2) }, nullptr, 16)));
+			p.mask.push_back(0xFF);
+			pos++;
+		}
+	}
+	return p;
+}
+
+// Byte distribution roughly like x86 code: lots of zeros, int3 padding, REX prefixes and movs, so first-byte filters on
+// common bytes get as many false candidates as they would in a real executable.
+static std::vector<uint8_t> GenerateHaystack(size_t size, std::mt19937& rng)
+{
+	constexpr uint8_t common[]{ 0x00, 0x00, 0x00, 0x00, 0xCC, 0xCC, 0x48, 0x48, 0x8B, 0x89, 0x8D, 0xFF, 0xE8, 0x0F, 0x4C, 0x24 };
+	std::uniform_int_distribution<uint32_t> dist{ 0, 255 };
+	std::vector<uint8_t> haystack(size);
+	for (auto& b : haystack)
+	{
+		const uint32_t r = dist(rng);
+		b = r < 128 ? common[r % std::size(common)] : static_cast<uint8_t>(dist(rng));
+	}
+	return haystack;
+}
+
+// One full pass per pattern, as hook::get_pattern does.
+static void NaiveScan(const uint8_t* data, size_t size, BenchPattern& p)
+{
+	p.naiveMatches.clear();
+	const size_t length = p.bytes.size();
+	for (size_t pos = 0; pos + length <= size && p.naiveMatches.size() < PatternScanner::MaxMatchesPerPattern; pos++)
+	{
+		size_t i = 0;
+		while (i < length && (data[pos + i] & p.mask[i]) == p.bytes[i])
+		{
+			i++;
+		}
+
+		if (i == length)
+		{
+			p.naiveMatches.push_back(pos);
+		}
+	}
+}
+
+template<class TFunc>
+static double BestOf(int iterations, TFunc func)
+{
+	double best = 0.0;
+	for (int i = 0; i < iterations; i++)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		best = i == 0 ? seconds : std::min(best, seconds);
+	}
+	return best;
+}
+
+int BenchPatterns(size_t sizeMiB, const char* executablePath)
+{
+	std::mt19937 rng{ 1234 };
+
+	std::vector<uint8_t> haystack;
+	if (executablePath != nullptr)
+	{
+		MappedFile file;
+		PeImage image;
+		std::string error;
+		if (!file.Open(executablePath))
+		{
+			std::fprintf(stderr, "Failed to open '%s'\n", executablePath);
+			return 1;
+		}
+		if (!image.Load(file.Data(), file.Size(), false, error))
+		{
+			std::fprintf(stderr, "%s: %s\n", executablePath, error.c_str());
+			return 1;
+		}
+		haystack.assign(image.Image(), image.Image() + image.ImageSize());
+	}
+	else
+	{
+		haystack = GenerateHaystack(sizeMiB * 1024 * 1024, rng);
+	}
+
+	// the patterns of every game, each planted once in its own slot of the buffer with random wildcard bytes
+	std::vector<BenchPattern> patterns;
+	for (auto game : { "rdr3", "rdr2", "gta5", "gta5g9", "mp3", "gta4" })
+	{
+		for (auto& info : GetPatterns(game))
+		{
+			if (std::none_of(patterns.begin(), patterns.end(), [&](auto& p) { return p.text == info.pattern; }))
+			{
+				patterns.push_back(ParseBenchPattern(info.pattern));
+			}
+		}
+	}
+
+	const size_t slotSize = haystack.size() / patterns.size();
+	std::uniform_int_distribution<uint32_t> byteDist{ 0, 255 };
+	for (size_t i = 0; i < patterns.size(); i++)
+	{
+		auto& p = patterns[i];
+		if (slotSize < p.bytes.size())
+		{
+			std::fprintf(stderr, "Buffer too small\n");
+			return 1;
+		}
+
+		p.planted = slotSize * i + std::uniform_int_distribution<size_t>{ 0, slotSize - p.bytes.size() }(rng);
+		for (size_t j = 0; j < p.bytes.size(); j++)
+		{
+			haystack[p.planted + j] = p.mask[j] ? p.bytes[j] : static_cast<uint8_t>(byteDist(rng));
+		}
+	}
+
+	PatternScanner scanner;
+	for (auto& p : patterns)
+	{
+		p.scannerIndex = scanner.Add(p.text);
+	}
+
+	constexpr int iterations = 5;
+	const double naiveSeconds = BestOf(iterations, [&]
+	{
+		for (auto& p : patterns)
+		{
+			NaiveScan(haystack.data(), haystack.size(), p);
+		}
+	});
+	const double scannerSeconds = BestOf(iterations, [&] { scanner.Scan(haystack.data(), haystack.size()); });
+
+	size_t failures = 0;
+	for (auto& p : patterns)
+	{
+		const auto matches = scanner.Matches(p.scannerIndex);
+		const bool found = std::find(matches.begin(), matches.end(), p.planted) != matches.end();
+		const bool same = std::equal(matches.begin(), matches.end(), p.naiveMatches.begin(), p.naiveMatches.end());
+		if (!found || !same)
+		{
+			std::printf("  FAIL %.*s: planted at 0x%zX, %zu matches (naive %zu)\n",
+				static_cast<int>(p.text.size()), p.text.data(), p.planted, matches.size(), p.naiveMatches.size());
+			failures++;
+		}
+	}
+
+	const double mib = haystack.size() / (1024.0 * 1024.0);
+	std::printf("%zu patterns in %.1f MiB (%s), best of %d\n", patterns.size(), mib, executablePath != nullptr ? executablePath : "synthetic", iterations);
+	std::printf("  naive:   %8.2f ms  %8.1f MiB/s\n", naiveSeconds * 1000.0, mib / naiveSeconds);
+	std::printf("  scanner: %8.2f ms  %8.1f MiB/s  %.1fx  (%s, %zu candidates)\n", scannerSeconds * 1000.0, mib / scannerSeconds,
+		naiveSeconds / scannerSeconds, PatternScanner::UsesAvx2() ? "AVX2" : "SSE2", scanner.CandidateCount());
+	std::printf("%zu failures\n", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+#include "Commands.h"
+#include "PatternCache.h"
+#include "Patterns.h"
+#include "PatternScanner.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	// What resolving the patterns with a cache file did.
+	struct CacheOutcome
+	{
+		PatternCacheLoadResult loadResult;
+		size_t numCached = 0;      // patterns whose cached RVA still matched
+		size_t numInvalid = 0;     // cached RVAs that no longer matched
+		bool scanned = false;
+		bool rewritten = false;    // the file contents changed
+		bool resolvedAll = false;  // every pattern resolved to where it was planted
+	};
+
+	struct CacheCase
+	{
+		const char* name;
+		std::optional<std::string> contents; // nullopt for no file
+		PatternCacheLoadResult loadResult;
+		size_t numCached;
+		size_t numInvalid;
+		bool scanned;
+		bool rewritten;
+	};
+}
+
+static const char* LoadResultToStr(PatternCacheLoadResult result)
+{
+	switch (result)
+	{
+	case PatternCacheLoadResult::Loaded: return "loaded";
+	case PatternCacheLoadResult::Missing: return "missing";
+	case PatternCacheLoadResult::Stale: return "stale";
+	case PatternCacheLoadResult::Corrupt: return "corrupt";
+	}
+	return "unknown";
+}
+
+static std::optional<std::string> ReadFile(const std::string& path)
+{
+	std::ifstream in{ path, std::ios::in | std::ios::binary };
+	if (!in)
+	{
+		return std::nullopt;
+	}
+
+	std::ostringstream contents;
+	contents << in.rdbuf();
+	return contents.str();
+}
+
+// Writes the pattern bytes at `pos`, wildcards keep the random bytes already there.
+static void PlantPattern(std::vector<uint8_t>& buffer, size_t pos, std::string_view pattern)
+{
+	for (size_t i = 0; i < pattern.size(); i++)
+	{
+		if (pattern[i] == ' ')
+		{
+			continue;
+		}
+
+		if (pattern[i] == '?')
+		{
+			i += i + 1 < pattern.size() && pattern[i + 1] == '?';
+		}
+		else
+		{
+			buffer[pos] = static_cast<uint8_t>(std::stoul(std::string{ pattern.substr(i, 2) }, nullptr, 16));
+			i++;
+		}
+		pos++;
+	}
+}
+
+static std::string KeyLine(const PatternCacheKey& key)
+{
+	char buffer[128];
+	std::snprintf(buffer, sizeof(buffer), "key %u.%u.%u.%u %08X %08X %08X\n",
+		key.build[0], key.build[1], key.build[2], key.build[3], key.timeDateStamp, key.checkSum, key.sizeOfImage);
+	return buffer;
+}
+
+static std::string EntryLine(size_t rva, std::string_view pattern)
+{
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%08zX ", rva);
+	return buffer + std::string{ pattern } + "\n";
+}
+
+// Same steps as InitPatterns in DumpStructs: trust the cached RVAs that still match, scan for the rest and save the cache
+// if it changed.
+static CacheOutcome ResolveWithCache(const std::string& cachePath, const PatternCacheKey& key, std::span<const PatternInfo> patterns,
+	const std::vector<uint8_t>& image, const std::vector<size_t>& planted)
+{
+	const auto before = ReadFile(cachePath);
+
+	PatternCache cache{ key };
+	CacheOutcome outcome{ cache.Load(cachePath) };
+
+	PatternScanner scanner;
+	std::vector<std::optional<size_t>> resolved(patterns.size());
+	for (size_t i = 0; i < patterns.size(); i++)
+	{
+		const size_t index = scanner.Add(patterns[i].pattern);
+		const auto cachedRva = cache.Find(patterns[i].pattern);
+		if (cachedRva.has_value() && scanner.IsMatch(index, image.data(), image.size(), cachedRva.value()))
+		{
+			resolved[i] = cachedRva;
+			outcome.numCached++;
+		}
+		else if (cachedRva.has_value())
+		{
+			cache.Remove(patterns[i].pattern);
+			outcome.numInvalid++;
+		}
+	}
+
+	outcome.scanned = outcome.numCached != patterns.size();
+	if (outcome.scanned)
+	{
+		scanner.Scan(image.data(), image.size());
+		for (size_t i = 0; i < patterns.size(); i++)
+		{
+			const auto matches = scanner.Matches(scanner.Find(patterns[i].pattern));
+			if (!resolved[i].has_value() && !matches.empty())
+			{
+				resolved[i] = matches[0];
+				cache.Set(patterns[i].pattern, matches[0]);
+			}
+		}
+	}
+
+	if (cache.IsDirty())
+	{
+		cache.Save(cachePath);
+	}
+
+	outcome.rewritten = ReadFile(cachePath) != before;
+	outcome.resolvedAll = true;
+	for (size_t i = 0; i < patterns.size(); i++)
+	{
+		outcome.resolvedAll = outcome.resolvedAll && resolved[i] == planted[i];
+	}
+	return outcome;
+}
+
+int CheckPatternCache()
+{
+	// a random buffer standing in for the executable image, with every GTA5 pattern planted once
+	const auto patterns = GetPatterns("gta5");
+	const size_t spacing = 64 * 1024;
+	std::mt19937 rng{ 1234 };
+	std::uniform_int_distribution<uint32_t> byteDist{ 0, 255 };
+	std::vector<uint8_t> image((patterns.size() + 1) * spacing);
+	for (auto& b : image)
+	{
+		b = static_cast<uint8_t>(byteDist(rng));
+	}
+
+	std::vector<size_t> planted;
+	for (size_t i = 0; i < patterns.size(); i++)
+	{
+		planted.push_back((i + 1) * spacing - 0x123 * i);
+		PlantPattern(image, planted.back(), patterns[i].pattern);
+	}
+
+	const PatternCacheKey key{ { 1, 0, 2944, 0 }, 0x5F3E1A2B, 0x03A1B2C4, static_cast<uint32_t>(image.size()) };
+	const std::string header = "DumpStructs pattern cache 1\n";
+	std::string entries;
+	for (size_t i = 0; i < patterns.size(); i++)
+	{
+		entries += EntryLine(planted[i], patterns[i].pattern);
+	}
+	const std::string valid = header + KeyLine(key) + entries;
+
+	auto withKey = [&](auto change)
+	{
+		PatternCacheKey k = key;
+		change(k);
+		return header + KeyLine(k) + entries;
+	};
+
+	const size_t n = patterns.size();
+	const size_t firstLineEnd = entries.find('\n') + 1;
+	const size_t keyLineEnd = valid.find('\n', header.size()) + 1;
+	const std::string wrongRva = header + KeyLine(key) + EntryLine(planted[0] + 1, patterns[0].pattern) + entries.substr(firstLineEnd);
+
+	std::string garbage(4096, '\0');
+	for (char& c : garbage)
+	{
+		c = static_cast<char>(byteDist(rng));
+	}
+
+	using enum PatternCacheLoadResult;
+	const CacheCase cases[]
+	{
+		{ "no file", std::nullopt, Missing, 0, 0, true, true },
+		{ "valid", valid, Loaded, n, 0, false, false },
+		{ "valid, an RVA that no longer matches", wrongRva, Loaded, n - 1, 1, true, true },
+		{ "valid, a pattern missing", header + KeyLine(key) + entries.substr(firstLineEnd), Loaded, n - 1, 0, true, true },
+		{ "valid, an extra pattern", valid + EntryLine(0x1000, "11 22 33 44 55 66"), Loaded, n, 0, false, false },
+		{ "wrong build", withKey([](PatternCacheKey& k) { k.build[2] = 3095; }), Stale, 0, 0, true, true },
+		{ "wrong TimeDateStamp", withKey([](PatternCacheKey& k) { k.timeDateStamp++; }), Stale, 0, 0, true, true },
+		{ "wrong CheckSum", withKey([](PatternCacheKey& k) { k.checkSum = 0; }), Stale, 0, 0, true, true },
+		{ "wrong SizeOfImage", withKey([](PatternCacheKey& k) { k.sizeOfImage += 0x1000; }), Stale, 0, 0, true, true },
+		{ "empty file", std::string{}, Corrupt, 0, 0, true, true },
+		{ "truncated in the header", header.substr(0, 10), Corrupt, 0, 0, true, true },
+		{ "truncated in the key", valid.substr(0, keyLineEnd - 10), Corrupt, 0, 0, true, true },
+		// the SizeOfImage cut short is still a number, just a different one
+		{ "truncated in the last key number", valid.substr(0, keyLineEnd - 4), Stale, 0, 0, true, true },
+		{ "truncated after the key", valid.substr(0, keyLineEnd), Loaded, 0, 0, true, true },
+		{ "truncated in an RVA", valid.substr(0, keyLineEnd + firstLineEnd + 4), Corrupt, 0, 0, true, true },
+		{ "truncated after an RVA", valid.substr(0, keyLineEnd + firstLineEnd + 8), Corrupt, 0, 0, true, true },
+		{ "truncated in a pattern", valid.substr(0, keyLineEnd + firstLineEnd + 15), Loaded, 1, 0, true, true },
+		{ "wrong version", "DumpStructs pattern cache 2\n" + KeyLine(key) + entries, Corrupt, 0, 0, true, true },
+		{ "garbage key", header + "key 1.0.2944 5F3E1A2B 03A1B2C4\n" + entries, Corrupt, 0, 0, true, true },
+		{ "garbage line", header + KeyLine(key) + entries.substr(0, firstLineEnd) + "this is not an entry\n" + entries.substr(firstLineEnd), Corrupt, 0, 0, true, true },
+		{ "blank line", valid + "\n", Corrupt, 0, 0, true, true },
+		{ "RVA not in hex", header + KeyLine(key) + "0x" + entries, Corrupt, 0, 0, true, true },
+		{ "binary garbage", garbage, Corrupt, 0, 0, true, true },
+	};
+
+	const auto cachePath = (fs::temp_directory_path() / "DumpTools_pattern_cache_check.patterns").string();
+	size_t failures = 0;
+	std::printf("%-40s %8s %7s %8s %8s %10s %8s\n", "case", "load", "cached", "invalid", "scanned", "rewritten", "resolved");
+	for (auto& c : cases)
+	{
+		std::error_code ec;
+		fs::remove(cachePath, ec);
+		if (c.contents.has_value())
+		{
+			std::ofstream out{ cachePath, std::ios::out | std::ios::binary | std::ios::trunc };
+			out.write(c.contents->data(), c.contents->size());
+		}
+
+		const auto outcome = ResolveWithCache(cachePath, key, patterns, image, planted);
+
+		// whatever the file was, the next run must find every pattern in the cache and leave it as is
+		const auto next = ResolveWithCache(cachePath, key, patterns, image, planted);
+
+		const bool ok = outcome.loadResult == c.loadResult && outcome.numCached == c.numCached &&
+			outcome.numInvalid == c.numInvalid && outcome.scanned == c.scanned && outcome.rewritten == c.rewritten &&
+			outcome.resolvedAll && next.loadResult == Loaded && next.numCached == n && !next.scanned && !next.rewritten &&
+			next.resolvedAll;
+		failures += ok ? 0 : 1;
+		std::printf("%-40s %8s %3zu/%-3zu %8zu %8s %10s %8s%s\n", c.name, LoadResultToStr(outcome.loadResult), outcome.numCached, n,
+			outcome.numInvalid, outcome.scanned ? "yes" : "no", outcome.rewritten ? "yes" : "no", outcome.resolvedAll ? "all" : "NOT ALL",
+			ok ? "" : "  FAILED");
+	}
+
+	std::error_code ec;
+	fs::remove(cachePath, ec);
+	std::printf("\n%zu cases, %zu failed\n", std::size(cases), failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+#include "Commands.h"
+#include "MappedFile.h"
+#include "PatternCache.h"
+#include "Patterns.h"
+#include "PatternScanner.h"
+#include "PeImage.h"
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Same format as GetDumpBaseName() in DumpStructs.
+static std::string GetBuildName(std::string_view game, const std::optional<std::array<uint16_t, 4>>& version)
+{
+	if (!version.has_value())
+	{
+		return "unknown build";
+	}
+
+	auto [major, minor, build, revision] = version.value();
+	if (game == "rdr3" || game == "gta5")
+	{
+		return "b" + std::to_string(build);
+	}
+	else if (game == "gta5g9")
+	{
+		return "b" + std::to_string(build) + "g9";
+	}
+	return "b" + std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(build) + "." + std::to_string(revision);
+}
+
+// Applies the offset and resolve kind of the pattern to a match, returns the resulting RVA.
+static std::optional<size_t> Resolve(const PeImage& image, const PatternInfo& info, size_t match)
+{
+	const size_t addr = match + info.offset;
+	switch (info.resolve)
+	{
+	case PatternResolve::None:
+		return addr;
+	case PatternResolve::Address:
+		if (auto rel = image.Read<int32_t>(addr); rel.has_value())
+		{
+			return addr + 4 + rel.value();
+		}
+		break;
+	case PatternResolve::Call:
+		if (auto rel = image.Read<int32_t>(addr + 1); rel.has_value())
+		{
+			return addr + 5 + rel.value();
+		}
+		break;
+	case PatternResolve::Pointer:
+		if (auto va = image.Read<uint32_t>(addr); va.has_value() && va.value() >= image.ImageBase())
+		{
+			return va.value() - image.ImageBase();
+		}
+		break;
+	}
+	return std::nullopt;
+}
+
+static const char* LoadResultToStr(PatternCacheLoadResult result)
+{
+	switch (result)
+	{
+	case PatternCacheLoadResult::Loaded: return "loaded";
+	case PatternCacheLoadResult::Missing: return "missing";
+	case PatternCacheLoadResult::Stale: return "stale, different executable";
+	case PatternCacheLoadResult::Corrupt: return "corrupt";
+	}
+	return "unknown";
+}
+
+int ScanPatterns(std::string_view game, std::span<const char* const> executablePaths, bool mapped, const char* cachePath)
+{
+	const auto patterns = GetPatterns(game);
+	if (patterns.empty())
+	{
+		std::fprintf(stderr, "Unknown game '%.*s'\n", static_cast<int>(game.size()), game.data());
+		return 1;
+	}
+
+	PatternScanner scanner;
+	std::vector<size_t> indices;
+	for (auto& p : patterns)
+	{
+		indices.push_back(scanner.Add(p.pattern));
+	}
+
+	size_t totalHits = 0, totalMisses = 0;
+	for (const char* path : executablePaths)
+	{
+		MappedFile file;
+		PeImage image;
+		std::string error;
+		if (!file.Open(path))
+		{
+			std::printf("%s: failed to open\n", path);
+			totalMisses += patterns.size();
+			continue;
+		}
+		if (!image.Load(file.Data(), file.Size(), mapped, error))
+		{
+			std::printf("%s: %s\n", path, error.c_str());
+			totalMisses += patterns.size();
+			continue;
+		}
+
+		const auto version = image.FileVersion().value_or(std::array<uint16_t, 4>{ 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF });
+		PatternCache cache{ { version, image.TimeDateStamp(), image.CheckSum(), image.SizeOfImage() } };
+		std::vector<std::optional<size_t>> cachedMatches(patterns.size());
+		bool needsScan = true;
+		if (cachePath != nullptr)
+		{
+			const auto loadResult = cache.Load(cachePath);
+			size_t numCached = 0, numInvalid = 0;
+			for (size_t i = 0; i < patterns.size(); i++)
+			{
+				const auto rva = cache.Find(patterns[i].pattern);
+				if (indices[i] != PatternScanner::InvalidPattern && rva.has_value() &&
+					scanner.IsMatch(indices[i], image.Image(), image.ImageSize(), rva.value()))
+				{
+					cachedMatches[i] = rva;
+					numCached++;
+				}
+				else if (rva.has_value())
+				{
+					cache.Remove(patterns[i].pattern);
+					numInvalid++;
+				}
+			}
+
+			needsScan = numCached != patterns.size();
+			std::printf("%s: cache %s, %zu of %zu patterns cached, %zu no longer match\n",
+				path, LoadResultToStr(loadResult), numCached, patterns.size(), numInvalid);
+		}
+
+		double seconds = 0.0;
+		if (needsScan)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			scanner.Scan(image.Image(), image.ImageSize());
+			seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		std::printf("%s: %.*s %s, %s, ", path, static_cast<int>(game.size()), game.data(),
+			GetBuildName(game, image.FileVersion()).c_str(), image.Is64Bit() ? "x64" : "x86");
+		if (needsScan)
+		{
+			std::printf("%.1f MiB scanned in %.1f ms (%zu patterns, single pass)\n",
+				image.ImageSize() / (1024.0 * 1024.0), seconds * 1000.0, scanner.PatternCount());
+		}
+		else
+		{
+			std::printf("all patterns resolved from the cache\n");
+		}
+
+		for (size_t i = 0; i < patterns.size(); i++)
+		{
+			auto& info = patterns[i];
+			const auto matches = cachedMatches[i].has_value() ? std::span<const size_t>{ &cachedMatches[i].value(), 1 } :
+				indices[i] != PatternScanner::InvalidPattern ? scanner.Matches(indices[i]) : std::span<const size_t>{};
+			const auto resolved = matches.empty() ? std::nullopt : Resolve(image, info, matches[0]);
+
+			// like hook::get_pattern, the first match is used but more than one means the pattern should be made unique
+			const char* status = indices[i] == PatternScanner::InvalidPattern ? "INVALID" :
+				!resolved.has_value() ? "MISS" :
+				cachedMatches[i].has_value() ? "CACHED" :
+				matches.size() > 1 ? "MULTI" : "OK";
+			std::printf("  %-8s %-45.*s", status, static_cast<int>(info.name.size()), info.name.data());
+			if (!matches.empty())
+			{
+				std::printf(" match 0x%08zX", matches[0]);
+				if (matches.size() > 1)
+				{
+					std::printf(" (%zu%s matches)", matches.size(), matches.size() >= PatternScanner::MaxMatchesPerPattern ? "+" : "");
+				}
+			}
+			if (resolved.has_value())
+			{
+				std::printf(" -> 0x%08zX", resolved.value());
+			}
+			std::printf("\n");
+
+			if (resolved.has_value())
+			{
+				totalHits++;
+				cache.Set(info.pattern, matches[0]);
+			}
+			else
+			{
+				totalMisses++;
+			}
+		}
+
+		if (cachePath != nullptr && cache.IsDirty() && !cache.Save(cachePath))
+		{
+			std::printf("%s: failed to write cache '%s'\n", path, cachePath);
+		}
+	}
+
+	std::printf("\n%zu hits, %zu misses\n", totalHits, totalMisses);
+	return totalMisses == 0 ? 0 : 1;
+}
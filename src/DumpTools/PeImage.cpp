@@ -0,0 +1,186 @@
+#include "PeImage.h"
+#include <algorithm>
+
+template<class T>
+static bool ReadRaw(const uint8_t* data, size_t size, size_t offset, T& value)
+{
+	if (offset > size || size - offset < sizeof(T))
+	{
+		return false;
+	}
+	std::memcpy(&value, data + offset, sizeof(T));
+	return true;
+}
+
+bool PeImage::Load(const uint8_t* data, size_t size, bool mapped, std::string& error)
+{
+	constexpr uint16_t DosSignature = 0x5A4D; // MZ
+	constexpr uint32_t NtSignature = 0x00004550; // PE\0\0
+	constexpr uint16_t OptionalHeader32Magic = 0x10B;
+	constexpr uint16_t OptionalHeader64Magic = 0x20B;
+	constexpr size_t FileHeaderSize = 20;
+	constexpr size_t SectionHeaderSize = 40;
+	constexpr size_t ResourceDirectoryIndex = 2;
+
+	uint16_t dosSignature;
+	uint32_t ntOffset, ntSignature;
+	if (!ReadRaw(data, size, 0, dosSignature) || dosSignature != DosSignature ||
+		!ReadRaw(data, size, 0x3C, ntOffset) ||
+		!ReadRaw(data, size, ntOffset, ntSignature) || ntSignature != NtSignature)
+	{
+		error = "not a PE file";
+		return false;
+	}
+
+	const size_t fileHeader = ntOffset + 4;
+	const size_t optionalHeader = fileHeader + FileHeaderSize;
+	uint16_t numberOfSections, sizeOfOptionalHeader, magic;
+	uint32_t sizeOfHeaders;
+	if (!ReadRaw(data, size, fileHeader + 2, numberOfSections) ||
+		!ReadRaw(data, size, fileHeader + 4, _timeDateStamp) ||
+		!ReadRaw(data, size, fileHeader + 16, sizeOfOptionalHeader) ||
+		!ReadRaw(data, size, optionalHeader, magic) ||
+		(magic != OptionalHeader32Magic && magic != OptionalHeader64Magic) ||
+		!ReadRaw(data, size, optionalHeader + 56, _sizeOfImage) ||
+		!ReadRaw(data, size, optionalHeader + 60, sizeOfHeaders) ||
+		!ReadRaw(data, size, optionalHeader + 64, _checkSum))
+	{
+		error = "invalid PE headers";
+		return false;
+	}
+
+	_is64Bit = magic == OptionalHeader64Magic;
+	size_t dataDirectories;
+	if (_is64Bit)
+	{
+		ReadRaw(data, size, optionalHeader + 24, _imageBase);
+		dataDirectories = optionalHeader + 112;
+	}
+	else
+	{
+		uint32_t imageBase = 0;
+		ReadRaw(data, size, optionalHeader + 28, imageBase);
+		_imageBase = imageBase;
+		dataDirectories = optionalHeader + 96;
+	}
+	ReadRaw(data, size, dataDirectories + ResourceDirectoryIndex * 8, _resourceRva);
+	ReadRaw(data, size, dataDirectories + ResourceDirectoryIndex * 8 + 4, _resourceSize);
+
+	if (mapped)
+	{
+		_image = data;
+		_imageSize = std::min<size_t>(size, _sizeOfImage);
+		return true;
+	}
+
+	_ownedImage.assign(_sizeOfImage, 0);
+	std::memcpy(_ownedImage.data(), data, std::min<size_t>({ size, sizeOfHeaders, _sizeOfImage }));
+	const size_t sectionHeaders = optionalHeader + sizeOfOptionalHeader;
+	for (size_t i = 0; i < numberOfSections; i++)
+	{
+		const size_t header = sectionHeaders + i * SectionHeaderSize;
+		uint32_t virtualSize, virtualAddress, sizeOfRawData, pointerToRawData;
+		if (!ReadRaw(data, size, header + 8, virtualSize) ||
+			!ReadRaw(data, size, header + 12, virtualAddress) ||
+			!ReadRaw(data, size, header + 16, sizeOfRawData) ||
+			!ReadRaw(data, size, header + 20, pointerToRawData))
+		{
+			error = "invalid section headers";
+			return false;
+		}
+
+		if (pointerToRawData >= size || virtualAddress >= _sizeOfImage)
+		{
+			continue;
+		}
+
+		const size_t rawSize = std::min<size_t>({ sizeOfRawData, virtualSize != 0 ? virtualSize : sizeOfRawData, size - pointerToRawData, _sizeOfImage - virtualAddress });
+		std::memcpy(_ownedImage.data() + virtualAddress, data + pointerToRawData, rawSize);
+	}
+
+	_image = _ownedImage.data();
+	_imageSize = _ownedImage.size();
+	return true;
+}
+
+std::optional<std::array<uint16_t, 4>> PeImage::FileVersion() const
+{
+	constexpr uint32_t VersionResourceType = 16; // RT_VERSION
+	constexpr uint32_t FixedFileInfoSignature = 0xFEEF04BD;
+	constexpr uint32_t SubdirectoryFlag = 0x80000000;
+
+	if (_resourceRva == 0)
+	{
+		return std::nullopt;
+	}
+
+	// returns the offset of the first entry in the directory with the given id, or of the first entry if id is not set
+	const auto findEntry = [this](uint32_t directory, std::optional<uint32_t> id) -> std::optional<uint32_t>
+	{
+		const auto named = Read<uint16_t>(_resourceRva + directory + 12);
+		const auto ids = Read<uint16_t>(_resourceRva + directory + 14);
+		if (!named || !ids)
+		{
+			return std::nullopt;
+		}
+
+		for (uint32_t i = 0; i < static_cast<uint32_t>(*named + *ids); i++)
+		{
+			const uint32_t entry = _resourceRva + directory + 16 + i * 8;
+			const auto name = Read<uint32_t>(entry);
+			const auto offset = Read<uint32_t>(entry + 4);
+			if (!name || !offset)
+			{
+				return std::nullopt;
+			}
+
+			if (!id.has_value() || *name == *id)
+			{
+				return *offset;
+			}
+		}
+		return std::nullopt;
+	};
+
+	// type -> name -> language -> data
+	auto typeDir = findEntry(0, VersionResourceType);
+	if (!typeDir || !(*typeDir & SubdirectoryFlag))
+	{
+		return std::nullopt;
+	}
+	auto nameDir = findEntry(*typeDir & ~SubdirectoryFlag, std::nullopt);
+	if (!nameDir || !(*nameDir & SubdirectoryFlag))
+	{
+		return std::nullopt;
+	}
+	auto dataEntry = findEntry(*nameDir & ~SubdirectoryFlag, std::nullopt);
+	if (!dataEntry || (*dataEntry & SubdirectoryFlag))
+	{
+		return std::nullopt;
+	}
+
+	const auto dataRva = Read<uint32_t>(_resourceRva + *dataEntry);
+	const auto dataSize = Read<uint32_t>(_resourceRva + *dataEntry + 4);
+	if (!dataRva || !dataSize)
+	{
+		return std::nullopt;
+	}
+
+	// VS_VERSIONINFO starts with a variable length header, VS_FIXEDFILEINFO is the first 32-bit aligned value after it
+	for (uint32_t offset = 0; offset + 16 <= *dataSize; offset += 4)
+	{
+		if (Read<uint32_t>(*dataRva + offset) == FixedFileInfoSignature)
+		{
+			const auto ms = Read<uint32_t>(*dataRva + offset + 8);
+			const auto ls = Read<uint32_t>(*dataRva + offset + 12);
+			if (!ms || !ls)
+			{
+				return std::nullopt;
+			}
+			return std::array<uint16_t, 4>{
+				static_cast<uint16_t>(*ms >> 16), static_cast<uint16_t>(*ms & 0xFFFF),
+				static_cast<uint16_t>(*ls >> 16), static_cast<uint16_t>(*ls & 0xFFFF) };
+		}
+	}
+	return std::nullopt;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Portable PE loader, only what is needed to scan the image of a game executable offline. The image is laid out as it would
+// be in memory, so offsets into it are RVAs and patterns resolve the same way as in the game process.
+class PeImage
+{
+public:
+	// Loads a PE file. If `mapped` is true, the file is a dump of the image as loaded in memory (sections already at their RVA),
+	// otherwise it is the executable file as stored on disk and the sections are copied to their RVA. The data must outlive
+	// the PeImage when `mapped` is true.
+	bool Load(const uint8_t* data, size_t size, bool mapped, std::string& error);
+
+	const uint8_t* Image() const { return _image; }
+	size_t ImageSize() const { return _imageSize; }
+	bool Is64Bit() const { return _is64Bit; }
+	uint64_t ImageBase() const { return _imageBase; }
+	uint32_t TimeDateStamp() const { return _timeDateStamp; }
+	uint32_t CheckSum() const { return _checkSum; }
+	// SizeOfImage from the optional header, may be bigger than ImageSize() for truncated mapped images.
+	uint32_t SizeOfImage() const { return _sizeOfImage; }
+
+	// File version from the version resource, { major, minor, build, revision } as in GetGameBuild().
+	std::optional<std::array<uint16_t, 4>> FileVersion() const;
+
+	template<class T>
+	std::optional<T> Read(size_t rva) const
+	{
+		if (rva > _imageSize || _imageSize - rva < sizeof(T))
+		{
+			return std::nullopt;
+		}
+
+		T value;
+		std::memcpy(&value, _image + rva, sizeof(T));
+		return value;
+	}
+
+private:
+	const uint8_t* _image = nullptr;
+	size_t _imageSize = 0;
+	std::vector<uint8_t> _ownedImage;
+	bool _is64Bit = false;
+	uint64_t _imageBase = 0;
+	uint32_t _timeDateStamp = 0;
+	uint32_t _checkSum = 0;
+	uint32_t _sizeOfImage = 0;
+	uint32_t _resourceRva = 0;
+	uint32_t _resourceSize = 0;
+};
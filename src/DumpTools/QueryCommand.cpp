@@ -0,0 +1,396 @@
+#include "Commands.h"
+#include "DumpColumns.h"
+#include "DumpQuery.h"
+#include "DumpReader.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	struct DumpFile
+	{
+		fs::path path;
+		std::string game;
+		std::string build;
+	};
+
+	// Calls f(i) for i in [0, count) from `numThreads` threads, each index once. Stops handing out indices after an exception,
+	// the first is rethrown.
+	template<class TFunc>
+	void ParallelFor(size_t count, size_t numThreads, TFunc f)
+	{
+		std::atomic<size_t> next = 0;
+		std::exception_ptr error;
+		std::mutex errorMutex;
+		const auto worker = [&]
+		{
+			for (size_t i = next++; i < count; i = next++)
+			{
+				try
+				{
+					f(i);
+				}
+				catch (...)
+				{
+					std::lock_guard lock{ errorMutex };
+					if (!error)
+					{
+						error = std::current_exception();
+					}
+					next = count;
+				}
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (size_t i = 1; i < std::min(numThreads, count); i++)
+		{
+			threads.emplace_back(worker);
+		}
+		worker();
+		for (auto& t : threads)
+		{
+			t.join();
+		}
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+	std::string JsonString(std::string_view str)
+	{
+		std::string result = "\"";
+		for (const char c : str)
+		{
+			if (c == '"' || c == '\\')
+			{
+				result += '\\';
+				result += c;
+			}
+			else if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char escape[8];
+				std::snprintf(escape, sizeof(escape), "\\u%04X", c);
+				result += escape;
+			}
+			else
+			{
+				result += c;
+			}
+		}
+		result += '"';
+		return result;
+	}
+
+	class RowPrinter
+	{
+	public:
+		// `changed` is the field compared by --changed, if any.
+		RowPrinter(const DumpQuery& query, const DumpColumns& columns, std::optional<QueryField> changed, bool stream)
+			: _query{ query }, _columns{ columns }, _changed{ changed }, _stream{ stream }
+		{
+		}
+
+		// One line of NDJSON per row if streaming, otherwise collects the cells for Table.
+		void Row(uint32_t build, std::span<const std::pair<std::string_view, std::string>> cells)
+		{
+			const auto& b = _columns.builds[build];
+			if (_stream)
+			{
+				std::string line = "{\"game\":" + JsonString(_columns.strings.Get(b.game)) + ",\"build\":" + JsonString(_columns.strings.Get(b.build));
+				for (auto& [name, value] : cells)
+				{
+					line += ',';
+					line += JsonString(name);
+					line += ':';
+					line += IsNumber(name) ? value : JsonString(value);
+				}
+				line += "}\n";
+				std::fputs(line.c_str(), stdout);
+				return;
+			}
+
+			if (_header.empty())
+			{
+				_header.push_back("build");
+				for (auto& cell : cells)
+				{
+					_header.emplace_back(cell.first);
+				}
+			}
+			auto& row = _rows.emplace_back();
+			row.push_back(std::string{ _columns.strings.Get(b.game) } + "/" + std::string{ _columns.strings.Get(b.build) });
+			for (auto& cell : cells)
+			{
+				row.push_back(cell.second);
+			}
+		}
+
+		// Prints the collected rows, with the columns as wide as their longest value.
+		void Table() const
+		{
+			if (_stream || _header.empty())
+			{
+				return;
+			}
+
+			std::vector<size_t> widths;
+			for (auto& name : _header)
+			{
+				widths.push_back(name.size());
+			}
+			for (auto& row : _rows)
+			{
+				for (size_t i = 0; i < row.size(); i++)
+				{
+					widths[i] = std::max(widths[i], row[i].size());
+				}
+			}
+
+			const auto print = [&](const std::vector<std::string>& cells)
+			{
+				std::string line;
+				for (size_t i = 0; i < cells.size(); i++)
+				{
+					line += cells[i];
+					line.append(widths[i] - cells[i].size() + 2, ' ');
+				}
+				line.erase(line.find_last_not_of(' ') + 1);
+				std::puts(line.c_str());
+			};
+			print(_header);
+			for (auto& row : _rows)
+			{
+				print(row);
+			}
+		}
+
+	private:
+		bool IsNumber(std::string_view name) const
+		{
+			const auto field = DumpQuery::FindField(_query.Target(), name);
+			// the old/new columns of --changed have the type of the compared field
+			return field ? DumpQuery::IsNumber(*field) : _changed && DumpQuery::IsNumber(*_changed);
+		}
+
+		const DumpQuery& _query;
+		const DumpColumns& _columns;
+		std::optional<QueryField> _changed;
+		bool _stream;
+		std::vector<std::string> _header;
+		std::vector<std::vector<std::string>> _rows;
+	};
+}
+
+static std::vector<DumpFile> FindDumps(const char* dumpsDir, std::span<const char* const> builds)
+{
+	std::vector<DumpFile> dumps;
+	for (auto& entry : fs::recursive_directory_iterator(dumpsDir))
+	{
+		// only the dumps, which are inside a subdirectory per game
+		if (entry.is_regular_file() && entry.path().extension() == ".json" && entry.path().parent_path() != fs::path{ dumpsDir })
+		{
+			const auto stem = entry.path().stem().string();
+			dumps.push_back({ entry.path(), entry.path().parent_path().filename().string(), stem.starts_with("b") ? stem.substr(1) : stem });
+		}
+	}
+
+	if (!builds.empty())
+	{
+		std::vector<DumpFile> selected;
+		for (const std::string_view name : builds)
+		{
+			const auto it = std::find_if(dumps.begin(), dumps.end(), [&](auto& d) { return d.game + "/" + d.build == name; });
+			if (it == dumps.end())
+			{
+				throw std::runtime_error{ "No dump of build '" + std::string{ name } + "'" };
+			}
+			selected.push_back(*it);
+		}
+		dumps = std::move(selected);
+	}
+
+	std::sort(dumps.begin(), dumps.end(), [](auto& a, auto& b) { return a.game != b.game ? a.game < b.game : BuildLess(a.path, b.path); });
+	return dumps;
+}
+
+// Reads the dumps in parallel with DumpReader, then adds them to the columns in order.
+static void LoadColumns(const std::vector<DumpFile>& dumps, size_t numThreads, DumpColumns& columns)
+{
+	std::vector<MappedFile> files(dumps.size());
+	std::vector<DumpModel> models(dumps.size());
+	ParallelFor(dumps.size(), numThreads, [&](size_t i)
+	{
+		if (!files[i].Open(dumps[i].path.string().c_str()))
+		{
+			throw std::runtime_error{ "Failed to open '" + dumps[i].path.string() + "'" };
+		}
+		DumpReader{}.Read(files[i].Text(), models[i]);
+	});
+
+	for (auto& model : models)
+	{
+		columns.AddBuild(model);
+	}
+}
+
+static std::vector<std::pair<std::string_view, std::string>> Cells(const DumpQuery& query, uint32_t row)
+{
+	std::vector<std::pair<std::string_view, std::string>> cells;
+	for (const auto field : query.Fields())
+	{
+		cells.emplace_back(DumpQuery::FieldName(field), query.FormatValue(field, query.Value(field, row)));
+	}
+	return cells;
+}
+
+// Rows of the second build that match the filter and whose field differs from the same struct (or the member with the same
+// name in the same struct) in the first build.
+static size_t PrintChanged(const DumpQuery& query, const DumpColumns& columns, QueryField field, RowPrinter& printer)
+{
+	const auto key = [&](uint32_t row)
+	{
+		if (query.Target() == QueryTarget::Structs)
+		{
+			return uint64_t{ columns.structs.nameHash[row] };
+		}
+		return uint64_t{ columns.structs.nameHash[columns.members.owner[row]] } << 32 | columns.members.nameHash[row];
+	};
+
+	std::vector<uint32_t> oldRows;
+	DumpQuery{ columns, query.Target(), "" }.Evaluate(0, oldRows);
+	std::unordered_map<uint64_t, uint32_t> oldByKey;
+	for (const uint32_t row : oldRows)
+	{
+		oldByKey.emplace(key(row), row);
+	}
+
+	std::vector<uint32_t> rows;
+	query.Evaluate(1, rows);
+	size_t count = 0;
+	for (const uint32_t row : rows)
+	{
+		const auto old = oldByKey.find(key(row));
+		if (old == oldByKey.end())
+		{
+			continue;
+		}
+
+		const uint64_t oldValue = query.Value(field, old->second);
+		const uint64_t newValue = query.Value(field, row);
+		if (oldValue != newValue)
+		{
+			std::vector<std::pair<std::string_view, std::string>> cells;
+			if (query.Target() == QueryTarget::Members)
+			{
+				cells.emplace_back("struct", query.FormatValue(QueryField::Struct, query.Value(QueryField::Struct, row)));
+			}
+			cells.emplace_back("name", query.FormatValue(QueryField::Name, query.Value(QueryField::Name, row)));
+			cells.emplace_back("old", query.FormatValue(field, oldValue));
+			cells.emplace_back("new", query.FormatValue(field, newValue));
+			printer.Row(1, cells);
+			count++;
+		}
+	}
+	return count;
+}
+
+int RunQuery(const char* dumpsDir, std::string_view target, std::span<const char* const> builds, const char* changedField,
+	size_t numThreads, bool stream, const char* filter)
+{
+	if (target != "structs" && target != "members")
+	{
+		throw std::runtime_error{ "Unknown query target '" + std::string{ target } + "', expected structs or members" };
+	}
+	const QueryTarget queryTarget = target == "structs" ? QueryTarget::Structs : QueryTarget::Members;
+	numThreads = std::max<size_t>(numThreads, 1);
+
+	std::optional<QueryField> changed;
+	if (changedField)
+	{
+		changed = DumpQuery::FindField(queryTarget, changedField);
+		if (!changed || *changed == QueryField::Attribute)
+		{
+			throw std::runtime_error{ "Unknown field '" + std::string{ changedField } + "'" };
+		}
+		if (builds.size() != 2)
+		{
+			throw std::runtime_error{ "--changed needs exactly two builds, the old and the new" };
+		}
+	}
+
+	const auto dumps = FindDumps(dumpsDir, builds);
+	DumpColumns columns;
+	LoadColumns(dumps, numThreads, columns);
+
+	const DumpQuery query{ columns, queryTarget, filter ? filter : "" };
+	RowPrinter printer{ query, columns, changed, stream };
+	size_t count = 0;
+	if (changed)
+	{
+		count = PrintChanged(query, columns, *changed, printer);
+	}
+	else
+	{
+		// each build is scanned by one thread, the rows are printed in build order as soon as the build is done
+		std::vector<std::vector<uint32_t>> rows(columns.builds.size());
+		std::vector<bool> done(columns.builds.size());
+		std::mutex mutex;
+		std::condition_variable doneChanged;
+		std::thread scanner{ [&]
+		{
+			ParallelFor(columns.builds.size(), numThreads, [&](size_t build)
+			{
+				std::vector<uint32_t> buildRows;
+				query.Evaluate(static_cast<uint32_t>(build), buildRows);
+				std::lock_guard lock{ mutex };
+				rows[build] = std::move(buildRows);
+				done[build] = true;
+				doneChanged.notify_one();
+			});
+		} };
+
+		for (uint32_t build = 0; build < columns.builds.size(); build++)
+		{
+			std::unique_lock lock{ mutex };
+			doneChanged.wait(lock, [&] { return done[build]; });
+			const auto buildRows = std::move(rows[build]);
+			lock.unlock();
+
+			for (const uint32_t row : buildRows)
+			{
+				printer.Row(build, Cells(query, row));
+			}
+			count += buildRows.size();
+			if (stream)
+			{
+				std::fflush(stdout);
+			}
+		}
+		scanner.join();
+	}
+
+	printer.Table();
+	if (!stream)
+	{
+		std::printf("\n%zu %s\n", count, count == 1 ? "row" : "rows");
+	}
+	return 0;
+}
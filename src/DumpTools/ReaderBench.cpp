@@ -0,0 +1,348 @@
+#include "Commands.h"
+#include "DumpReader.h"
+#include "JsonReader.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	class Fnv
+	{
+	public:
+		Fnv& Add(std::string_view str)
+		{
+			Add(uint64_t{ str.size() });
+			for (const char c : str)
+			{
+				Mix(static_cast<uint8_t>(c));
+			}
+			return *this;
+		}
+
+		Fnv& Add(uint64_t value)
+		{
+			for (int i = 0; i < 8; i++)
+			{
+				Mix(static_cast<uint8_t>(value >> (i * 8)));
+			}
+			return *this;
+		}
+
+		uint64_t Hash() const { return _hash; }
+
+	private:
+		void Mix(uint8_t b) { _hash = (_hash ^ b) * 0x100000001B3; }
+
+		uint64_t _hash = 0xCBF29CE484222325;
+	};
+
+	// What a dump contains, independent of the order of the records, to check DumpReader against JsonReader.
+	struct ModelSummary
+	{
+		size_t structs = 0;
+		size_t members = 0;
+		size_t subMembers = 0;
+		size_t enums = 0;
+		size_t enumValues = 0;
+		uint64_t hash = 0; // sum of the hashes of every record
+
+		bool operator==(const ModelSummary&) const = default;
+	};
+
+	struct MemberFields
+	{
+		std::string_view name, type, subtype, structName, enumName;
+		uint64_t offset, size, align, flags1, flags2;
+	};
+
+	uint64_t HashStruct(std::string_view name, uint64_t size, uint64_t align, uint64_t memberCount)
+	{
+		return Fnv{}.Add(name).Add(size).Add(align).Add(memberCount).Hash();
+	}
+
+	uint64_t HashMember(const MemberFields& m)
+	{
+		return Fnv{}.Add(m.name).Add(m.type).Add(m.subtype).Add(m.structName).Add(m.enumName)
+			.Add(m.offset).Add(m.size).Add(m.align).Add(m.flags1).Add(m.flags2).Hash();
+	}
+
+	uint64_t HashEnum(std::string_view name, std::string_view flags, uint64_t valueCount)
+	{
+		return Fnv{}.Add(name).Add(flags).Add(valueCount).Hash();
+	}
+
+	uint64_t HashEnumValue(std::string_view name, int64_t value)
+	{
+		return Fnv{}.Add(name).Add(static_cast<uint64_t>(value)).Hash();
+	}
+
+	ModelSummary Summarize(const DumpModel& model)
+	{
+		ModelSummary summary;
+		summary.structs = model.structs.size();
+		summary.members = model.members.size();
+		summary.subMembers = model.subMembers.size();
+		summary.enums = model.enums.size();
+		summary.enumValues = model.enumValues.size();
+		for (auto& s : model.structs)
+		{
+			summary.hash += HashStruct(s.name, s.size, s.align, s.memberCount);
+		}
+		for (auto* members : { &model.members, &model.subMembers })
+		{
+			for (auto& m : *members)
+			{
+				summary.hash += HashMember({ m.name, m.type, m.subtype, m.structName, m.enumName, m.offset, m.size, m.align, m.flags1, m.flags2 });
+			}
+		}
+		for (auto& e : model.enums)
+		{
+			summary.hash += HashEnum(e.name, e.flags, e.valueCount);
+		}
+		for (auto& v : model.enumValues)
+		{
+			summary.hash += HashEnumValue(v.name, v.value);
+		}
+		return summary;
+	}
+
+	// Builds the ModelSummary of a dump replayed by JsonReader, tracking which objects are records from the keys of their
+	// parents.
+	class SummaryWriter
+	{
+	public:
+		void Null(std::optional<std::string_view>) {}
+		void String(std::optional<std::string_view> key, std::string_view value)
+		{
+			auto& f = _frames.back();
+			if (f.kind == Kind::Other || f.kind == Kind::Array)
+			{
+				return;
+			}
+
+			if (key == "name") { f.name = value; }
+			else if (key == "type") { f.type = value; }
+			else if (key == "subtype") { f.subtype = value; }
+			else if (key == "structName") { f.structName = value; }
+			else if (key == "enumName") { f.enumName = value; }
+			else if (key == "flags") { f.flags = value; }
+			else if (key == "flags1" || key == "flags2")
+			{
+				uint64_t flags = 0;
+				std::from_chars(value.data() + 2, value.data() + value.size(), flags, 16);
+				(key == "flags1" ? f.flags1 : f.flags2) = flags;
+			}
+		}
+		void Bool(std::optional<std::string_view>, bool) {}
+		void Int(std::optional<std::string_view> key, std::signed_integral auto value)
+		{
+			auto& f = _frames.back();
+			if (f.kind == Kind::EnumValue && key == "value")
+			{
+				f.value = value;
+			}
+		}
+		void UInt(std::optional<std::string_view> key, std::unsigned_integral auto value, JsonUIntOptions)
+		{
+			auto& f = _frames.back();
+			if (key == "offset") { f.offset = value; }
+			else if (key == "size") { f.size = value; }
+			else if (key == "align") { f.align = value; }
+			else if (key == "value") { f.value = static_cast<int64_t>(value); }
+		}
+		void Double(std::optional<std::string_view>, double) {}
+		void BeginObject(std::optional<std::string_view> key = std::nullopt)
+		{
+			Kind kind = Kind::Other;
+			if (!_frames.empty())
+			{
+				const auto& parent = _frames.back();
+				if (parent.kind == Kind::Array)
+				{
+					kind = parent.name == "structs" ? Kind::Struct : parent.name == "members" ? Kind::Member :
+						parent.name == "enums" ? Kind::Enum : parent.name == "values" ? Kind::EnumValue : Kind::Other;
+				}
+				else if ((parent.kind == Kind::Member || parent.kind == Kind::SubMember) && (key == "item" || key == "key" || key == "value"))
+				{
+					kind = Kind::SubMember;
+				}
+			}
+			_frames.push_back({ kind });
+		}
+		void EndObject()
+		{
+			const Frame f = _frames.back();
+			_frames.pop_back();
+			switch (f.kind)
+			{
+			case Kind::Struct:
+				summary.structs++;
+				summary.hash += HashStruct(f.name, f.size, f.align, f.children);
+				break;
+			case Kind::Member:
+			case Kind::SubMember:
+				(f.kind == Kind::Member ? summary.members : summary.subMembers)++;
+				summary.hash += HashMember({ f.name, f.type, f.subtype, f.structName, f.enumName, f.offset, f.size, f.align, f.flags1, f.flags2 });
+				break;
+			case Kind::Enum:
+				summary.enums++;
+				summary.hash += HashEnum(f.name, f.flags, f.children);
+				break;
+			case Kind::EnumValue:
+				summary.enumValues++;
+				summary.hash += HashEnumValue(f.name, f.value);
+				break;
+			default:
+				break;
+			}
+
+			// members of a struct and values of an enum, which are in an array of the record
+			if ((f.kind == Kind::Member || f.kind == Kind::EnumValue) && _frames.size() >= 2)
+			{
+				_frames[_frames.size() - 2].children++;
+			}
+		}
+		void BeginArray(std::optional<std::string_view> key = std::nullopt)
+		{
+			Frame f{ Kind::Array };
+			f.name = key.value_or(std::string_view{});
+			_frames.push_back(std::move(f));
+		}
+		void EndArray() { _frames.pop_back(); }
+
+		ModelSummary summary;
+
+	private:
+		enum class Kind { Other, Array, Struct, Member, SubMember, Enum, EnumValue };
+
+		struct Frame
+		{
+			Kind kind;
+			std::string name; // for an array, its key
+			std::string type, subtype, structName, enumName, flags;
+			uint64_t offset = 0, size = 0, align = 0, flags1 = 0, flags2 = 0, children = 0;
+			int64_t value = 0;
+		};
+
+		std::vector<Frame> _frames;
+	};
+
+	// Only parses, to compare the reader with JsonReader on its own.
+	struct NullWriter
+	{
+		void Null(std::optional<std::string_view>) {}
+		void String(std::optional<std::string_view>, std::string_view) {}
+		void Bool(std::optional<std::string_view>, bool) {}
+		void Int(std::optional<std::string_view>, std::signed_integral auto) {}
+		void UInt(std::optional<std::string_view>, std::unsigned_integral auto, JsonUIntOptions) {}
+		void Double(std::optional<std::string_view>, double) {}
+		void BeginObject(std::optional<std::string_view> = std::nullopt) {}
+		void EndObject() {}
+		void BeginArray(std::optional<std::string_view> = std::nullopt) {}
+		void EndArray() {}
+	};
+}
+
+static double Seconds(std::chrono::steady_clock::duration d)
+{
+	return std::chrono::duration<double>(d).count();
+}
+
+int BenchReader(const char* dumpsDir)
+{
+	using clock = std::chrono::steady_clock;
+
+	std::map<fs::path, std::vector<fs::path>> games;
+	for (auto& entry : fs::recursive_directory_iterator(dumpsDir))
+	{
+		// only the dumps, which are inside a subdirectory per game
+		if (entry.is_regular_file() && entry.path().extension() == ".json" && entry.path().parent_path() != fs::path{ dumpsDir })
+		{
+			games[entry.path().parent_path()].push_back(entry.path());
+		}
+	}
+
+	// one model and reader for every dump, like a tool going through all the builds would do
+	DumpModel model;
+	DumpReader reader;
+	size_t failures = 0;
+	std::printf("%-40s %10s %8s %8s %8s %6s %10s %10s %8s %8s\n",
+		"dump", "MiB", "structs", "members", "sub", "enums", "reader ms", "replay ms", "MiB/s", "result");
+	for (auto& [game, paths] : games)
+	{
+		std::sort(paths.begin(), paths.end(), BuildLess);
+		size_t gameSize = 0;
+		double gameReaderTime = 0.0, gameReplayTime = 0.0;
+		for (auto& path : paths)
+		{
+			MappedFile dump;
+			if (!dump.Open(path.string().c_str()))
+			{
+				std::printf("%-40s failed to open\n", path.string().c_str());
+				failures++;
+				continue;
+			}
+
+			const char* result = "MISMATCH";
+			double readerTime = 0.0, replayTime = 0.0;
+			try
+			{
+				// best of a few runs, the first one also pays for the page faults of the mapping
+				for (int run = 0; run < 3; run++)
+				{
+					auto start = clock::now();
+					reader.Read(dump.Text(), model);
+					const double time = Seconds(clock::now() - start);
+					readerTime = run == 0 ? time : std::min(readerTime, time);
+
+					start = clock::now();
+					NullWriter nullWriter;
+					JsonReader{ dump.Text() }.Replay(nullWriter);
+					const double replay = Seconds(clock::now() - start);
+					replayTime = run == 0 ? replay : std::min(replayTime, replay);
+				}
+
+				SummaryWriter expected;
+				JsonReader{ dump.Text() }.Replay(expected);
+				if (Summarize(model) == expected.summary)
+				{
+					result = "OK";
+				}
+			}
+			catch (const std::exception& ex)
+			{
+				std::printf("%-40s %s\n", path.string().c_str(), ex.what());
+				failures++;
+				continue;
+			}
+
+			const double sizeMiB = dump.Size() / (1024.0 * 1024.0);
+			std::printf("%-40s %10.2f %8zu %8zu %8zu %6zu %10.2f %10.2f %8.1f %8s\n",
+				fs::relative(path, dumpsDir).string().c_str(), sizeMiB, model.structs.size(), model.members.size(),
+				model.subMembers.size(), model.enums.size(), readerTime * 1000.0, replayTime * 1000.0, sizeMiB / readerTime, result);
+			failures += result[0] == 'O' ? 0 : 1;
+			gameSize += dump.Size();
+			gameReaderTime += readerTime;
+			gameReplayTime += replayTime;
+		}
+
+		std::printf("%-40s %10.2f %37s %10.2f %10.2f %8.1f\n\n", (game.filename().string() + " total").c_str(), gameSize / (1024.0 * 1024.0),
+			"", gameReaderTime * 1000.0, gameReplayTime * 1000.0, gameSize / (1024.0 * 1024.0) / gameReaderTime);
+	}
+
+	std::printf("%zu failed\n", failures);
+	return failures == 0 ? 0 : 1;
+}
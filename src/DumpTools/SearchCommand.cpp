@@ -0,0 +1,225 @@
+#include "Commands.h"
+#include "DumpReader.h"
+#include "DumpRecords.h"
+#include "MappedFile.h"
+#include "NameRegistry.h"
+#include "SearchIndex.h"
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static double Seconds(std::chrono::steady_clock::duration d)
+{
+	return std::chrono::duration<double>(d).count();
+}
+
+// The name as the formatters write it: the dump has the string or only the hash ("0x1234ABCD"), which the dictionary may
+// know, otherwise it is written as "_0x1234ABCD".
+static std::string FormatName(std::string_view name, const NameDictionary& dictionary)
+{
+	uint32_t hash = 0;
+	if (name.size() != 10 || !name.starts_with("0x") ||
+		std::from_chars(name.data() + 2, name.data() + name.size(), hash, 16).ptr != name.data() + name.size())
+	{
+		return std::string{ name };
+	}
+
+	if (const auto known = dictionary.Find(hash); !known.empty())
+	{
+		return std::string{ known };
+	}
+	char buffer[16];
+	std::snprintf(buffer, sizeof(buffer), "_0x%08X", hash);
+	return buffer;
+}
+
+// Searches typed in the page, to compare the index with matching every name.
+static const std::pair<const char*, SearchOptions> sample_searches[]
+{
+	{ "ped", {} },
+	{ "vehicle", {} },
+	{ "CPed", { .matchCase = true } },
+	{ "fx", {} },
+	{ "^C.*Info$", { .regex = true } },
+	{ "Ped(Model|Info)", { .regex = true } },
+	{ "rage__fi.*Handler", { .matchCase = true, .regex = true } },
+	{ "\\x43Ped(Model)?Info\\d*", { .regex = true } },
+	{ "health", { .matchMembers = true } },
+	{ "name", { .matchMembers = true } },
+	{ "m_.*hash", { .regex = true, .matchMembers = true } },
+};
+
+int BuildSearchIndex(const char* registryPath, const char* dumpsDir, const char* outputDir, const char* dictionaryPath)
+{
+	using clock = std::chrono::steady_clock;
+
+	MappedFile registry;
+	if (!registry.Open(registryPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", registryPath);
+		return 1;
+	}
+
+	NameDictionary dictionary;
+	if (dictionaryPath != nullptr && !dictionary.Load(dictionaryPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", dictionaryPath);
+		return 1;
+	}
+
+	// the builds of the site, only those with a dump in the directory can be indexed
+	std::vector<std::pair<std::string, std::string>> builds;
+	JsonScanner{ registry.Text() }.Members([&](std::string_view game, std::string_view gameBuilds)
+	{
+		JsonScanner{ gameBuilds }.Items([&](std::string_view item)
+		{
+			JsonScanner{ item }.Members([&](std::string_view key, std::string_view value)
+			{
+				if (key == "build")
+				{
+					builds.emplace_back(game, JsonScanner::StringValue(value));
+				}
+			});
+		});
+	});
+
+	DumpModel model;
+	DumpReader reader;
+	size_t numIndexed = 0, numMissing = 0, failures = 0, totalJsonSize = 0, totalIndexSize = 0;
+	size_t totalCandidates = 0, totalDocuments = 0;
+	double totalReadTime = 0.0, totalIndexTime = 0.0, totalSearchTime = 0.0, totalScanTime = 0.0;
+	std::printf("%-30s %8s %8s %9s %10s %10s %8s %8s %8s\n", "build", "docs", "members", "trigrams", "json KiB", "index KiB",
+		"read ms", "index ms", "check");
+	for (auto& [game, build] : builds)
+	{
+		const auto name = game + "/b" + build;
+		const auto dumpPath = fs::path{ dumpsDir } / game / ("b" + build + ".json");
+		MappedFile dump;
+		if (!dump.Open(dumpPath.string().c_str()))
+		{
+			numMissing++;
+			continue;
+		}
+
+		const auto readStart = clock::now();
+		try
+		{
+			reader.Read(dump.Text(), model);
+		}
+		catch (const std::exception& ex)
+		{
+			std::printf("%-30s %s\n", name.c_str(), ex.what());
+			failures++;
+			continue;
+		}
+		const double readTime = Seconds(clock::now() - readStart);
+
+		const auto indexPath = fs::path{ outputDir } / game / ("b" + build + ".search");
+		fs::create_directories(indexPath.parent_path());
+		const auto indexStart = clock::now();
+		SearchIndexBuilder builder;
+		for (auto& s : model.structs)
+		{
+			builder.AddStruct(FormatName(s.name, dictionary));
+			for (uint32_t i = s.firstMember; i < s.firstMember + s.memberCount; i++)
+			{
+				builder.AddMember(FormatName(model.members[i].name, dictionary));
+			}
+		}
+		for (auto& e : model.enums)
+		{
+			builder.AddEnum(FormatName(e.name, dictionary));
+		}
+		const bool saved = builder.Save(indexPath.string().c_str());
+		const double indexTime = Seconds(clock::now() - indexStart);
+
+		SearchIndex index;
+		if (!saved || !index.Open(indexPath.string().c_str()))
+		{
+			std::printf("%-30s failed to write the index\n", name.c_str());
+			failures++;
+			continue;
+		}
+
+		// every sample search through the index has to find the same as matching every name
+		bool same = true;
+		for (auto& [text, options] : sample_searches)
+		{
+			size_t numCandidates = 0;
+			const auto searchStart = clock::now();
+			const auto found = index.Search(text, options, &numCandidates);
+			totalSearchTime += Seconds(clock::now() - searchStart);
+			const auto scanStart = clock::now();
+			const auto scanned = index.Scan(text, options);
+			totalScanTime += Seconds(clock::now() - scanStart);
+			same = same && found == scanned;
+			totalCandidates += numCandidates;
+			totalDocuments += index.Documents().size();
+		}
+
+		numIndexed++;
+		failures += same ? 0 : 1;
+		totalJsonSize += dump.Size();
+		totalIndexSize += index.Size();
+		totalReadTime += readTime;
+		totalIndexTime += indexTime;
+		std::printf("%-30s %8zu %8zu %9u %10.1f %10.1f %8.2f %8.2f %8s\n", name.c_str(), index.Documents().size(),
+			model.members.size(), index.TrigramCount(), dump.Size() / 1024.0, index.Size() / 1024.0, readTime * 1000.0,
+			indexTime * 1000.0, same ? "OK" : "MISMATCH");
+	}
+
+	std::printf("\n%zu builds indexed, %zu without a dump, %zu failed\n", numIndexed, numMissing, failures);
+	if (numIndexed != 0)
+	{
+		std::printf("Dumps: %.2f MiB, indices: %.2f MiB (%.1f%%)\n", totalJsonSize / (1024.0 * 1024.0),
+			totalIndexSize / (1024.0 * 1024.0), 100.0 * totalIndexSize / totalJsonSize);
+		std::printf("Read %.1f ms, index %.1f ms in total\n", totalReadTime * 1000.0, totalIndexTime * 1000.0);
+		std::printf("Sample searches: %.1f%% of the documents are candidates, %.2f ms with the index, %.2f ms matching every name\n",
+			100.0 * totalCandidates / totalDocuments, totalSearchTime * 1000.0, totalScanTime * 1000.0);
+	}
+	return failures == 0 ? 0 : 1;
+}
+
+int SearchNames(const char* indexPath, std::string_view text, bool matchCase, bool regex, bool matchMembers)
+{
+	SearchIndex index;
+	if (!index.Open(indexPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", indexPath);
+		return 1;
+	}
+
+	SearchOptions options;
+	options.matchCase = matchCase;
+	options.regex = regex;
+	options.matchMembers = matchMembers;
+	size_t numCandidates = 0;
+	std::vector<uint32_t> found;
+	try
+	{
+		found = index.Search(text, options, &numCandidates);
+	}
+	catch (const std::regex_error& ex)
+	{
+		std::fprintf(stderr, "Invalid regex: %s\n", ex.what());
+		return 1;
+	}
+
+	for (const uint32_t i : found)
+	{
+		const auto& document = index.Documents()[i];
+		const auto name = index.Name(document.name);
+		std::printf("%s %.*s\n", i < index.StructCount() ? "struct" : "enum  ", static_cast<int>(name.size()), name.data());
+	}
+	std::printf("\n%zu found, %zu of %zu documents were candidates\n", found.size(), numCandidates, index.Documents().size());
+	return 0;
+}
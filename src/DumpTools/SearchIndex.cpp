@@ -0,0 +1,509 @@
+#include "SearchIndex.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <regex>
+#include <stdexcept>
+
+static constexpr std::array<char, 8> search_magic{ 'D', 'S', 'S', 'R', 'C', 'H', '\0', '\0' };
+static constexpr uint32_t search_version = 1;
+
+// The names are ASCII, like the lowercase of the page for them.
+static char ToLower(char c)
+{
+	return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+static std::string ToLower(std::string_view str)
+{
+	std::string result{ str };
+	std::transform(result.begin(), result.end(), result.begin(), [](char c) { return ToLower(c); });
+	return result;
+}
+
+static uint32_t Trigram(const char* c)
+{
+	return static_cast<uint32_t>(static_cast<uint8_t>(ToLower(c[0]))) << 16 |
+		static_cast<uint32_t>(static_cast<uint8_t>(ToLower(c[1]))) << 8 |
+		static_cast<uint8_t>(ToLower(c[2]));
+}
+
+void SearchIndexBuilder::AddTrigrams(std::string_view name, uint32_t document, std::vector<uint64_t>& pairs)
+{
+	for (size_t i = 0; i + 3 <= name.size(); i++)
+	{
+		pairs.push_back(uint64_t{ Trigram(name.data() + i) } << 32 | document);
+	}
+}
+
+SearchName SearchIndexBuilder::AddChars(std::string_view str)
+{
+	const auto [it, inserted] = _charOffsets.emplace(str, static_cast<uint32_t>(_chars.size()));
+	if (inserted)
+	{
+		_chars.append(str);
+	}
+	return { it->second, static_cast<uint32_t>(str.size()) };
+}
+
+void SearchIndexBuilder::AddDocument(std::string_view name)
+{
+	const uint32_t document = static_cast<uint32_t>(_documents.size());
+	_documents.push_back({ AddChars(name), static_cast<uint32_t>(_members.size()), 0 });
+	AddTrigrams(name, document, _namePairs);
+}
+
+void SearchIndexBuilder::AddStruct(std::string_view name)
+{
+	if (_structCount != _documents.size())
+	{
+		throw std::logic_error{ "structs must be added before the enums" };
+	}
+	AddDocument(name);
+	_structCount++;
+}
+
+void SearchIndexBuilder::AddEnum(std::string_view name)
+{
+	AddDocument(name);
+}
+
+void SearchIndexBuilder::AddMember(std::string_view name)
+{
+	if (_documents.empty() || _documents.size() != _structCount)
+	{
+		throw std::logic_error{ "members must be added after their struct" };
+	}
+	_members.push_back(AddChars(name));
+	_documents.back().memberCount++;
+	AddTrigrams(name, static_cast<uint32_t>(_documents.size() - 1), _memberPairs);
+}
+
+std::vector<SearchTrigram> SearchIndexBuilder::MakePostings(const std::vector<uint64_t>& unsortedPairs, std::vector<uint8_t>& postings)
+{
+	auto pairs = unsortedPairs;
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+	std::vector<SearchTrigram> trigrams;
+	uint32_t previous = 0;
+	for (const uint64_t pair : pairs)
+	{
+		const uint32_t trigram = static_cast<uint32_t>(pair >> 32);
+		const uint32_t document = static_cast<uint32_t>(pair);
+		if (trigrams.empty() || trigrams.back().trigram != trigram)
+		{
+			trigrams.push_back({ trigram, static_cast<uint32_t>(postings.size()), 0 });
+			previous = 0;
+		}
+		trigrams.back().documentCount++;
+
+		uint32_t delta = document - previous;
+		previous = document;
+		do
+		{
+			const uint8_t b = delta & 0x7F;
+			delta >>= 7;
+			postings.push_back(delta != 0 ? b | 0x80 : b);
+		} while (delta != 0);
+	}
+	return trigrams;
+}
+
+bool SearchIndexBuilder::Save(const char* path) const
+{
+	std::vector<uint8_t> postings;
+	const auto nameTrigrams = MakePostings(_namePairs, postings);
+	const auto memberTrigrams = MakePostings(_memberPairs, postings);
+	if (postings.size() > UINT32_MAX || _chars.size() > UINT32_MAX)
+	{
+		return false;
+	}
+
+	SearchHeader header{};
+	header.magic = search_magic;
+	header.version = search_version;
+	header.documentCount = static_cast<uint32_t>(_documents.size());
+	header.structCount = _structCount;
+	header.memberCount = static_cast<uint32_t>(_members.size());
+	header.nameTrigramCount = static_cast<uint32_t>(nameTrigrams.size());
+	header.memberTrigramCount = static_cast<uint32_t>(memberTrigrams.size());
+	header.postingBytes = static_cast<uint32_t>(postings.size());
+	header.charCount = static_cast<uint32_t>(_chars.size());
+
+	std::ofstream out{ path, std::ios::out | std::ios::binary | std::ios::trunc };
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(_documents.data()), _documents.size() * sizeof(SearchDocument));
+	out.write(reinterpret_cast<const char*>(_members.data()), _members.size() * sizeof(SearchName));
+	out.write(reinterpret_cast<const char*>(nameTrigrams.data()), nameTrigrams.size() * sizeof(SearchTrigram));
+	out.write(reinterpret_cast<const char*>(memberTrigrams.data()), memberTrigrams.size() * sizeof(SearchTrigram));
+	out.write(reinterpret_cast<const char*>(postings.data()), postings.size());
+	out.write(_chars.data(), _chars.size());
+	return out.good();
+}
+
+bool SearchIndex::Open(const char* path)
+{
+	if (!_file.Open(path) || _file.Size() < sizeof(SearchHeader))
+	{
+		return false;
+	}
+
+	std::memcpy(&_header, _file.Data(), sizeof(_header));
+	const auto& h = _header;
+	const uint64_t expectedSize = sizeof(SearchHeader) + uint64_t{ h.documentCount } * sizeof(SearchDocument) +
+		uint64_t{ h.memberCount } * sizeof(SearchName) + (uint64_t{ h.nameTrigramCount } + h.memberTrigramCount) * sizeof(SearchTrigram) +
+		h.postingBytes + h.charCount;
+	if (h.magic != search_magic || h.version != search_version || h.structCount > h.documentCount || _file.Size() != expectedSize)
+	{
+		return false;
+	}
+
+	// each section is aligned for its elements, the mapping itself is page-aligned
+	const uint8_t* data = _file.Data() + sizeof(SearchHeader);
+	_documents = reinterpret_cast<const SearchDocument*>(data);
+	data += h.documentCount * sizeof(SearchDocument);
+	_members = reinterpret_cast<const SearchName*>(data);
+	data += h.memberCount * sizeof(SearchName);
+	_nameTrigrams = reinterpret_cast<const SearchTrigram*>(data);
+	data += h.nameTrigramCount * sizeof(SearchTrigram);
+	_memberTrigrams = reinterpret_cast<const SearchTrigram*>(data);
+	data += h.memberTrigramCount * sizeof(SearchTrigram);
+	_postings = data;
+	data += h.postingBytes;
+	_chars = reinterpret_cast<const char*>(data);
+
+	// the lookups trust the offsets and counts, check them once here. A posting list can't take less than a byte per
+	// document, DecodePostings checks it doesn't run past the end
+	const auto inRange = [](uint64_t offset, uint64_t size, uint64_t total) { return offset <= total && size <= total - offset; };
+	bool valid = true;
+	for (auto& d : Documents())
+	{
+		valid = valid && inRange(d.name.offset, d.name.size, h.charCount) && inRange(d.firstMember, d.memberCount, h.memberCount);
+	}
+	for (uint32_t i = 0; i < h.memberCount; i++)
+	{
+		valid = valid && inRange(_members[i].offset, _members[i].size, h.charCount);
+	}
+	for (uint32_t i = 0; i < h.nameTrigramCount + h.memberTrigramCount; i++)
+	{
+		const auto& t = i < h.nameTrigramCount ? _nameTrigrams[i] : _memberTrigrams[i - h.nameTrigramCount];
+		valid = valid && inRange(t.postingOffset, t.documentCount, h.postingBytes);
+	}
+	if (!valid)
+	{
+		_file.Close();
+	}
+	return valid;
+}
+
+void SearchIndex::DecodePostings(const SearchTrigram& trigram, std::vector<uint32_t>& documents) const
+{
+	documents.clear();
+	const uint8_t* p = _postings + trigram.postingOffset;
+	const uint8_t* end = _postings + _header.postingBytes;
+	uint32_t document = 0;
+	for (uint32_t i = 0; i < trigram.documentCount && p != end; i++)
+	{
+		uint32_t delta = 0;
+		for (int shift = 0; p != end && shift < 32; shift += 7)
+		{
+			const uint8_t b = *p++;
+			delta |= static_cast<uint32_t>(b & 0x7F) << shift;
+			if ((b & 0x80) == 0)
+			{
+				break;
+			}
+		}
+		document += delta;
+		if (document >= _header.documentCount)
+		{
+			break;
+		}
+		documents.push_back(document);
+	}
+}
+
+std::vector<std::string> SearchIndex::RequiredLiterals(std::string_view text, const SearchOptions& options)
+{
+	if (!options.regex)
+	{
+		return { ToLower(text) };
+	}
+
+	// only the runs of plain characters outside groups and classes, and not made optional by a quantifier. Anything the
+	// scan doesn't understand ends the current run, which can only make the candidates a superset of the matches
+	std::vector<std::string> literals;
+	std::string run;
+	const auto endRun = [&]
+	{
+		if (!run.empty())
+		{
+			literals.push_back(ToLower(run));
+			run.clear();
+		}
+	};
+	const auto skipPast = [&](size_t i, char close)
+	{
+		const size_t end = text.find(close, i);
+		return end == std::string_view::npos ? text.size() : end + 1;
+	};
+
+	for (size_t i = 0; i < text.size();)
+	{
+		const char c = text[i];
+		switch (c)
+		{
+		case '|':
+			// an alternative at the top level, no literal is required
+			return {};
+		case '\\':
+		{
+			const char escaped = i + 1 < text.size() ? text[i + 1] : '\0';
+			const bool isWordChar = (escaped >= 'a' && escaped <= 'z') || (escaped >= 'A' && escaped <= 'Z') || (escaped >= '0' && escaped <= '9');
+			if (escaped != '\0' && !isWordChar)
+			{
+				run += escaped;
+				i += 2;
+				break;
+			}
+
+			// a class (\d, \w, ...), an escaped character (\n, \x41, \u{41}, \cJ), a property or a back reference
+			endRun();
+			i += 2;
+			if (escaped == 'x')
+			{
+				i += 2;
+			}
+			else if (escaped == 'u')
+			{
+				i = i < text.size() && text[i] == '{' ? skipPast(i, '}') : i + 4;
+			}
+			else if (escaped == 'c')
+			{
+				i += 1;
+			}
+			else if (escaped == 'p' || escaped == 'P')
+			{
+				i = skipPast(i, '}');
+			}
+			else if (escaped == 'k')
+			{
+				i = skipPast(i, '>');
+			}
+			else
+			{
+				while (i < text.size() && text[i] >= '0' && text[i] <= '9')
+				{
+					i++;
+				}
+			}
+			break;
+		}
+		case '[':
+		{
+			endRun();
+			i++;
+			while (i < text.size() && text[i] != ']')
+			{
+				i += text[i] == '\\' ? 2 : 1;
+			}
+			i++;
+			break;
+		}
+		case '(':
+		{
+			endRun();
+			int depth = 0;
+			bool inClass = false;
+			for (; i < text.size(); i++)
+			{
+				if (text[i] == '\\')
+				{
+					i++;
+				}
+				else if (inClass)
+				{
+					inClass = text[i] != ']';
+				}
+				else if (text[i] == '[')
+				{
+					inClass = true;
+				}
+				else if (text[i] == '(')
+				{
+					depth++;
+				}
+				else if (text[i] == ')' && --depth == 0)
+				{
+					break;
+				}
+			}
+			i++;
+			break;
+		}
+		case '?':
+		case '*':
+		case '{':
+			// the previous character may not be there
+			if (!run.empty())
+			{
+				run.pop_back();
+			}
+			endRun();
+			i = c == '{' ? skipPast(i, '}') : i + 1;
+			break;
+		case '+':
+		case '.':
+		case '^':
+		case '$':
+		case ')':
+			endRun();
+			i++;
+			break;
+		default:
+			run += c;
+			i++;
+			break;
+		}
+	}
+	endRun();
+	return literals;
+}
+
+std::optional<std::vector<uint32_t>> SearchIndex::Candidates(std::span<const std::string> literals, std::span<const SearchTrigram> trigrams) const
+{
+	std::vector<uint32_t> keys;
+	for (auto& literal : literals)
+	{
+		for (size_t i = 0; i + 3 <= literal.size(); i++)
+		{
+			keys.push_back(Trigram(literal.data() + i));
+		}
+	}
+	if (keys.empty())
+	{
+		return std::nullopt;
+	}
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+	std::vector<const SearchTrigram*> found;
+	for (const uint32_t key : keys)
+	{
+		const auto it = std::lower_bound(trigrams.begin(), trigrams.end(), key, [](const SearchTrigram& t, uint32_t k) { return t.trigram < k; });
+		if (it == trigrams.end() || it->trigram != key)
+		{
+			// no document has this trigram
+			return std::vector<uint32_t>{};
+		}
+		found.push_back(&*it);
+	}
+
+	// the shortest lists first, so the intersection shrinks as soon as possible
+	std::sort(found.begin(), found.end(), [](auto* a, auto* b) { return a->documentCount < b->documentCount; });
+	std::vector<uint32_t> result, list, intersection;
+	DecodePostings(*found[0], result);
+	for (size_t i = 1; i < found.size() && !result.empty(); i++)
+	{
+		DecodePostings(*found[i], list);
+		intersection.clear();
+		std::set_intersection(result.begin(), result.end(), list.begin(), list.end(), std::back_inserter(intersection));
+		result.swap(intersection);
+	}
+	return result;
+}
+
+std::vector<uint32_t> SearchIndex::Match(const std::vector<uint32_t>* candidates, std::string_view text, const SearchOptions& options) const
+{
+	// like the page: the text lowercased if not matching case, a regex with the "i" flag
+	std::regex regex;
+	if (options.regex)
+	{
+		regex = std::regex{ std::string{ text }, options.matchCase ? std::regex::ECMAScript : std::regex::ECMAScript | std::regex::icase };
+	}
+	const std::string needle = options.matchCase ? std::string{ text } : ToLower(text);
+	std::string lowered;
+	const auto matches = [&](std::string_view name)
+	{
+		if (options.regex)
+		{
+			return std::regex_search(name.begin(), name.end(), regex);
+		}
+		if (options.matchCase)
+		{
+			return name.find(needle) != std::string_view::npos;
+		}
+		lowered.assign(name);
+		std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](char c) { return ToLower(c); });
+		return lowered.find(needle) != std::string::npos;
+	};
+	const auto documentMatches = [&](uint32_t index)
+	{
+		const auto& document = _documents[index];
+		if (matches(Name(document.name)))
+		{
+			return true;
+		}
+		if (options.matchMembers)
+		{
+			for (auto& member : Members(document))
+			{
+				if (matches(Name(member)))
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	};
+
+	std::vector<uint32_t> result;
+	if (candidates != nullptr)
+	{
+		std::copy_if(candidates->begin(), candidates->end(), std::back_inserter(result), documentMatches);
+	}
+	else
+	{
+		for (uint32_t i = 0; i < _header.documentCount; i++)
+		{
+			if (documentMatches(i))
+			{
+				result.push_back(i);
+			}
+		}
+	}
+	return result;
+}
+
+// The page trims the search text.
+static std::string_view Trim(std::string_view text)
+{
+	const size_t first = text.find_first_not_of(" \t\r\n");
+	return first == std::string_view::npos ? std::string_view{} : text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+std::vector<uint32_t> SearchIndex::Search(std::string_view text, const SearchOptions& options, size_t* numCandidates) const
+{
+	text = Trim(text);
+	const auto literals = RequiredLiterals(text, options);
+	auto candidates = Candidates(literals, { _nameTrigrams, _header.nameTrigramCount });
+	if (candidates && options.matchMembers)
+	{
+		const auto memberCandidates = Candidates(literals, { _memberTrigrams, _header.memberTrigramCount });
+		std::vector<uint32_t> all;
+		std::set_union(candidates->begin(), candidates->end(), memberCandidates->begin(), memberCandidates->end(), std::back_inserter(all));
+		candidates = std::move(all);
+	}
+
+	if (numCandidates != nullptr)
+	{
+		*numCandidates = candidates ? candidates->size() : _header.documentCount;
+	}
+	return Match(candidates ? &*candidates : nullptr, text, options);
+}
+
+std::vector<uint32_t> SearchIndex::Scan(std::string_view text, const SearchOptions& options) const
+{
+	return Match(nullptr, Trim(text), options);
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include "MappedFile.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Trigram index of the names of a build, for the search of the Pages site. The documents are the structs and enums (the nodes
+// of DumpTree) and each document has two sets of trigrams, those of its name and those of the names of its members. The
+// trigrams are of the names in lowercase, so the same index serves case-sensitive and case-insensitive searches: a query's
+// trigrams select the candidate documents and only those are matched against the query.
+//
+// The index is a single file per build, meant to be fetched whole:
+//
+//   SearchHeader
+//   SearchDocument documents[documentCount]        // the structs and then the enums, in the order of the dump
+//   SearchName members[memberCount]                // the member names of each document
+//   SearchTrigram nameTrigrams[nameTrigramCount]   // sorted by trigram
+//   SearchTrigram memberTrigrams[memberTrigramCount]
+//   uint8_t postings[postingBytes]                 // of each trigram, its documents in ascending order
+//   char chars[charCount]                          // the names
+//
+// A trigram is the three lowercase characters as (c0 << 16) | (c1 << 8) | c2. A posting list is a LEB128 varint per document,
+// the difference with the previous document (the first one as is). Everything is little-endian.
+
+struct SearchHeader
+{
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t documentCount;
+	uint32_t structCount;
+	uint32_t memberCount;
+	uint32_t nameTrigramCount;
+	uint32_t memberTrigramCount;
+	uint32_t postingBytes;
+	uint32_t charCount;
+};
+
+struct SearchName
+{
+	uint32_t offset; // in chars
+	uint32_t size;
+};
+
+struct SearchDocument
+{
+	SearchName name;
+	uint32_t firstMember; // in members
+	uint32_t memberCount;
+};
+
+struct SearchTrigram
+{
+	uint32_t trigram;
+	uint32_t postingOffset; // in postings
+	uint32_t documentCount;
+};
+
+// The toggles of the DumpTree search box.
+struct SearchOptions
+{
+	bool matchCase = false;
+	bool regex = false;      // ECMAScript syntax, like the RegExp of the page
+	bool matchMembers = false;
+};
+
+// Builds the index of a build. Names without a known string are added as the formatters write them ("_0x1234ABCD").
+class SearchIndexBuilder
+{
+public:
+	// The structs go before the enums. Throws std::logic_error otherwise.
+	void AddStruct(std::string_view name);
+	void AddEnum(std::string_view name);
+	// Adds a member to the last struct.
+	void AddMember(std::string_view name);
+	bool Save(const char* path) const;
+
+	size_t DocumentCount() const { return _documents.size(); }
+
+private:
+	void AddDocument(std::string_view name);
+	static void AddTrigrams(std::string_view name, uint32_t document, std::vector<uint64_t>& pairs);
+	static std::vector<SearchTrigram> MakePostings(const std::vector<uint64_t>& pairs, std::vector<uint8_t>& postings);
+	SearchName AddChars(std::string_view str);
+
+	std::vector<SearchDocument> _documents;
+	std::vector<SearchName> _members;
+	std::vector<uint64_t> _namePairs;   // (trigram << 32) | document, sorted when saving
+	std::vector<uint64_t> _memberPairs;
+	std::string _chars;
+	std::unordered_map<std::string, uint32_t> _charOffsets; // the member names repeat a lot, each is stored once
+	uint32_t _structCount = 0;
+};
+
+// Read-only view of an index file.
+class SearchIndex
+{
+public:
+	// Returns false if the file could not be read or is not a valid index.
+	bool Open(const char* path);
+
+	std::span<const SearchDocument> Documents() const { return { _documents, _header.documentCount }; }
+	std::span<const SearchName> Members(const SearchDocument& document) const { return { _members + document.firstMember, document.memberCount }; }
+	std::string_view Name(const SearchName& name) const { return { _chars + name.offset, name.size }; }
+	uint32_t StructCount() const { return _header.structCount; }
+	uint32_t TrigramCount() const { return _header.nameTrigramCount + _header.memberTrigramCount; }
+	size_t Size() const { return _file.Size(); }
+
+	// Indices in Documents() of the documents that match, in order, like DumpTree's search without the tree: the name
+	// contains the text (or matches the regex) or, with matchMembers, the name of one of its members does. Throws
+	// std::regex_error if the regex is not valid. `numCandidates` is set to the number of documents the trigrams
+	// could not rule out.
+	std::vector<uint32_t> Search(std::string_view text, const SearchOptions& options, size_t* numCandidates = nullptr) const;
+	// The same search, matching every document.
+	std::vector<uint32_t> Scan(std::string_view text, const SearchOptions& options) const;
+
+	// Literal strings, in lowercase, that a match of the query must contain.
+	static std::vector<std::string> RequiredLiterals(std::string_view text, const SearchOptions& options);
+
+private:
+	// nullopt if the literals have no trigrams, so every document is a candidate.
+	std::optional<std::vector<uint32_t>> Candidates(std::span<const std::string> literals, std::span<const SearchTrigram> trigrams) const;
+	void DecodePostings(const SearchTrigram& trigram, std::vector<uint32_t>& documents) const;
+	std::vector<uint32_t> Match(const std::vector<uint32_t>* candidates, std::string_view text, const SearchOptions& options) const;
+
+	MappedFile _file;
+	SearchHeader _header{};
+	const SearchDocument* _documents = nullptr;
+	const SearchName* _members = nullptr;
+	const SearchTrigram* _nameTrigrams = nullptr;
+	const SearchTrigram* _memberTrigrams = nullptr;
+	const uint8_t* _postings = nullptr;
+	const char* _chars = nullptr;
+};
@@ -0,0 +1,563 @@
+#include "Commands.h"
+#include "DumpBinaryReplay.h"
+#include "DumpBinaryWriter.h"
+#include "Joaat.h"
+#include "JsonWriter.h"
+#include "MappedFile.h"
+#include "MemorySnapshot.h"
+#include "NameRegistry.h"
+#include "ParLayout.h"
+#include "ParWalkDump.h"
+#include "ParWalker.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	// Lays out fake parser objects at increasing addresses of a fake address space, with small gaps between them like the
+	// allocations of the game, and adds them to the snapshot.
+	class FakeHeap
+	{
+	public:
+		static constexpr uint64_t Base = 0x2'0000'0000;
+
+		FakeHeap(MemorySnapshotWriter& writer) : _writer{ writer } {}
+
+		uint64_t Reserve(size_t size)
+		{
+			const uint64_t address = _next;
+			_next += (size + _gap(_rng)) & ~uint64_t{ 7 };
+			_next += 8;
+			return address;
+		}
+
+		void Write(uint64_t address, const std::vector<uint8_t>& bytes) { _writer.AddRange(address, bytes); }
+		void Annotate(uint64_t address, MemorySnapshotAnnotationKind kind, uint64_t value) { _writer.AddAnnotation(address, kind, value); }
+
+		uint64_t Add(const std::vector<uint8_t>& bytes)
+		{
+			const uint64_t address = Reserve(bytes.size());
+			Write(address, bytes);
+			return address;
+		}
+
+		uint64_t AddString(const std::string& str)
+		{
+			return Add({ str.c_str(), str.c_str() + str.size() + 1 });
+		}
+
+	private:
+		MemorySnapshotWriter& _writer;
+		uint64_t _next = Base;
+		std::mt19937 _rng{ 1234 };
+		std::uniform_int_distribution<uint64_t> _gap{ 0, 96 };
+	};
+
+	struct ExpectedCounts
+	{
+		size_t structures = 0;
+		size_t topLevelMembers = 0;
+		size_t members = 0;
+		size_t enums = 0;
+		size_t initValues = 0;
+		size_t attributes = 0;
+		size_t callbacks = 0;
+		std::vector<bool> usedEnums;
+	};
+}
+
+// the functions of the synthetic registry are in this image
+static constexpr uint64_t image_base = 0x1'4000'0000;
+
+template<class T>
+static void Put(std::vector<uint8_t>& object, uint32_t offset, T value)
+{
+	std::memcpy(object.data() + offset, &value, sizeof(T));
+}
+
+static void PutUInt(std::vector<uint8_t>& object, uint32_t offset, uint64_t value, uint32_t size)
+{
+	std::memcpy(object.data() + offset, &value, size);
+}
+
+// parDelegateHolderBase with the given function
+static uint64_t AddDelegate(FakeHeap& heap, uint64_t function)
+{
+	std::vector<uint8_t> holder(0x10);
+	Put<uint64_t>(holder, 0x8, function);
+	return heap.Add(holder);
+}
+
+// parAttributeList with an attribute of each type
+static uint64_t AddAttributeList(FakeHeap& heap, const ParLayout& layout, ExpectedCounts& expected)
+{
+	std::vector<uint8_t> attributes(4 * layout.attributeSize);
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		Put<uint64_t>(attributes, i * layout.attributeSize, heap.AddString("attribute" + std::to_string(i)));
+		Put<uint8_t>(attributes, i * layout.attributeSize + layout.attributeType, static_cast<uint8_t>(i));
+	}
+	Put<uint64_t>(attributes, layout.attributeValue, heap.AddString("a string"));
+	Put<int64_t>(attributes, layout.attributeSize + layout.attributeValue, -42);
+	Put<double>(attributes, 2 * layout.attributeSize + layout.attributeValue, 0.5);
+	Put<uint8_t>(attributes, 3 * layout.attributeSize + layout.attributeValue, 1);
+	expected.attributes += 4;
+
+	std::vector<uint8_t> list(layout.attributeListSize);
+	Put<uint64_t>(list, 0, heap.Add(attributes));
+	Put<uint16_t>(list, 8, 4);
+	Put<uint16_t>(list, 10, 4);
+	Put<uint8_t>(list, layout.attributeListUserData1, 3);
+	return heap.Add(list);
+}
+
+// Member of the given type, with its item/key/value members for arrays and maps. Returns the parMember address.
+static uint64_t AddMember(FakeHeap& heap, const ParLayout& layout, std::mt19937& rng, ParLayoutMemberType type,
+	const std::vector<uint64_t>& structures, const std::vector<uint64_t>& enums, ExpectedCounts& expected, size_t depth = 0)
+{
+	expected.members++;
+	std::uniform_int_distribution<uint32_t> u32;
+	std::vector<uint8_t> data(0x60);
+	Put<uint32_t>(data, 0, u32(rng));
+	Put<uint64_t>(data, layout.dataOffset, u32(rng) % 0x400);
+	Put<uint8_t>(data, layout.dataType, static_cast<uint8_t>(type));
+	if (u32(rng) % 8 == 0)
+	{
+		Put<uint64_t>(data, layout.dataAttributes, AddAttributeList(heap, layout, expected));
+	}
+
+	std::vector<uint8_t> member(0x20);
+	Put<uint64_t>(member, 0, 0x1'4100'0000 + static_cast<uint8_t>(type) * 0x100); // vftable, never read
+	switch (type)
+	{
+	case ParLayoutMemberType::STRUCT:
+		Put<uint64_t>(data, layout.dataStructStructure, structures[u32(rng) % structures.size()]);
+		Put<uint64_t>(data, layout.dataStructAllocateStruct, u32(rng) % 4 == 0 ? image_base + 0x1000 : 0);
+		break;
+	case ParLayoutMemberType::ENUM:
+	case ParLayoutMemberType::BITSET:
+		PutUInt(data, layout.dataEnumInitValue, 1, layout.dataEnumInitValueSize);
+	{
+		const size_t e = u32(rng) % enums.size();
+		Put<uint64_t>(data, layout.dataEnumEnumData, enums[e]);
+		expected.usedEnums[e] = true;
+	}
+	break;
+	case ParLayoutMemberType::ARRAY:
+		Put<uint32_t>(data, layout.dataArraySize, u32(rng) % 64);
+		Put<uint64_t>(member, layout.memberArrayItem,
+			AddMember(heap, layout, rng, depth < 2 && u32(rng) % 4 == 0 ? ParLayoutMemberType::ARRAY : ParLayoutMemberType::ENUM,
+				structures, enums, expected, depth + 1));
+		break;
+	case ParLayoutMemberType::MAP:
+		Put<uint64_t>(member, layout.memberMapKey, AddMember(heap, layout, rng, ParLayoutMemberType::ENUM, structures, enums, expected, depth + 1));
+		Put<uint64_t>(member, layout.memberMapValue, AddMember(heap, layout, rng, ParLayoutMemberType::STRUCT, structures, enums, expected, depth + 1));
+		Put<uint64_t>(data, layout.dataMapCreateIterator, AddDelegate(heap, image_base + 0x2000));
+		Put<uint64_t>(data, layout.dataMapCreateInterface, AddDelegate(heap, image_base + 0x2100));
+		break;
+	case ParLayoutMemberType::STRING:
+		Put<uint32_t>(data, layout.dataStringMemberSize, 64);
+		break;
+	case ParLayoutMemberType::VEC3V:
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			Put<float>(data, layout.dataInitValues + i * 4, 0.25f * i);
+		}
+		expected.initValues += 4;
+		break;
+	default:
+		// INT, FLOAT and BOOL, the init value is as wide as the enum one
+		if (layout.dataEnumInitValueSize == sizeof(double))
+		{
+			Put<double>(data, layout.dataSimpleInitValue, 0.1);
+		}
+		else
+		{
+			Put<float>(data, layout.dataSimpleInitValue, 0.1f);
+		}
+		expected.initValues++;
+		break;
+	}
+
+	Put<uint64_t>(member, layout.memberData, heap.Add(data));
+	const uint64_t address = heap.Add(member);
+	heap.Annotate(address, MemorySnapshotAnnotationKind::MemberSize, 4 + u32(rng) % 64);
+	heap.Annotate(address, MemorySnapshotAnnotationKind::MemberAlign, 4);
+	return address;
+}
+
+// A registry shaped like the GTA5 one: mostly simple members, one STRUCT/ARRAY/ENUM every few members, a few maps.
+static ExpectedCounts GenerateSnapshot(std::string_view game, const ParLayout& layout, size_t numStructs, const std::string& path)
+{
+	constexpr ParLayoutMemberType memberTypes[]
+	{
+		ParLayoutMemberType::INT, ParLayoutMemberType::FLOAT, ParLayoutMemberType::BOOL, ParLayoutMemberType::VEC3V,
+		ParLayoutMemberType::STRING, ParLayoutMemberType::STRUCT, ParLayoutMemberType::STRUCT, ParLayoutMemberType::ARRAY,
+		ParLayoutMemberType::ENUM, ParLayoutMemberType::BITSET, ParLayoutMemberType::MAP,
+	};
+
+	std::mt19937 rng{ 1234 };
+	std::uniform_int_distribution<uint32_t> u32;
+	ExpectedCounts expected;
+	// the parManager is the first object in the heap
+	MemorySnapshotWriter writer{ game, image_base, FakeHeap::Base };
+	FakeHeap heap{ writer };
+	const uint64_t root = heap.Reserve(layout.managerStructures + 0x18);
+
+	std::vector<uint64_t> enums(std::max<size_t>(numStructs / 3, 1));
+	for (auto& e : enums)
+	{
+		const size_t valueCount = 1 + u32(rng) % 24;
+		std::vector<uint8_t> values(valueCount * layout.enumValueSize);
+		std::vector<uint8_t> names(valueCount * 8);
+		for (size_t i = 0; i < valueCount; i++)
+		{
+			Put<uint32_t>(values, static_cast<uint32_t>(i * layout.enumValueSize), u32(rng));
+			PutUInt(values, static_cast<uint32_t>(i * layout.enumValueSize + layout.enumValueValue), i, layout.enumValueSize - layout.enumValueValue);
+			Put<uint64_t>(names, static_cast<uint32_t>(i * 8), heap.AddString("VALUE_" + std::to_string(i)));
+		}
+
+		std::vector<uint8_t> data(layout.enumSize);
+		Put<uint64_t>(data, 0, heap.Add(values));
+		Put<uint64_t>(data, layout.enumValueNames, heap.Add(names));
+		Put<uint16_t>(data, layout.enumValueCount, static_cast<uint16_t>(valueCount));
+		Put<uint32_t>(data, layout.enumName, u32(rng));
+		e = heap.Add(data);
+	}
+
+	std::vector<uint64_t> structures(numStructs);
+	for (auto& s : structures)
+	{
+		s = heap.Reserve(layout.structureSize);
+	}
+
+	expected.usedEnums.resize(enums.size());
+	for (size_t i = 0; i < numStructs; i++)
+	{
+		const size_t memberCount = u32(rng) % 16;
+		std::vector<uint8_t> members(memberCount * 8);
+		std::vector<uint8_t> memberNames(memberCount * 8);
+		for (size_t j = 0; j < memberCount; j++)
+		{
+			const auto type = memberTypes[u32(rng) % std::size(memberTypes)];
+			Put<uint64_t>(members, static_cast<uint32_t>(j * 8), AddMember(heap, layout, rng, type, structures, enums, expected));
+			Put<uint64_t>(memberNames, static_cast<uint32_t>(j * 8), heap.AddString("m_Member" + std::to_string(j)));
+		}
+		expected.topLevelMembers += memberCount;
+
+		std::vector<uint8_t> s(layout.structureSize);
+		Put<uint32_t>(s, layout.structureName, u32(rng));
+		Put<uint64_t>(s, layout.structureBase, i % 5 == 0 && i > 0 ? structures[u32(rng) % i] : 0);
+		Put<uint64_t>(s, layout.structureStructureSize, 8 + u32(rng) % 0x400);
+		PutUInt(s, layout.structureFlags, 1 << 1, layout.structureFlagsSize);
+		Put<uint16_t>(s, layout.structureVersionMajor, 1);
+		Put<uint64_t>(s, layout.structureMembers, memberCount != 0 ? heap.Add(members) : 0);
+		Put<uint16_t>(s, layout.structureMembers + 8, static_cast<uint16_t>(memberCount));
+		Put<uint16_t>(s, layout.structureMembers + 10, static_cast<uint16_t>(memberCount));
+		Put<uint64_t>(s, layout.structureFactoryNew + 8, image_base + 0x3000 + i * 0x10);
+		Put<uint64_t>(s, layout.structureFactoryDelete + 8, image_base + 0x4000 + i * 0x10);
+		if (i % 7 == 0)
+		{
+			Put<uint64_t>(s, layout.structureExtraAttributes, AddAttributeList(heap, layout, expected));
+		}
+		if (i % 3 == 0)
+		{
+			// atBinaryMap<uint32_t, parDelegateHolderBase*>, one callback with a known name and one without
+			std::vector<uint8_t> pairs(2 * 0x10);
+			Put<uint32_t>(pairs, 0, joaat_literal("postpsoplace"));
+			Put<uint64_t>(pairs, 0x8, AddDelegate(heap, image_base + 0x5000));
+			Put<uint32_t>(pairs, 0x10, u32(rng));
+			Put<uint64_t>(pairs, 0x18, AddDelegate(heap, image_base + 0x5100));
+			Put<uint64_t>(s, layout.structureCallbacks + 8, heap.Add(pairs));
+			Put<uint16_t>(s, layout.structureCallbacks + 8 + 8, 2);
+			Put<uint16_t>(s, layout.structureCallbacks + 8 + 10, 2);
+			expected.callbacks += 2;
+		}
+		heap.Write(structures[i], s);
+
+		std::vector<uint8_t> staticData(0x38);
+		Put<uint64_t>(staticData, layout.staticDataNameStr, heap.AddString("CSynthetic" + std::to_string(i)));
+		Put<uint64_t>(staticData, layout.staticDataMemberNames, memberCount != 0 ? heap.Add(memberNames) : 0);
+		writer.AddAnnotation(structures[i], MemorySnapshotAnnotationKind::StructureStaticData, heap.Add(staticData));
+		writer.AddAnnotation(structures[i], MemorySnapshotAnnotationKind::StructureAlign, 8);
+	}
+	expected.structures = numStructs;
+	expected.enums = std::count(expected.usedEnums.begin(), expected.usedEnums.end(), true);
+
+	// atMap<uint32_t, parStructure*> with a few collisions per bucket
+	const size_t numBuckets = std::clamp<size_t>(numStructs / 2, 1, UINT16_MAX);
+	std::vector<uint8_t> buckets(numBuckets * 8);
+	for (size_t i = 0; i < numStructs; i++)
+	{
+		const uint32_t bucket = static_cast<uint32_t>(i % numBuckets);
+		std::vector<uint8_t> entry(layout.mapEntrySize);
+		Put<uint64_t>(entry, layout.mapEntryValue, structures[i]);
+		uint64_t next;
+		std::memcpy(&next, buckets.data() + bucket * 8, 8);
+		Put<uint64_t>(entry, layout.mapEntryNext, next);
+		Put<uint64_t>(buckets, bucket * 8, heap.Add(entry));
+	}
+
+	std::vector<uint8_t> manager(layout.managerStructures + 0x18);
+	Put<uint64_t>(manager, layout.managerStructures, heap.Add(buckets));
+	PutUInt(manager, layout.managerStructures + layout.mapNumBuckets, numBuckets, layout.mapCountSize);
+	heap.Write(root, manager);
+	// 1.0.3323.0, as CaptureSnapshot records it
+	heap.Annotate(0, MemorySnapshotAnnotationKind::GameBuild, 1ull << 48 | 3323ull << 16);
+
+	if (!writer.Save(path))
+	{
+		std::fprintf(stderr, "Failed to write '%s'\n", path.c_str());
+	}
+	std::printf("Synthetic %.*s snapshot: %zu ranges, %.1f MiB\n", static_cast<int>(game.size()), game.data(), writer.RangeCount(),
+		writer.ByteCount() / (1024.0 * 1024.0));
+	return expected;
+}
+
+// Structures, members and enums referenced from the walked structures that were not found by the walk.
+static size_t CountUnresolved(const ParWalkResult& result)
+{
+	size_t unresolved = 0;
+	for (auto& s : result.structures)
+	{
+		unresolved += s.base != 0 && result.FindStructure(s.base) == nullptr ? 1 : 0;
+	}
+	for (auto& m : result.members)
+	{
+		unresolved += m.structure != 0 && result.FindStructure(m.structure) == nullptr ? 1 : 0;
+	}
+	return unresolved;
+}
+
+// Loads the snapshot in `file`, null if it cannot be loaded or is of a game without a layout.
+static const ParLayout* LoadSnapshot(const char* snapshotPath, MappedFile& file, MemorySnapshot& snapshot)
+{
+	if (!file.Open(snapshotPath) || !snapshot.Load({ file.Data(), file.Size() }))
+	{
+		std::fprintf(stderr, "Failed to load snapshot '%s'\n", snapshotPath);
+		return nullptr;
+	}
+
+	const ParLayout* layout = FindParLayout(snapshot.Game());
+	if (layout == nullptr || snapshot.Header().pointerSize != 8)
+	{
+		std::fprintf(stderr, "Unsupported game '%.*s'\n", static_cast<int>(snapshot.Game().size()), snapshot.Game().data());
+		return nullptr;
+	}
+	return layout;
+}
+
+// The "build" DumpStructs writes in the dump, from the GameBuild annotation. Empty if the snapshot does not have it, like
+// the synthetic ones.
+static std::string SnapshotBuild(const MemorySnapshot& snapshot)
+{
+	const auto version = snapshot.FindAnnotation(0, MemorySnapshotAnnotationKind::GameBuild);
+	if (!version.has_value())
+	{
+		return {};
+	}
+
+	char buffer[16];
+	const auto build = static_cast<uint16_t>(version.value() >> 16);
+	std::snprintf(buffer, sizeof(buffer), snapshot.Game() == "gta5g9" ? "%ug9" : "%u", build);
+	return buffer;
+}
+
+static int WalkSnapshotFile(const char* snapshotPath, const ExpectedCounts* expected)
+{
+	MappedFile file;
+	MemorySnapshot snapshot;
+	const ParLayout* layout = LoadSnapshot(snapshotPath, file, snapshot);
+	if (layout == nullptr)
+	{
+		return 1;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	ParWalker walker{ snapshot, *layout, &snapshot };
+	const auto result = walker.Walk(snapshot.Header().root);
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	size_t topLevelMembers = 0;
+	size_t namedStructures = 0;
+	for (auto& s : result.structures)
+	{
+		topLevelMembers += s.memberCount;
+		namedStructures += s.nameStr.empty() ? 0 : 1;
+	}
+
+	const size_t unresolved = CountUnresolved(result);
+	std::printf("%.*s snapshot, %zu ranges, %.1f MiB\n", static_cast<int>(snapshot.Game().size()), snapshot.Game().data(),
+		snapshot.Ranges().size(), file.Size() / (1024.0 * 1024.0));
+	std::printf("  %zu structures (%zu with names), %zu members (%zu top-level), %zu enums, %zu enum values\n",
+		result.structures.size(), namedStructures, result.members.size(), topLevelMembers, result.enums.size(), result.enumValues.size());
+	std::printf("  walked in %.1f ms, %zu range lookups, %zu page cache misses, %zu failed reads, %zu unresolved references\n",
+		seconds * 1000.0, snapshot.Lookups(), snapshot.CacheMisses(), result.failedReads, unresolved);
+
+	// the dump of the walk, written as JSON and as a binary dump: converted to JSON, the binary one must give the same text
+	bool dumpOk = false;
+	try
+	{
+		const auto build = SnapshotBuild(snapshot);
+		const ParWalkDumpInfo info{ snapshot.Game(), build, snapshot.Header().imageBase };
+		JsonWriter json{ 0, true };
+		WriteParWalkDump(json, result, info);
+		const std::string text = json.TakeFragment();
+		DumpBinaryWriter binary;
+		WriteParWalkDump(binary, result, info);
+		const auto bytes = binary.Serialize();
+		DumpBinaryView view{ bytes.data(), bytes.size() };
+		JsonWriter replayed{ 0, true };
+		if (view.Validate())
+		{
+			DumpBinaryReplay{ view, replayed }.Run();
+			dumpOk = replayed.TakeFragment() == text;
+		}
+		std::printf("  dump: %.1f KiB JSON, %.1f KiB binary, %s\n", text.size() / 1024.0, bytes.size() / 1024.0,
+			dumpOk ? "same content" : "DIFFERENT CONTENT");
+	}
+	catch (const std::exception& ex)
+	{
+		std::printf("  dump failed: %s\n", ex.what());
+	}
+
+	bool ok = result.failedReads == 0 && unresolved == 0 && dumpOk;
+	if (expected != nullptr)
+	{
+		const bool same = result.structures.size() == expected->structures && topLevelMembers == expected->topLevelMembers &&
+			result.members.size() == expected->members && result.enums.size() == expected->enums &&
+			result.initValues.size() == expected->initValues && result.attributes.size() == expected->attributes &&
+			result.callbacks.size() == expected->callbacks;
+		std::printf("  %s the generated registry\n", same ? "matches" : "DOES NOT MATCH");
+		ok = ok && same;
+	}
+	return ok ? 0 : 1;
+}
+
+int WalkSnapshot(const char* snapshotPath)
+{
+	return WalkSnapshotFile(snapshotPath, nullptr);
+}
+
+// Walks the snapshot and writes its dump to `outputPath`, as JSON or as a binary dump depending on the extension.
+static bool WriteSnapshotDump(const char* snapshotPath, const std::string& outputPath, const char* dictionaryPath)
+{
+	MappedFile file;
+	MemorySnapshot snapshot;
+	const ParLayout* layout = LoadSnapshot(snapshotPath, file, snapshot);
+	if (layout == nullptr)
+	{
+		return false;
+	}
+
+	NameRegistry names;
+	if (dictionaryPath != nullptr && !names.Dictionary().Load(dictionaryPath))
+	{
+		std::fprintf(stderr, "Failed to load dictionary '%s'\n", dictionaryPath);
+		return false;
+	}
+
+	ParWalker walker{ snapshot, *layout, &snapshot };
+	const auto result = walker.Walk(snapshot.Header().root);
+	if (result.failedReads != 0)
+	{
+		std::fprintf(stderr, "%zu reads failed while walking '%s'\n", result.failedReads, snapshotPath);
+		return false;
+	}
+
+	try
+	{
+		const auto build = SnapshotBuild(snapshot);
+		const ParWalkDumpInfo info{ snapshot.Game(), build, snapshot.Header().imageBase, &names };
+		if (fs::path{ outputPath }.extension() == ".json")
+		{
+			JsonWriter w{ outputPath };
+			WriteParWalkDump(w, result, info);
+		}
+		else
+		{
+			DumpBinaryWriter w{ outputPath };
+			WriteParWalkDump(w, result, info);
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::fprintf(stderr, "Failed to write '%s': %s\n", outputPath.c_str(), ex.what());
+		return false;
+	}
+	return true;
+}
+
+int DumpSnapshot(const char* snapshotPath, const char* outputPath, const char* dictionaryPath)
+{
+	return WriteSnapshotDump(snapshotPath, outputPath, dictionaryPath) ? 0 : 1;
+}
+
+int CheckSnapshotDump(const char* snapshotPath, const char* dumpPath, const char* dictionaryPath)
+{
+	const auto outputPath = (fs::temp_directory_path() / "DumpTools_snapshot_check.json").string();
+	if (!WriteSnapshotDump(snapshotPath, outputPath, dictionaryPath))
+	{
+		return 1;
+	}
+
+	MappedFile live, offline;
+	if (!live.Open(dumpPath) || !offline.Open(outputPath.c_str()))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", dumpPath);
+		return 1;
+	}
+
+	const std::string_view expected = live.Text(), written = offline.Text();
+	const auto [e, w] = std::mismatch(expected.begin(), expected.end(), written.begin(), written.end());
+	const bool same = e == expected.end() && w == written.end();
+	if (same)
+	{
+		std::printf("same as %s, %.1f KiB\n", dumpPath, expected.size() / 1024.0);
+	}
+	else
+	{
+		// the whole line of the first difference on each side
+		auto lineAt = [](std::string_view text, size_t pos)
+		{
+			const size_t newline = pos == 0 ? std::string_view::npos : text.rfind('\n', pos - 1);
+			const size_t begin = newline == std::string_view::npos ? 0 : newline + 1;
+			return text.substr(begin, text.find('\n', begin) - begin);
+		};
+		const size_t pos = e - expected.begin();
+		const auto line = std::count(expected.begin(), e, '\n') + 1;
+		const auto expectedLine = lineAt(expected, pos), writtenLine = lineAt(written, pos);
+		std::printf("DIFFERENT from %s at line %td\n  live     %.*s\n  snapshot %.*s\n", dumpPath, line,
+			static_cast<int>(expectedLine.size()), expectedLine.data(), static_cast<int>(writtenLine.size()), writtenLine.data());
+	}
+
+	offline.Close();
+	std::error_code ec;
+	fs::remove(outputPath, ec);
+	return same ? 0 : 1;
+}
+
+int BenchWalk(size_t numStructs)
+{
+	const fs::path path = fs::temp_directory_path() / "DumpTools_synthetic.snapshot";
+	int failures = 0;
+	for (std::string_view game : { "gta5", "rdr3" })
+	{
+		const auto expected = GenerateSnapshot(game, *FindParLayout(game), numStructs, path.string());
+		failures += WalkSnapshotFile(path.string().c_str(), &expected);
+	}
+
+	std::error_code ec;
+	fs::remove(path, ec);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+#include "Commands.h"
+#include "DefinitionStore.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static double Seconds(std::chrono::steady_clock::duration d)
+{
+	return std::chrono::duration<double>(d).count();
+}
+
+int ImportStore(const char* dumpsDir, const char* storePath)
+{
+	using clock = std::chrono::steady_clock;
+
+	std::map<fs::path, std::vector<fs::path>> games;
+	for (auto& entry : fs::recursive_directory_iterator(dumpsDir))
+	{
+		// only the dumps, which are inside a subdirectory per game
+		if (entry.is_regular_file() && entry.path().extension() == ".json" && entry.path().parent_path() != fs::path{ dumpsDir })
+		{
+			games[entry.path().parent_path()].push_back(entry.path());
+		}
+	}
+
+	DefinitionStoreBuilder builder;
+	std::vector<fs::path> imported;
+	size_t failures = 0, totalJsonSize = 0;
+	double importTime = 0.0;
+	std::printf("%-40s %12s %8s %8s %8s\n", "dump", "json bytes", "records", "new", "ms");
+	for (auto& [game, paths] : games)
+	{
+		std::sort(paths.begin(), paths.end(), BuildLess);
+		for (auto& path : paths)
+		{
+			MappedFile dump;
+			if (!dump.Open(path.string().c_str()))
+			{
+				std::printf("%-40s failed to open\n", path.string().c_str());
+				failures++;
+				continue;
+			}
+
+			const size_t recordsBefore = builder.RecordCount();
+			size_t added = 0;
+			const auto start = clock::now();
+			try
+			{
+				added = builder.AddDump(dump.Text());
+			}
+			catch (const std::exception& ex)
+			{
+				// the builder is left with part of the dump, don't save it
+				std::printf("%-40s %s\n", path.string().c_str(), ex.what());
+				return 1;
+			}
+			const double time = Seconds(clock::now() - start);
+			importTime += time;
+			totalJsonSize += dump.Size();
+			imported.push_back(path);
+			std::printf("%-40s %12zu %8zu %8zu %8.2f\n",
+				fs::relative(path, dumpsDir).string().c_str(), dump.Size(), builder.RecordCount() - recordsBefore, added, time * 1000.0);
+		}
+	}
+
+	if (!builder.Save(storePath))
+	{
+		std::fprintf(stderr, "Failed to write '%s'\n", storePath);
+		return 1;
+	}
+
+	DefinitionStore store;
+	if (!store.Open(storePath))
+	{
+		std::fprintf(stderr, "Failed to open '%s' after writing it\n", storePath);
+		return 1;
+	}
+
+	// every build exported back and compared against the original re-written by the current JsonWriter, like roundtrip does
+	const auto tmpOutputPath = (fs::temp_directory_path() / "DumpTools_store_output.json").string();
+	const auto tmpCanonicalPath = (fs::temp_directory_path() / "DumpTools_store_canonical.json").string();
+	double exportTime = 0.0;
+	for (size_t i = 0; i < imported.size(); i++)
+	{
+		const auto& build = store.Builds()[i];
+		const char* result = "MISMATCH";
+		try
+		{
+			const auto start = clock::now();
+			{
+				JsonWriter w{ tmpOutputPath };
+				store.WriteDump(w, build);
+			}
+			exportTime += Seconds(clock::now() - start);
+
+			MappedFile dump;
+			if (dump.Open(imported[i].string().c_str()))
+			{
+				JsonWriter w{ tmpCanonicalPath };
+				JsonReader{ dump.Text() }.Replay(w);
+			}
+			MappedFile output, canonical;
+			if (output.Open(tmpOutputPath.c_str()) && canonical.Open(tmpCanonicalPath.c_str()) && output.Text() == canonical.Text())
+			{
+				result = "OK";
+			}
+		}
+		catch (const std::exception& ex)
+		{
+			std::printf("%-40s %s\n", imported[i].string().c_str(), ex.what());
+			failures++;
+			continue;
+		}
+
+		if (result[0] != 'O')
+		{
+			std::printf("%s %s: %s\n", std::string{ store.Game(build) }.c_str(), std::string{ store.Build(build) }.c_str(), result);
+			failures++;
+		}
+	}
+	fs::remove(tmpOutputPath);
+	fs::remove(tmpCanonicalPath);
+
+	std::printf("\n%zu dumps, %zu failed\n", imported.size(), failures);
+	std::printf("%zu records, %zu distinct definitions\n", builder.RecordCount(), builder.DefinitionCount());
+	std::printf("Full dumps: %.2f MiB\n", totalJsonSize / (1024.0 * 1024.0));
+	std::printf("Store:      %.2f MiB (%.1f%%)\n", store.Size() / (1024.0 * 1024.0), 100.0 * store.Size() / totalJsonSize);
+	std::printf("Import %.1f ms, export %.1f ms in total\n", importTime * 1000.0, exportTime * 1000.0);
+	return failures == 0 ? 0 : 1;
+}
+
+int ExportStoreBuild(const char* storePath, std::string_view game, std::string_view build, const char* outputPath)
+{
+	DefinitionStore store;
+	if (!store.Open(storePath))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", storePath);
+		return 1;
+	}
+
+	const auto* storeBuild = store.FindBuild(game, build);
+	if (storeBuild == nullptr)
+	{
+		std::fprintf(stderr, "Build %.*s of %.*s is not in the store\n",
+			static_cast<int>(build.size()), build.data(), static_cast<int>(game.size()), game.data());
+		return 1;
+	}
+
+	JsonWriter w{ outputPath };
+	store.WriteDump(w, *storeBuild);
+	return 0;
+}
+
+int FindDefinitions(const char* storePath, std::string_view name)
+{
+	DefinitionStore store;
+	if (!store.Open(storePath))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", storePath);
+		return 1;
+	}
+
+	size_t numFound = 0;
+	for (auto& definition : store.Definitions())
+	{
+		if (store.Name(definition) != name)
+		{
+			continue;
+		}
+
+		numFound++;
+		std::printf("%016llX %u bytes:", static_cast<unsigned long long>(definition.hash), definition.textSize);
+		for (const uint32_t buildIndex : store.BuildsContaining(definition))
+		{
+			const auto& build = store.Builds()[buildIndex];
+			std::printf(" %.*s/%.*s", static_cast<int>(store.Game(build).size()), store.Game(build).data(),
+				static_cast<int>(store.Build(build).size()), store.Build(build).data());
+		}
+		std::printf("\n");
+	}
+
+	if (numFound == 0)
+	{
+		std::printf("No definitions of %.*s\n", static_cast<int>(name.size()), name.data());
+	}
+	return 0;
+}
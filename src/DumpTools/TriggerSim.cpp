@@ -0,0 +1,87 @@
+#include "Commands.h"
+#include "DumpTrigger.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+	// Registration timeline of a game launch: structures are registered at a constant rate between two times.
+	struct Scenario
+	{
+		const char* name;
+		bool requireManager;
+		uint64_t managerMs;        // when parManager::sm_Instance becomes non-null, UINT64_MAX if never
+		uint64_t registerStartMs;
+		uint64_t registerEndMs;
+		uint32_t numStructures;
+		uint64_t pauseStartMs;     // registrations stop during [pauseStartMs, pauseEndMs), e.g. a loading screen
+		uint64_t pauseEndMs;
+		DumpTriggerState expectedState;
+	};
+}
+
+static uint32_t RegisteredAt(const Scenario& s, uint64_t timeMs)
+{
+	if (timeMs < s.registerStartMs)
+	{
+		return 0;
+	}
+
+	// time spent registering so far, not counting the pause
+	const uint64_t end = std::min(timeMs, s.registerEndMs);
+	uint64_t active = end - s.registerStartMs;
+	if (end > s.pauseStartMs)
+	{
+		active -= std::min(end, s.pauseEndMs) - s.pauseStartMs;
+	}
+	const uint64_t total = s.registerEndMs - s.registerStartMs - (s.pauseEndMs - s.pauseStartMs);
+	return static_cast<uint32_t>(s.numStructures * active / total);
+}
+
+static DumpTriggerSample SampleAt(const Scenario& s, uint64_t timeMs)
+{
+	const bool hasManager = timeMs >= s.managerMs;
+	const uint32_t registered = RegisteredAt(s, timeMs);
+	return { timeMs, hasManager, hasManager ? registered : 0, registered };
+}
+
+int SimulateTrigger()
+{
+	constexpr uint64_t never = UINT64_MAX;
+	constexpr uint64_t pollMs = 100;
+	constexpr uint64_t fixedSleepMs = 25'000; // what DumpStructs used to wait
+	const Scenario scenarios[]
+	{
+		{ "fast machine",            true,  1'000,  1'000,  6'000, 3000, never, never, DumpTriggerState::Ready },
+		{ "slow machine",            true,  5'000,  5'000, 40'000, 3000, never, never, DumpTriggerState::Ready },
+		{ "pause while registering", true,  1'000,  1'000, 10'000, 3000, 4'000, 5'500, DumpTriggerState::Ready },
+		{ "long pause (slow disk)",  true,  1'000,  1'000, 14'000, 3000, 4'000, 10'000, DumpTriggerState::Ready },
+		{ "lazy parManager",         false, never,  2'000,  8'000, 2000, never, never, DumpTriggerState::Ready },
+		{ "parManager never set",    true,  never,  2'000,  8'000, 2000, never, never, DumpTriggerState::TimedOut },
+	};
+
+	DumpTriggerOptions options;
+	size_t failures = 0;
+	for (auto& s : scenarios)
+	{
+		options.requireManager = s.requireManager;
+		DumpTrigger trigger{ options, 0 };
+		for (uint64_t t = pollMs; !trigger.IsDone(); t += pollMs)
+		{
+			trigger.Update(SampleAt(s, t));
+		}
+
+		// dumping before the registrations end would miss structures
+		const uint32_t dumped = RegisteredAt(s, trigger.ElapsedMs());
+		const uint32_t dumpedFixed = RegisteredAt(s, fixedSleepMs);
+		const bool ok = trigger.State() == s.expectedState && (trigger.State() != DumpTriggerState::Ready || dumped == s.numStructures);
+		std::printf("  %-4s %-24s %-9s after %6.1f s, %4u/%u structures (fixed %.0f s sleep: %4u)\n",
+			ok ? "OK" : "FAIL", s.name, EnumToString(trigger.State()), trigger.ElapsedMs() / 1000.0,
+			dumped, s.numStructures, fixedSleepMs / 1000.0, dumpedFixed);
+		failures += ok ? 0 : 1;
+	}
+
+	std::printf("%zu failures\n", failures);
+	return failures == 0 ? 0 : 1;
+}
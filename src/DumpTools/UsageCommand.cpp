@@ -0,0 +1,244 @@
+#include "Commands.h"
+#include "DumpColumns.h"
+#include "DumpReader.h"
+#include "MappedFile.h"
+#include "UsageIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static double Seconds(std::chrono::steady_clock::duration d)
+{
+	return std::chrono::duration<double>(d).count();
+}
+
+// The users of a struct or enum found like JsonTreeFormatter.GetStructUsage/GetEnumUsage do, scanning every member of the
+// build for each definition. Indices of the structs relative to the first struct of the build.
+static std::vector<uint32_t> ScanUsers(const DumpColumns& columns, uint32_t buildIndex, bool isEnum, uint32_t nameHash)
+{
+	const auto& b = columns.builds[buildIndex];
+	const uint32_t structType = columns.strings.Find("STRUCT");
+	const uint32_t enumType = columns.strings.Find("ENUM");
+	const uint32_t bitsetType = columns.strings.Find("BITSET");
+	const auto uses = [&](const MemberColumns& m, int32_t row)
+	{
+		if (row == -1)
+		{
+			return false;
+		}
+		const uint32_t type = m.type[row];
+		const bool typeMatches = isEnum ? type == enumType || type == bitsetType : type == structType;
+		return typeMatches && m.refNameHash[row] == nameHash;
+	};
+
+	std::vector<uint32_t> users;
+	for (uint32_t s = b.structBegin; s < b.structEnd; s++)
+	{
+		for (uint32_t m = columns.structs.memberBegin[s]; m < columns.structs.memberEnd[s]; m++)
+		{
+			if (uses(columns.members, static_cast<int32_t>(m)) || uses(columns.subMembers, columns.members.item[m]) ||
+				uses(columns.subMembers, columns.members.value[m]))
+			{
+				users.push_back(s - b.structBegin);
+				break;
+			}
+		}
+	}
+	return users;
+}
+
+int BuildUsageIndex(const char* dumpsDir, const char* indexPath)
+{
+	using clock = std::chrono::steady_clock;
+
+	std::map<fs::path, std::vector<fs::path>> games;
+	for (auto& entry : fs::recursive_directory_iterator(dumpsDir))
+	{
+		// only the dumps, which are inside a subdirectory per game
+		if (entry.is_regular_file() && entry.path().extension() == ".json" && entry.path().parent_path() != fs::path{ dumpsDir })
+		{
+			games[entry.path().parent_path()].push_back(entry.path());
+		}
+	}
+
+	DumpColumns columns;
+	DumpModel model;
+	DumpReader reader;
+	std::vector<fs::path> paths;
+	for (auto& [game, gamePaths] : games)
+	{
+		std::sort(gamePaths.begin(), gamePaths.end(), BuildLess);
+		for (auto& path : gamePaths)
+		{
+			MappedFile dump;
+			if (!dump.Open(path.string().c_str()))
+			{
+				std::fprintf(stderr, "Failed to open '%s'\n", path.string().c_str());
+				return 1;
+			}
+			reader.Read(dump.Text(), model);
+			columns.AddBuild(model);
+			paths.push_back(path);
+		}
+	}
+
+	UsageIndexBuilder builder;
+	const auto buildStart = clock::now();
+	for (uint32_t i = 0; i < columns.builds.size(); i++)
+	{
+		builder.AddBuild(columns, i);
+	}
+	const double buildTime = Seconds(clock::now() - buildStart);
+
+	if (!builder.Save(indexPath))
+	{
+		std::fprintf(stderr, "Failed to write '%s'\n", indexPath);
+		return 1;
+	}
+
+	UsageIndex index;
+	const auto openStart = clock::now();
+	if (!index.Open(indexPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s' after writing it\n", indexPath);
+		return 1;
+	}
+	const double openTime = Seconds(clock::now() - openStart);
+
+	// every definition looked up by name in the index and compared with scanning the build for it
+	size_t failures = 0;
+	double lookupTime = 0.0, scanTime = 0.0;
+	std::printf("%-40s %8s %8s %8s %12s %10s %8s\n", "dump", "structs", "enums", "users", "lookups ms", "scan ms", "check");
+	for (uint32_t i = 0; i < columns.builds.size(); i++)
+	{
+		const auto& b = columns.builds[i];
+		const auto* build = index.FindBuild(columns.strings.Get(b.game), columns.strings.Get(b.build));
+		if (build == nullptr)
+		{
+			std::printf("%-40s not in the index\n", fs::relative(paths[i], dumpsDir).string().c_str());
+			failures++;
+			continue;
+		}
+
+		std::vector<std::vector<uint32_t>> found;
+		size_t numUsers = 0;
+		const auto lookupStart = clock::now();
+		const auto lookup = [&](const UsageDefinition* definition)
+		{
+			auto& users = found.emplace_back();
+			if (definition != nullptr)
+			{
+				for (const uint32_t user : index.Users(*definition))
+				{
+					users.push_back(user - build->firstDefinition);
+				}
+			}
+			numUsers += users.size();
+		};
+		for (uint32_t s = b.structBegin; s < b.structEnd; s++)
+		{
+			lookup(index.FindStruct(*build, columns.structs.nameHash[s]));
+		}
+		for (uint32_t e = b.enumBegin; e < b.enumEnd; e++)
+		{
+			lookup(index.FindEnum(*build, columns.enums.nameHash[e]));
+		}
+		const double buildLookupTime = Seconds(clock::now() - lookupStart);
+		lookupTime += buildLookupTime;
+
+		std::vector<std::vector<uint32_t>> scanned;
+		const auto scanStart = clock::now();
+		for (uint32_t s = b.structBegin; s < b.structEnd; s++)
+		{
+			scanned.push_back(ScanUsers(columns, i, false, columns.structs.nameHash[s]));
+		}
+		for (uint32_t e = b.enumBegin; e < b.enumEnd; e++)
+		{
+			scanned.push_back(ScanUsers(columns, i, true, columns.enums.nameHash[e]));
+		}
+		const double buildScanTime = Seconds(clock::now() - scanStart);
+		scanTime += buildScanTime;
+
+		const bool match = found == scanned;
+		failures += match ? 0 : 1;
+		std::printf("%-40s %8u %8u %8zu %12.3f %10.1f %8s\n", fs::relative(paths[i], dumpsDir).string().c_str(),
+			b.structEnd - b.structBegin, b.enumEnd - b.enumBegin, numUsers, buildLookupTime * 1000.0, buildScanTime * 1000.0,
+			match ? "OK" : "MISMATCH");
+	}
+
+	std::printf("\n%zu builds, %zu failed\n", columns.builds.size(), failures);
+	std::printf("%zu definitions, %zu users, index of %.2f KiB\n", builder.DefinitionCount(), builder.UserCount(), index.Size() / 1024.0);
+	std::printf("Build %.1f ms, open %.3f ms, every lookup %.1f ms, every scan %.1f ms\n", buildTime * 1000.0, openTime * 1000.0,
+		lookupTime * 1000.0, scanTime * 1000.0);
+	return failures == 0 ? 0 : 1;
+}
+
+int FindUsage(const char* indexPath, std::string_view game, std::string_view build, std::string_view name)
+{
+	UsageIndex index;
+	if (!index.Open(indexPath))
+	{
+		std::fprintf(stderr, "Failed to open '%s'\n", indexPath);
+		return 1;
+	}
+
+	const auto* usageBuild = index.FindBuild(game, build);
+	if (usageBuild == nullptr)
+	{
+		std::fprintf(stderr, "Build %.*s of %.*s is not in the index\n",
+			static_cast<int>(build.size()), build.data(), static_cast<int>(game.size()), game.data());
+		return 1;
+	}
+
+	// like the formatters, names without a known string are printed as the hash with an underscore
+	const auto print = [&](const UsageDefinition& definition)
+	{
+		const auto str = index.Name(definition);
+		if (str.empty())
+		{
+			std::printf("_0x%08X", definition.nameHash);
+		}
+		else
+		{
+			std::printf("%.*s", static_cast<int>(str.size()), str.data());
+		}
+	};
+
+	const uint32_t nameHash = DumpColumns::NameHash(name);
+	size_t numFound = 0;
+	for (const auto* definition : { index.FindStruct(*usageBuild, nameHash), index.FindEnum(*usageBuild, nameHash) })
+	{
+		if (definition == nullptr)
+		{
+			continue;
+		}
+
+		numFound++;
+		const auto users = index.Users(*definition);
+		const size_t position = definition - index.Definitions().data();
+		std::printf("%s ", position < usageBuild->firstDefinition + usageBuild->structCount ? "struct" : "enum");
+		print(*definition);
+		std::printf(", used by %zu structs\n", users.size());
+		for (const uint32_t user : users)
+		{
+			std::printf("  ");
+			print(index.Definitions()[user]);
+			std::printf("\n");
+		}
+	}
+
+	if (numFound == 0)
+	{
+		std::printf("No struct or enum %.*s in %.*s/%.*s\n", static_cast<int>(name.size()), name.data(),
+			static_cast<int>(game.size()), game.data(), static_cast<int>(build.size()), build.data());
+	}
+	return 0;
+}
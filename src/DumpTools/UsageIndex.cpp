@@ -0,0 +1,233 @@
+#include "UsageIndex.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+static constexpr std::array<char, 8> usage_magic{ 'D', 'S', 'U', 'S', 'A', 'G', 'E', '\0' };
+static constexpr uint32_t usage_version = 1;
+
+uint32_t UsageIndexBuilder::AddChars(std::string_view str)
+{
+	const auto [it, inserted] = _charOffsets.emplace(str, static_cast<uint32_t>(_chars.size()));
+	if (inserted)
+	{
+		_chars.append(str);
+	}
+	return it->second;
+}
+
+void UsageIndexBuilder::AddBuild(const DumpColumns& columns, uint32_t buildIndex)
+{
+	const auto& b = columns.builds[buildIndex];
+	const uint32_t first = static_cast<uint32_t>(_definitions.size());
+	UsageBuild build{};
+	const auto game = columns.strings.Get(b.game);
+	const auto buildName = columns.strings.Get(b.build);
+	build.gameOffset = AddChars(game);
+	build.gameSize = static_cast<uint32_t>(game.size());
+	build.buildOffset = AddChars(buildName);
+	build.buildSize = static_cast<uint32_t>(buildName.size());
+	build.firstDefinition = first;
+	build.structCount = b.structEnd - b.structBegin;
+	build.enumCount = b.enumEnd - b.enumBegin;
+	_builds.push_back(build);
+
+	// the references are by name hash, resolved within the build
+	std::unordered_map<uint32_t, uint32_t> structsByHash, enumsByHash;
+	const auto addDefinition = [&](uint32_t nameHash, uint32_t name, std::unordered_map<uint32_t, uint32_t>& byHash)
+	{
+		const auto str = columns.strings.Get(name);
+		byHash.emplace(nameHash, static_cast<uint32_t>(_definitions.size()));
+		_definitions.push_back({ nameHash, AddChars(str), static_cast<uint32_t>(str.size()) });
+	};
+	for (uint32_t s = b.structBegin; s < b.structEnd; s++)
+	{
+		addDefinition(columns.structs.nameHash[s], columns.structs.name[s], structsByHash);
+	}
+	for (uint32_t e = b.enumBegin; e < b.enumEnd; e++)
+	{
+		addDefinition(columns.enums.nameHash[e], columns.enums.name[e], enumsByHash);
+	}
+	const uint32_t count = static_cast<uint32_t>(_definitions.size()) - first;
+
+	// (definition, user) pairs in the order of the users, each pair once
+	const uint32_t structType = columns.strings.Find("STRUCT");
+	const uint32_t enumType = columns.strings.Find("ENUM");
+	const uint32_t bitsetType = columns.strings.Find("BITSET");
+	std::vector<std::pair<uint32_t, uint32_t>> uses;
+	std::vector<uint32_t> lastUser(count, UINT32_MAX);
+	const auto use = [&](const MemberColumns& m, uint32_t row, uint32_t user)
+	{
+		const uint32_t type = m.type[row];
+		const auto* byHash = type == structType ? &structsByHash : type == enumType || type == bitsetType ? &enumsByHash : nullptr;
+		if (byHash == nullptr)
+		{
+			return;
+		}
+
+		const auto it = byHash->find(m.refNameHash[row]);
+		if (it != byHash->end() && lastUser[it->second - first] != user)
+		{
+			lastUser[it->second - first] = user;
+			uses.emplace_back(it->second - first, user);
+		}
+	};
+	for (uint32_t s = b.structBegin; s < b.structEnd; s++)
+	{
+		const uint32_t user = first + (s - b.structBegin);
+		for (uint32_t m = columns.structs.memberBegin[s]; m < columns.structs.memberEnd[s]; m++)
+		{
+			use(columns.members, m, user);
+			if (columns.members.item[m] != -1)
+			{
+				use(columns.subMembers, columns.members.item[m], user);
+			}
+			if (columns.members.value[m] != -1)
+			{
+				use(columns.subMembers, columns.members.value[m], user);
+			}
+		}
+	}
+
+	// counting sort of the pairs by definition, which keeps the users of each one in order
+	std::vector<uint32_t> cursors(count + 1, 0);
+	for (auto& [definition, user] : uses)
+	{
+		cursors[definition + 1]++;
+	}
+	std::partial_sum(cursors.begin(), cursors.end(), cursors.begin());
+	const uint32_t firstUser = static_cast<uint32_t>(_users.size());
+	for (uint32_t i = 1; i <= count; i++)
+	{
+		_userOffsets.push_back(firstUser + cursors[i]);
+	}
+	_users.resize(_users.size() + uses.size());
+	for (auto& [definition, user] : uses)
+	{
+		_users[firstUser + cursors[definition]++] = user;
+	}
+
+	const auto sortRange = [this](uint32_t begin, uint32_t end)
+	{
+		const size_t offset = _sortedByHash.size();
+		_sortedByHash.resize(offset + (end - begin));
+		std::iota(_sortedByHash.begin() + offset, _sortedByHash.end(), begin);
+		std::stable_sort(_sortedByHash.begin() + offset, _sortedByHash.end(),
+			[this](uint32_t a, uint32_t b) { return _definitions[a].nameHash < _definitions[b].nameHash; });
+	};
+	sortRange(first, first + build.structCount);
+	sortRange(first + build.structCount, first + count);
+}
+
+bool UsageIndexBuilder::Save(const char* path) const
+{
+	if (_chars.size() > UINT32_MAX)
+	{
+		return false;
+	}
+
+	UsageHeader header{};
+	header.magic = usage_magic;
+	header.version = usage_version;
+	header.buildCount = static_cast<uint32_t>(_builds.size());
+	header.definitionCount = static_cast<uint32_t>(_definitions.size());
+	header.userCount = static_cast<uint32_t>(_users.size());
+	header.charCount = _chars.size();
+
+	std::ofstream out{ path, std::ios::out | std::ios::binary | std::ios::trunc };
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(_builds.data()), _builds.size() * sizeof(UsageBuild));
+	out.write(reinterpret_cast<const char*>(_definitions.data()), _definitions.size() * sizeof(UsageDefinition));
+	out.write(reinterpret_cast<const char*>(_sortedByHash.data()), _sortedByHash.size() * sizeof(uint32_t));
+	out.write(reinterpret_cast<const char*>(_userOffsets.data()), _userOffsets.size() * sizeof(uint32_t));
+	out.write(reinterpret_cast<const char*>(_users.data()), _users.size() * sizeof(uint32_t));
+	out.write(_chars.data(), _chars.size());
+	return out.good();
+}
+
+bool UsageIndex::Open(const char* path)
+{
+	if (!_file.Open(path) || _file.Size() < sizeof(UsageHeader))
+	{
+		return false;
+	}
+
+	std::memcpy(&_header, _file.Data(), sizeof(_header));
+	const auto& h = _header;
+	const uint64_t expectedSize = sizeof(UsageHeader) + uint64_t{ h.buildCount } * sizeof(UsageBuild) +
+		uint64_t{ h.definitionCount } * (sizeof(UsageDefinition) + 2 * sizeof(uint32_t)) + sizeof(uint32_t) +
+		uint64_t{ h.userCount } * sizeof(uint32_t) + h.charCount;
+	if (h.magic != usage_magic || h.version != usage_version || h.charCount > UINT32_MAX || _file.Size() != expectedSize)
+	{
+		return false;
+	}
+
+	// each section is aligned for its elements, the mapping itself is page-aligned
+	const uint8_t* data = _file.Data() + sizeof(UsageHeader);
+	_builds = reinterpret_cast<const UsageBuild*>(data);
+	data += h.buildCount * sizeof(UsageBuild);
+	_definitions = reinterpret_cast<const UsageDefinition*>(data);
+	data += h.definitionCount * sizeof(UsageDefinition);
+	_sortedByHash = reinterpret_cast<const uint32_t*>(data);
+	data += h.definitionCount * sizeof(uint32_t);
+	_userOffsets = reinterpret_cast<const uint32_t*>(data);
+	data += (h.definitionCount + 1) * sizeof(uint32_t);
+	_users = reinterpret_cast<const uint32_t*>(data);
+	data += h.userCount * sizeof(uint32_t);
+	_chars = reinterpret_cast<const char*>(data);
+
+	// the lookups trust the offsets and indices, check them once here
+	const auto inRange = [](uint64_t offset, uint64_t size, uint64_t total) { return offset <= total && size <= total - offset; };
+	bool valid = _userOffsets[0] == 0 && _userOffsets[h.definitionCount] == h.userCount;
+	for (auto& b : Builds())
+	{
+		valid = valid && inRange(b.gameOffset, b.gameSize, h.charCount) && inRange(b.buildOffset, b.buildSize, h.charCount) &&
+			inRange(b.firstDefinition, uint64_t{ b.structCount } + b.enumCount, h.definitionCount);
+	}
+	for (uint32_t i = 0; i < h.definitionCount; i++)
+	{
+		valid = valid && inRange(_definitions[i].nameOffset, _definitions[i].nameSize, h.charCount) &&
+			_sortedByHash[i] < h.definitionCount && _userOffsets[i] <= _userOffsets[i + 1];
+	}
+	for (uint32_t i = 0; i < h.userCount; i++)
+	{
+		valid = valid && _users[i] < h.definitionCount;
+	}
+	if (!valid)
+	{
+		_file.Close();
+	}
+	return valid;
+}
+
+const UsageBuild* UsageIndex::FindBuild(std::string_view game, std::string_view build) const
+{
+	for (auto& b : Builds())
+	{
+		if (Game(b) == game && Build(b) == build)
+		{
+			return &b;
+		}
+	}
+	return nullptr;
+}
+
+const UsageDefinition* UsageIndex::Find(uint32_t firstSorted, uint32_t count, uint32_t nameHash) const
+{
+	const uint32_t* begin = _sortedByHash + firstSorted;
+	const uint32_t* end = begin + count;
+	const uint32_t* it = std::lower_bound(begin, end, nameHash,
+		[this](uint32_t definition, uint32_t hash) { return _definitions[definition].nameHash < hash; });
+	return it != end && _definitions[*it].nameHash == nameHash ? &_definitions[*it] : nullptr;
+}
+
+const UsageDefinition* UsageIndex::FindStruct(const UsageBuild& build, uint32_t nameHash) const
+{
+	return Find(build.firstDefinition, build.structCount, nameHash);
+}
+
+const UsageDefinition* UsageIndex::FindEnum(const UsageBuild& build, uint32_t nameHash) const
+{
+	return Find(build.firstDefinition + build.structCount, build.enumCount, nameHash);
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include "DumpColumns.h"
+#include "MappedFile.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Reverse references of the structs and enums of many builds: for each of them, the structs of the same build with a member
+// of that type, the same as the Usage lists of JsonTreeFormatter. A member uses a struct if it is a STRUCT member of it, an
+// enum if it is an ENUM or BITSET member of it, and the item of an array and the key and value of a map count as members of
+// the struct. Each struct is listed once, in the order of the dump.
+//
+// The index is a single file meant to be memory-mapped, the users are in CSR form so a lookup is a slice of `users`:
+//
+//   UsageHeader
+//   UsageBuild builds[buildCount]
+//   UsageDefinition definitions[definitionCount] // of each build, its structs and then its enums, in the order of the dump
+//   uint32_t sortedByHash[definitionCount]       // of each build, the indices of its structs and then of its enums, sorted by name hash
+//   uint32_t userOffsets[definitionCount + 1]    // the users of definitions[i] are users[userOffsets[i], userOffsets[i + 1])
+//   uint32_t users[userCount]                    // indices in definitions of the structs
+//   char chars[charCount]                        // names, games and builds
+
+struct UsageHeader
+{
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t buildCount;
+	uint32_t definitionCount;
+	uint32_t userCount;
+	uint64_t charCount;
+};
+
+struct UsageBuild
+{
+	uint32_t gameOffset;
+	uint32_t gameSize;
+	uint32_t buildOffset;
+	uint32_t buildSize;
+	uint32_t firstDefinition;
+	uint32_t structCount;
+	uint32_t enumCount;
+};
+
+struct UsageDefinition
+{
+	uint32_t nameHash;
+	uint32_t nameOffset;
+	uint32_t nameSize;   // 0 if the dump only has the hash
+};
+
+// Builds the index from the columns, in a single pass over the members of each build.
+class UsageIndexBuilder
+{
+public:
+	void AddBuild(const DumpColumns& columns, uint32_t build);
+	bool Save(const char* path) const;
+
+	size_t DefinitionCount() const { return _definitions.size(); }
+	size_t UserCount() const { return _users.size(); }
+
+private:
+	uint32_t AddChars(std::string_view str);
+
+	std::vector<UsageBuild> _builds;
+	std::vector<UsageDefinition> _definitions;
+	std::vector<uint32_t> _sortedByHash;
+	std::vector<uint32_t> _userOffsets{ 0 };
+	std::vector<uint32_t> _users;
+	std::string _chars;
+	std::unordered_map<std::string, uint32_t> _charOffsets; // the names repeat in every build, each is stored once
+};
+
+// Read-only view of an index file.
+class UsageIndex
+{
+public:
+	// Returns false if the file could not be read or is not a valid index.
+	bool Open(const char* path);
+
+	std::span<const UsageBuild> Builds() const { return { _builds, _header.buildCount }; }
+	std::span<const UsageDefinition> Definitions() const { return { _definitions, _header.definitionCount }; }
+
+	std::string_view Game(const UsageBuild& build) const { return Chars(build.gameOffset, build.gameSize); }
+	std::string_view Build(const UsageBuild& build) const { return Chars(build.buildOffset, build.buildSize); }
+	// Empty if the dump only has the hash.
+	std::string_view Name(const UsageDefinition& definition) const { return Chars(definition.nameOffset, definition.nameSize); }
+	// Indices in Definitions() of the structs that use the definition.
+	std::span<const uint32_t> Users(const UsageDefinition& definition) const
+	{
+		const size_t index = &definition - _definitions;
+		return { _users + _userOffsets[index], _users + _userOffsets[index + 1] };
+	}
+
+	// nullptr if not found.
+	const UsageBuild* FindBuild(std::string_view game, std::string_view build) const;
+	const UsageDefinition* FindStruct(const UsageBuild& build, uint32_t nameHash) const;
+	const UsageDefinition* FindEnum(const UsageBuild& build, uint32_t nameHash) const;
+
+	size_t Size() const { return _file.Size(); }
+
+private:
+	std::string_view Chars(uint32_t offset, uint32_t size) const { return { _chars + offset, size }; }
+	const UsageDefinition* Find(uint32_t firstSorted, uint32_t count, uint32_t nameHash) const;
+
+	MappedFile _file;
+	UsageHeader _header{};
+	const UsageBuild* _builds = nullptr;
+	const UsageDefinition* _definitions = nullptr;
+	const uint32_t* _sortedByHash = nullptr;
+	const uint32_t* _userOffsets = nullptr;
+	const uint32_t* _users = nullptr;
+	const char* _chars = nullptr;
+};
@@ -0,0 +1,391 @@
+#include "Commands.h"
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+static void PrintUsage()
+{
+	std::puts(
+		"Usage:\n"
+		"  DumpTools tobinary <input.json> <output.pardump>\n"
+		"  DumpTools tojson <input.pardump> <output.json>\n"
+		"  DumpTools roundtrip <dumps-dir>\n"
+		"  DumpTools patterns <rdr3|rdr2|gta5|gta5g9|mp3|gta4> [--mapped] [--cache <file>] <executable>...\n"
+		"      --mapped: the executables are dumps of the image as loaded in memory\n"
+		"      --cache: read and update a pattern cache file (DumpStructs.patterns in the game directory)\n"
+		"  DumpTools bench-patterns [size-MiB | <executable>]\n"
+		"  DumpTools pattern-cache-check\n"
+		"  DumpTools trigger-sim\n"
+		"  DumpTools bench-enums [max-members]\n"
+		"  DumpTools bench-json [num-structs]\n"
+		"  DumpTools bench-writer <dump.json> [runs]\n"
+		"  DumpTools fuzz-escape [num-strings]\n"
+		"  DumpTools bench-escape <dumps-dir> [runs]\n"
+		"  DumpTools bench-calls [num-structs]\n"
+		"  DumpTools walk-snapshot <snapshot>\n"
+		"  DumpTools snapshot-dump <snapshot> <output.json|output.pardump> [dictionary.txt]\n"
+		"  DumpTools snapshot-check <snapshot> <dump.json> [dictionary.txt]\n"
+		"      dump.json: written by DumpStructs with DUMPSTRUCTS_SNAPSHOT=2, along with the snapshot (=1 only takes the snapshot)\n"
+		"  DumpTools bench-walk [num-structs]\n"
+		"  DumpTools count-allocs [max-structs]\n"
+		"  DumpTools bench-names <dump.json> [dictionary.txt]\n"
+		"  DumpTools name-index <dictionary.txt> [index]\n"
+		"  DumpTools delta <baseline.json> <dump.json> <output.delta.json>\n"
+		"  DumpTools reconstruct <baseline.json> <input.delta.json> <output.json>\n"
+		"  DumpTools delta-check <dumps-dir>\n"
+		"  DumpTools store-import <dumps-dir> <store>\n"
+		"  DumpTools store-export <store> <game> <build> <output.json>\n"
+		"  DumpTools store-find <store> <name>\n"
+		"  DumpTools bench-reader <dumps-dir>\n"
+		"  DumpTools bench-columns <dumps-dir>\n"
+		"  DumpTools query <dumps-dir> <structs|members> [--build <game>/<build>]... [--changed <field>] [--threads N] [--stream] [filter]\n"
+		"      filter: e.g. \"type == ARRAY && flags1 & 0x8\", fields: name base size align members struct offset type subtype\n"
+		"              flags1 flags2 structName enumName attribute\n"
+		"      --changed: with two builds, the rows of the second whose field changed since the first\n"
+		"      --stream: a JSON object per line, printed as each build is scanned\n"
+		"  DumpTools usage-index <dumps-dir> <index>\n"
+		"  DumpTools usage-find <index> <game> <build> <name>\n"
+		"  DumpTools search-index <registry.json> <dumps-dir> <output-dir> [dictionary.txt]\n"
+		"  DumpTools search <index> [--match-case] [--regex] [--members] <text>");
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const std::string_view command = argv[1];
+	try
+	{
+		if (command == "tobinary" && argc == 4)
+		{
+			return ToBinary(argv[2], argv[3]);
+		}
+		else if (command == "tojson" && argc == 4)
+		{
+			return ToJson(argv[2], argv[3]);
+		}
+		else if (command == "roundtrip" && argc == 3)
+		{
+			return RoundTrip(argv[2]);
+		}
+		else if (command == "patterns" && argc >= 4)
+		{
+			bool mapped = false;
+			const char* cachePath = nullptr;
+			int first = 3;
+			for (; first < argc; first++)
+			{
+				if (std::strcmp(argv[first], "--mapped") == 0)
+				{
+					mapped = true;
+				}
+				else if (std::strcmp(argv[first], "--cache") == 0 && first + 1 < argc)
+				{
+					cachePath = argv[++first];
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			if (first < argc)
+			{
+				return ScanPatterns(argv[2], std::span<const char* const>{ argv + first, static_cast<size_t>(argc - first) }, mapped, cachePath);
+			}
+		}
+		else if (command == "bench-patterns" && argc <= 3)
+		{
+			size_t sizeMiB = 64;
+			const char* executablePath = nullptr;
+			if (argc == 3)
+			{
+				const std::string_view arg = argv[2];
+				auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), sizeMiB);
+				if (ec != std::errc{} || ptr != arg.data() + arg.size())
+				{
+					executablePath = argv[2];
+				}
+			}
+			return BenchPatterns(sizeMiB, executablePath);
+		}
+		else if (command == "pattern-cache-check" && argc == 2)
+		{
+			return CheckPatternCache();
+		}
+		else if (command == "trigger-sim" && argc == 2)
+		{
+			return SimulateTrigger();
+		}
+		else if (command == "bench-enums" && argc <= 3)
+		{
+			size_t maxCount = 20'000;
+			if (argc == 3)
+			{
+				const std::string_view arg = argv[2];
+				auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), maxCount);
+				if (ec != std::errc{} || ptr != arg.data() + arg.size())
+				{
+					PrintUsage();
+					return 1;
+				}
+			}
+			return BenchEnums(maxCount);
+		}
+		else if (command == "bench-json" && argc <= 3)
+		{
+			size_t numStructs = 100'000;
+			if (argc == 3)
+			{
+				const std::string_view arg = argv[2];
+				auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), numStructs);
+				if (ec != std::errc{} || ptr != arg.data() + arg.size())
+				{
+					PrintUsage();
+					return 1;
+				}
+			}
+			return BenchJson(numStructs);
+		}
+		else if (command == "bench-writer" && (argc == 3 || argc == 4))
+		{
+			size_t numRuns = 10;
+			if (argc == 4)
+			{
+				const std::string_view arg = argv[3];
+				auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), numRuns);
+				if (ec != std::errc{} || ptr != arg.data() + arg.size() || numRuns == 0)
+				{
+					PrintUsage();
+					return 1;
+				}
+			}
+			return BenchWriter(argv[2], numRuns);
+		}
+		else if (command == "fuzz-escape" && argc <= 3)
+		{
+			size_t numStrings = 200'000;
+			if (argc == 3)
+			{
+				const std::string_view arg = argv[2];
+				auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), numStrings);
+				if (ec != std::errc{} || ptr != arg.data() + arg.size())
+				{
+					PrintUsage();
+					return 1;
+				}
+			}
+			return FuzzEscape(numStrings);
+		}
+		else if (command == "bench-escape" && (argc == 3 || argc == 4))
+		{
+			size_t numRuns = 5;
+			if (argc == 4)
+			{
+				const std::string_view arg = argv[3];
+				auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), numRuns);
+				if (ec != std::errc{} || ptr != arg.data() + arg.size() || numRuns == 0)
+				{
+					PrintUsage();
+					return 1;
+				}
+			}
+			return BenchEscape(argv[2], numRuns);
+		}
+		else if (command == "bench-calls" && argc <= 3)
+		{
+			size_t numStructs = 10'000;
+			if (argc == 3)
+			{
+				const std::string_view arg = argv[2];
+				auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), numStructs);
+				if (ec != std::errc{} || ptr != arg.data() + arg.size())
+				{
+					PrintUsage();
+					return 1;
+				}
+			}
+			return BenchCallCache(numStructs);
+		}
+		else if (command == "walk-snapshot" && argc == 3)
+		{
+			return WalkSnapshot(argv[2]);
+		}
+		else if (command == "snapshot-dump" && (argc == 4 || argc == 5))
+		{
+			return DumpSnapshot(argv[2], argv[3], argc == 5 ? argv[4] : nullptr);
+		}
+		else if (command == "snapshot-check" && (argc == 4 || argc == 5))
+		{
+			return CheckSnapshotDump(argv[2], argv[3], argc == 5 ? argv[4] : nullptr);
+		}
+		else if (command == "bench-walk" && argc <= 3)
+		{
+			size_t numStructs = 5'000;
+			if (argc == 3)
+			{
+				const std::string_view arg = argv[2];
+				auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), numStructs);
+				if (ec != std::errc{} || ptr != arg.data() + arg.size())
+				{
+					PrintUsage();
+					return 1;
+				}
+			}
+			return BenchWalk(numStructs);
+		}
+		else if (command == "count-allocs" && argc <= 3)
+		{
+			size_t maxStructs = 256'000;
+			if (argc == 3)
+			{
+				const std::string_view arg = argv[2];
+				auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), maxStructs);
+				if (ec != std::errc{} || ptr != arg.data() + arg.size())
+				{
+					PrintUsage();
+					return 1;
+				}
+			}
+			return CountAllocs(maxStructs);
+		}
+		else if (command == "bench-names" && (argc == 3 || argc == 4))
+		{
+			return BenchNames(argv[2], argc == 4 ? argv[3] : nullptr);
+		}
+		else if (command == "name-index" && (argc == 3 || argc == 4))
+		{
+			return BuildNameIndex(argv[2], argc == 4 ? argv[3] : nullptr);
+		}
+		else if (command == "delta" && argc == 5)
+		{
+			return MakeDelta(argv[2], argv[3], argv[4]);
+		}
+		else if (command == "reconstruct" && argc == 5)
+		{
+			return Reconstruct(argv[2], argv[3], argv[4]);
+		}
+		else if (command == "delta-check" && argc == 3)
+		{
+			return CheckDeltas(argv[2]);
+		}
+		else if (command == "store-import" && argc == 4)
+		{
+			return ImportStore(argv[2], argv[3]);
+		}
+		else if (command == "store-export" && argc == 6)
+		{
+			return ExportStoreBuild(argv[2], argv[3], argv[4], argv[5]);
+		}
+		else if (command == "store-find" && argc == 4)
+		{
+			return FindDefinitions(argv[2], argv[3]);
+		}
+		else if (command == "bench-reader" && argc == 3)
+		{
+			return BenchReader(argv[2]);
+		}
+		else if (command == "bench-columns" && argc == 3)
+		{
+			return BenchColumns(argv[2]);
+		}
+		else if (command == "usage-index" && argc == 4)
+		{
+			return BuildUsageIndex(argv[2], argv[3]);
+		}
+		else if (command == "usage-find" && argc == 6)
+		{
+			return FindUsage(argv[2], argv[3], argv[4], argv[5]);
+		}
+		else if (command == "search-index" && (argc == 5 || argc == 6))
+		{
+			return BuildSearchIndex(argv[2], argv[3], argv[4], argc == 6 ? argv[5] : nullptr);
+		}
+		else if (command == "search" && argc >= 4)
+		{
+			bool matchCase = false, regex = false, matchMembers = false;
+			int first = 3;
+			for (; first < argc; first++)
+			{
+				if (std::strcmp(argv[first], "--match-case") == 0)
+				{
+					matchCase = true;
+				}
+				else if (std::strcmp(argv[first], "--regex") == 0)
+				{
+					regex = true;
+				}
+				else if (std::strcmp(argv[first], "--members") == 0)
+				{
+					matchMembers = true;
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			if (first + 1 == argc)
+			{
+				return SearchNames(argv[2], argv[first], matchCase, regex, matchMembers);
+			}
+		}
+		else if (command == "query" && argc >= 4)
+		{
+			std::vector<const char*> builds;
+			const char* changedField = nullptr;
+			size_t numThreads = std::thread::hardware_concurrency();
+			bool stream = false;
+			int first = 4;
+			for (; first < argc; first++)
+			{
+				if (std::strcmp(argv[first], "--build") == 0 && first + 1 < argc)
+				{
+					builds.push_back(argv[++first]);
+				}
+				else if (std::strcmp(argv[first], "--changed") == 0 && first + 1 < argc)
+				{
+					changedField = argv[++first];
+				}
+				else if (std::strcmp(argv[first], "--threads") == 0 && first + 1 < argc)
+				{
+					const std::string_view arg = argv[++first];
+					if (std::from_chars(arg.data(), arg.data() + arg.size(), numThreads).ptr != arg.data() + arg.size())
+					{
+						PrintUsage();
+						return 1;
+					}
+				}
+				else if (std::strcmp(argv[first], "--stream") == 0)
+				{
+					stream = true;
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			if (first + 1 >= argc)
+			{
+				return RunQuery(argv[2], argv[3], builds, changedField, numThreads, stream, first < argc ? argv[first] : nullptr);
+			}
+		}
+	}
+	catch (const std::exception& ex)
+	{
+		std::fprintf(stderr, "Error: %s\n", ex.what());
+		return 1;
+	}
+
+	PrintUsage();
+	return 1;
+}
@@ -3,6 +3,7 @@ import "./CodeSnippet";
 import "./DumpDownloads";
 import {GameId, JTree, JTreeNode, JTreeStructNode, hasDiffInfo} from "../types";
 import {animateButtonClick, gameIdToFormattedName} from "../util";
+import {SearchIndex, fetchSearchIndex} from "../search_index";
 import {LitElement, html, nothing, TemplateResult} from 'lit';
 import {customElement, state, query} from 'lit/decorators.js';
 import {Ref, createRef, ref} from 'lit/directives/ref.js';
@@ -208,6 +209,8 @@ export default class DumpTree extends LitElement {
     private searchInput!: HTMLInputElement;
 
     private hashIdToNameIdMap: Map<string, string> = new Map();
+    // to rule out most types before matching them, null while it is loading or if the build has none
+    private searchIndex: SearchIndex | null = null;
 
     override connectedCallback(): void {
         super.connectedCallback();
@@ -712,13 +715,26 @@ export default class DumpTree extends LitElement {
             text = this.searchOptions.matchCase ? text : text.toLowerCase();
             matcher = str => str.indexOf(text) !== -1;
         }
-        const foundNodes = this.doSearch(this.nodes, matcher);
+        const foundNodes = this.doSearch(this.nodes, matcher, this.findSearchCandidates(text));
         this.onSearchDone(foundNodes);
     }
 
+    /**
+     * Names of the types that may match the search, from the search index.
+     * @returns The names, or `null` if every type has to be matched: there is no index, or the search is not of plain
+     * text in the type names (the index has no trigrams of the struct markup that 'matchMembers' searches).
+     */
+    private findSearchCandidates(text: string): Set<string> | null {
+        if (this.searchIndex === null || text.length === 0 || this.searchOptions.regex || this.searchOptions.matchMembers) {
+            return null;
+        }
+        return this.searchIndex.candidates(text);
+    }
+
     private doSearch(
         nodes: readonly TreeNode[],
         matcher: (str: string) => boolean,
+        candidates: Set<string> | null,
         state: { parentMatch?: boolean } = {}
     ): SearchResult[] {
         const results = [];
@@ -727,20 +743,22 @@ export default class DumpTree extends LitElement {
             const name = this.searchOptions.matchMembers ?
                 (this.searchOptions.matchCase ? node.markup : node.markupLowerCase) : // TODO: search only member names with 'matchMembers' set
                 (this.searchOptions.matchCase ? node.name : node.nameLowerCase);
+            // the types ruled out by the index can't match, the rest are matched as without it
+            const isCandidate = candidates === null || candidates.has(node.name);
             let match = false;
             let childrenResults = null;
             if (this.searchOptions.showChildren) {
-                match = state.parentMatch || matcher(name);
+                match = state.parentMatch || (isCandidate && matcher(name));
                 const prevParentMatch = state.parentMatch;
                 state.parentMatch = match;
 
-                childrenResults = node.children ? this.doSearch(node.children, matcher, state) : null;
+                childrenResults = node.children ? this.doSearch(node.children, matcher, candidates, state) : null;
                 match = (childrenResults && childrenResults.length > 0) || match;
 
                 state.parentMatch = prevParentMatch || false;
             } else {
-                childrenResults = node.children ? this.doSearch(node.children, matcher, state) : null;
-                match = (childrenResults && childrenResults.length > 0) || matcher(name);
+                childrenResults = node.children ? this.doSearch(node.children, matcher, candidates, state) : null;
+                match = (childrenResults && childrenResults.length > 0) || (isCandidate && matcher(name));
             }
 
 
@@ -872,6 +890,7 @@ export default class DumpTree extends LitElement {
         };
         initNodes(this.nodes, null);
         this.visibleNodes = this.buildVisibleNodes(this.nodes);
+        this.loadSearchIndex();
         this.visibleNodesToRender = this.visibleNodes; // all nodes are visible initially
 
         if (this.nodes.length === 0) {
@@ -900,6 +919,29 @@ export default class DumpTree extends LitElement {
         }
     }
 
+    /**
+     * Fetches the search index of the build, which is only used if it has the same types as the tree. Until then, or without
+     * it, searches match every type.
+     */
+    private async loadSearchIndex(): Promise<void> {
+        this.searchIndex = null;
+        const isDiff = this.buildB !== null;
+        if (this.game === null || this.buildA === null || isDiff) {
+            return;
+        }
+
+        const allNodes = this.visibleNodes; // before any search filters it
+        const index = await fetchSearchIndex(this.game, this.buildA);
+        if (index === null) {
+            return;
+        }
+
+        const names = new Set(index.names);
+        if (allNodes.length === index.names.length && allNodes.every(n => names.has(n.name))) {
+            this.searchIndex = index;
+        }
+    }
+
     public setGameBuild(game: GameId, buildA: string, buildB: string | null): void {
         this.game = game;
         this.buildA = buildA;
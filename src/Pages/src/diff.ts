@@ -4,7 +4,16 @@ import DumpTree from "./components/DumpTree";
 
 import {gameIdToName, getDumpURL, hideElement} from "./util"
 import {DIFF_DELETE, DIFF_EQUAL, DIFF_INSERT, diff_match_patch} from "./diff_match_patch";
-import {isGameId, JTree, JTreeNodeWithDiffInfo, JTreeStructNode, JTreeStructNodeWithDiffInfo} from "./types";
+import {
+    GameId,
+    isGameId,
+    JDiff,
+    JDiffNode,
+    JTree,
+    JTreeNodeWithDiffInfo,
+    JTreeStructNode,
+    JTreeStructNodeWithDiffInfo
+} from "./types";
 
 type Diff = { [0]: number, [1]: string }; // typed alias for diff_match_patch.Diff;
 
@@ -34,16 +43,9 @@ async function init(): Promise<{ error?: any, errorMessage: string } | null> {
     tree.setGameBuild(game, buildA, buildB);
 
     const errorMessage = `Failed to fetch dumps for ${gameIdToName(game)} builds ${buildA} and ${buildB}.`;
-    const jsonLocA = getDumpURL(game, buildA, "tree.json");
-    const jsonLocB = getDumpURL(game, buildB, "tree.json");
     try {
-        const [treeA, treeB] = await Promise.all([
-            fetch(jsonLocA).then(r => r.json()),
-            fetch(jsonLocB).then(r => r.json()),
-        ]);
-        if (treeA && treeB) {
-            const treeDiff = getTreeDiff(treeA, treeB);
-
+        const treeDiff = await fetchPrecomputedDiff(game, buildA, buildB) ?? await fetchTreeDiff(game, buildA, buildB);
+        if (treeDiff) {
             tree.setTree(treeDiff);
         } else {
             return { errorMessage };
@@ -55,6 +57,76 @@ async function init(): Promise<{ error?: any, errorMessage: string } | null> {
     return null;
 }
 
+/**
+ * Gets the diff from the *.diff.json precomputed by DumpFormatter for adjacent builds, in either order.
+ * @returns the diff tree, or `null` if there is no precomputed diff for these builds.
+ */
+async function fetchPrecomputedDiff(game: GameId, buildA: string, buildB: string): Promise<JTree | null> {
+    async function fetchDiff(a: string, b: string): Promise<JDiff | null> {
+        const r = await fetch(getDumpURL(game, `${a}_b${b}`, "diff.json"));
+        return r.ok ? r.json() : null;
+    }
+
+    const diff = await fetchDiff(buildA, buildB);
+    if (diff !== null) {
+        return getTreeFromDiff(diff, false);
+    }
+
+    const reversedDiff = await fetchDiff(buildB, buildA);
+    return reversedDiff !== null ? getTreeFromDiff(reversedDiff, true) : null;
+}
+
+/**
+ * Gets the diff comparing the full *.tree.json of both builds, for builds without a precomputed diff.
+ */
+async function fetchTreeDiff(game: GameId, buildA: string, buildB: string): Promise<JTree | null> {
+    const [treeA, treeB] = await Promise.all([
+        fetch(getDumpURL(game, buildA, "tree.json")).then(r => r.json()),
+        fetch(getDumpURL(game, buildB, "tree.json")).then(r => r.json()),
+    ]);
+    return treeA && treeB ? getTreeDiff(treeA, treeB) : null;
+}
+
+function getTreeFromDiff(diff: JDiff, reversed: boolean): JTree {
+    function getMarkups(n: JDiffNode): [string, string] {
+        const a = n.diffType === "a" ? "" : n.markup;
+        const b = n.diffType === "r" ? "" : (n.diffType === "a" ? n.markup : n.markupB || "");
+        return reversed ? [b, a] : [a, b];
+    }
+
+    function getDiffType(n: JDiffNode): "a" | "r" | "m" {
+        if (!reversed || n.diffType === "m") {
+            return n.diffType;
+        }
+        return n.diffType === "a" ? "r" : "a";
+    }
+
+    const structs = diff.structs.map(n => {
+        const [a, b] = getMarkups(n);
+        const s: JTreeStructNodeWithDiffInfo = {
+            name: n.name,
+            hash: n.hash,
+            size: n.size ?? 0,
+            align: n.align ?? 0,
+            xml: "",
+            markup: computeDiffMarkup(a, b),
+            diffType: getDiffType(n),
+        };
+        return s;
+    });
+    const enums = diff.enums.map(n => {
+        const [a, b] = getMarkups(n);
+        const e: JTreeNodeWithDiffInfo = {
+            name: n.name,
+            hash: n.hash,
+            markup: computeDiffMarkup(a, b),
+            diffType: getDiffType(n),
+        };
+        return e;
+    });
+    return { structs, enums };
+}
+
 function diff_characterMode(text1: string, text2: string): Diff[] {
     const dmp = new diff_match_patch();
     const diffs = dmp.diff_main(text1, text2, false);
@@ -0,0 +1,187 @@
+import {GameId} from "./types";
+import {getDumpURL} from "./util";
+
+const MAGIC = "DSSRCH";
+const VERSION = 1;
+const HEADER_SIZE = 40;
+const DOCUMENT_SIZE = 16;
+const NAME_SIZE = 8;
+const TRIGRAM_SIZE = 12;
+
+/**
+ * Trigram index of the struct and enum names of a build, the *.search file written by `DumpTools search-index` (the layout
+ * is documented in SearchIndex.h). It rules out the types whose name cannot contain a text, the rest still have to be
+ * matched against it.
+ */
+export class SearchIndex {
+    /**
+     * Names of the structs and then the enums, in the order of the dump.
+     */
+    readonly names: readonly string[];
+
+    private readonly view: DataView;
+    private readonly nameTrigramsOffset: number;
+    private readonly nameTrigramCount: number;
+    private readonly postingsOffset: number;
+    private readonly postingsEnd: number;
+
+    private constructor(view: DataView, names: string[], nameTrigramsOffset: number, nameTrigramCount: number,
+                        postingsOffset: number, postingsEnd: number) {
+        this.view = view;
+        this.names = names;
+        this.nameTrigramsOffset = nameTrigramsOffset;
+        this.nameTrigramCount = nameTrigramCount;
+        this.postingsOffset = postingsOffset;
+        this.postingsEnd = postingsEnd;
+    }
+
+    /**
+     * @returns The index, or `null` if the data is not a valid index.
+     */
+    static parse(buffer: ArrayBuffer): SearchIndex | null {
+        const view = new DataView(buffer);
+        if (buffer.byteLength < HEADER_SIZE) {
+            return null;
+        }
+
+        const magic = new TextDecoder().decode(new Uint8Array(buffer, 0, MAGIC.length));
+        const u32 = (offset: number) => view.getUint32(offset, true);
+        const version = u32(8);
+        const documentCount = u32(12);
+        const memberCount = u32(20);
+        const nameTrigramCount = u32(24);
+        const memberTrigramCount = u32(28);
+        const postingBytes = u32(32);
+        const charCount = u32(36);
+        const documentsOffset = HEADER_SIZE;
+        const nameTrigramsOffset = documentsOffset + documentCount * DOCUMENT_SIZE + memberCount * NAME_SIZE;
+        const postingsOffset = nameTrigramsOffset + (nameTrigramCount + memberTrigramCount) * TRIGRAM_SIZE;
+        const charsOffset = postingsOffset + postingBytes;
+        if (magic !== MAGIC || version !== VERSION || buffer.byteLength !== charsOffset + charCount) {
+            return null;
+        }
+
+        const chars = new Uint8Array(buffer, charsOffset, charCount);
+        const decoder = new TextDecoder();
+        const names = new Array<string>(documentCount);
+        for (let i = 0; i < documentCount; i++) {
+            const offset = u32(documentsOffset + i * DOCUMENT_SIZE);
+            const size = u32(documentsOffset + i * DOCUMENT_SIZE + 4);
+            if (offset + size > charCount) {
+                return null;
+            }
+            names[i] = decoder.decode(chars.subarray(offset, offset + size));
+        }
+
+        return new SearchIndex(view, names, nameTrigramsOffset, nameTrigramCount, postingsOffset, charsOffset);
+    }
+
+    /**
+     * Names of the types whose name may contain `text`, in any case.
+     * @returns The names, or `null` if the index can't rule out any type (the text is shorter than a trigram or is not ASCII).
+     */
+    candidates(text: string): Set<string> | null {
+        // the trigrams of the index are of the names in lowercase, ASCII only
+        const lower = text.toLowerCase();
+        if (lower.length < 3 || /[^\x00-\x7F]/.test(lower)) {
+            return null;
+        }
+
+        const trigrams = new Set<number>();
+        for (let i = 0; i + 3 <= lower.length; i++) {
+            trigrams.add((lower.charCodeAt(i) << 16) | (lower.charCodeAt(i + 1) << 8) | lower.charCodeAt(i + 2));
+        }
+
+        // intersected from the trigram with the fewest documents, so the lists only get shorter
+        const entries = [];
+        for (const trigram of trigrams) {
+            const entry = this.findNameTrigram(trigram);
+            if (entry === null) {
+                return new Set();
+            }
+            entries.push(entry);
+        }
+        entries.sort((a, b) => a.documentCount - b.documentCount);
+
+        let documents: number[] | null = null;
+        for (const entry of entries) {
+            const postings = this.decodePostings(entry.postingOffset, entry.documentCount);
+            documents = documents === null ? postings : intersect(documents, postings);
+            if (documents.length === 0) {
+                break;
+            }
+        }
+
+        return new Set((documents ?? []).map(d => this.names[d]));
+    }
+
+    private findNameTrigram(trigram: number): { postingOffset: number, documentCount: number } | null {
+        let lo = 0;
+        let hi = this.nameTrigramCount;
+        while (lo < hi) {
+            const mid = (lo + hi) >>> 1;
+            const offset = this.nameTrigramsOffset + mid * TRIGRAM_SIZE;
+            const value = this.view.getUint32(offset, true);
+            if (value < trigram) {
+                lo = mid + 1;
+            } else if (value > trigram) {
+                hi = mid;
+            } else {
+                return { postingOffset: this.view.getUint32(offset + 4, true), documentCount: this.view.getUint32(offset + 8, true) };
+            }
+        }
+        return null;
+    }
+
+    // a posting list is a LEB128 varint per document, the difference with the previous one
+    private decodePostings(postingOffset: number, documentCount: number): number[] {
+        const documents = [];
+        let p = this.postingsOffset + postingOffset;
+        let document = 0;
+        for (let i = 0; i < documentCount && p < this.postingsEnd; i++) {
+            let delta = 0;
+            for (let shift = 0; p < this.postingsEnd && shift < 32; shift += 7) {
+                const b = this.view.getUint8(p++);
+                delta += (b & 0x7F) * 2 ** shift;
+                if ((b & 0x80) === 0) {
+                    break;
+                }
+            }
+            document += delta;
+            if (document >= this.names.length) {
+                break;
+            }
+            documents.push(document);
+        }
+        return documents;
+    }
+}
+
+function intersect(a: number[], b: number[]): number[] {
+    const result = [];
+    for (let i = 0, j = 0; i < a.length && j < b.length;) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            result.push(a[i]);
+            i++;
+            j++;
+        }
+    }
+    return result;
+}
+
+/**
+ * Fetches the search index of a build.
+ * @returns The index, or `null` if the build has none (e.g. DumpTools was not available when the site was built).
+ */
+export async function fetchSearchIndex(game: GameId, build: string): Promise<SearchIndex | null> {
+    try {
+        const response = await fetch(getDumpURL(game, build, "search"));
+        return response.ok ? SearchIndex.parse(await response.arrayBuffer()) : null;
+    } catch {
+        return null;
+    }
+}
@@ -87,6 +87,30 @@ export type JTreeStructField = {
     subtype: string,
 };
 
+/**
+ * Model for the *.diff.json file, the precomputed diff between two builds.
+ * @see {@link DumpFormatter/Diff/DiffArtifact.cs} for the C# implementation.
+ */
+export type JDiff = {
+    buildA: string,
+    buildB: string,
+    structs: JDiffNode[],
+    enums: JDiffNode[],
+};
+
+/**
+ * Struct or enum in a {@link JDiff}. The markup is of build A, or of build B for added nodes.
+ */
+export interface JDiffNode {
+    name: string;
+    hash: string;
+    diffType: "a" | "r" | "m";
+    size?: number;
+    align?: number;
+    markup: string;
+    markupB?: string;
+}
+
 export function hasDiffInfo(node: JTreeNode): node is JTreeNodeWithDiffInfo {
     return "diffType" in node;
 }
\ No newline at end of file
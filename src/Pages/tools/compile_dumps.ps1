@@ -7,7 +7,10 @@ param (
     $DumpFormatterExePath,
     [Parameter(Mandatory=$true,HelpMessage="Path to output directory.")]
     [string]
-    $OutputDir
+    $OutputDir,
+    [Parameter(HelpMessage="Path to DumpTools.exe, to write the search index of each build.")]
+    [string]
+    $DumpToolsExePath
 )
 
 if (!(Test-Path -Path $RootDir -PathType Container)) {
@@ -18,28 +21,25 @@ if (!(Test-Path -Path $DumpFormatterExePath -PathType Leaf)) {
     Write-Error "-DumpFormatterExePath '$DumpFormatterExePath' does not exist" -ErrorAction Stop
 }
 
-New-Item -Path $OutputDir -ItemType Directory
+if ($DumpToolsExePath -and !(Test-Path -Path $DumpToolsExePath -PathType Leaf)) {
+    Write-Error "-DumpToolsExePath '$DumpToolsExePath' does not exist" -ErrorAction Stop
+}
 
 $dictionary = "$RootDir\dumps\dictionary.txt"
 $registry = "$RootDir\dumps\registry.json"
 
-Copy-Item -Path $registry -Destination "$OutputDir\registry.json"
-
-$games = (Get-Content $registry -Raw | ConvertFrom-Json).psobject.properties | Select-Object name,value
-
-foreach ($game in $games) {
-    $name = $game.name
-    foreach ($entry in $game.value) {
-        $build = $entry.build
-
-        New-Item -Path "$OutputDir\$name" -ItemType Directory -Force
+# formats every build in one process, copying the registry and the JSON dumps to the output directory too, and
+# precomputes the diffs between adjacent builds for the diff page
+& $DumpFormatterExePath batch --diffs --dictionary $dictionary $registry "$RootDir\dumps" $OutputDir
+if ($LASTEXITCODE -ne 0) {
+    Write-Error "DumpFormatter failed with exit code $LASTEXITCODE" -ErrorAction Stop
+}
 
-        $jsonDump = "$RootDir\dumps\$name\b$build.json"
-        Copy-Item -Path $jsonDump -Destination "$OutputDir\$name\b$build.json"
-        & $DumpFormatterExePath --dictionary $dictionary html      $jsonDump "$OutputDir\$name\b$build.html"
-        & $DumpFormatterExePath --dictionary $dictionary plaintext $jsonDump "$OutputDir\$name\b$build.txt"
-        #& $DumpFormatterExePath --dictionary $dictionary xsd       $jsonDump "$OutputDir\$name\b$build.xsd"
-        & $DumpFormatterExePath --dictionary $dictionary jsontree  $jsonDump "$OutputDir\$name\b$build.tree.json"
+# the search index of each build (<game>/b<build>.search), without it the dump page matches every type when searching
+if ($DumpToolsExePath) {
+    & $DumpToolsExePath search-index $registry "$RootDir\dumps" $OutputDir $dictionary
+    if ($LASTEXITCODE -ne 0) {
+        Write-Error "DumpTools failed with exit code $LASTEXITCODE" -ErrorAction Stop
     }
 }
 
@@ -7,7 +7,10 @@ param (
     $DumpFormatterExePath,
     [Parameter(Mandatory=$true,HelpMessage="Path to output directory.")]
     [string]
-    $OutputDir
+    $OutputDir,
+    [Parameter(HelpMessage="Path to DumpTools.exe, to write the search index of each build.")]
+    [string]
+    $DumpToolsExePath
 )
 
 Push-Location "$RootDir\src\Pages\"
@@ -21,4 +24,4 @@ foreach ($include in $includes) {
     Copy-Item -Path "$RootDir\src\Pages\$include" -Destination $OutputDir -Recurse -Force
 }
 
-& "$PSScriptRoot\compile_dumps.ps1" -RootDir $RootDir -DumpFormatterExePath $DumpFormatterExePath -OutputDir "$OutputDir\dumps"
\ No newline at end of file
+& "$PSScriptRoot\compile_dumps.ps1" -RootDir $RootDir -DumpFormatterExePath $DumpFormatterExePath -OutputDir "$OutputDir\dumps" -DumpToolsExePath $DumpToolsExePath
\ No newline at end of file